@@ -2,8 +2,14 @@
 #define CAN_DATA_H
 
 #include <Arduino.h>
-#include <ArduinoJson.h>
+#include <FS.h>
+#include <freertos/semphr.h>
 #include "Config.h"
+#include "RingBuffer.h"
+#include "Seqlock.h"
+#include "SDOManager.h"
+#include "ParamJsonParser.h"
+#include "PollScheduler.h"
 
 // CAN Parameter data types
 enum ParamDataType {
@@ -16,42 +22,24 @@ enum ParamDataType {
     PARAM_FLOAT
 };
 
-// CAN Parameter structure
-struct CANParameter {
-    uint16_t id;
-    char name[32];
-    ParamDataType dataType;
-    
-    union {
-        int8_t i8;
-        uint8_t u8;
-        int16_t i16;
-        uint16_t u16;
-        int32_t i32;
-        uint32_t u32;
-        float f32;
-    } value;
-    
-    bool editable;
+// Parameter metadata (cold). Read on load, for debug output and by the web
+// UI - never touched by the per-frame decode path. Lives in PSRAM when the
+// board has it; name and unit point into a string pool sized at load time.
+struct ParamMeta {
+    const char* name;
+    const char* unit;
     int32_t minValue;
     int32_t maxValue;
-    
-    char unit[8];
+    uint16_t id;
+    uint8_t dataType;       // ParamDataType
     uint8_t decimalPlaces;
-    
-    uint32_t lastUpdateTime;
-    bool dirty;
-    
-    // Get value as string
-    void toString(char* buffer, size_t bufferSize);
-    
-    // Set value from int32
-    void setValue(int32_t val);
-    
-    // Get value as int32
-    int32_t getValueAsInt();
+    bool editable;
 };
 
+// Hot per-parameter flags
+#define PARAM_FLAG_DIRTY     0x01   // Value not yet read from the inverter
+#define PARAM_FLAG_BROADCAST 0x02   // Last value came from a PDO/broadcast frame
+
 // CAN Message structure
 struct CANMessage {
     uint32_t id;
@@ -60,6 +48,66 @@ struct CANMessage {
     uint32_t timestamp;
 };
 
+// Parameter values as last published by the CAN task. Other tasks read this
+// through CANDataManager::getValue() rather than the CAN task's own arrays.
+// The ids travel with the values, so a reader looks an id up in the same
+// table layout it reads the value from, even across a reload.
+struct ParamValues {
+    uint16_t count;
+    uint16_t id[MAX_PARAMETERS];        // Sorted ascending, as paramIds
+    int32_t value[MAX_PARAMETERS];
+    uint32_t updated[MAX_PARAMETERS];   // millis() of the last update, 0 = never
+};
+
+// Value change requested outside the CAN task (optimistic UI update)
+struct ParamWrite {
+    uint16_t id;
+    int32_t value;
+};
+
+// Parameters somebody is looking at right now. Each slot has one writer (the
+// UI task for the dial screen, the web task for /spot); the CAN task polls the
+// union at POLL_FAST and only runs the optional decoders that are asked for.
+#define MAX_INTEREST_IDS    12
+#define MAX_INTEREST_TAGS   16      // Screens tracked in InterestStats
+#define DECODE_BMS_CELLS    0x01    // Per-cell voltage frames (0x400/0x600)
+
+enum InterestSlot : uint8_t {
+    INTEREST_SCREEN,
+    INTEREST_WEB,
+    INTEREST_SLOTS
+};
+
+struct ParamInterest {
+    uint32_t generation;    // Bumped by every setInterest()
+    uint32_t expires;       // millis() the set lapses, 0 = until replaced
+    uint16_t ids[MAX_INTEREST_IDS];
+    uint8_t count;
+    uint8_t decode;         // DECODE_* groups wanted
+    uint8_t tag;            // Screen the cost is booked to
+};
+
+// What the CAN task spent while a screen was shown
+struct InterestStats {
+    uint32_t activeMs;
+    uint32_t sdoRequests;
+    uint32_t framesDecoded;
+    uint32_t framesSkipped;     // Optional decoders nobody wanted
+    uint32_t decodeUs;          // CPU time in processReceivedMessage()
+};
+
+// CAN bus statistics (frames lost anywhere show up here)
+struct CANStats {
+    uint32_t rxFrames;          // Frames taken from the driver
+    uint32_t rxBurstMax;        // Most frames drained in a single update()
+    uint32_t driverRxMissed;    // Driver RX queue full (frame lost)
+    uint32_t driverRxOverrun;   // Controller FIFO overrun (frame lost)
+    uint32_t driverRxPeak;      // Deepest driver RX queue seen at drain time
+    uint32_t txFrames;
+    uint32_t txFailed;
+    uint32_t txQueueFull;       // Frames dropped because txQueue was full (atomic, any task)
+};
+
 // CAN Data Manager
 class CANDataManager {
 public:
@@ -68,37 +116,148 @@ public:
     bool init();
     void update();
     
-    // Parameter management
+    // Parameter management (streamed, no JSON tree or file copy in RAM)
     bool loadParametersFromJSON(const char* jsonString);
-    CANParameter* getParameter(uint16_t id);
-    CANParameter* getParameterByIndex(uint8_t index);
+    bool loadParametersFromFile(const char* path);
+    
+    // Load from the binary cache while jsonPath is unchanged, otherwise parse
+    // jsonPath and rewrite the cache
+    bool loadParametersCached(const char* jsonPath, const char* cachePath);
+    
+    // Have the CAN task reload PARAM_JSON_PATH at its next update() (for
+    // tasks that must not swap the table under it)
+    void requestReload() { reloadRequested = true; }
+    bool isReloadPending() { return reloadRequested; }
+    bool didReloadSucceed() { return reloadOk; }    // Once it is no longer pending
+    
+    // The table (ids, metadata, count) is swapped by the CAN task on a
+    // reload. Any other task holds it - see ParamTableLock - while it uses
+    // the calls below and the ParamMeta pointers they return. The CAN task
+    // never waits for it; a held table just postpones the reload.
+    bool lockTable(TickType_t wait = portMAX_DELAY);
+    void unlockTable();
+    
+    // Parameter metadata (name, unit, limits). Values belong to the CAN
+    // task - use getValue()/getValues() from any other task.
+    const ParamMeta* getParameter(uint16_t id);
+    const ParamMeta* getParameterByIndex(uint16_t index);
     uint16_t getParameterCount() { return parameterCount; }
     
+    // Parameters are kept sorted by id; index is a position in that order
+    uint16_t getParameterId(uint16_t index) { return index < parameterCount ? paramIds[index] : 0; }
+    
+    // SDO polling (runs inside update()). Rates of parameters in an interest
+    // set are managed by setInterest().
+    void setPollRate(uint16_t id, PollRate rate);
+    const PollStats& getPollStats() { return poller.getStats(); }
+    
+    // Replace a slot's interest set (one writer task per slot). ttlMs > 0
+    // lets the set lapse unless it is renewed.
+    void setInterest(InterestSlot slot, uint8_t tag, const uint16_t* ids, uint8_t count,
+                     uint8_t decode, uint32_t ttlMs = 0);
+    const InterestStats& getInterestStats(uint8_t tag) { return interestStats[tag < MAX_INTEREST_TAGS ? tag : 0]; }
+    
+    // Lock-free reads of the published snapshot (safe from any task)
+    bool getValue(uint16_t id, int32_t& value, uint32_t* updated = nullptr);
+    uint8_t getValues(const uint16_t* ids, int32_t* values, uint8_t count);  // One consistent view
+    uint32_t getLastUpdate(const uint16_t* ids, uint8_t count);  // Newest update time of the set
+    
     // CAN communication
     void requestParameter(uint16_t paramId);
     void setParameter(uint16_t paramId, int32_t value);
     bool sendMessage(uint32_t id, uint8_t* data, uint8_t length);
     
+    // Straight to the driver from any task, leaving HEARTBEAT_TX_RESERVE
+    // queue slots free for the 0x351 heartbeat. Waits up to `wait` for room.
+    static bool transmit(const twai_message_t& msg, TickType_t wait);
+    
     // Connection status
     bool isConnected() { return connected; }
     uint32_t getLastMessageTime() { return lastMessageTime; }
     
+    // Blocking SDO client - only call from tasks other than the CAN task
+    SDOManager& getSDO() { return sdo; }
+    
+    // Write many parameters as one SDO batch (SDOManager::writeBatch).
+    // Parameters with a direct CAN mapping (gear, motor, regen) are sent
+    // through setParameter() once the SDO writes succeeded. Blocks.
+    bool writeParameters(SDOWrite* writes, uint16_t count, uint8_t options);
+    
+    // Statistics
+    const CANStats& getStats();
+    
+    // Called for every received frame (e.g. web CAN log)
+    void setOnMessageReceived(void (*callback)(const CANMessage& msg));
+    
+    // Called from the CAN task for frames with (frame id & mask) == (id & mask),
+    // before they are decoded. Register during setup, before the tasks start.
+    typedef void (*FrameHandler)(const CANMessage& msg, void* context);
+    bool addFrameListener(uint32_t id, uint32_t mask, FrameHandler handler, void* context);
+    
     // BMS cell voltage access
     uint16_t getCellVoltage(uint8_t cellIndex);  // Returns voltage in mV
     uint8_t getCellCount() { return bmsCellCount; }
     uint32_t getCellLastUpdate(uint8_t cellIndex);
     
+    // Store size and lookup/scan timing (serial)
+    void printFootprint();
+    
 private:
-    CANParameter parameters[MAX_PARAMETERS];
+    // Parameter store, structure-of-arrays. The hot arrays are what the
+    // decode, snapshot and polling loops walk; metadata stays out of the way.
+    uint16_t paramIds[MAX_PARAMETERS];          // Sorted ascending
+    int32_t paramValues[MAX_PARAMETERS];        // Already narrowed to dataType
+    uint32_t paramUpdateTimes[MAX_PARAMETERS];
+    uint8_t paramFlags[MAX_PARAMETERS];
     uint16_t parameterCount;
     
-    CANMessage txQueue[TX_QUEUE_SIZE];
-    CANMessage rxQueue[RX_QUEUE_SIZE];
-    uint8_t txHead, txTail;
-    uint8_t rxHead, rxTail;
+    ParamMeta* paramMeta;       // parameterCount entries
+    char* stringPool;
+    size_t stringPoolSize;
+    bool metaInPsram;
+    volatile bool reloadRequested;
+    volatile bool reloadOk;
+    SemaphoreHandle_t tableMutex;
+    
+    // Published after each drained RX burst
+    Seqlock<ParamValues> snapshot;
+    MpscRingBuffer<ParamWrite, 16> localWrites;
     
-    bool connected;
-    uint32_t lastMessageTime;
+    PollScheduler poller;
+    
+    // Interest sets, as last applied by the CAN task
+    Seqlock<ParamInterest> interest[INTEREST_SLOTS];
+    uint32_t interestApplied[INTEREST_SLOTS];   // Generation, ~0 = reapply
+    bool interestActive[INTEREST_SLOTS];
+    int16_t fastIndices[MAX_INTEREST_IDS * INTEREST_SLOTS];
+    uint8_t fastCount;
+    uint8_t decodeMask;
+    uint8_t screenTag;
+    InterestStats interestStats[MAX_INTEREST_TAGS];
+    uint32_t interestAccounted;
+    
+    // TX is queued from the UI, web and immobilizer code, RX only from update()
+    MpscRingBuffer<CANMessage, TX_QUEUE_SIZE> txQueue;
+    CANMessage pendingTx;       // Popped, but the driver had no room yet
+    bool txPending;
+    uint32_t pendingTxSince;
+    RingBuffer<CANMessage, RX_QUEUE_SIZE> rxQueue;
+    
+    volatile bool connected;
+    volatile uint32_t lastMessageTime;
+    
+    SDOManager sdo;
+    CANStats stats;
+    void (*onMessageReceived)(const CANMessage& msg);
+    
+    struct FrameListener {
+        uint32_t id;
+        uint32_t mask;
+        FrameHandler handler;
+        void* context;
+    };
+    FrameListener frameListeners[MAX_FRAME_LISTENERS];
+    uint8_t frameListenerCount;
     
     // BMS cell voltage storage (up to 96 cells = 16 modules * 6 cells)
     static const uint8_t MAX_BMS_CELLS = 96;
@@ -112,12 +271,58 @@ private:
     void handleGenericMessage(CANMessage& msg);
     void handleBMSCellVoltage(CANMessage& msg);
     void updateParameterIfExists(uint16_t paramId, int32_t value);
+    void setValueAt(uint16_t index, int32_t value);
+    int16_t indexOf(uint16_t paramId);
+    static int16_t indexIn(const uint16_t* ids, uint16_t count, uint16_t paramId);
+    void freeParameters();
+    void resetPolling();
+    PollRate defaultPollRate(uint16_t index);
+    void applyInterest(uint32_t now);
+    
+    // Two-pass streaming load: size the cold store, then fill it
+    struct LoadState {
+        CANDataManager* manager;
+        uint16_t count;         // Records in the JSON (pass 1)
+        uint16_t duplicates;    // Records skipped for a repeated id (pass 2)
+        size_t poolSize;
+        char* poolNext;
+    };
+    bool loadParameters(File* file, const char* text);
+    
+    // Values of the previous table, kept across a reload for unchanged ids
+    struct CarriedValue {
+        uint16_t id;
+        uint8_t dataType;
+        uint8_t flags;
+        int32_t value;
+        uint32_t updated;
+    };
+    uint16_t carryValues(CarriedValue* carried, uint16_t count);
+    size_t parsePass(File* file, const char* text, ParamJsonParser& parser, bool& ok);
+    static void countParam(const ParamRecord& record, void* context);
+    static void storeParam(const ParamRecord& record, void* context);
+    
+    bool loadParameterCache(const char* path, uint32_t sourceCrc, uint32_t sourceSize);
+    bool saveParameterCache(const char* path, uint32_t sourceCrc, uint32_t sourceSize);
+    void publishSnapshot();
     
     // Queue management
-    bool enqueueTx(CANMessage& msg);
-    bool dequeueTx(CANMessage& msg);
-    bool enqueueRx(CANMessage& msg);
-    bool dequeueRx(CANMessage& msg);
+    bool enqueueTx(const CANMessage& msg);
+};
+
+// Holds the parameter table for the lifetime of a scope
+class ParamTableLock {
+public:
+    explicit ParamTableLock(CANDataManager* can, TickType_t wait = portMAX_DELAY)
+        : manager(can), held(can->lockTable(wait)) {}
+    ~ParamTableLock() { if (held) manager->unlockTable(); }
+    bool isHeld() { return held; }
+
+private:
+    CANDataManager* manager;
+    bool held;
+    ParamTableLock(const ParamTableLock&);
+    ParamTableLock& operator=(const ParamTableLock&);
 };
 
 #endif // CAN_DATA_H
@@ -20,11 +20,32 @@
 #define ENCODER_PIN_B       40  // Swapped with PIN_A
 #define ENCODER_BUTTON      42
 
+// Encoder decoding (PCNT unit 0, full quadrature) and acceleration.
+// Detents closer together than SLOW_MS move more than one step, up to
+// ACCEL_MAX steps at FAST_MS; a flick sweeps Regen's whole -35..0 range.
+#define ENCODER_COUNTS_PER_DETENT 4
+#define ENCODER_FILTER_TICKS  250   // APB cycles (80 MHz): ignore edges under ~3 us
+#define ENCODER_ACCEL_SLOW_MS 60
+#define ENCODER_ACCEL_FAST_MS 10
+#define ENCODER_ACCEL_MAX     5
+
 // Touch Screen (FT6336U)
 #define TOUCH_SDA           11
 #define TOUCH_SCL           12
 #define TOUCH_INT           14
 #define TOUCH_RST           -1
+#define TOUCH_I2C_ADDR      0x38
+#define TOUCH_USE_INT       true    // Only read the FT6336U while INT says touched
+
+// Gesture recognition (see GestureRecognizer)
+#define GESTURE_TAP_MAX_MS      300
+#define GESTURE_TAP_SLOP_PX     12  // Movement that still counts as holding still
+#define GESTURE_LONG_PRESS_MS   700
+#define GESTURE_SWIPE_MIN_PX    60
+#define GESTURE_SWIPE_MAX_MS    600
+#define GESTURE_RING_MIN_RADIUS 85  // Drags starting this far out turn the "ring"
+#define GESTURE_RING_STEP_DEG   30  // Arc per rotate step
+#define GESTURE_PINCH_STEP_PCT  25  // Finger distance change per pinch event
 
 // CAN Bus (External Unit - Grove Port)
 // USE PORT B (GREY CONNECTOR) - This is the one that works!
@@ -50,6 +71,18 @@
 
 // File Upload
 #define MAX_JSON_SIZE       16384  // 16KB - enough for large param files
+#define PARAM_LOAD_CHUNK_SIZE   256 // params.json is streamed in chunks this size
+#define PARAM_JSON_PATH         "/params.json"
+#define PARAM_CACHE_PATH        "/params.bin"
+
+// Parameter schema from the inverter (OpenInverter SDO objects)
+#define SCHEMA_KEY_PATH         "/schema.key"       // Firmware the JSON came from
+#define SCHEMA_DOWNLOAD_PATH    "/params.json.tmp"
+#define SCHEMA_SDO_INDEX        0x5001  // Parameter list JSON
+#define SCHEMA_SERIAL_INDEX     0x5000  // Serial number
+#define SCHEMA_VERSION_UID      2039    // "version" value, read at 0x2100 | (uid >> 8), subindex uid & 0xFF
+#define SCHEMA_SYNC_DELAY_MS    5000    // Settle time after the inverter appears
+#define SCHEMA_MAX_SIZE         65536   // Refuse larger downloads (SPIFFS space)
 
 // ============================================
 // Application Configuration
@@ -63,13 +96,97 @@
 #define MAX_SCREENS         6
 #define MAX_WIDGETS_PER_SCREEN  8
 #define DEFAULT_BRIGHTNESS  128
-#define SLEEP_TIMEOUT_MS    300000  // 5 minutes
+
+// Display power (PowerManager). Idle = no input and no change in the
+// POWER_WAKE_PARAMS values or the lock state.
+#define DIM_TIMEOUT_MS      30000   // Idle time before dimming
+#define DIM_BRIGHTNESS      24
+#define SLEEP_TIMEOUT_MS    300000  // 5 minutes: display off, LVGL paused
+#define SLEEP_CPU_MHZ       80      // CPU clock while the display is off (no esp_pm)
+#define POWER_WAKE_PARAMS   { 27, 129 }     // Gear, motor mode: a change wakes the display
+
+// Supply current model for the energy estimate (mA at 5 V). Datasheet
+// figures for the ESP32-S3 and the Dial's backlight; check against a USB
+// meter and adjust.
+#define POWER_EST_BOARD_MA      18  // CAN transceiver, regulators, touch/RFID idle
+#define POWER_EST_CPU_MA_PER_MHZ 0.17f  // Both cores awake, no WiFi
+#define POWER_EST_PANEL_MA      6   // GC9A01 out of sleep mode
+#define POWER_EST_BACKLIGHT_MA  70  // At brightness 255, linear below
+
+// CPU power management (esp_pm): the clock scales between PM_MIN_CPU_MHZ
+// and the boot clock, and runs fast only while a CPU_FREQ_MAX PmLock is
+// held (heartbeat cycle, UI cycle with the display on). Light sleep also
+// needs tickless idle in the SDK build and never starts while the TWAI
+// driver runs, as it holds the APB at max. Set PM_ENABLE false to compare
+// heartbeat jitter and the current estimate at a fixed clock.
+#define PM_ENABLE           true
+#define PM_MIN_CPU_MHZ      80      // APB stays 80 MHz: PCNT filter, I2C, UART timing hold
+#define PM_LIGHT_SLEEP      true
 
 // Data Settings
-#define MAX_PARAMETERS      64
-#define TX_QUEUE_SIZE       16
+#define MAX_PARAMETERS      512     // ~27 bytes/param internal RAM, metadata in PSRAM
+#define TX_QUEUE_SIZE       16      // Ring buffer sizes must be powers of two
 #define RX_QUEUE_SIZE       32
-#define PARAM_UPDATE_INTERVAL_MS  100
+#define MAX_FRAME_LISTENERS 8       // CANDataManager::addFrameListener() slots
+
+// SDO parameter polling (PollScheduler). Each read is a request and a
+// response frame; at full budget polling uses under 2% of a 500k bus.
+#define POLL_FAST_MS            250     // Values on the visible screen
+#define POLL_NORMAL_MS          2000    // Other live values
+#define POLL_SLOW_MS            30000   // Editable settings
+#define POLL_BUDGET_PER_SEC     40      // SDO reads per second, sustained
+#define POLL_BUDGET_BURST       4
+#define POLL_BROADCAST_STALE_MS 2000    // Poll a broadcast value again after this silence
+
+// TWAI driver queues (frames). The driver RX queue is the only buffer that
+// absorbs a burst while loop() is busy, so it is sized for the deepest burst
+// seen on the bus (SimpBMS cell sweep + broadcasts, ~40 frames back-to-back)
+// with headroom. Check CANDataManager::getStats() if you change these.
+#define CAN_DRIVER_RX_QUEUE_LEN   64
+#define CAN_DRIVER_TX_QUEUE_LEN   16
+#define CAN_TX_RETRY_MS           100   // A queued frame the driver has no room for is dropped after this
+
+// ============================================
+// Task Layout (see TaskManager)
+// ============================================
+
+// Core 1: CAN RX/TX, immobilizer and the 0x351 heartbeat
+// Core 0: LVGL/input, then the web server below it (WiFi also lives here)
+#define CAN_TASK_CORE           1
+#define CAN_TASK_PRIORITY       5
+#define CAN_TASK_STACK          6144    // Reloads the parameter table on request
+#define CAN_TASK_PERIOD_MS      2
+
+#define HEARTBEAT_TASK_CORE     1
+#define HEARTBEAT_TASK_PRIORITY 20      // Highest app task; only IDF system tasks above
+#define HEARTBEAT_TASK_STACK    3072
+#define HEARTBEAT_DEADLINE_SLACK_MS 10  // Gap over the interval + this = missed deadline
+#define HEARTBEAT_STATS_WINDOW  50      // Frames per jitter window (5 s)
+#define HEARTBEAT_TX_RESERVE    2       // Driver TX slots only the heartbeat may fill
+
+#define UI_TASK_CORE            0
+#define UI_TASK_PRIORITY        3
+#define UI_TASK_STACK           8192
+#define UI_TASK_PERIOD_MS       5       // Input, LVGL timers and flush
+#define UI_REFRESH_MS           100     // Screen values from the CAN table
+#define UI_SETTINGS_REFRESH_MS  500
+
+#define WEB_TASK_CORE           0
+#define WEB_TASK_PRIORITY       2       // Below UI - /json can run for seconds
+#define WEB_TASK_STACK          8192
+#define WEB_TASK_PERIOD_MS      5
+
+// Not a TaskManager task: sleeps on the WS1850S IRQ between card probes
+#define RFID_TASK_CORE          0
+#define RFID_TASK_PRIORITY      4       // Above UI - short I2C bursts, then blocks
+#define RFID_TASK_STACK         3072
+
+#define TASK_STATS_INTERVAL_MS  5000    // CPU usage window
+
+// Scheduler jobs within one task: when several are due, higher runs first
+#define JOB_PRIORITY_HIGH       3       // CAN drain; input, LVGL and flush
+#define JOB_PRIORITY_NORMAL     2       // idcmax upkeep, screen refreshes
+#define JOB_PRIORITY_LOW        0       // Serial stats
 
 // Debug
 #define DEBUG_SERIAL        true
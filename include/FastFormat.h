@@ -0,0 +1,51 @@
+#ifndef FAST_FORMAT_H
+#define FAST_FORMAT_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+
+// ============================================
+// Label text formatting without printf
+// ============================================
+//
+// Values are written straight into a buffer owned by the label and handed
+// to LVGL with lv_label_set_text_static(), so an update costs a few integer
+// divides and no heap allocation (lv_label_set_text_fmt runs vsnprintf
+// twice and reallocates the label text every call).
+
+#define LABEL_TEXT_SIZE 24
+
+// Text storage for one label - must live as long as the label
+struct LabelText {
+    char text[LABEL_TEXT_SIZE];
+};
+
+// Appends to a fixed buffer; truncates, always terminated
+class TextWriter {
+public:
+    TextWriter(char* buffer, size_t size);
+
+    TextWriter& str(const char* text);
+    TextWriter& num(int32_t value);
+    TextWriter& fixed(int32_t scaled, uint8_t decimals);   // scaled / 10^decimals
+
+    size_t length() const { return len; }
+
+private:
+    char* buffer;
+    size_t size;
+    size_t len;
+};
+
+// prefix + scaled/10^decimals + unit into the label's buffer. Returns false
+// and leaves the label alone when the text is unchanged (no redraw).
+bool setLabelValue(lv_obj_t* label, LabelText& text, const char* prefix,
+                   int32_t scaled, uint8_t decimals, const char* unit);
+
+// Whole-number shorthand
+inline bool setLabelInt(lv_obj_t* label, LabelText& text, const char* prefix,
+                        int32_t value, const char* unit) {
+    return setLabelValue(label, text, prefix, value, 0, unit);
+}
+
+#endif // FAST_FORMAT_H
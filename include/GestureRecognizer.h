@@ -0,0 +1,87 @@
+#ifndef GESTURE_RECOGNIZER_H
+#define GESTURE_RECOGNIZER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "RingBuffer.h"
+
+#define GESTURE_MAX_POINTS 2    // FT6336U reports two fingers
+
+struct TouchPoint {
+    int16_t x;
+    int16_t y;
+};
+
+enum GestureType : uint8_t {
+    GESTURE_NONE,
+    GESTURE_TAP,
+    GESTURE_LONG_PRESS,         // Fires while still held
+    GESTURE_SWIPE_LEFT,
+    GESTURE_SWIPE_RIGHT,
+    GESTURE_SWIPE_UP,
+    GESTURE_SWIPE_DOWN,
+    GESTURE_ROTATE,             // Circular drag along the rim
+    GESTURE_PINCH,
+    GESTURE_TWO_FINGER_TAP
+};
+
+struct GestureEvent {
+    GestureType type;
+    int16_t x;                  // Where: release point, or the fingers' midpoint
+    int16_t y;
+    int16_t value;              // Swipe: distance px. Rotate: steps, + = clockwise.
+                                // Pinch: distance change in %, + = apart.
+    uint32_t timestamp;
+};
+
+// Turns one touch sample per frame into gestures. No I/O: the same code runs
+// on the dial and against recorded traces on a PC.
+//
+// A drag that starts on the rim (GESTURE_RING_MIN_RADIUS from the centre)
+// turns a virtual ring, one ROTATE step per GESTURE_RING_STEP_DEG of arc;
+// drags starting further in are swipes. Nothing but TWO_FINGER_TAP and PINCH
+// comes out of a touch that ever had two fingers down.
+class GestureRecognizer {
+public:
+    GestureRecognizer();
+
+    void reset();
+
+    // count = fingers down (0 = none), points[0..count-1] their positions
+    void feed(uint32_t ms, uint8_t count, const TouchPoint* points);
+
+    // Next recognized gesture, oldest first
+    bool poll(GestureEvent& event) { return output.pop(event); }
+
+    static const char* getName(GestureType type);
+
+private:
+    RingBuffer<GestureEvent, 8> output;
+
+    bool down;
+    uint32_t downMs;
+    TouchPoint start;
+    TouchPoint last;
+    uint8_t maxFingers;
+    bool moved;                 // Left the GESTURE_TAP_SLOP_PX circle
+    bool longPressed;
+
+    // Ring (circular drag)
+    bool onRing;
+    bool angleValid;
+    float lastAngle;
+    float arc;                  // Degrees not yet turned into steps
+    bool rotated;
+
+    // Pinch
+    int32_t pinchStart;         // Finger distance when the second one landed
+    int32_t pinchReported;      // % change already emitted
+    bool pinched;
+
+    void trackSingle(uint32_t ms, const TouchPoint& point);
+    void trackPair(uint32_t ms, const TouchPoint* points);
+    void release(uint32_t ms);
+    void emit(GestureType type, int16_t x, int16_t y, int16_t value, uint32_t ms);
+};
+
+#endif // GESTURE_RECOGNIZER_H
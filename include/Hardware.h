@@ -7,14 +7,16 @@
 
 class Hardware {
 public:
-    static bool init();
-    static void update();
+    static bool init();   // Touch is sampled by InputManager, not here
     
-    // Display control
+    // Display control. The backlight setting survives dim() and sleep();
+    // wake() goes back to it.
     static void setBacklight(uint8_t brightness);
     static uint8_t getBacklight();
-    static void sleep();
+    static void dim(uint8_t brightness);
+    static void sleep();    // Backlight off and the panel in sleep mode
     static void wake();
+    static bool isAsleep() { return isSleeping; }
     
     // Power management
     static void powerOn();
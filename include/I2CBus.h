@@ -0,0 +1,46 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <freertos/semphr.h>
+
+// Contention on the internal I2C bus (written by whoever holds it)
+struct I2CBusStats {
+    uint32_t acquired;
+    uint32_t contended;     // Had to wait for the other user
+    uint32_t timeouts;      // Gave up waiting
+    uint32_t maxWaitUs;
+};
+
+// Arbiter for M5.In_I2C (GPIO 11/12). The FT6336U touch controller (read by
+// M5.update() in the UI task) and the WS1850S RFID reader (its own task)
+// share the bus; each transaction burst holds this mutex. It is a FreeRTOS
+// mutex, so a low-priority holder inherits the waiter's priority.
+class I2CBus {
+public:
+    static void init();
+
+    static bool lock(TickType_t wait = portMAX_DELAY);
+    static void unlock();
+
+    static const I2CBusStats& getStats() { return stats; }
+
+private:
+    static SemaphoreHandle_t mutex;
+    static I2CBusStats stats;
+};
+
+// Holds the bus for the lifetime of a scope
+class I2CBusLock {
+public:
+    explicit I2CBusLock(TickType_t wait = portMAX_DELAY) : held(I2CBus::lock(wait)) {}
+    ~I2CBusLock() { if (held) I2CBus::unlock(); }
+    bool isHeld() { return held; }
+
+private:
+    bool held;
+    I2CBusLock(const I2CBusLock&);
+    I2CBusLock& operator=(const I2CBusLock&);
+};
+
+#endif // I2C_BUS_H
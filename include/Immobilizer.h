@@ -4,21 +4,31 @@
 #include <Arduino.h>
 #include <M5Unified.h>
 #include "Config.h"
+#include "CANData.h"
+#include "Scheduler.h"
+#include "Seqlock.h"
+#include "WS1850S.h"
+#include <esp_timer.h>
 
 // RFID Module - WS1850S I2C RFID (13.56MHz)
-// M5Dial V1.1 has built-in WS1850S at I2C address 0x28
-// ISSUE: M5Unified 0.1.17 does not include M5.Rfid API
-// Need to either:
-//   1. Update to newer M5Unified (may have M5.Rfid)
-//   2. Find WS1850S I2C library
-//   3. Implement I2C protocol manually
-// TEMPORARILY DISABLED until proper library is found
-#define RFID_ENABLED        false  // M5.Rfid not available in M5Unified 0.1.17
-
-// I2C configuration for future implementation
+// M5Dial V1.1 has built-in WS1850S at I2C address 0x28, on the internal bus
+// it shares with the touch controller. Driven by our own WS1850S class over
+// M5.In_I2C (M5Unified 0.1.17 has no M5.Rfid), from its own task.
+#define RFID_ENABLED        false  // Set AUTHORIZED_UIDS first; also off if no reader answers
+
 #define RFID_I2C_SDA        11     // I2C Data
 #define RFID_I2C_SCL        12     // I2C Clock
 #define RFID_I2C_ADDR       0x28   // WS1850S I2C address
+#define RFID_IRQ_PIN        -1     // WS1850S IRQ GPIO, -1 if not wired to the ESP32
+
+// Card probing: the field is on for SETTLE + RESPONSE ms every INTERVAL.
+// There is no low-power card detection, so every probe is an I2C burst on
+// the bus touch uses, IRQ pin or not; the pin only ends the response wait
+// early. 500 ms is the old polling rate.
+#define RFID_PROBE_INTERVAL_MS 500 // Worst-case delay before a new card is seen
+#define RFID_FIELD_SETTLE_MS   5   // Card power-up before REQA
+#define RFID_RESPONSE_MS       5   // ATQA/UID arrive well within this
+#define RFID_CARD_HOLDOFF_MS   2000 // Ignore cards after acting on one
 
 // Ghost read: 0x20 0x20 0x20 0x20 must be filtered
 
@@ -37,6 +47,8 @@
 // Immobilizer Security Settings
 #define SECRET_PIN_LENGTH   4
 #define VCU_TIMEOUT_MS      5000   // 5 seconds without VCU heartbeat = auto-lock
+#define VCU_ONLINE_FRAMES   10     // 0x500 frames in a row before a timeout may auto-lock
+#define VCU_REARM_MS        60000  // After a dropout, also this long back without a gap
 #define IMMOBILIZER_CAN_ID  0x351  // Immobilizer heartbeat CAN ID
 #define VCU_HEARTBEAT_ID    0x500  // VCU heartbeat to monitor
 #define HEARTBEAT_INTERVAL  100    // Send immobilizer status every 100ms
@@ -50,8 +62,17 @@
 #define CURRENT_UNLOCKED    500    // 500A when unlocked (matches BMS limit)
 #define IDCMAX_SEND_INTERVAL 100   // Send every 100ms for continuous override
 
+// The limit itself goes out as an SDO write to idcmax; the ACK is tracked
+// without blocking and unanswered writes are retried with backoff
+#define IDCMAX_PARAM_ID       37    // idcmax "i" field, written raw (no x32)
+#define IDCMAX_ACK_TIMEOUT_MS 50    // No 0x60/0x80 by then = missed
+#define IMMOBILIZER_UPDATE_MS 10    // CAN task job: ACK timeouts and resends
+#define IDCMAX_RETRY_MAX_MS   1000  // Backoff cap between failed writes
+#define IDCMAX_ALARM_MISSES   3     // Consecutive failures that raise the alarm (~1 s)
+
 // Authorized RFID UIDs
-// Add your actual card UIDs here after scanning them
+// Add your actual card UIDs here after scanning them. The RFID task does
+// not start while the example UIDs below are still in the list.
 const uint8_t AUTHORIZED_UIDS[][4] = {
     {0xDE, 0xAD, 0xBE, 0xEF},  // Example UID 1 - replace with real card
     {0xCA, 0xFE, 0xBA, 0xBE},  // Example UID 2 - replace with real card
@@ -64,13 +85,54 @@ const uint8_t NUM_AUTHORIZED_UIDS = sizeof(AUTHORIZED_UIDS) / sizeof(AUTHORIZED_
 // Secret PIN (change this!)
 const uint8_t SECRET_PIN[SECRET_PIN_LENGTH] = {1, 2, 3, 4};  // Change to your PIN
 
+// Current limit enforcement (written by the CAN task, published for others)
+struct CurrentLimitStatus {
+    int32_t acked;          // Last value the inverter acknowledged, -1 = none yet
+    uint32_t lastAck;       // millis() of that ACK
+    uint32_t sent;
+    uint32_t acks;
+    uint32_t timeouts;
+    uint32_t aborts;
+    uint32_t lastAbortCode;
+    uint16_t ackLatencyMaxMs;
+    uint8_t failures;       // Consecutive, reset by an ACK
+    bool alarm;             // Inverter stopped acknowledging
+};
+
+// VCU heartbeat watchdog. Written by the CAN task (frames) and the esp_timer
+// task (timeouts) under vcuMux; getVcuStatus() copies it out the same way.
+struct VcuWatchdogStatus {
+    uint32_t frames;
+    uint32_t timeouts;
+    uint32_t autoLocks;
+    uint32_t lastLatencyUs;   // Deadline to watchdog firing, last timeout
+    uint32_t maxLatencyUs;
+    uint16_t streak;          // Frames since the last timeout
+    bool online;              // Armed: a timeout now auto-locks
+};
+
+// RFID reader activity (written by the RFID task, published after each probe)
+struct RfidStatus {
+    bool present;
+    uint8_t version;          // WS1850S VersionReg
+    uint32_t probes;
+    uint32_t cards;           // Valid UIDs read
+    uint32_t ghosts;          // 20 20 20 20 reads
+    uint32_t readErrors;      // Answered REQA, then no clean UID
+    uint32_t authorized;
+    uint32_t rejected;
+    uint32_t lastLatencyUs;   // Card answer to lock state change
+    uint32_t maxLatencyUs;
+};
+
 class Immobilizer {
 public:
     Immobilizer();
     
     // Main control
-    void init();
-    void update();  // Call in main loop
+    void init(CANDataManager* can);
+    void update();  // CAN task - never blocks
+    void schedule(Scheduler* sched);  // update() every IMMOBILIZER_UPDATE_MS
     
     // Lock state
     bool isUnlocked() { return unlocked; }
@@ -78,8 +140,12 @@ public:
     void unlock();
     void toggleLock();
     
-    // CAN control for immobilizer
-    void sendCurrentLimit();  // Send idcmax via CAN mapping
+    // idcmax enforcement (any task). The alarm is raised after
+    // IDCMAX_ALARM_MISSES writes in a row were aborted or not acknowledged.
+    void getLimitStatus(CurrentLimitStatus& out) const { limitSnapshot.copy(out); }
+    bool isLimitAlarm() const {
+        return limitSnapshot.read([](const CurrentLimitStatus& s) { return s.alarm; });
+    }
     
     // PIN entry
     void enterDigit(uint8_t digit);
@@ -91,20 +157,22 @@ public:
     void incrementDigit() { currentDigit = (currentDigit + 1) % 10; }
     void decrementDigit() { currentDigit = (currentDigit == 0) ? 9 : currentDigit - 1; }
     
-    // RFID (if enabled)
+    // RFID (if enabled). One probe; true if a card was read and acted on.
     bool checkRFID();
+    void getRfidStatus(RfidStatus& out) const { rfidSnapshot.copy(out); }
     
-    // CAN monitoring
-    void processCANMessage(uint32_t id, uint8_t* data, uint8_t len);
-    void sendHeartbeat();  // Called by timer
+    // CAN monitoring (CAN task, via the VCU_HEARTBEAT_ID frame listener)
+    void processCANMessage(uint32_t id, const uint8_t* data, uint8_t len);
     
-    // VCU monitoring
+    // VCU monitoring. Every 0x500 frame re-arms a one-shot esp_timer; if it
+    // ever expires after the VCU was online, the immobilizer locks itself.
     uint32_t getTimeSinceVCU() { return millis() - lastVCUHeartbeat; }
-    bool isVCUActive() { return (millis() - lastVCUHeartbeat) < VCU_TIMEOUT_MS; }
+    bool isVCUActive() { return vcu.online; }
+    void getVcuStatus(VcuWatchdogStatus& out);
     
 private:
-    // State
-    bool unlocked;
+    // State (read by the heartbeat task on the other core)
+    volatile bool unlocked;
     bool pinEntryMode;
     
     // PIN entry
@@ -113,11 +181,46 @@ private:
     uint8_t currentDigit;  // 0-9 for rotary selection
     
     // Timing
-    uint32_t lastHeartbeat;
-    uint32_t lastVCUHeartbeat;
+    volatile uint32_t lastVCUHeartbeat;
+    
+    // VCU watchdog
+    esp_timer_handle_t vcuTimer;
+    VcuWatchdogStatus vcu;
+    portMUX_TYPE vcuMux;
+    uint32_t vcuUpSinceMs;              // First frame after the last timeout
+    volatile uint32_t lastVcuFrameUs;   // Low 32 bits of esp_timer_get_time()
+    volatile bool vcuAutoLocked;        // Set by the timer, logged by update()
+    
+    // idcmax write/ACK state machine (CAN task only)
+    enum LimitState : uint8_t {
+        LIMIT_IDLE,         // Next write due at lastLimitSend + limitInterval
+        LIMIT_WAIT_ACK      // Write out, waiting for the 0x583 reply
+    };
+    CANDataManager* canManager;
+    CurrentLimitStatus limitStatus;
+    Seqlock<CurrentLimitStatus> limitSnapshot;
+    uint8_t limitState;
+    int32_t limitPending;       // Value of the write in flight
+    uint32_t lastLimitSend;
+    uint32_t limitInterval;     // IDCMAX_SEND_INTERVAL, longer while backing off
+    
+    void updateCurrentLimit(uint32_t now);
+    static void updateJobFn(void* context);
+    void sendCurrentLimit(int32_t current, uint32_t now);
+    void limitFailed();
+    void publishLimit();
+    static void onSdoReply(const CANMessage& msg, void* context);
+    static void onVcuFrame(const CANMessage& msg, void* context);
+    static void onVcuTimeout(void* arg);
     
     // RFID
+    WS1850S rfid;
+    RfidStatus rfidStatus;
+    Seqlock<RfidStatus> rfidSnapshot;
+    void publishRfid();
     bool checkAuthorizedUID(uint8_t* uid);
+    static bool hasExampleUIDs();  // Placeholders in AUTHORIZED_UIDS
+    static void rfidTask(void* arg);
     
     // PIN validation
     bool validatePIN();
@@ -2,8 +2,10 @@
 #define INPUT_MANAGER_H
 
 #include <Arduino.h>
-#include <ESP32Encoder.h>
 #include <OneButton.h>
+#include <driver/pcnt.h>
+#include "RingBuffer.h"
+#include "GestureRecognizer.h"
 
 enum InputEventType {
     INPUT_NONE,
@@ -14,17 +16,34 @@ enum InputEventType {
     INPUT_BUTTON_LONG_PRESS,
     INPUT_TOUCH_PRESS,
     INPUT_TOUCH_RELEASE,
-    INPUT_TOUCH_TAP
+    INPUT_TOUCH_TAP,
+    INPUT_TOUCH_GESTURE     // Anything else GestureRecognizer saw
 };
 
 struct InputEvent {
     InputEventType type;
-    int32_t encoderDelta;
+    int32_t encoderDelta;   // Detents
+    int32_t encoderSteps;   // Detents after the acceleration curve
     uint16_t touchX;
     uint16_t touchY;
+    GestureType gesture;
+    int16_t gestureValue;
     uint32_t timestamp;
 };
 
+// One encoder detent, timestamped in the PCNT ISR
+struct EncoderDetent {
+    int8_t direction;       // +1 CW, -1 CCW
+    uint32_t timeUs;        // esp_timer_get_time(), low 32 bits
+};
+
+struct EncoderStats {
+    uint32_t detents;
+    uint32_t dropped;       // Detent queue full (UI task stalled)
+    uint32_t events;        // Rotate events; detents are coalesced per update()
+    uint16_t maxPerEvent;
+};
+
 class InputManager {
 public:
     InputManager();
@@ -32,42 +51,53 @@ public:
     bool init();
     void update();
     
+    // Everything update() saw, in order. The UI drains it into LVGL's
+    // input devices (see UIManager::readInput()).
     bool hasEvent();
     InputEvent getNextEvent();
     
+    // Finger position while held, for dragging between press and release
+    bool getTouchPoint(uint16_t& x, uint16_t& y);
+    
+    // millis() of the newest event of any kind (idle timing)
+    uint32_t getLastEventTime() { return lastEventMs; }
+    
     // Encoder access
     int32_t getEncoderPosition();
     void resetEncoderPosition();
+    const EncoderStats& getEncoderStats() { return encoderStats; }
     
-    // Callbacks
-    void setOnEncoderRotate(void (*callback)(int32_t delta));
-    void setOnButtonClick(void (*callback)());
-    void setOnButtonDoubleClick(void (*callback)());
-    void setOnButtonLongPress(void (*callback)());
-    void setOnTouchTap(void (*callback)(uint16_t x, uint16_t y));
+    // ISR time of the oldest detent behind the last rotate event, once
+    bool takeInputTime(uint32_t& timeUs);
     
 private:
-    ESP32Encoder encoder;
     OneButton button;
     
-    int32_t lastEncoderPosition;
+    // Detents from the PCNT ISR. The counter resets itself at +/-4 counts,
+    // so the ISR only sees whole detents and nothing is polled.
+    RingBuffer<EncoderDetent, 32> detents;
+    volatile int32_t encoderPosition;   // Detents since reset (ISR)
+    volatile uint32_t detentsDropped;
+    EncoderStats encoderStats;
+    uint32_t lastDetentUs;
+    int8_t lastDirection;
+    uint32_t inputTimeUs;
+    bool inputTimePending;
     bool touchPressed;
     uint16_t lastTouchX, lastTouchY;
-    uint32_t touchPressTime;
+    uint32_t lastEventMs;
+    GestureRecognizer gestures;
     
-    InputEvent eventQueue[8];
-    uint8_t eventHead, eventTail;
+    // Filled from button/encoder/touch handling, drained by the UI
+    MpscRingBuffer<InputEvent, 16> eventQueue;
     
-    void (*onEncoderRotate)(int32_t delta);
-    void (*onButtonClick)();
-    void (*onButtonDoubleClick)();
-    void (*onButtonLongPress)();
-    void (*onTouchTap)(uint16_t x, uint16_t y);
-    
-    bool enqueueEvent(InputEvent& event);
-    bool dequeueEvent(InputEvent& event);
+    bool enqueueEvent(const InputEvent& event);
     
     void checkTouch();
+    void checkEncoder();
+    int32_t accelerate(uint32_t intervalUs);
+    
+    static void IRAM_ATTR onPcntEvent(void* arg);
     
     // Static callbacks for OneButton
     static void buttonClickCallback();
@@ -0,0 +1,86 @@
+#ifndef PARAM_JSON_PARSER_H
+#define PARAM_JSON_PARSER_H
+
+#include <Arduino.h>
+
+// One parameter as read from params.json
+struct ParamRecord {
+    uint16_t id;
+    bool hasId;
+    char name[32];
+    char unit[8];
+    char type[8];
+    int32_t minValue;
+    int32_t maxValue;
+    uint8_t decimals;
+    bool editable;
+};
+
+// Streaming (SAX style) params.json reader. Input is pushed in chunks of any
+// size and each parameter is handed to the callback as soon as its object
+// closes, so the file never has to be in RAM and no tree is built.
+//
+// Two layouts are understood:
+//   {"parameters": [ {"id": 1, "name": "Speed", "type": "int16", ...}, ... ]}
+//   {"speed": {"i": 2, "unit": "rpm", "minimum": 0, "maximum": 6000}, ...}
+// The second is the OpenInverter web UI export; entries with a
+// minimum/maximum (or "isparam": true) are treated as editable.
+class ParamJsonParser {
+public:
+    typedef void (*RecordCallback)(const ParamRecord& record, void* context);
+
+    ParamJsonParser();
+
+    // Reset state and set where records go
+    void begin(RecordCallback callback, void* context);
+
+    // Push the next chunk. Returns false once the input is known to be bad.
+    bool feed(const char* data, size_t length);
+
+    // End of input. True if the document was complete and well formed.
+    bool finish();
+
+    uint16_t getRecordCount() { return recordCount; }
+
+private:
+    static const uint8_t MAX_DEPTH = 8;
+    static const uint8_t TEXT_SIZE = 32;
+
+    enum State : uint8_t {
+        STATE_STRUCTURE,    // Between tokens
+        STATE_STRING,
+        STATE_STRING_ESCAPE,
+        STATE_LITERAL       // Number, true, false, null
+    };
+
+    RecordCallback callback;
+    void* context;
+
+    State state;
+    bool failed;
+    bool expectKey;             // Next string in the current object is a key
+    bool sawRoot;
+    char stack[MAX_DEPTH];      // '{' or '['
+    uint8_t depth;
+    uint8_t recordDepth;        // Depth of the open record object, 0 = none
+
+    char key[TEXT_SIZE];        // Last key seen at the current depth
+    char text[TEXT_SIZE];       // String or literal being read
+    uint8_t textLength;
+    uint8_t unicodeSkip;        // Hex digits of a \uXXXX escape still to skip
+    bool parametersArray;       // Inside {"parameters": [ ... ]}
+
+    ParamRecord record;
+    bool recordOpenInverter;
+    bool recordHasRange;
+    uint16_t recordCount;
+
+    bool processChar(char c);
+    bool openContainer(char c);
+    bool closeContainer(char c);
+    void endValue(bool isString);
+    void startRecord(const char* name, bool openInverter);
+    void applyField(const char* field, bool isString);
+};
+
+#endif // PARAM_JSON_PARSER_H
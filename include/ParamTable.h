@@ -0,0 +1,44 @@
+#ifndef PARAM_TABLE_H
+#define PARAM_TABLE_H
+
+#include <Arduino.h>
+
+// How a ZombieVerter parameter travels over SDO
+enum ParamEncoding : uint8_t {
+    PARAM_ENC_FIXED32,  // Value x32 (OpenInverter fixed point)
+    PARAM_ENC_RAW       // Enums, CAN/GPIO assignments, counters - sent as is
+};
+
+// 32-bit FNV-1a, usable at compile time
+constexpr uint32_t paramNameHash(const char* name, uint32_t hash = 2166136261u) {
+    return *name ? paramNameHash(name + 1, (hash ^ (uint8_t)*name) * 16777619u) : hash;
+}
+
+// One ZombieVerter parameter as shown by the web UI
+struct ParamInfo {
+    const char* name;
+    const char* unit;
+    const char* category;
+    uint32_t nameHash;
+    uint16_t id;
+    ParamEncoding encoding;
+
+    constexpr ParamInfo(uint16_t id, const char* name, const char* unit,
+                        const char* category, ParamEncoding encoding)
+        : name(name), unit(unit), category(category), nameHash(paramNameHash(name)),
+          id(id), encoding(encoding) {}
+};
+
+// ZombieVerter parameter table (flash). Entry i has id i.
+#define PARAM_TABLE_SIZE 119
+extern const ParamInfo PARAM_TABLE[PARAM_TABLE_SIZE];
+
+// O(1) lookup by SDO parameter id
+inline const ParamInfo* findParamInfo(uint16_t id) {
+    return id < PARAM_TABLE_SIZE ? &PARAM_TABLE[id] : nullptr;
+}
+
+// Lookup by name (hash compare, strcmp only on a hash match)
+const ParamInfo* findParamInfo(const char* name);
+
+#endif // PARAM_TABLE_H
@@ -0,0 +1,45 @@
+#ifndef PM_LOCK_H
+#define PM_LOCK_H
+
+#include <Arduino.h>
+#include <esp_pm.h>
+#include "Config.h"
+
+#define MAX_PM_LOCKS 8
+
+// An esp_pm lock that keeps count of how long it was held. Every lock is
+// listed (see get()) so /power can show who kept the CPU fast. Without
+// CONFIG_PM_ENABLE in the SDK build create() fails and the lock does
+// nothing.
+class PmLock {
+public:
+    PmLock(esp_pm_lock_type_t type, const char* name);
+    
+    bool create();
+    
+    // Not recursive: one acquire() per release(), from one task
+    void acquire();
+    void release();
+    
+    const char* getName() const { return name; }
+    esp_pm_lock_type_t getType() const { return type; }
+    uint32_t getAcquisitions() const { return acquisitions; }
+    uint32_t getHeldUs() const { return heldUs; }      // Wraps; subtract readings
+    
+    static uint8_t getCount() { return count; }
+    static const PmLock* get(uint8_t index) { return index < count ? locks[index] : nullptr; }
+    static uint32_t getTotalHeldUs(esp_pm_lock_type_t type);
+    
+private:
+    esp_pm_lock_handle_t handle;
+    esp_pm_lock_type_t type;
+    const char* name;
+    int64_t acquiredUs;
+    volatile uint32_t acquisitions;
+    volatile uint32_t heldUs;
+    
+    static PmLock* locks[MAX_PM_LOCKS];
+    static uint8_t count;
+};
+
+#endif // PM_LOCK_H
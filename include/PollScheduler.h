@@ -0,0 +1,63 @@
+#ifndef POLL_SCHEDULER_H
+#define POLL_SCHEDULER_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// How often a parameter should be refreshed over SDO
+enum PollRate : uint8_t {
+    POLL_FAST,      // On screen now
+    POLL_NORMAL,    // Live values not on screen
+    POLL_SLOW,      // Settings - change rarely
+    POLL_NEVER
+};
+
+// Polling statistics (freshness refreshed once a second)
+struct PollStats {
+    uint32_t requests;          // SDO reads sent
+    uint32_t budgetDeferred;    // Times a due read waited for a bus token
+    uint16_t requestsPerSec;    // Over the last second
+    uint16_t polled;            // Parameters with a rate other than NEVER
+    uint16_t broadcast;         // Skipped because PDO/broadcast frames keep them fresh
+    uint16_t stale;             // Polled parameters older than 2x their period
+    uint32_t worstAgeMs;        // Oldest polled value
+};
+
+// Decides which parameter to read next. Each parameter has a target period
+// by rate class; the one furthest past its period (relative to that period)
+// goes first, and a token bucket caps SDO reads per second so polling can
+// never crowd the bus. Values that PDO/broadcast frames update are left alone
+// until those frames stop.
+class PollScheduler {
+public:
+    PollScheduler();
+
+    // Call after the parameter table is (re)loaded; all rates become POLL_NORMAL
+    void reset(uint16_t count);
+
+    void setRate(uint16_t index, PollRate rate);
+    PollRate getRate(uint16_t index) { return (PollRate)rates[index]; }
+
+    // Index of the parameter to read now, or -1 if none is due or the budget
+    // is spent. Marks it requested.
+    int16_t next(uint32_t now, const uint32_t* updateTimes, const uint8_t* flags, uint16_t count);
+
+    const PollStats& getStats() { return stats; }
+
+private:
+    uint8_t rates[MAX_PARAMETERS];
+    uint32_t lastRequest[MAX_PARAMETERS];
+
+    // Token bucket, in thousandths of a request
+    uint32_t tokens;
+    uint32_t lastRefill;
+
+    PollStats stats;
+    uint32_t windowStart;
+    uint32_t windowRequests;
+
+    static uint32_t periodFor(uint8_t rate);
+    void updateFreshness(uint32_t now, const uint32_t* updateTimes, const uint8_t* flags, uint16_t count);
+};
+
+#endif // POLL_SCHEDULER_H
@@ -0,0 +1,107 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "Seqlock.h"
+#include "CANData.h"
+#include "PmLock.h"
+
+class UIManager;
+class InputManager;
+class Immobilizer;
+
+enum PowerState : uint8_t {
+    POWER_ACTIVE,       // Full backlight, LVGL running
+    POWER_DIM,          // DIM_BRIGHTNESS, LVGL running
+    POWER_OFF,          // Panel asleep, LVGL paused, CPU at its minimum
+    POWER_STATE_COUNT
+};
+
+// What esp_pm_configure() accepted (the SDK build decides)
+enum PmMode : uint8_t {
+    PM_MODE_FIXED,          // No esp_pm: setCpuFrequencyMhz() when the display is off
+    PM_MODE_DFS,            // Frequency scaling
+    PM_MODE_DFS_SLEEP       // Frequency scaling and automatic light sleep
+};
+
+// Time and estimated charge per state since boot (readable from any task)
+struct PowerStats {
+    PowerState state;
+    uint32_t ms[POWER_STATE_COUNT];
+    uint32_t uAh[POWER_STATE_COUNT];        // Estimated, see POWER_EST_*
+    uint16_t estimateMa[POWER_STATE_COUNT]; // Average model current in each state
+    uint32_t savedUAh;                      // Against staying POWER_ACTIVE
+    uint32_t wakesByInput;
+    uint32_t wakesByCan;                    // Wake parameter or lock state changed
+    
+    PmMode pmMode;
+    uint16_t maxCpuMhz;
+    uint16_t minCpuMhz;
+    uint8_t boostPct;                       // Time a CPU_FREQ_MAX lock was held, last second
+};
+
+// Dims the display after DIM_TIMEOUT_MS without activity and turns it off
+// after SLEEP_TIMEOUT_MS: backlight and panel off, LVGL paused, the CPU
+// clocked down. Input, a change in POWER_WAKE_PARAMS or the lock state
+// brings it back. Runs on the UI task, which owns the display.
+//
+// It also sets up esp_pm. The UI cycle holds a CPU_FREQ_MAX lock while the
+// display is on; the CPU idles at PM_MIN_CPU_MHZ in between and whenever
+// the display is off.
+class PowerManager {
+public:
+    PowerManager();
+    
+    void begin(UIManager* ui, InputManager* input, CANDataManager* can, Immobilizer* immob);
+    
+    // UI task, every cycle: update() between InputManager::update() and
+    // UIManager::update(), cycleDone() at the end of the cycle
+    void update();
+    void cycleDone();
+    
+    PowerState getState() const { return state; }
+    static const char* getStateName(PowerState state);
+    
+    void getStats(PowerStats& out) const { stats.copy(out); }
+    void printStats() const;
+    
+private:
+    UIManager* ui;
+    InputManager* input;
+    CANDataManager* canManager;
+    Immobilizer* immobilizer;
+    
+    PowerState state;
+    uint32_t lastActivityMs;
+    uint32_t lastInputMs;
+    uint32_t lastAccountMs;
+    uint32_t activeCpuMhz;
+    uint32_t minCpuMhz;
+    PmMode pmMode;
+    PmLock uiLock;
+    bool uiBoosted;
+    uint32_t lastHeldUs;
+    uint32_t windowMs;
+    uint32_t windowHeldUs;
+    
+    // Last seen wake parameter values and lock state
+    int32_t wakeValues[MAX_INTEREST_IDS];
+    bool wakeValuesValid;
+    bool wasUnlocked;
+    
+    // Charge in mA*ms (uAh * 3600)
+    uint64_t chargeMaMs[POWER_STATE_COUNT];
+    uint64_t activeChargeMaMs;
+    
+    PowerStats current;
+    Seqlock<PowerStats> stats;
+    
+    void configurePm();
+    bool checkCanWake();
+    void setState(PowerState next);
+    void account(uint32_t now);
+    float modelMa(PowerState s, float boost) const;
+};
+
+#endif // POWER_MANAGER_H
@@ -0,0 +1,211 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// ============================================
+// Lock-free ring buffers
+// ============================================
+//
+// Header-only, fixed-size queues shared by CAN, input and the web CAN log.
+// N must be a power of two so wrap-around is a mask instead of a divide.
+// Indices run freely (uint32_t) and are masked on access, so all N slots are
+// usable and "full" is simply head - tail == N.
+//
+// RingBuffer      - one producer, one consumer (task->task or ISR->task)
+// MpscRingBuffer  - any number of producers, one consumer
+//
+// Neither type blocks or takes a lock, so both are safe to use from an ISR
+// on the producer side.
+
+// --------------------------------------------
+// Single producer / single consumer
+// --------------------------------------------
+// head is written only by the producer, tail only by the consumer. Each side
+// publishes its index with release ordering after touching the slot, and
+// reads the other side's index with acquire ordering before touching a slot.
+template <typename T, size_t N>
+class RingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "RingBuffer size must be a power of two");
+
+public:
+    RingBuffer() : head(0), tail(0) {}
+
+    static size_t capacity() { return N; }
+
+    // Producer side
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) return false;
+
+        buffer[h & MASK] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Push up to count items, returns how many fit
+    size_t pushBulk(const T* items, size_t count) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        size_t space = N - (h - tail.load(std::memory_order_acquire));
+        if (count > space) count = space;
+
+        for (size_t i = 0; i < count; i++) {
+            buffer[(h + i) & MASK] = items[i];
+        }
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) return false;
+
+        item = buffer[t & MASK];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pop up to maxCount items, returns how many were copied
+    size_t popBulk(T* items, size_t maxCount) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        size_t avail = head.load(std::memory_order_acquire) - t;
+        if (maxCount > avail) maxCount = avail;
+
+        for (size_t i = 0; i < maxCount; i++) {
+            items[i] = buffer[(t + i) & MASK];
+        }
+        tail.store(t + maxCount, std::memory_order_release);
+        return maxCount;
+    }
+
+    // Look at the oldest item without copying it (consumer only).
+    // Returns nullptr when empty. Call popFront() when done with it.
+    T* front() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) return nullptr;
+        return &buffer[t & MASK];
+    }
+
+    void popFront() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Drop everything queued (consumer only)
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Approximate when called from the other side, exact from either owner
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= N; }
+
+private:
+    static const uint32_t MASK = N - 1;
+
+    T buffer[N];
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+};
+
+// --------------------------------------------
+// Multiple producers / single consumer
+// --------------------------------------------
+// Bounded queue with a sequence number per cell (D. Vyukov). A producer
+// claims a position with a CAS on enqueuePos, fills the cell and then
+// publishes it by bumping the cell sequence. The consumer only reads a cell
+// once its sequence says it has been published, so a producer pre-empted
+// mid-push (e.g. by an ISR that also pushes) never exposes a torn item; the
+// consumer just sees the queue as empty up to that cell until it finishes.
+template <typename T, size_t N>
+class MpscRingBuffer {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscRingBuffer size must be a power of two");
+
+public:
+    MpscRingBuffer() : enqueuePos(0), dequeuePos(0) {
+        for (uint32_t i = 0; i < N; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    static size_t capacity() { return N; }
+
+    // Producer side (any task or ISR)
+    bool push(const T& item) {
+        uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & MASK];
+            uint32_t seq = cell->sequence.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)(seq - pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+                // pos was reloaded by the failed CAS - retry
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t pushBulk(const T* items, size_t count) {
+        size_t pushed = 0;
+        while (pushed < count && push(items[pushed])) {
+            pushed++;
+        }
+        return pushed;
+    }
+
+    // Consumer side (one task only)
+    bool pop(T& item) {
+        uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell = &cells[pos & MASK];
+        uint32_t seq = cell->sequence.load(std::memory_order_acquire);
+        if ((int32_t)(seq - (pos + 1)) < 0) return false;  // Empty (or not yet published)
+
+        item = cell->data;
+        cell->sequence.store(pos + N, std::memory_order_release);
+        dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t popBulk(T* items, size_t maxCount) {
+        size_t popped = 0;
+        while (popped < maxCount && pop(items[popped])) {
+            popped++;
+        }
+        return popped;
+    }
+
+    // Approximate - producers may be mid-push
+    size_t size() const {
+        return enqueuePos.load(std::memory_order_acquire) - dequeuePos.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+
+private:
+    static const uint32_t MASK = N - 1;
+
+    struct Cell {
+        std::atomic<uint32_t> sequence;
+        T data;
+    };
+
+    Cell cells[N];
+    std::atomic<uint32_t> enqueuePos;
+    std::atomic<uint32_t> dequeuePos;
+};
+
+#endif // RING_BUFFER_H
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include "driver/twai.h"
+#include <freertos/semphr.h>
+#include "RingBuffer.h"
 
 // ZombieVerter SDO Configuration
 #define SDO_TX_ID 0x603  // M5Dial → ZombieVerter
@@ -10,6 +12,12 @@
 #define SDO_TIMEOUT_MS 100
 #define SDO_MAX_RETRIES 3
 
+// Batch writes (writeBatch)
+#define SDO_BATCH_WINDOW    4     // Expedited requests in flight at once
+#define SDO_BATCH_VERIFY    0x01  // Read every value back after writing
+#define SDO_BATCH_ROLLBACK  0x02  // Stop at the first failure, restore old values
+#define SDO_BATCH_SAVE      0x04  // saveToFlash() once if everything went through
+
 // SDO Command Codes (byte 0)
 #define SDO_CMD_READ    0x40  // Upload (read from device)
 #define SDO_CMD_WRITE   0x23  // Download (write to device)
@@ -17,9 +25,26 @@
 
 // SDO Response Codes (byte 0)
 #define SDO_RESP_READ   0x43  // Upload response (4 bytes)
+#define SDO_RESP_READ_MASK 0xE3  // Any expedited upload: 0x43/47/4B/4F, n in bits 2-3
 #define SDO_RESP_WRITE  0x60  // Download confirmation
 #define SDO_RESP_ABORT  0x80  // Abort code
 
+// Segmented upload (CiA 301 7.2.4.3.5). Byte 0 bits: t = toggle,
+// n = unused bytes, e = expedited, s = size indicated, c = last segment.
+#define SDO_CMD_UPLOAD_SEGMENT  0x60  // | t << 4
+#define SDO_SCS_UPLOAD_INIT     0x40  // | n << 2 | e << 1 | s
+#define SDO_SCS_UPLOAD_SEGMENT  0x00  // | t << 4 | n << 1 | c
+
+// Block upload (CiA 301 7.2.4.3.13)
+#define SDO_CMD_BLOCK_UPLOAD    0xA0  // ccs 5 | cs
+#define SDO_BLOCK_INITIATE      0x00
+#define SDO_BLOCK_END           0x01
+#define SDO_BLOCK_ACK           0x02
+#define SDO_BLOCK_START         0x03
+#define SDO_BLOCK_CRC           0x04  // Client/server supports CRC
+#define SDO_SCS_BLOCK_UPLOAD    0xC0  // scs 6 | sc << 2 | s << 1 | ss
+#define SDO_BLOCK_SIZE          127   // Segments per block (max 127)
+
 // ZombieVerter Fixed Bytes (Index 0x2100)
 #define SDO_FIXED_BYTE1 0x00  // Index low byte (0x2100 & 0xFF)
 #define SDO_FIXED_BYTE2 0x21  // Index high byte (0x2100 >> 8)
@@ -28,10 +53,37 @@
 #define SDO_ABORT_TOGGLE        0x05030000
 #define SDO_ABORT_TIMEOUT       0x05040000
 #define SDO_ABORT_CMD_INVALID   0x05040001
+#define SDO_ABORT_BLOCK_SIZE    0x05040002
+#define SDO_ABORT_SEQUENCE      0x05040003
+#define SDO_ABORT_CRC           0x05040004
+#define SDO_ABORT_MEMORY        0x05040005
 #define SDO_ABORT_PARAM_INVALID 0x06090011
 #define SDO_ABORT_PARAM_RANGE   0x06090030
 #define SDO_ABORT_GENERAL       0x08000000
 
+// What happened to one entry of a batch write
+enum SDOWriteStatus : uint8_t {
+    SDO_WRITE_PENDING,          // To be written (set by the caller)
+    SDO_WRITE_DONE,             // Acknowledged, not read back
+    SDO_WRITE_VERIFIED,         // Acknowledged and read back equal
+    SDO_WRITE_MISMATCH,         // Read back a different value
+    SDO_WRITE_ABORTED,          // Server aborted (abortCode)
+    SDO_WRITE_TIMEOUT,          // No reply after SDO_MAX_RETRIES
+    SDO_WRITE_SKIPPED,          // Not attempted - an earlier entry failed
+    SDO_WRITE_ROLLED_BACK,      // Written, then restored to previous
+    SDO_WRITE_ROLLBACK_FAILED,  // Written, restoring it failed
+    SDO_WRITE_DIRECT            // Handled outside SDO by the caller
+};
+
+struct SDOWrite {
+    uint8_t paramId;
+    uint8_t status;         // SDOWriteStatus
+    int32_t value;          // To write
+    int32_t previous;       // Read before writing when rolling back
+    int32_t readBack;       // Read after writing when verifying
+    uint32_t abortCode;
+};
+
 class SDOManager {
 public:
     SDOManager();
@@ -48,8 +100,38 @@ public:
     // Save all parameters to flash
     bool saveToFlash();
     
-    // Process incoming SDO responses
-    void processResponse(const twai_message_t& msg);
+    // Write many parameters with SDO_BATCH_WINDOW requests in flight
+    // instead of one round trip each. Only entries whose status is
+    // SDO_WRITE_PENDING are touched; options are SDO_BATCH_* flags. True if
+    // every entry was written (and verified/saved when asked).
+    bool writeBatch(SDOWrite* writes, uint16_t count, uint8_t options);
+    uint32_t getLastBatchMs() { return lastBatchMs; }
+    static const char* getWriteStatusName(uint8_t status);
+    
+    // Value of an expedited upload reply, whatever size it indicates
+    // (bytes past the size are zeroed). False for any other frame.
+    static bool decodeExpedited(const uint8_t* data, uint8_t len, uint32_t& value);
+    
+    // Read an object of any length (parameter list, serial number). Tries
+    // block upload first and falls back to segmented if the server aborts
+    // it; expedited replies are handled too. Data is handed to sink as it
+    // is confirmed - return false from sink to abort.
+    typedef bool (*UploadSink)(const uint8_t* data, size_t length, void* context);
+    bool upload(uint16_t index, uint8_t subIndex, UploadSink sink, void* context,
+                uint32_t* length = nullptr, bool allowBlock = true);
+    
+    // Same, into a buffer. Fails if the object does not fit.
+    bool upload(uint16_t index, uint8_t subIndex, uint8_t* buffer, size_t capacity, size_t& length,
+                bool allowBlock = true);
+    
+    // Process incoming SDO responses. Called from the CAN task for every
+    // frame on SDO_RX_ID; wakes the task blocked in readParameter() etc.
+    // Returns true if the frame belonged to a segmented/block transfer and
+    // must not be decoded as a parameter reply.
+    bool processResponse(uint32_t id, const uint8_t* data, uint8_t len);
+    
+    // A transfer holds the server; the CAN task stops polling meanwhile
+    bool isTransferActive() { return transferActive; }
     
     // Get last error information
     uint32_t getLastAbortCode() { return lastAbortCode; }
@@ -61,10 +143,47 @@ public:
     uint32_t getTimeoutCount() { return timeoutCount; }
     
 private:
+    // Request/response handshake with the CAN task
+    SemaphoreHandle_t responseSem;   // Given by processResponse()
+    SemaphoreHandle_t transferMutex; // One transfer at a time
+    volatile bool requestPending;
+    volatile uint8_t pendingParam;
+    volatile bool transferActive;
+    
+    // Segmented/block transfers: the CAN task hands over whole frames
+    enum RawMode : uint8_t {
+        RAW_OFF,        // Expedited replies only (readParameter() etc.)
+        RAW_HOLD,       // Transfer running, nothing expected - drop frames
+        RAW_FRAME,      // Next frame to rawFrame
+        RAW_BLOCK       // Collect block segments into blockData
+    };
+    volatile uint8_t rawMode;
+    uint8_t rawFrame[8];
+    uint8_t blockData[SDO_BLOCK_SIZE * 7];
+    volatile uint8_t blockSeq;      // Last segment received in order
+    volatile bool blockLast;        // That segment had the c bit
+    
+    // Batch writes: the CAN task queues every expedited reply, writeBatch()
+    // matches them to its requests by sub-index
+    struct BatchReply {
+        uint8_t cmd;
+        uint8_t paramId;
+        uint32_t data;
+    };
+    enum BatchOp : uint8_t {
+        BATCH_READ_PREVIOUS,
+        BATCH_WRITE,
+        BATCH_VERIFY,
+        BATCH_RESTORE
+    };
+    RingBuffer<BatchReply, 16> batchReplies;
+    volatile bool batchActive;
+    uint32_t lastBatchMs;
+    
     // Response state
-    bool responseReceived;
-    bool responseSuccess;
-    int32_t responseValue;
+    volatile bool responseReceived;
+    volatile bool responseSuccess;
+    volatile int32_t responseValue;
     uint32_t lastAbortCode;
     char lastError[64];
     
@@ -74,7 +193,18 @@ private:
     uint32_t timeoutCount;
     
     // Helper functions
+    bool readParameterLocked(uint8_t paramId, int32_t& value);
+    bool writeParameterLocked(uint8_t paramId, int32_t value);
     bool sendSDORequest(uint8_t cmd, uint8_t paramId, int32_t value = 0);
+    bool sendFrame(const uint8_t* data);
+    bool transact(const uint8_t* request, bool matchIndex);
+    void sendAbort(uint16_t index, uint8_t subIndex, uint32_t code);
+    void recordAbort(uint32_t code);
+    bool uploadSegmented(uint16_t index, uint8_t subIndex, UploadSink sink, void* context, uint32_t& total);
+    bool uploadBlock(uint16_t index, uint8_t subIndex, UploadSink sink, void* context, uint32_t& total,
+                     bool& unsupported);
+    bool runBatch(SDOWrite* writes, uint16_t count, uint8_t op, bool stopOnFailure);
+    bool sendBatchRequest(const SDOWrite& write, uint8_t op);
     bool waitForResponse(uint32_t timeoutMs);
     void clearResponse();
     const char* getAbortCodeDescription(uint32_t abortCode);
@@ -0,0 +1,64 @@
+#ifndef SAFETY_HEARTBEAT_H
+#define SAFETY_HEARTBEAT_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "Seqlock.h"
+#include "Immobilizer.h"
+#include "PmLock.h"
+
+// How well the 0x351 heartbeat keeps its period (readable from any task)
+struct HeartbeatStats {
+    uint32_t sent;              // Frames the driver accepted
+    uint32_t txFailed;          // Frames it refused (queue full, bus off)
+    uint32_t deadlineMisses;    // Gaps over HEARTBEAT_INTERVAL + HEARTBEAT_DEADLINE_SLACK_MS
+    uint32_t worstPeriodUs;     // Longest gap between frames since boot
+
+    // Last completed window of HEARTBEAT_STATS_WINDOW frames
+    uint32_t periodMinUs;
+    uint32_t periodMaxUs;
+    uint32_t periodAvgUs;
+    uint32_t jitterMaxUs;       // Largest |period - HEARTBEAT_INTERVAL|
+    uint16_t windowFaults;      // Misses + TX failures
+
+    bool unlocked;              // What the last frame said
+};
+
+// The 0x351 frame that gates the inverter's current limit. Runs as the
+// highest-priority application task on the CAN core and transmits straight
+// into the driver, using TX slots every other sender leaves free (see
+// CANDataManager::transmit()). It never logs or blocks; it only measures.
+class SafetyHeartbeat {
+public:
+    SafetyHeartbeat();
+
+    void begin(Immobilizer* immob);
+
+    // Heartbeat task, every HEARTBEAT_INTERVAL ms
+    void cycle();
+
+    // 0x351 payload: bytes 4-5 = current limit in 0.1 A, little endian
+    static void fillFrame(uint8_t* data, bool unlocked);
+
+    void getStats(HeartbeatStats& out) const { stats.copy(out); }
+    void printStats() const;
+
+private:
+    Immobilizer* immobilizer;
+    Seqlock<HeartbeatStats> stats;
+    PmLock cpuLock;         // Full clock for the cycle, whatever esp_pm scaled to
+
+    // Heartbeat task only
+    HeartbeatStats current;
+    int64_t lastSendUs;
+    uint32_t windowMin;
+    uint32_t windowMax;
+    uint64_t windowSum;
+    uint32_t windowJitter;
+    uint16_t windowCount;
+    uint16_t windowFaults;
+
+    void recordPeriod(uint32_t periodUs);
+};
+
+#endif // SAFETY_HEARTBEAT_H
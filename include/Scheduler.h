@@ -0,0 +1,78 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "Seqlock.h"
+
+#define MAX_JOBS 8
+
+// One job's timing (readable from any task)
+struct JobStats {
+    const char* name;
+    uint32_t periodMs;          // 0 = one-shot
+    uint8_t priority;
+    bool armed;                 // Has a deadline (one-shots disarm when they ran)
+    uint32_t runs;
+    uint32_t skipped;           // Whole periods lost to a late start
+    uint32_t lastRunUs;
+    uint32_t maxRunUs;
+    uint64_t totalRunUs;
+    uint32_t lastLateUs;        // Start time past the deadline
+    uint32_t maxLateUs;
+    uint64_t totalLateUs;
+};
+
+// Cooperative deadline scheduler for one task. Modules register periodic or
+// one-shot jobs; runDue() runs every job whose deadline has passed, the
+// highest priority first (earliest deadline among equals), and the task
+// then sleeps until getNextDueUs(). Jobs never preempt each other, so a
+// job must return quickly - a long one makes every job behind it late,
+// which is what the lateness figures show.
+//
+// Jobs are added, armed and cancelled only from the owning task (or before
+// it starts). Stats may be read from anywhere.
+class Scheduler {
+public:
+    typedef void (*JobFn)(void* context);
+
+    Scheduler();
+
+    // Periodic when periodMs > 0, first run after periodMs (or firstMs if
+    // given). A one-shot (periodMs = 0) waits for runIn(). Returns the job
+    // id, or -1 if the table is full.
+    int8_t addJob(const char* name, JobFn fn, void* context,
+                  uint32_t periodMs, uint8_t priority, int32_t firstMs = -1);
+
+    // (Re)arm: next run in delayMs, a periodic job continues from there
+    void runIn(int8_t id, uint32_t delayMs);
+    void cancel(int8_t id);
+
+    // Run what is due; returns the number of jobs run
+    uint8_t runDue();
+
+    // esp_timer time of the earliest deadline, INT64_MAX if nothing is armed
+    int64_t getNextDueUs() const;
+
+    uint8_t getJobCount() const { return jobCount; }
+    void getStats(uint8_t id, JobStats& out) const;
+    void printStats() const;
+
+private:
+    struct Job {
+        JobFn fn;
+        void* context;
+        int64_t dueUs;
+        Seqlock<JobStats> stats;
+        JobStats current;       // Owning task only
+    };
+
+    Job jobs[MAX_JOBS];
+    uint8_t jobCount;
+
+    int8_t nextDue(int64_t now) const;
+    void run(Job& job, int64_t now);
+    void publish(Job& job);
+};
+
+#endif // SCHEDULER_H
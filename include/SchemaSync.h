@@ -0,0 +1,87 @@
+#ifndef SCHEMA_SYNC_H
+#define SCHEMA_SYNC_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "CANData.h"
+
+// Outcome of the last check (for /schema)
+struct SchemaStatus {
+    uint32_t serial;            // Inverter serial number (first word)
+    uint32_t firmware;          // Raw "version" value
+    uint32_t size;              // JSON bytes downloaded, 0 if not fetched
+    uint32_t downloadMs;
+    uint16_t added;             // Against the table that was loaded
+    uint16_t removed;
+    uint16_t changed;
+    uint16_t unchanged;
+    uint32_t lastCheck;         // millis(), 0 = never
+    const char* result;
+};
+
+// Keeps /params.json in step with the inverter it is talking to. The
+// parameter list JSON is pulled over SDO (block transfer) only when the
+// inverter's serial number or firmware version differs from the one the
+// cached file came from; a download identical to the cached file changes
+// nothing, otherwise it is diffed per parameter and the CAN task reloads
+// the table, keeping the values of parameters that did not change.
+//
+// Blocks on SDO - run it from the web task only.
+class SchemaSync {
+public:
+    SchemaSync();
+
+    void begin(CANDataManager* can);
+
+    // Web task: first check once the inverter has been on the bus a while
+    void update();
+
+    // Check now; force downloads even if the firmware matches.
+    // True if /params.json matches the inverter afterwards.
+    bool sync(bool force = false);
+
+    // /params.json came from the inverter it is connected to
+    bool isSynced() { return synced; }
+
+    const SchemaStatus& getStatus() { return status; }
+
+private:
+    // Stored in SCHEMA_KEY_PATH next to the JSON it describes
+    struct SchemaKey {
+        uint32_t magic;
+        uint32_t serial;
+        uint32_t firmware;
+        uint32_t jsonCrc;
+        uint32_t jsonSize;
+    };
+
+    struct DownloadState {
+        File* file;
+        uint32_t crc;
+        uint32_t size;
+    };
+
+    struct DiffState {
+        CANDataManager* manager;
+        uint16_t added;
+        uint16_t changed;
+        uint16_t unchanged;
+    };
+
+    CANDataManager* canManager;
+    SchemaStatus status;
+    bool checked;
+    bool synced;
+    uint32_t connectedSince;
+
+    bool readFingerprint(uint32_t& serial, uint32_t& firmware);
+    bool loadKey(SchemaKey& key);
+    bool saveKey(uint32_t serial, uint32_t firmware, uint32_t crc, uint32_t size);
+    bool download(const char* path, uint32_t& crc, uint32_t& size);
+    bool diff(const char* path);
+
+    static bool writeChunk(const uint8_t* data, size_t length, void* context);
+    static void diffParam(const ParamRecord& record, void* context);
+};
+
+#endif // SCHEMA_SYNC_H
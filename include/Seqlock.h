@@ -0,0 +1,80 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <atomic>
+
+// ============================================
+// Double-buffered seqlock
+// ============================================
+//
+// One writer task publishes a complete copy of T; any number of readers on
+// either core take consistent views without locks and without ever blocking
+// the writer.
+//
+// The writer always fills the buffer readers are NOT pointed at, bumps that
+// buffer's sequence to odd while writing and back to even when done, then
+// flips `active`. A reader picks the active buffer, copies what it needs and
+// checks the sequence did not move. With two buffers the writer has to
+// publish twice during a single read before a reader retries, which at the
+// CAN task's publish rate means readers effectively never loop.
+//
+// T must be trivially copyable (plain data, no pointers into itself).
+template <typename T>
+class Seqlock {
+public:
+    Seqlock() : active(0) {
+        seq[0].store(0, std::memory_order_relaxed);
+        seq[1].store(0, std::memory_order_relaxed);
+    }
+
+    // Writer: get the back buffer, fill it completely, then endWrite()
+    T& beginWrite() {
+        back = active.load(std::memory_order_relaxed) ^ 1;
+        seq[back].store(seq[back].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return buffers[back];
+    }
+
+    void endWrite() {
+        std::atomic_thread_fence(std::memory_order_release);
+        seq[back].store(seq[back].load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        active.store(back, std::memory_order_release);
+    }
+
+    // Writer only: the most recently published copy (no race with itself)
+    const T& published() const {
+        return buffers[active.load(std::memory_order_relaxed)];
+    }
+
+    // Reader: run fn on a consistent buffer and return its result.
+    // fn must only copy data out - it may run more than once.
+    template <typename F>
+    auto read(F fn) const -> decltype(fn(*(const T*)nullptr)) {
+        while (true) {
+            uint32_t index = active.load(std::memory_order_acquire);
+            uint32_t before = seq[index].load(std::memory_order_acquire);
+            if (before & 1) continue;  // Lapped by the writer - re-pick buffer
+
+            auto result = fn(buffers[index]);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq[index].load(std::memory_order_relaxed) == before) {
+                return result;
+            }
+        }
+    }
+
+    // Reader: copy the whole snapshot
+    void copy(T& out) const {
+        read([&out](const T& data) { out = data; return true; });
+    }
+
+private:
+    T buffers[2];
+    std::atomic<uint32_t> seq[2];
+    std::atomic<uint32_t> active;
+    uint32_t back;  // Writer only
+};
+
+#endif // SEQLOCK_H
@@ -0,0 +1,69 @@
+#ifndef TASK_MANAGER_H
+#define TASK_MANAGER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "Scheduler.h"
+
+#define MAX_TASKS 4
+
+// Per-task runtime statistics (refreshed every TASK_STATS_INTERVAL_MS)
+struct TaskStats {
+    const char* name;
+    uint8_t core;
+    uint8_t priority;
+    uint32_t periodMs;        // 0 = runs a Scheduler, sleeps until its next deadline
+    uint32_t cycles;          // Total cycles run
+    uint32_t lastCycleUs;     // Duration of the most recent cycle
+    uint32_t maxCycleUs;      // Longest cycle in the last window
+    uint8_t cpuPercent;       // Busy time / wall time over the last window
+    uint32_t stackFree;       // Stack high water mark (bytes)
+};
+
+// Runs each registered cycle function in its own FreeRTOS task, pinned to a
+// core and repeated every periodMs. Keeps the time-critical CAN work on one
+// core so a slow HTTP handler or LVGL redraw on the other cannot stall it.
+class TaskManager {
+public:
+    TaskManager();
+
+    // Register before begin(). Returns false if the table is full.
+    bool addTask(const char* name, void (*cycle)(), uint8_t core,
+                 uint8_t priority, uint32_t stackSize, uint32_t periodMs);
+
+    // A task that runs the scheduler's due jobs and sleeps until the next
+    // deadline. Add the jobs before begin().
+    bool addTask(const char* name, Scheduler* scheduler, uint8_t core,
+                 uint8_t priority, uint32_t stackSize);
+
+    // Create all registered tasks
+    bool begin();
+
+    // Statistics
+    uint8_t getTaskCount() { return taskCount; }
+    const TaskStats& getStats(uint8_t index);
+    Scheduler* getScheduler(uint8_t index);  // nullptr for a fixed-period task
+    void printStats();
+
+private:
+    struct TaskSlot {
+        TaskHandle_t handle;
+        void (*cycle)();
+        Scheduler* scheduler;
+        uint32_t stackSize;
+        TaskStats stats;
+
+        // Current measurement window
+        uint64_t windowStartUs;
+        uint64_t busyUs;
+        uint32_t windowMaxUs;
+    };
+
+    TaskSlot tasks[MAX_TASKS];
+    uint8_t taskCount;
+
+    static void taskEntry(void* arg);
+    static void sleepUntilDue(TaskSlot* slot);
+};
+
+#endif // TASK_MANAGER_H
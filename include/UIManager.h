@@ -6,9 +6,15 @@
 #include <lvgl.h>
 #include "CANData.h"
 #include "Config.h"
+#include "FastFormat.h"
+#include "SafetyHeartbeat.h"
+#include "Scheduler.h"
 
 // Forward declarations
 class Immobilizer;
+class InputManager;
+class WiFiManager;
+struct InputEvent;
 
 // Screen IDs
 enum ScreenID {
@@ -27,6 +33,15 @@ enum ScreenID {
     SCREEN_COUNT
 };
 
+// Input to pixels: from the encoder ISR to the end of the next LVGL flush
+struct InputLatency {
+    uint32_t samples;
+    uint32_t lastUs;
+    uint32_t maxUs;
+    uint64_t totalUs;
+    uint32_t unrendered;    // Input that changed nothing on screen
+};
+
 class UIManager {
 public:
     UIManager();
@@ -41,19 +56,56 @@ public:
     
     // Immobilizer integration
     void setImmobilizer(Immobilizer* immob) { immobilizer = immob; }
+    void setHeartbeat(SafetyHeartbeat* beat) { heartbeat = beat; }
     void updateLockScreen();  // Update lock screen PIN display
     
+    // Input: update() drains the manager's event queue into the LVGL
+    // encoder and pointer devices, and LVGL routes them to the widgets
+    void setInput(InputManager* in) { input = in; }
+    
+    // Screen refreshes run as jobs on the UI task's scheduler, next to
+    // update(): values every UI_REFRESH_MS, the settings screen slower
+    void schedule(Scheduler* sched);
+    
+    // Display off: update() stops rendering and drops input. Resuming
+    // redraws the screen; the input that woke it is not acted on.
+    void setPaused(bool pause);
+    bool isPaused() { return paused; }
+    
+    // WiFi AP mode (click on a screen without settings to edit)
+    void setWiFiManager(WiFiManager* wifi) { wifiManager = wifi; }
+    void setWiFiMode(bool enable);
+    bool isWiFiMode() { return wifiMode; }
+    
     // Edit mode control (for Gear, Motor, Regen screens)
     void toggleEditMode();
     bool isEditMode() { return editMode; }
     bool isEditableScreen();  // Check if current screen supports editing
     
+    // Input latency: call with the input's ISR time after its callback ran
+    void markInput(uint32_t inputUs);
+    const InputLatency& getInputLatency() { return inputLatency; }
+    
 private:
     // LVGL Setup
     static void lvgl_flush_cb(lv_disp_drv_t* disp, const lv_area_t* area, lv_color_t* color_p);
     static void lvgl_encoder_read_cb(lv_indev_drv_t* indev_drv, lv_indev_data_t* data);
+    static void lvgl_pointer_read_cb(lv_indev_drv_t* indev_drv, lv_indev_data_t* data);
     void setupLVGL();
     
+    // Input routing
+    void createInputGroups();
+    void readInput();
+    void discardInput();
+    void handleGesture(const InputEvent& event);
+    void dialKey(uint32_t key);
+    void selectOption(uint16_t paramId, int32_t option);
+    void finishEdit();
+    bool isLocked();
+    static void onDialEvent(lv_event_t* e);
+    static void onOptionEvent(lv_event_t* e);
+    static void onRegenEvent(lv_event_t* e);
+    
     // Screen creation functions
     void createSplashScreen();
     void createLockScreen();  // Immobilizer lock screen
@@ -77,9 +129,15 @@ private:
     void updateGear();
     void updateMotor();
     void updateRegen();
+    void updateSettings();
+    void updateLimitStatus();
+    void refreshScreen();
+    static void refreshJobFn(void* context);
+    static void settingsJobFn(void* context);
     
     // Helper functions
     void clearAllScreens();
+    void printScreenCost(ScreenID screen);
     lv_color_t getColorForValue(int32_t value, int32_t min_val, int32_t max_val);
     void setMeterValue(lv_obj_t* meter, lv_meter_indicator_t* indic, int32_t value, int32_t min_val, int32_t max_val);
     
@@ -88,7 +146,25 @@ private:
     lv_color_t *buf1;
     lv_color_t *buf2;
     lv_disp_drv_t disp_drv;
-    lv_indev_drv_t indev_drv;
+    lv_indev_drv_t indev_drv;       // Encoder: dial and button
+    lv_indev_drv_t pointer_drv;     // Touch
+    lv_indev_t* encoderIndev;
+    
+    // One group per screen. Its only member is an invisible dial object
+    // that takes the rotation and click as LV_KEY_LEFT/RIGHT/ENTER.
+    // Editable screens have a second group with the value widgets, which
+    // the encoder uses while in edit mode.
+    lv_group_t* groups[SCREEN_COUNT];
+    lv_group_t* editGroups[SCREEN_COUNT];
+    lv_obj_t* dials[SCREEN_COUNT];
+    
+    // Indev state between readInput() and the read callbacks
+    int32_t encoderDiff;
+    uint8_t encoderClicks;
+    bool encoderPressed;
+    bool touchDown;
+    bool touchUp;                   // Released, after the press was reported
+    uint16_t touchX, touchY;
     
     // Screens
     lv_obj_t* screens[SCREEN_COUNT];
@@ -102,6 +178,8 @@ private:
     lv_obj_t* dash_power_label;
     lv_obj_t* dash_soc_arc;
     lv_meter_indicator_t* dash_soc_indicator;
+    LabelText dash_voltage_text;
+    LabelText dash_power_text;
     
     // Power screen widgets
     lv_obj_t* power_meter;
@@ -111,6 +189,10 @@ private:
     lv_obj_t* power_voltage_label;
     lv_obj_t* power_current_label;
     lv_obj_t* power_soc_label;
+    LabelText power_text;
+    LabelText power_voltage_text;
+    LabelText power_current_text;
+    LabelText power_soc_text;
     
     // Temperature screen widgets
     lv_obj_t* temp_motor_arc;
@@ -120,6 +202,9 @@ private:
     lv_meter_indicator_t* temp_inverter_indicator;
     lv_obj_t* temp_inverter_label;
     lv_obj_t* temp_battery_label;
+    LabelText temp_motor_text;
+    LabelText temp_inverter_text;
+    LabelText temp_battery_text;
     
     // Battery screen widgets
     lv_obj_t* battery_soc_meter;
@@ -129,6 +214,10 @@ private:
     lv_obj_t* battery_voltage_label;
     lv_obj_t* battery_current_label;
     lv_obj_t* battery_temp_label;
+    LabelText battery_soc_text;
+    LabelText battery_voltage_text;
+    LabelText battery_current_text;
+    LabelText battery_temp_text;
     
     // BMS screen widgets
     lv_obj_t* bms_cell_max_label;
@@ -154,12 +243,17 @@ private:
     lv_obj_t* lock_digit_label;
     lv_obj_t* lock_instruction_label;
     lv_obj_t* lock_icon;
+    LabelText lock_digit_text;
     
     // Regen screen widgets
     lv_obj_t* regen_arc;
     lv_meter_indicator_t* regen_indicator;
     lv_obj_t* regen_value_label;
     lv_obj_t* regen_title_label;
+    lv_obj_t* regen_down_zone;      // Left half: tap for -5% (stronger)
+    lv_obj_t* regen_up_zone;        // Right half: tap for +5% (lighter)
+    LabelText regen_value_text;
+    bool regenPending;              // Arc moved, send it after this LVGL pass
     
     // WiFi screen widgets
     lv_obj_t* wifi_ssid_label;
@@ -171,13 +265,31 @@ private:
     lv_obj_t* settings_can_status_label;
     lv_obj_t* settings_param_count_label;
     lv_obj_t* settings_version_label;
+    lv_obj_t* settings_heartbeat_label;
+    LabelText settings_heartbeat_text;
+    lv_obj_t* settings_limit_label;
+    LabelText settings_limit_text;
     
     // Data
     CANDataManager* canManager;
     Immobilizer* immobilizer;  // Security system
+    SafetyHeartbeat* heartbeat;
+    InputManager* input;
+    WiFiManager* wifiManager;
     ScreenID currentScreen;
-    uint32_t lastUpdateTime;
+    Scheduler* scheduler;
+    int8_t refreshJob;
+    uint32_t lastDataTime;      // Newest update among the screen's params at the last redraw
+    uint32_t refreshCount[SCREEN_COUNT];
+    uint32_t refreshSkipped[SCREEN_COUNT];  // Nothing on screen had changed
     bool editMode;  // For programmable screens (Gear, Motor, Regen)
+    bool wifiMode;
+    bool paused;
+    
+    // Oldest input not yet on screen (esp_timer us)
+    uint32_t inputUs;
+    bool inputPending;
+    InputLatency inputLatency;
     
     // Static instance for callbacks
     static UIManager* instance;
@@ -0,0 +1,91 @@
+#ifndef VALUE_CODEC_H
+#define VALUE_CODEC_H
+
+#include <Arduino.h>
+
+// ============================================
+// Parameter value codecs
+// ============================================
+//
+// Every value shown on the dial or the web UI is an integer "scaled value":
+// the display value times 10^decimals (Decimals = 1 -> 12.5 kW is 125).
+// A codec converts between what travels on the bus (raw) and that scaled
+// value using integer maths only, rounding half away from zero.
+
+// 10^N at compile time
+template <uint8_t N>
+struct Pow10 {
+    static const int32_t value = 10 * Pow10<N - 1>::value;
+};
+template <>
+struct Pow10<0> {
+    static const int32_t value = 1;
+};
+
+// n / d rounded half away from zero, d > 0. No branches: the sign of n picks
+// whether half of d is added or subtracted before the truncating divide.
+inline int32_t divRound(int64_t n, int64_t d) {
+    return (int32_t)((n + ((n >> 63) | 1) * (d >> 1)) / d);
+}
+
+// OpenInverter fixed point: raw = value * 2^FracBits (SDO values use 5, i.e. x32)
+template <uint8_t FracBits, uint8_t Decimals>
+struct FixedPoint {
+    static const uint8_t decimals = Decimals;
+
+    static int32_t decode(int32_t raw) {
+        return divRound((int64_t)raw * Pow10<Decimals>::value, (int64_t)1 << FracBits);
+    }
+    static int32_t encode(int32_t scaled) {
+        return divRound((int64_t)scaled << FracBits, Pow10<Decimals>::value);
+    }
+};
+
+// Decimal unit change: value = raw / Divisor (mV -> V is Divisor 1000)
+template <int32_t Divisor, uint8_t Decimals>
+struct DecimalScale {
+    static_assert(Divisor > 0, "Divisor must be positive");
+    static const uint8_t decimals = Decimals;
+
+    static int32_t decode(int32_t raw) {
+        return divRound((int64_t)raw * Pow10<Decimals>::value, Divisor);
+    }
+    static int32_t encode(int32_t scaled) {
+        return divRound((int64_t)scaled * Divisor, Pow10<Decimals>::value);
+    }
+};
+
+// Linear sensor: value = raw * Num / Den + Offset
+template <int32_t Num, int32_t Den, int32_t Offset, uint8_t Decimals>
+struct GainOffset {
+    static_assert(Num > 0 && Den > 0, "Gain must be positive");
+    static const uint8_t decimals = Decimals;
+
+    static int32_t decode(int32_t raw) {
+        return divRound((int64_t)raw * Num * Pow10<Decimals>::value, Den) +
+               Offset * Pow10<Decimals>::value;
+    }
+    static int32_t encode(int32_t scaled) {
+        return divRound(((int64_t)scaled - (int64_t)Offset * Pow10<Decimals>::value) * Den,
+                        (int64_t)Num * Pow10<Decimals>::value);
+    }
+};
+
+// Codecs in use
+typedef FixedPoint<5, 2> OpenInverterCodec;     // SDO parameter values (x32), 0.01 resolution
+typedef FixedPoint<5, 0> OpenInverterRawCodec;  // Same, whole units (web /set)
+typedef FixedPoint<5, 1> OpenInverterDeciCodec; // Same, 0.1 resolution (inverter power -> 0.1 kW)
+typedef DecimalScale<1000, 0> MilliCodec;       // IVT-S mV -> V, mA -> A
+typedef DecimalScale<1000, 1> WattToKwCodec;    // IVT-S W -> 0.1 kW
+typedef DecimalScale<10, 0> DeciCodec;          // 0.1 degC -> degC
+typedef DecimalScale<3600, 0> AsToAhCodec;      // IVT-S charge
+
+// Write scaled/10^decimals as text, e.g. (-5, 1, "kW") -> "-0.5kW".
+// Always terminates; returns the length written.
+size_t formatScaled(char* buffer, size_t size, int32_t scaled, uint8_t decimals, const char* unit = "");
+
+// Parse "12", "-0.5", "3.14159" into a scaled value, rounding extra digits.
+// Returns false on anything that is not a plain decimal number.
+bool parseScaled(const char* text, uint8_t decimals, int32_t& scaled);
+
+#endif // VALUE_CODEC_H
@@ -0,0 +1,81 @@
+#ifndef WS1850S_H
+#define WS1850S_H
+
+#include <Arduino.h>
+#include <freertos/semphr.h>
+
+// WS1850S registers (MFRC522 compatible; over I2C the address is sent as is)
+#define WS_REG_COMMAND      0x01
+#define WS_REG_COM_IEN      0x02
+#define WS_REG_DIV_IEN      0x03
+#define WS_REG_COM_IRQ      0x04
+#define WS_REG_ERROR        0x06
+#define WS_REG_FIFO_DATA    0x09
+#define WS_REG_FIFO_LEVEL   0x0A
+#define WS_REG_BIT_FRAMING  0x0D
+#define WS_REG_MODE         0x11
+#define WS_REG_TX_MODE      0x12
+#define WS_REG_RX_MODE      0x13
+#define WS_REG_TX_CONTROL   0x14
+#define WS_REG_TX_ASK       0x15
+#define WS_REG_MOD_WIDTH    0x24
+#define WS_REG_T_MODE       0x2A
+#define WS_REG_T_PRESCALER  0x2B
+#define WS_REG_T_RELOAD_H   0x2C
+#define WS_REG_T_RELOAD_L   0x2D
+#define WS_REG_VERSION      0x37
+
+#define WS_CMD_IDLE         0x00
+#define WS_CMD_TRANSCEIVE   0x0C
+#define WS_CMD_SOFT_RESET   0x0F
+
+#define WS_IRQ_RX           0x20    // ComIrqReg/ComIEnReg: frame received
+#define WS_ERR_MASK         0x13    // ErrorReg: buffer overflow, parity, protocol
+
+// ISO 14443A
+#define PICC_CMD_REQA       0x26
+#define PICC_CMD_SEL_CL1    0x93
+
+// WS1850S 13.56 MHz reader on M5.In_I2C, shared with touch through I2CBus.
+// The caller polls for cards with probe(): field on, REQA, field off unless
+// a card answered. With an IRQ pin the reader pulls it low when a card
+// answers, which wakes the caller blocked in probe(); without one the
+// caller sleeps out the response window and reads ComIrqReg once. Either
+// way the bus is only held for the register accesses, not the waits.
+class WS1850S {
+public:
+    WS1850S();
+
+    // Reset and configure the reader. False if nothing answers at address.
+    bool begin(uint8_t address, int8_t irqPin);
+    uint8_t getVersion() { return version; }
+
+    // Field on, REQA, wait up to responseMs for an answer. answeredUs is the
+    // esp_timer time the answer was seen (the IRQ edge when there is one).
+    // The field stays on if a card answered, for readUid().
+    bool probe(uint16_t settleMs, uint16_t responseMs, int64_t& answeredUs);
+
+    // Cascade level 1 anticollision: the first 4 UID bytes (checked by BCC)
+    bool readUid(uint8_t* uid, uint16_t responseMs);
+
+    void fieldOff();
+
+private:
+    uint8_t address;
+    int8_t irqPin;
+    uint8_t version;
+    SemaphoreHandle_t irqSemaphore;
+    volatile int64_t irqUs;
+
+    // Register access - the caller holds I2CBus
+    bool writeReg(uint8_t reg, uint8_t value);
+    bool writeReg(uint8_t reg, const uint8_t* data, size_t length);
+    uint8_t readReg(uint8_t reg);
+
+    bool startTransceive(const uint8_t* data, uint8_t length, uint8_t txLastBits);
+    uint8_t finishTransceive(uint16_t responseMs, uint8_t* back, uint8_t backSize, int64_t& answeredUs);
+
+    static void IRAM_ATTR onIrq(void* arg);
+};
+
+#endif // WS1850S_H
@@ -6,6 +6,11 @@
 #include <ESPmDNS.h>
 #include <ArduinoJson.h>
 #include "CANData.h"
+#include "TaskManager.h"
+#include "SchemaSync.h"
+#include "SafetyHeartbeat.h"
+#include "PowerManager.h"
+#include "Immobilizer.h"
 
 /**
  * WebInterface - OpenInverter-compatible web API for M5Dial
@@ -39,9 +44,19 @@ public:
     // Configuration
     void setHostname(const char* hostname = "zombieverter");
     void enableCORS(bool enable = true);
+    void setTaskManager(TaskManager* tasks) { taskManager = tasks; }
+    void setSchemaSync(SchemaSync* sync) { schemaSync = sync; }
+    void setHeartbeat(SafetyHeartbeat* beat) { heartbeat = beat; }
+    void setPowerManager(PowerManager* pm) { power = pm; }
+    void setImmobilizer(Immobilizer* immob) { immobilizer = immob; }
     
 private:
     CANDataManager* canManager;
+    TaskManager* taskManager;
+    SchemaSync* schemaSync;
+    SafetyHeartbeat* heartbeat;
+    PowerManager* power;
+    Immobilizer* immobilizer;
     WebServer server;
     bool apMode;
     bool corsEnabled;
@@ -54,9 +69,14 @@ private:
         uint32_t timestamp;
         bool isRx;
     };
-    static const int CAN_LOG_SIZE = 100;
-    CANLogMessage canLogBuffer[CAN_LOG_SIZE];
-    int canLogIndex;
+    // Filled from the CAN RX callback and /can/send, drained by /can/log.
+    // Only filled while a browser is polling so it never holds stale frames.
+    static const int CAN_LOG_SIZE = 128;
+    static const uint32_t CAN_LOG_IDLE_MS = 2000;
+    static const uint32_t SPOT_INTEREST_TTL_MS = 5000;  // /spot values stay fast this long
+    static const uint16_t SET_BATCH_MAX = 128;          // Parameters per /set/batch
+    MpscRingBuffer<CANLogMessage, CAN_LOG_SIZE> canLog;
+    volatile uint32_t canLogLastPoll;
     bool canLoggingEnabled;
     
     // HTTP Handlers
@@ -65,11 +85,18 @@ private:
     void handleCmd();  // jamiejones85 compatibility
     void handleGet();
     void handleSet();
+    void handleSetBatch();
     void handleSave();
     void handleLoad();
     void handleSpot();
     void handleCanSend();
     void handleCanLog();
+    void handleCanStats();
+    void handleTasks();
+    void handlePower();
+    void handleSchedule();
+    void handleSchema();
+    void handleSchemaSync();
     void handleParamsUpload();
     void handleNotFound();
     void handleCORS();
@@ -77,13 +104,18 @@ private:
     // Helper Functions
     String buildJSONResponse(bool includeHidden = false);
     String queryAllParametersFromZombieVerter();
-    bool setParameterValue(int paramId, int32_t value);
+    bool setParameterValue(int paramId, const String& valueText);
+    bool encodeParamValue(int paramId, const String& valueText, int32_t& encodedValue);
     int32_t getParameterValue(int paramId);
     void logCanMessage(uint32_t id, uint8_t* data, uint8_t len, bool isRx);
-    bool usesRawValue(const char* paramName);  // Check if parameter needs fixed-point encoding
+    int resolveParamArg(const String& arg);    // Numeric id or parameter name, -1 if unknown
     
     // CORS headers
     void addCORSHeaders();
+    
+    // CAN RX hook (CANDataManager takes a plain function pointer)
+    static void canMessageCallback(const CANMessage& msg);
+    static WebInterface* instance;
 };
 
 #endif // WEB_INTERFACE_H
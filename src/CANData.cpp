@@ -1,57 +1,68 @@
 #include "CANData.h"
 #include "Config.h"
 #include "driver/twai.h"
+#include "ValueCodec.h"
+#include "ParamTable.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <SPIFFS.h>
+#include <esp_rom_crc.h>
 
-void CANParameter::toString(char* buffer, size_t bufferSize) {
+// Narrow a raw value to the parameter's wire type, so the int32 stored in
+// the hot array reads back exactly as the typed union used to.
+static int32_t narrowValue(uint8_t dataType, int32_t val) {
     switch (dataType) {
-        case PARAM_INT8:
-        case PARAM_INT16:
-        case PARAM_INT32:
-            snprintf(buffer, bufferSize, "%d %s", (int)getValueAsInt(), unit);
-            break;
-        case PARAM_UINT8:
-        case PARAM_UINT16:
-        case PARAM_UINT32:
-            snprintf(buffer, bufferSize, "%u %s", (unsigned)getValueAsInt(), unit);
-            break;
-        case PARAM_FLOAT:
-            dtostrf(value.f32, 0, decimalPlaces, buffer);
-            strcat(buffer, " ");
-            strcat(buffer, unit);
-            break;
+        case PARAM_INT8:   return (int8_t)val;
+        case PARAM_UINT8:  return (uint8_t)val;
+        case PARAM_INT16:  return (int16_t)val;
+        case PARAM_UINT16: return (uint16_t)val;
+        case PARAM_UINT32: return (int32_t)(uint32_t)val;
+        default:           return val;
     }
 }
 
-void CANParameter::setValue(int32_t val) {
-    switch (dataType) {
-        case PARAM_INT8:   value.i8 = (int8_t)val; break;
-        case PARAM_UINT8:  value.u8 = (uint8_t)val; break;
-        case PARAM_INT16:  value.i16 = (int16_t)val; break;
-        case PARAM_UINT16: value.u16 = (uint16_t)val; break;
-        case PARAM_INT32:  value.i32 = val; break;
-        case PARAM_UINT32: value.u32 = (uint32_t)val; break;
-        case PARAM_FLOAT:  value.f32 = (float)val; break;
-    }
-    lastUpdateTime = millis();
-    dirty = false;
+// Param 2 (power) is kept in 0.1 kW whichever frame it came from: the IVT-S
+// decoder produces that directly, the inverter sends x32 kW (SDO and TPDO1).
+#define POWER_PARAM_ID 2
+
+// How the inverter sends a parameter over SDO: as the built-in table has it
+// when the loaded entry is that parameter (same id and name, as the web UI
+// matches them), otherwise x32 like any OpenInverter value.
+static ParamEncoding sdoEncoding(uint16_t paramId, const char* name) {
+    const ParamInfo* info = findParamInfo(paramId);
+    bool known = info && strcmp(info->name, name) == 0;
+    return known ? info->encoding : PARAM_ENC_FIXED32;
 }
 
-int32_t CANParameter::getValueAsInt() {
-    switch (dataType) {
-        case PARAM_INT8:   return value.i8;
-        case PARAM_UINT8:  return value.u8;
-        case PARAM_INT16:  return value.i16;
-        case PARAM_UINT16: return value.u16;
-        case PARAM_INT32:  return value.i32;
-        case PARAM_UINT32: return value.u32;
-        case PARAM_FLOAT:  return (int32_t)value.f32;
-        default: return 0;
+// x32 values are stored in the units the screens show: whole units, power
+// in 0.1 kW
+static int32_t fromFixed32(uint16_t paramId, int32_t raw) {
+    return paramId == POWER_PARAM_ID ? OpenInverterDeciCodec::decode(raw)
+                                     : OpenInverterRawCodec::decode(raw);
+}
+
+// Metadata and strings go to PSRAM when there is any
+static void* allocColdStore(size_t size, bool& inPsram) {
+    void* ptr = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    inPsram = ptr != nullptr;
+    if (!ptr) {
+        ptr = heap_caps_malloc(size, MALLOC_CAP_8BIT);
     }
+    return ptr;
 }
 
 CANDataManager::CANDataManager() 
-    : parameterCount(0), txHead(0), txTail(0), rxHead(0), rxTail(0),
-      connected(false), lastMessageTime(0), bmsCellCount(0) {
+    : parameterCount(0), paramMeta(nullptr), stringPool(nullptr), stringPoolSize(0), metaInPsram(false),
+      reloadRequested(false), reloadOk(false), tableMutex(nullptr),
+      fastCount(0), decodeMask(0), screenTag(0), interestAccounted(0),
+      txPending(false), pendingTxSince(0), connected(false), lastMessageTime(0), onMessageReceived(nullptr), frameListenerCount(0), bmsCellCount(0) {
+    memset(&stats, 0, sizeof(stats));
+    memset(interestStats, 0, sizeof(interestStats));
+    for (uint8_t slot = 0; slot < INTEREST_SLOTS; slot++) {
+        interestApplied[slot] = 0;  // Generations start at 1
+        interestActive[slot] = false;
+    }
+    
     // Initialize BMS cell arrays
     for (uint8_t i = 0; i < MAX_BMS_CELLS; i++) {
         bmsCellVoltages[i] = 0;
@@ -60,6 +71,8 @@ CANDataManager::CANDataManager()
 }
 
 bool CANDataManager::init() {
+    tableMutex = xSemaphoreCreateMutex();
+    
     // Configure TWAI (CAN) timing for 500kbps
     twai_timing_config_t t_config = TWAI_TIMING_CONFIG_500KBITS();
     
@@ -72,11 +85,20 @@ bool CANDataManager::init() {
         (gpio_num_t)CAN_RX_PIN, 
         TWAI_MODE_NORMAL
     );
-    g_config.rx_queue_len = 10;
-    g_config.tx_queue_len = 10;
+    g_config.rx_queue_len = CAN_DRIVER_RX_QUEUE_LEN;
+    g_config.tx_queue_len = CAN_DRIVER_TX_QUEUE_LEN;
+    
+    // Keep the RX ISR running while flash is busy (SPIFFS writes, OTA)
+    g_config.intr_flags = ESP_INTR_FLAG_LEVEL1 | ESP_INTR_FLAG_IRAM;
     
     // Install TWAI driver
-    if (twai_driver_install(&g_config, &t_config, &f_config) != ESP_OK) {
+    esp_err_t err = twai_driver_install(&g_config, &t_config, &f_config);
+    if (err == ESP_ERR_INVALID_ARG) {
+        // Driver built without CONFIG_TWAI_ISR_IN_IRAM - use a flash ISR
+        g_config.intr_flags = ESP_INTR_FLAG_LEVEL1;
+        err = twai_driver_install(&g_config, &t_config, &f_config);
+    }
+    if (err != ESP_OK) {
         #if DEBUG_CAN
         Serial.println("TWAI driver install failed");
         #endif
@@ -95,63 +117,121 @@ bool CANDataManager::init() {
     Serial.println("TWAI (CAN) initialized");
     #endif
     
+    // Blocking SDO client for the web task; responses arrive via update()
+    sdo.init();
+    
     return true;
 }
 
 void CANDataManager::update() {
-    // Receive messages
-    twai_message_t rx_message;
-    while (twai_receive(&rx_message, 0) == ESP_OK) {
-        #if DEBUG_CAN
-        Serial.print("CAN RX: ID=0x");
-        Serial.print(rx_message.identifier, HEX);
-        Serial.print(" Len=");
-        Serial.print(rx_message.data_length_code);
-        Serial.print(" Data=[");
-        for (int i = 0; i < rx_message.data_length_code; i++) {
-            if (i > 0) Serial.print(" ");
-            if (rx_message.data[i] < 0x10) Serial.print("0");
-            Serial.print(rx_message.data[i], HEX);
+    // Note how deep the driver queue got since the last drain
+    twai_status_info_t status;
+    if (twai_get_status_info(&status) == ESP_OK) {
+        if (status.msgs_to_rx > stats.driverRxPeak) {
+            stats.driverRxPeak = status.msgs_to_rx;
         }
-        Serial.println("]");
-        #endif
-        
-        CANMessage msg;
-        msg.id = rx_message.identifier;
-        msg.length = rx_message.data_length_code;
-        msg.timestamp = millis();
-        
-        for (int i = 0; i < rx_message.data_length_code && i < 8; i++) {
-            msg.data[i] = rx_message.data[i];
+        stats.driverRxMissed = status.rx_missed_count;
+        stats.driverRxOverrun = status.rx_overrun_count;
+    }
+    
+    // Table swap asked for by another task (schema sync). Never waits for
+    // the table: its holder may be blocked on an SDO reply only we deliver.
+    if (reloadRequested && lockTable(0)) {
+        reloadOk = loadParametersCached(PARAM_JSON_PATH, PARAM_CACHE_PATH);
+        unlockTable();
+        reloadRequested = false;
+    }
+    
+    uint32_t now = millis();
+    applyInterest(now);
+    InterestStats& cost = interestStats[screenTag];
+    
+    // Drain the driver into rxQueue in bursts and process them. If a burst is
+    // deeper than rxQueue, process what we have and keep draining rather than
+    // dropping frames.
+    uint32_t burst = 0;
+    bool driverEmpty = false;
+    while (!driverEmpty) {
+        while (!rxQueue.full()) {
+            twai_message_t rx_message;
+            if (twai_receive(&rx_message, 0) != ESP_OK) {
+                driverEmpty = true;
+                break;
+            }
+            
+            #if DEBUG_CAN
+            Serial.print("CAN RX: ID=0x");
+            Serial.print(rx_message.identifier, HEX);
+            Serial.print(" Len=");
+            Serial.print(rx_message.data_length_code);
+            Serial.print(" Data=[");
+            for (int i = 0; i < rx_message.data_length_code; i++) {
+                if (i > 0) Serial.print(" ");
+                if (rx_message.data[i] < 0x10) Serial.print("0");
+                Serial.print(rx_message.data[i], HEX);
+            }
+            Serial.println("]");
+            #endif
+            
+            CANMessage msg;
+            msg.id = rx_message.identifier;
+            msg.length = rx_message.data_length_code > 8 ? 8 : rx_message.data_length_code;
+            msg.timestamp = millis();
+            memcpy(msg.data, rx_message.data, msg.length);
+            rxQueue.push(msg);
+            
+            burst++;
+            lastMessageTime = msg.timestamp;
+            connected = true;
         }
         
-        enqueueRx(msg);
-        lastMessageTime = millis();
-        connected = true;
+        // Process received messages in place
+        CANMessage* msg;
+        int64_t decodeStart = esp_timer_get_time();
+        while ((msg = rxQueue.front()) != nullptr) {
+            if (onMessageReceived) {
+                onMessageReceived(*msg);
+            }
+            for (uint8_t i = 0; i < frameListenerCount; i++) {
+                const FrameListener& listener = frameListeners[i];
+                if (((msg->id ^ listener.id) & listener.mask) == 0) {
+                    listener.handler(*msg, listener.context);
+                }
+            }
+            processReceivedMessage(*msg);
+            rxQueue.popFront();
+        }
+        cost.decodeUs += (uint32_t)(esp_timer_get_time() - decodeStart);
     }
     
-    // Process received messages
-    CANMessage rxMsg;
-    while (dequeueRx(rxMsg)) {
-        processReceivedMessage(rxMsg);
+    // Apply optimistic updates queued by other tasks
+    ParamWrite write;
+    bool changed = burst > 0;
+    while (localWrites.pop(write)) {
+        int16_t index = indexOf(write.id);
+        if (index >= 0) {
+            setValueAt(index, write.value);
+            changed = true;
+        }
     }
     
-    // Send queued messages
+    // Let the UI and web see this burst as one consistent update
+    if (changed) {
+        publishSnapshot();
+    }
+    
+    stats.rxFrames += burst;
+    if (burst > stats.rxBurstMax) {
+        stats.rxBurstMax = burst;
+    }
+    
+    // Send queued messages while the driver has room. Never waits: a frame
+    // that does not fit now is held and retried first next cycle, in order.
     CANMessage txMsg;
-    if (dequeueTx(txMsg)) {
-        #if DEBUG_CAN
-        Serial.print("CAN TX: ID=0x");
-        Serial.print(txMsg.id, HEX);
-        Serial.print(" Len=");
-        Serial.print(txMsg.length);
-        Serial.print(" Data=[");
-        for (int i = 0; i < txMsg.length; i++) {
-            if (i > 0) Serial.print(" ");
-            if (txMsg.data[i] < 0x10) Serial.print("0");
-            Serial.print(txMsg.data[i], HEX);
+    while (txPending || txQueue.pop(txMsg)) {
+        if (txPending) {
+            txMsg = pendingTx;
         }
-        Serial.println("]");
-        #endif
         
         twai_message_t tx_message;
         tx_message.identifier = txMsg.id;
@@ -162,7 +242,47 @@ void CANDataManager::update() {
             tx_message.data[i] = txMsg.data[i];
         }
         
-        twai_transmit(&tx_message, pdMS_TO_TICKS(100));
+        if (transmit(tx_message, 0)) {
+            #if DEBUG_CAN
+            Serial.print("CAN TX: ID=0x");
+            Serial.print(txMsg.id, HEX);
+            Serial.print(" Len=");
+            Serial.print(txMsg.length);
+            Serial.print(" Data=[");
+            for (int i = 0; i < txMsg.length; i++) {
+                if (i > 0) Serial.print(" ");
+                if (txMsg.data[i] < 0x10) Serial.print("0");
+                Serial.print(txMsg.data[i], HEX);
+            }
+            Serial.println("]");
+            #endif
+            stats.txFrames++;
+            txPending = false;
+            continue;
+        }
+        
+        if (!txPending) {
+            pendingTx = txMsg;
+            pendingTxSince = millis();
+            txPending = true;
+        } else if (millis() - pendingTxSince >= CAN_TX_RETRY_MS) {
+            // Bus off or flooded: drop it, the queue moves on next cycle
+            stats.txFailed++;
+            txPending = false;
+        }
+        break;
+    }
+    
+    // Queue the next SDO read the scheduler picks (if any is due and in budget).
+    // The server handles one transfer at a time, so hold off during another.
+    int16_t pollIndex = sdo.isTransferActive() ? -1 :
+        poller.next(millis(), paramUpdateTimes, paramFlags, parameterCount);
+    if (pollIndex >= 0) {
+        requestParameter(paramIds[pollIndex]);
+        cost.sdoRequests++;
+        #if DEBUG_CAN
+        Serial.printf("Requesting param %d (%s)\n", paramIds[pollIndex], paramMeta[pollIndex].name);
+        #endif
     }
     
     // Check connection timeout
@@ -172,69 +292,693 @@ void CANDataManager::update() {
 }
 
 bool CANDataManager::loadParametersFromJSON(const char* jsonString) {
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, jsonString);
+    return loadParameters(nullptr, jsonString);
+}
+
+bool CANDataManager::loadParametersFromFile(const char* path) {
+    File file = SPIFFS.open(path, "r");
+    if (!file) {
+        return false;
+    }
+    
+    bool ok = loadParameters(&file, nullptr);
+    file.close();
+    return ok;
+}
+
+// ============================================
+// Binary parameter cache
+// ============================================
+//
+// Image of the loaded table, written after a successful JSON parse and
+// read back on later boots while params.json is unchanged:
+//   ParamCacheHeader | ParamCacheEntry[count] (sorted by id) | string pool
+// Bump PARAM_CACHE_VERSION whenever the layout or ParamMeta meaning changes.
+
+static const uint32_t PARAM_CACHE_MAGIC = 0x424D5250;  // "PRMB"
+static const uint16_t PARAM_CACHE_VERSION = 1;
+
+struct ParamCacheHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t sourceSize;    // params.json size and CRC32 it was built from
+    uint32_t sourceCrc;
+    uint32_t poolSize;
+    uint32_t payloadCrc;    // CRC32 of entries + pool
+};
+
+struct ParamCacheEntry {
+    uint16_t id;
+    uint8_t dataType;
+    uint8_t decimalPlaces;
+    int32_t minValue;
+    int32_t maxValue;
+    uint16_t nameOffset;    // Into the string pool
+    uint16_t unitOffset;
+    uint8_t editable;
+    uint8_t reserved[3];
+};
+
+static uint32_t crcFile(File& file, uint32_t& size) {
+    uint8_t chunk[PARAM_LOAD_CHUNK_SIZE];
+    uint32_t crc = 0;
+    size = 0;
     
-    if (error) {
+    file.seek(0);
+    while (file.available()) {
+        size_t n = file.read(chunk, sizeof(chunk));
+        if (n == 0) break;
+        crc = esp_rom_crc32_le(crc, chunk, n);
+        size += n;
+    }
+    return crc;
+}
+
+bool CANDataManager::loadParametersCached(const char* jsonPath, const char* cachePath) {
+    File source = SPIFFS.open(jsonPath, "r");
+    if (!source) {
+        return false;
+    }
+    
+    uint64_t start = esp_timer_get_time();
+    uint32_t sourceSize;
+    uint32_t sourceCrc = crcFile(source, sourceSize);
+    
+    if (loadParameterCache(cachePath, sourceCrc, sourceSize)) {
+        source.close();
         #if DEBUG_SERIAL
-        Serial.print("JSON parse failed: ");
-        Serial.println(error.c_str());
+        Serial.printf("[PARAM] Loaded %d parameters from %s in %d us\n",
+                      parameterCount, cachePath, (int)(esp_timer_get_time() - start));
         #endif
+        return true;
+    }
+    
+    // Source changed or no usable cache: parse the JSON and rebuild it
+    bool ok = loadParameters(&source, nullptr);
+    source.close();
+    
+    if (ok) {
+        saveParameterCache(cachePath, sourceCrc, sourceSize);
+    } else {
+        SPIFFS.remove(cachePath);
+    }
+    return ok;
+}
+
+bool CANDataManager::loadParameterCache(const char* path, uint32_t sourceCrc, uint32_t sourceSize) {
+    File file = SPIFFS.open(path, "r");
+    if (!file) {
         return false;
     }
     
-    parameterCount = 0;
-    JsonArray params = doc["parameters"].as<JsonArray>();
+    ParamCacheHeader header;
+    if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+        header.magic != PARAM_CACHE_MAGIC ||
+        header.version != PARAM_CACHE_VERSION ||
+        header.sourceCrc != sourceCrc ||
+        header.sourceSize != sourceSize ||
+        header.count == 0 || header.count > MAX_PARAMETERS ||
+        header.poolSize == 0 || header.poolSize > 0xFFFF ||
+        file.size() != sizeof(header) + header.count * sizeof(ParamCacheEntry) + header.poolSize) {
+        file.close();
+        return false;
+    }
     
-    for (JsonObject param : params) {
-        if (parameterCount >= MAX_PARAMETERS) break;
-        
-        CANParameter& p = parameters[parameterCount];
-        p.id = param["id"];
-        strncpy(p.name, param["name"] | "Unknown", 31);
-        
-        String type = param["type"] | "int16";
-        if (type == "int8") p.dataType = PARAM_INT8;
-        else if (type == "uint8") p.dataType = PARAM_UINT8;
-        else if (type == "int16") p.dataType = PARAM_INT16;
-        else if (type == "uint16") p.dataType = PARAM_UINT16;
-        else if (type == "int32") p.dataType = PARAM_INT32;
-        else if (type == "uint32") p.dataType = PARAM_UINT32;
-        else if (type == "float") p.dataType = PARAM_FLOAT;
-        
-        p.editable = param["editable"] | false;
-        p.minValue = param["min"] | 0;
-        p.maxValue = param["max"] | 100;
-        strncpy(p.unit, param["unit"] | "", 7);
-        p.decimalPlaces = param["decimals"] | 0;
-        p.dirty = true;
+    // Stage the whole image and check it before the current table goes:
+    // a truncated or corrupt cache must leave the loaded parameters alone
+    bool stagedInPsram, poolInPsram;
+    ParamMeta* meta = (ParamMeta*)allocColdStore(header.count * sizeof(ParamMeta), stagedInPsram);
+    char* pool = (char*)allocColdStore(header.poolSize, poolInPsram);
+    bool ok = meta && pool;
+    
+    // Entries into the staged metadata, offsets fixed up below
+    uint32_t crc = 0;
+    for (uint16_t i = 0; ok && i < header.count; i++) {
+        ParamCacheEntry entry;
+        if (file.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry) ||
+            entry.nameOffset >= header.poolSize || entry.unitOffset >= header.poolSize ||
+            (i > 0 && entry.id <= meta[i - 1].id)) {
+            ok = false;
+            break;
+        }
+        crc = esp_rom_crc32_le(crc, (const uint8_t*)&entry, sizeof(entry));
         
-        parameterCount++;
+        ParamMeta& m = meta[i];
+        m.id = entry.id;
+        m.dataType = entry.dataType;
+        m.decimalPlaces = entry.decimalPlaces;
+        m.minValue = entry.minValue;
+        m.maxValue = entry.maxValue;
+        m.editable = entry.editable != 0;
+        m.name = (const char*)(uintptr_t)entry.nameOffset;
+        m.unit = (const char*)(uintptr_t)entry.unitOffset;
+    }
+    
+    if (ok) {
+        ok = file.read((uint8_t*)pool, header.poolSize) == header.poolSize &&
+             pool[header.poolSize - 1] == '\0';
+        crc = esp_rom_crc32_le(crc, (const uint8_t*)pool, header.poolSize);
+    }
+    file.close();
+    
+    if (!ok || crc != header.payloadCrc) {
+        #if DEBUG_SERIAL
+        Serial.printf("[PARAM] %s invalid, rebuilding\n", path);
+        #endif
+        free(meta);
+        free(pool);
+        return false;
+    }
+    
+    // Valid: swap it in
+    freeParameters();
+    paramMeta = meta;
+    stringPool = pool;
+    metaInPsram = stagedInPsram;
+    for (uint16_t i = 0; i < header.count; i++) {
+        paramMeta[i].name = stringPool + (uintptr_t)paramMeta[i].name;
+        paramMeta[i].unit = stringPool + (uintptr_t)paramMeta[i].unit;
+        paramIds[i] = paramMeta[i].id;
+    }
+    stringPoolSize = header.poolSize;
+    parameterCount = header.count;
+    
+    memset(paramValues, 0, sizeof(paramValues));
+    memset(paramUpdateTimes, 0, sizeof(paramUpdateTimes));
+    memset(paramFlags, PARAM_FLAG_DIRTY, parameterCount);
+    resetPolling();
+    publishSnapshot();
+    return true;
+}
+
+// Fill entry i of the cache image from the loaded table
+static void makeCacheEntry(const ParamMeta& m, const char* pool, ParamCacheEntry& entry) {
+    memset(&entry, 0, sizeof(entry));
+    entry.id = m.id;
+    entry.dataType = m.dataType;
+    entry.decimalPlaces = m.decimalPlaces;
+    entry.minValue = m.minValue;
+    entry.maxValue = m.maxValue;
+    entry.nameOffset = (uint16_t)(m.name - pool);
+    entry.unitOffset = (uint16_t)(m.unit - pool);
+    entry.editable = m.editable ? 1 : 0;
+}
+
+bool CANDataManager::saveParameterCache(const char* path, uint32_t sourceCrc, uint32_t sourceSize) {
+    if (parameterCount == 0 || stringPoolSize > 0xFFFF) {
+        return false;
+    }
+    
+    ParamCacheHeader header;
+    header.magic = PARAM_CACHE_MAGIC;
+    header.version = PARAM_CACHE_VERSION;
+    header.count = parameterCount;
+    header.sourceSize = sourceSize;
+    header.sourceCrc = sourceCrc;
+    header.poolSize = stringPoolSize;
+    
+    ParamCacheEntry entry;
+    uint32_t crc = 0;
+    for (uint16_t i = 0; i < parameterCount; i++) {
+        makeCacheEntry(paramMeta[i], stringPool, entry);
+        crc = esp_rom_crc32_le(crc, (const uint8_t*)&entry, sizeof(entry));
+    }
+    header.payloadCrc = esp_rom_crc32_le(crc, (const uint8_t*)stringPool, stringPoolSize);
+    
+    // Write beside the old image and swap, so a power cut never leaves half a cache
+    String tempPath = String(path) + ".tmp";
+    File file = SPIFFS.open(tempPath.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    
+    bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    for (uint16_t i = 0; ok && i < parameterCount; i++) {
+        makeCacheEntry(paramMeta[i], stringPool, entry);
+        ok = file.write((const uint8_t*)&entry, sizeof(entry)) == sizeof(entry);
+    }
+    ok = ok && file.write((const uint8_t*)stringPool, stringPoolSize) == stringPoolSize;
+    file.close();
+    
+    if (ok) {
+        SPIFFS.remove(path);
+        ok = SPIFFS.rename(tempPath.c_str(), path);
+    }
+    if (!ok) {
+        SPIFFS.remove(tempPath.c_str());
+    }
+    
+    #if DEBUG_SERIAL
+    Serial.printf("[PARAM] %s %s (%d parameters)\n", path, ok ? "written" : "write failed", parameterCount);
+    #endif
+    return ok;
+}
+
+// Run the streaming parser over the whole source once
+size_t CANDataManager::parsePass(File* file, const char* text, ParamJsonParser& parser, bool& ok) {
+    size_t bytes = 0;
+    
+    if (file) {
+        char chunk[PARAM_LOAD_CHUNK_SIZE];
+        file->seek(0);
+        while (file->available()) {
+            size_t n = file->read((uint8_t*)chunk, sizeof(chunk));
+            if (n == 0) break;
+            bytes += n;
+            if (!parser.feed(chunk, n)) break;
+        }
+    } else {
+        bytes = strlen(text);
+        parser.feed(text, bytes);
+    }
+    
+    ok = parser.finish();
+    return bytes;
+}
+
+void CANDataManager::countParam(const ParamRecord& record, void* context) {
+    LoadState* state = (LoadState*)context;
+    if (state->count >= MAX_PARAMETERS) return;
+    
+    state->poolSize += strlen(record.name) + 1;
+    state->poolSize += strlen(record.unit) + 1;
+    state->count++;
+}
+
+void CANDataManager::storeParam(const ParamRecord& record, void* context) {
+    LoadState* state = (LoadState*)context;
+    CANDataManager* self = state->manager;
+    if (self->parameterCount + state->duplicates >= state->count) return;
+    
+    // Insertion point by id, which keeps paramIds ready for binary search.
+    // A repeated id keeps its first entry, so the table - and the cache
+    // written from it - holds every id once.
+    uint16_t i = self->parameterCount;
+    while (i > 0 && self->paramIds[i - 1] > record.id) {
+        i--;
+    }
+    if (i > 0 && self->paramIds[i - 1] == record.id) {
+        #if DEBUG_SERIAL
+        Serial.printf("[PARAM] Duplicate id %d (%s) ignored\n", record.id, record.name);
+        #endif
+        state->duplicates++;
+        return;
+    }
+    
+    ParamMeta m;
+    m.id = record.id;
+    
+    size_t len = strlen(record.name);
+    memcpy(state->poolNext, record.name, len + 1);
+    m.name = state->poolNext;
+    state->poolNext += len + 1;
+    
+    len = strlen(record.unit);
+    memcpy(state->poolNext, record.unit, len + 1);
+    m.unit = state->poolNext;
+    state->poolNext += len + 1;
+    
+    const char* type = record.type;
+    if (strcmp(type, "int8") == 0) m.dataType = PARAM_INT8;
+    else if (strcmp(type, "uint8") == 0) m.dataType = PARAM_UINT8;
+    else if (strcmp(type, "uint16") == 0) m.dataType = PARAM_UINT16;
+    else if (strcmp(type, "int32") == 0) m.dataType = PARAM_INT32;
+    else if (strcmp(type, "uint32") == 0) m.dataType = PARAM_UINT32;
+    else if (strcmp(type, "float") == 0) m.dataType = PARAM_FLOAT;
+    else m.dataType = PARAM_INT16;
+    
+    m.editable = record.editable;
+    m.minValue = record.minValue;
+    m.maxValue = record.maxValue;
+    m.decimalPlaces = record.decimals;
+    
+    for (uint16_t j = self->parameterCount; j > i; j--) {
+        self->paramIds[j] = self->paramIds[j - 1];
+        self->paramMeta[j] = self->paramMeta[j - 1];
+    }
+    self->paramIds[i] = m.id;
+    self->paramMeta[i] = m;
+    
+    self->parameterCount++;
+}
+
+bool CANDataManager::loadParameters(File* file, const char* text) {
+    uint32_t heapBefore = ESP.getFreeHeap();
+    uint64_t start = esp_timer_get_time();
+    
+    ParamJsonParser parser;
+    LoadState state = {this, 0, 0, 0, nullptr};
+    bool ok;
+    
+    // Pass 1: validate and size the cold store, current table untouched
+    parser.begin(countParam, &state);
+    size_t bytes = parsePass(file, text, parser, ok);
+    if (!ok) {
+        #if DEBUG_SERIAL
+        Serial.printf("JSON parse failed after %d bytes\n", (int)bytes);
+        #endif
+        return false;
+    }
+    
+    // Keep what is known about the current table so a reload does not blank
+    // every value and re-poll the lot
+    uint16_t carriedCount = parameterCount;
+    bool carriedInPsram;
+    CarriedValue* carried = nullptr;
+    if (carriedCount > 0) {
+        carried = (CarriedValue*)allocColdStore(carriedCount * sizeof(CarriedValue), carriedInPsram);
+        if (carried) {
+            for (uint16_t i = 0; i < carriedCount; i++) {
+                carried[i].id = paramIds[i];
+                carried[i].dataType = paramMeta[i].dataType;
+                carried[i].flags = paramFlags[i];
+                carried[i].value = paramValues[i];
+                carried[i].updated = paramUpdateTimes[i];
+            }
+        }
+    }
+    
+    freeParameters();
+    
+    if (state.count > 0) {
+        bool poolInPsram;
+        paramMeta = (ParamMeta*)allocColdStore(state.count * sizeof(ParamMeta), metaInPsram);
+        stringPool = (char*)allocColdStore(state.poolSize, poolInPsram);
+        if (!paramMeta || !stringPool) {
+            #if DEBUG_SERIAL
+            Serial.println("Parameter store allocation failed");
+            #endif
+            freeParameters();
+            free(carried);
+            publishSnapshot();
+            return false;
+        }
+        stringPoolSize = state.poolSize;
     }
     
+    // Pass 2: fill the table in place
+    state.poolNext = stringPool;
+    parser.begin(storeParam, &state);
+    parsePass(file, text, parser, ok);
+    if (!ok || parameterCount + state.duplicates != state.count) {
+        freeParameters();
+        free(carried);
+        publishSnapshot();
+        return false;
+    }
+    // Without the skipped duplicates' strings
+    stringPoolSize = state.poolNext - stringPool;
+    
+    uint16_t kept = carryValues(carried, carried ? carriedCount : 0);
+    free(carried);
+    resetPolling();
+    
+    publishSnapshot();
+    
     #if DEBUG_SERIAL
-    Serial.printf("Loaded %d parameters\n", parameterCount);
+    Serial.printf("[PARAM] Loaded %d parameters from %d bytes in %d us, heap %d B, %d values kept\n",
+                  parameterCount, (int)bytes, (int)(esp_timer_get_time() - start),
+                  (int)(heapBefore - ESP.getFreeHeap()), kept);
     #endif
     
     return true;
 }
 
-CANParameter* CANDataManager::getParameter(uint16_t id) {
+// Fill the hot arrays of a freshly loaded table. Ids that were in the old
+// table with the same type keep their value; the rest start dirty so the
+// poller reads them first. Both lists are sorted by id.
+uint16_t CANDataManager::carryValues(CarriedValue* carried, uint16_t count) {
+    uint16_t kept = 0;
+    uint16_t j = 0;
+    
     for (uint16_t i = 0; i < parameterCount; i++) {
-        if (parameters[i].id == id) {
-            return &parameters[i];
+        while (j < count && carried[j].id < paramIds[i]) {
+            j++;
+        }
+        if (j < count && carried[j].id == paramIds[i] && carried[j].dataType == paramMeta[i].dataType) {
+            paramValues[i] = carried[j].value;
+            paramUpdateTimes[i] = carried[j].updated;
+            paramFlags[i] = carried[j].flags;
+            kept++;
+        } else {
+            paramValues[i] = 0;
+            paramUpdateTimes[i] = 0;
+            paramFlags[i] = PARAM_FLAG_DIRTY;
         }
     }
-    return nullptr;
+    return kept;
+}
+
+// Settings change rarely; live values default to the normal rate
+PollRate CANDataManager::defaultPollRate(uint16_t index) {
+    return paramMeta[index].editable ? POLL_SLOW : POLL_NORMAL;
+}
+
+void CANDataManager::resetPolling() {
+    poller.reset(parameterCount);
+    for (uint16_t i = 0; i < parameterCount; i++) {
+        poller.setRate(i, defaultPollRate(i));
+    }
+    
+    // Indices moved - put the interest sets back on the new table
+    fastCount = 0;
+    for (uint8_t slot = 0; slot < INTEREST_SLOTS; slot++) {
+        interestApplied[slot] = ~0u;
+    }
+}
+
+void CANDataManager::setInterest(InterestSlot slot, uint8_t tag, const uint16_t* ids, uint8_t count,
+                                 uint8_t decode, uint32_t ttlMs) {
+    if (slot >= INTEREST_SLOTS) return;
+    if (count > MAX_INTEREST_IDS) count = MAX_INTEREST_IDS;
+    
+    uint32_t generation = interest[slot].published().generation + 1;
+    ParamInterest& set = interest[slot].beginWrite();
+    set.generation = generation ? generation : 1;
+    set.expires = ttlMs ? (millis() + ttlMs) | 1 : 0;  // Never 0 while a TTL is set
+    memcpy(set.ids, ids, count * sizeof(uint16_t));
+    set.count = count;
+    set.decode = decode;
+    set.tag = tag < MAX_INTEREST_TAGS ? tag : 0;
+    interest[slot].endWrite();
+}
+
+// CAN task: pick up changed or lapsed interest sets and re-rate the poller
+void CANDataManager::applyInterest(uint32_t now) {
+    // Book the time since the last cycle to the screen shown during it
+    if (interestAccounted) {
+        interestStats[screenTag].activeMs += now - interestAccounted;
+    }
+    interestAccounted = now;
+    
+    bool changed = false;
+    for (uint8_t slot = 0; slot < INTEREST_SLOTS; slot++) {
+        uint32_t expires = 0;
+        uint32_t generation = interest[slot].read([&expires](const ParamInterest& set) {
+            expires = set.expires;
+            return set.generation;
+        });
+        bool lapsed = interestActive[slot] && expires && (int32_t)(now - expires) >= 0;
+        if (generation != interestApplied[slot] || lapsed) {
+            changed = true;
+        }
+    }
+    if (!changed) return;
+    
+    // Back to the default rates, then raise the union of every live set
+    for (uint8_t i = 0; i < fastCount; i++) {
+        poller.setRate(fastIndices[i], defaultPollRate(fastIndices[i]));
+    }
+    fastCount = 0;
+    decodeMask = 0;
+    
+    for (uint8_t slot = 0; slot < INTEREST_SLOTS; slot++) {
+        ParamInterest set;
+        interest[slot].copy(set);
+        interestApplied[slot] = set.generation;
+        interestActive[slot] = set.generation != 0 && !(set.expires && (int32_t)(now - set.expires) >= 0);
+        if (!interestActive[slot]) continue;
+        
+        if (slot == INTEREST_SCREEN) {
+            screenTag = set.tag;
+        }
+        decodeMask |= set.decode;
+        for (uint8_t i = 0; i < set.count && i < MAX_INTEREST_IDS; i++) {
+            int16_t index = indexOf(set.ids[i]);
+            if (index >= 0 && poller.getRate(index) != POLL_FAST) {
+                poller.setRate(index, POLL_FAST);
+                fastIndices[fastCount++] = index;
+            }
+        }
+    }
+    
+    #if DEBUG_SERIAL
+    Serial.printf("[POLL] Interest: screen %d, %d fast params, decode 0x%02X\n",
+                  screenTag, fastCount, decodeMask);
+    #endif
+}
+
+void CANDataManager::setPollRate(uint16_t id, PollRate rate) {
+    int16_t index = indexOf(id);
+    if (index >= 0) {
+        poller.setRate(index, rate);
+    }
+}
+
+void CANDataManager::freeParameters() {
+    parameterCount = 0;
+    free(paramMeta);
+    free(stringPool);
+    paramMeta = nullptr;
+    stringPool = nullptr;
+    stringPoolSize = 0;
+}
+
+// Before init() there is only the setup() task, nothing to exclude
+bool CANDataManager::lockTable(TickType_t wait) {
+    return !tableMutex || xSemaphoreTake(tableMutex, wait) == pdTRUE;
+}
+
+void CANDataManager::unlockTable() {
+    if (tableMutex) xSemaphoreGive(tableMutex);
+}
+
+const ParamMeta* CANDataManager::getParameter(uint16_t id) {
+    int16_t index = indexOf(id);
+    return index >= 0 ? &paramMeta[index] : nullptr;
+}
+
+int16_t CANDataManager::indexOf(uint16_t paramId) {
+    return indexIn(paramIds, parameterCount, paramId);
 }
 
-CANParameter* CANDataManager::getParameterByIndex(uint8_t index) {
+int16_t CANDataManager::indexIn(const uint16_t* ids, uint16_t count, uint16_t paramId) {
+    uint16_t low = 0;
+    uint16_t high = count;
+    while (low < high) {
+        uint16_t mid = (low + high) / 2;
+        if (ids[mid] < paramId) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < count && ids[low] == paramId) ? low : -1;
+}
+
+// The lookups run inside the read, against the snapshot's own ids. A read
+// the writer lapped is retried, but may see a torn count first: clamp it.
+static inline uint16_t snapshotCount(const ParamValues& v) {
+    return v.count < MAX_PARAMETERS ? v.count : MAX_PARAMETERS;
+}
+
+bool CANDataManager::getValue(uint16_t id, int32_t& value, uint32_t* updated) {
+    bool found = false;
+    uint32_t when = 0;
+    value = snapshot.read([id, &found, &when](const ParamValues& v) {
+        int16_t index = indexIn(v.id, snapshotCount(v), id);
+        found = index >= 0;
+        when = found ? v.updated[index] : 0;
+        return found ? v.value[index] : 0;
+    });
+    
+    if (updated) *updated = when;
+    return found;
+}
+
+uint8_t CANDataManager::getValues(const uint16_t* ids, int32_t* values, uint8_t count) {
+    return snapshot.read([&](const ParamValues& v) {
+        uint8_t found = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            int16_t index = indexIn(v.id, snapshotCount(v), ids[i]);
+            if (index >= 0) {
+                values[i] = v.value[index];
+                found++;
+            } else {
+                values[i] = 0;
+            }
+        }
+        return found;
+    });
+}
+
+uint32_t CANDataManager::getLastUpdate(const uint16_t* ids, uint8_t count) {
+    return snapshot.read([&](const ParamValues& v) {
+        uint32_t newest = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            int16_t index = indexIn(v.id, snapshotCount(v), ids[i]);
+            if (index >= 0 && v.updated[index] > newest) {
+                newest = v.updated[index];
+            }
+        }
+        return newest;
+    });
+}
+
+void CANDataManager::publishSnapshot() {
+    ParamValues& v = snapshot.beginWrite();
+    v.count = parameterCount;
+    memcpy(v.id, paramIds, parameterCount * sizeof(uint16_t));
+    memcpy(v.value, paramValues, parameterCount * sizeof(int32_t));
+    memcpy(v.updated, paramUpdateTimes, parameterCount * sizeof(uint32_t));
+    snapshot.endWrite();
+}
+
+const ParamMeta* CANDataManager::getParameterByIndex(uint16_t index) {
     if (index < parameterCount) {
-        return &parameters[index];
+        return &paramMeta[index];
     }
     return nullptr;
 }
 
+void CANDataManager::setValueAt(uint16_t index, int32_t value) {
+    paramValues[index] = narrowValue(paramMeta[index].dataType, value);
+    paramUpdateTimes[index] = millis();
+    paramFlags[index] &= ~PARAM_FLAG_DIRTY;
+}
+
+void CANDataManager::printFootprint() {
+    const size_t hotPerParam = sizeof(uint16_t) + sizeof(int32_t) + sizeof(uint32_t) + sizeof(uint8_t);
+    const size_t snapshotPerParam = 2 * (sizeof(uint16_t) + sizeof(int32_t) + sizeof(uint32_t));
+    
+    Serial.printf("[PARAM] %d/%d params, hot %d B/param (%d B), snapshot %d B/param (%d B)\n",
+                  parameterCount, MAX_PARAMETERS,
+                  (int)hotPerParam, (int)(hotPerParam * MAX_PARAMETERS),
+                  (int)snapshotPerParam, (int)sizeof(snapshot));
+    Serial.printf("[PARAM] meta %d B/param + %d B strings (%s)\n",
+                  (int)sizeof(ParamMeta), (int)stringPoolSize,
+                  metaInPsram ? "PSRAM" : "internal");
+    
+    if (parameterCount == 0) return;
+    
+    // Dirty scan over the hot flags, as the polling loop does
+    const uint16_t rounds = 100;
+    uint32_t dirty = 0;
+    uint64_t start = esp_timer_get_time();
+    for (uint16_t r = 0; r < rounds; r++) {
+        for (uint16_t i = 0; i < parameterCount; i++) {
+            dirty += paramFlags[i] & PARAM_FLAG_DIRTY;
+        }
+    }
+    uint32_t scanUs = (uint32_t)(esp_timer_get_time() - start);
+    
+    // Lookup of every id, as the decoders do per frame
+    uint32_t hits = 0;
+    start = esp_timer_get_time();
+    for (uint16_t r = 0; r < rounds; r++) {
+        for (uint16_t i = 0; i < parameterCount; i++) {
+            hits += indexOf(paramIds[i]) >= 0;
+        }
+    }
+    uint32_t lookupUs = (uint32_t)(esp_timer_get_time() - start);
+    
+    Serial.printf("[PARAM] scan %d ns/param, lookup %d ns/id (dirty %d, hits %d)\n",
+                  (scanUs * 1000) / (rounds * parameterCount),
+                  (lookupUs * 1000) / (rounds * parameterCount),
+                  dirty / rounds, hits / rounds);
+}
+
 void CANDataManager::requestParameter(uint16_t paramId) {
     // SDO Read Request - Correct CANopen format with index 0x2100
     CANMessage msg;
@@ -253,6 +997,34 @@ void CANDataManager::requestParameter(uint16_t paramId) {
     enqueueTx(msg);
 }
 
+// Parameters setParameter() sends as their own CAN frame instead of SDO
+static bool hasDirectMapping(uint16_t paramId) {
+    return paramId == 27 || paramId == 129 || paramId == 61;
+}
+
+bool CANDataManager::writeParameters(SDOWrite* writes, uint16_t count, uint8_t options) {
+    for (uint16_t i = 0; i < count; i++) {
+        writes[i].status = hasDirectMapping(writes[i].paramId) ? SDO_WRITE_DIRECT : SDO_WRITE_PENDING;
+        writes[i].abortCode = 0;
+    }
+    
+    // Read-backs during verify update the store like any other SDO reply
+    bool ok = sdo.writeBatch(writes, count, options);
+    if (!ok) {
+        for (uint16_t i = 0; i < count; i++) {
+            if (writes[i].status == SDO_WRITE_DIRECT) writes[i].status = SDO_WRITE_SKIPPED;
+        }
+        return false;
+    }
+    
+    for (uint16_t i = 0; i < count; i++) {
+        if (writes[i].status == SDO_WRITE_DIRECT) {
+            setParameter(writes[i].paramId, writes[i].value);
+        }
+    }
+    return true;
+}
+
 void CANDataManager::setParameter(uint16_t paramId, int32_t value) {
     CANMessage msg;
     msg.timestamp = millis();
@@ -274,7 +1046,7 @@ void CANDataManager::setParameter(uint16_t paramId, int32_t value) {
             Serial.printf("Sending Gear change to 0x300: value=%d\n", value);
             #endif
             // Optimistic update - immediately update local value
-            updateParameterIfExists(27, value);
+            localWrites.push(ParamWrite{27, value});
             break;
             
         case 129:  // MotActive
@@ -292,7 +1064,7 @@ void CANDataManager::setParameter(uint16_t paramId, int32_t value) {
             Serial.printf("Sending Motor change to 0x301: value=%d\n", value);
             #endif
             // Optimistic update - immediately update local value
-            updateParameterIfExists(129, value);
+            localWrites.push(ParamWrite{129, value});
             break;
             
         case 61:  // regenmax
@@ -310,7 +1082,7 @@ void CANDataManager::setParameter(uint16_t paramId, int32_t value) {
             Serial.printf("Sending Regen change to 0x302: value=%d\n", value);
             #endif
             // Optimistic update - immediately update local value
-            updateParameterIfExists(61, value);
+            localWrites.push(ParamWrite{61, value});
             break;
             
         default:
@@ -344,8 +1116,16 @@ void CANDataManager::processReceivedMessage(CANMessage& msg) {
     Serial.println(")");
     #endif
     
-    // Check for BMS cell voltage messages (0x400-0x4FF or 0x600-0x6FF)
+    InterestStats& cost = interestStats[screenTag];
+    
+    // Check for BMS cell voltage messages (0x400-0x4FF or 0x600-0x6FF).
+    // Up to 24 frames per sweep - only decoded while a screen wants cells.
     if ((msg.id >= 0x400 && msg.id < 0x500) || (msg.id >= 0x600 && msg.id < 0x700)) {
+        if (!(decodeMask & DECODE_BMS_CELLS)) {
+            cost.framesSkipped++;
+            return;
+        }
+        cost.framesDecoded++;
         #if DEBUG_CAN
         Serial.println("  -> BMS cell voltage message detected");
         #endif
@@ -353,12 +1133,16 @@ void CANDataManager::processReceivedMessage(CANMessage& msg) {
         return;
     }
     
+    cost.framesDecoded++;
+    
     // Check if it's an SDO response (0x580 + node_id)
     if (msg.id == (0x580 + CAN_NODE_ID)) {
         #if DEBUG_CAN
         Serial.println("  -> SDO Response detected");
         #endif
-        handleSDOResponse(msg);
+        if (!sdo.processResponse(msg.id, msg.data, msg.length)) {
+            handleSDOResponse(msg);
+        }
     }
     // Check if it's a PDO message from Node 3
     // TPDO1: 0x180 + node_id = 0x183
@@ -432,8 +1216,8 @@ void CANDataManager::handleSDOResponse(CANMessage& msg) {
     Serial.println(paramId);
     #endif
     
-    CANParameter* param = getParameter(paramId);
-    if (!param) {
+    int16_t slot = indexOf(paramId);
+    if (slot < 0) {
         #if DEBUG_CAN
         Serial.print("  -> Parameter ID ");
         Serial.print(paramId);
@@ -447,11 +1231,14 @@ void CANDataManager::handleSDOResponse(CANMessage& msg) {
     if (cmd == 0x43 || cmd == 0x4B) {
         int32_t value = msg.data[4] | (msg.data[5] << 8) | 
                        (msg.data[6] << 16) | (msg.data[7] << 24);
-        param->setValue(value);
+        if (sdoEncoding(paramId, paramMeta[slot].name) == PARAM_ENC_FIXED32) {
+            value = fromFixed32(paramId, value);
+        }
+        setValueAt(slot, value);
         
         #if DEBUG_CAN
         Serial.print("  -> Updated ");
-        Serial.print(param->name);
+        Serial.print(paramMeta[slot].name);
         Serial.print(" = ");
         Serial.println(value);
         #endif
@@ -502,7 +1289,7 @@ void CANDataManager::handlePDOMessage(CANMessage& msg) {
         updateParameterIfExists(1, val0);  // Speed/RPM
         updateParameterIfExists(3, val1);  // Voltage
         updateParameterIfExists(4, val2);  // Current  
-        updateParameterIfExists(2, val3);  // Power
+        updateParameterIfExists(POWER_PARAM_ID, fromFixed32(POWER_PARAM_ID, val3));  // Power
         
         #if DEBUG_CAN
         Serial.printf("  -> TPDO1: %d, %d, %d, %d\n", val0, val1, val2, val3);
@@ -530,49 +1317,70 @@ void CANDataManager::handlePDOMessage(CANMessage& msg) {
     // TPDO3 and TPDO4 can be added similarly if needed
 }
 
-bool CANDataManager::enqueueTx(CANMessage& msg) {
-    uint8_t next = (txHead + 1) % TX_QUEUE_SIZE;
-    if (next == txTail) return false;
-    
-    txQueue[txHead] = msg;
-    txHead = next;
-    return true;
+// The CAN and web tasks can both pass the check before either transmits,
+// so with two slots reserved the heartbeat always has at least one
+bool CANDataManager::transmit(const twai_message_t& msg, TickType_t wait) {
+    TickType_t start = xTaskGetTickCount();
+    while (true) {
+        twai_status_info_t status;
+        if (twai_get_status_info(&status) != ESP_OK) {
+            return false;
+        }
+        if (status.msgs_to_tx + HEARTBEAT_TX_RESERVE < CAN_DRIVER_TX_QUEUE_LEN) {
+            return twai_transmit(&msg, 0) == ESP_OK;
+        }
+        if (xTaskGetTickCount() - start >= wait) {
+            return false;
+        }
+        vTaskDelay(1);
+    }
 }
 
-bool CANDataManager::dequeueTx(CANMessage& msg) {
-    if (txHead == txTail) return false;
-    
-    msg = txQueue[txTail];
-    txTail = (txTail + 1) % TX_QUEUE_SIZE;
+bool CANDataManager::enqueueTx(const CANMessage& msg) {
+    if (!txQueue.push(msg)) {
+        __atomic_fetch_add(&stats.txQueueFull, 1, __ATOMIC_RELAXED);  // Any task
+        return false;
+    }
     return true;
 }
 
-bool CANDataManager::enqueueRx(CANMessage& msg) {
-    uint8_t next = (rxHead + 1) % RX_QUEUE_SIZE;
-    if (next == rxTail) return false;
-    
-    rxQueue[rxHead] = msg;
-    rxHead = next;
-    return true;
+const CANStats& CANDataManager::getStats() {
+    return stats;
 }
 
-bool CANDataManager::dequeueRx(CANMessage& msg) {
-    if (rxHead == rxTail) return false;
-    
-    msg = rxQueue[rxTail];
-    rxTail = (rxTail + 1) % RX_QUEUE_SIZE;
+void CANDataManager::setOnMessageReceived(void (*callback)(const CANMessage&)) {
+    onMessageReceived = callback;
+}
+
+bool CANDataManager::addFrameListener(uint32_t id, uint32_t mask, FrameHandler handler, void* context) {
+    if (!handler || frameListenerCount >= MAX_FRAME_LISTENERS) {
+        return false;
+    }
+    frameListeners[frameListenerCount++] = FrameListener{ id, mask, handler, context };
     return true;
 }
 
+bool CANDataManager::sendMessage(uint32_t id, uint8_t* data, uint8_t length) {
+    CANMessage msg;
+    msg.id = id;
+    msg.length = length > 8 ? 8 : length;
+    memset(msg.data, 0, sizeof(msg.data));
+    memcpy(msg.data, data, msg.length);
+    msg.timestamp = millis();
+    return enqueueTx(msg);
+}
+
+// Value decoded from a PDO/broadcast frame - the poller leaves it alone
 void CANDataManager::updateParameterIfExists(uint16_t paramId, int32_t value) {
-    CANParameter* param = getParameter(paramId);
-    if (param) {
-        param->setValue(value);
+    int16_t index = indexOf(paramId);
+    if (index >= 0) {
+        setValueAt(index, value);
+        paramFlags[index] |= PARAM_FLAG_BROADCAST;
         #if DEBUG_CAN
         Serial.print("    -> Updated param ");
         Serial.print(paramId);
         Serial.print(" (");
-        Serial.print(param->name);
+        Serial.print(paramMeta[index].name);
         Serial.print(") = ");
         Serial.println(value);
         #endif
@@ -623,15 +1431,14 @@ void CANDataManager::handleGenericMessage(CANMessage& msg) {
         // Sign extend if bit 23 is set
         if (voltage_mv & 0x800000) voltage_mv |= 0xFF000000;
         
-        // Convert mV to decivolts (for display with 1 decimal place)
-        // 311059 mV / 1000 = 311 decivolts (displays as 311.0V with 1 decimal)
-        int32_t voltage_dv = voltage_mv / 1000;
+        // Param 3 is whole volts (311059 mV -> 311 V)
+        int32_t voltage_v = MilliCodec::decode(voltage_mv);
         
         Serial.println("=== IVT-S VOLTAGE (U2) ===");
-        Serial.printf("Raw: %d mV, Scaled: %d dV (%.1f V)\n", voltage_mv, voltage_dv, voltage_mv/1000.0);
+        Serial.printf("Raw: %d mV, Scaled: %d V\n", voltage_mv, voltage_v);
         Serial.println("==========================");
         
-        updateParameterIfExists(3, voltage_dv);  // ID 3 = Voltage
+        updateParameterIfExists(3, voltage_v);  // ID 3 = Voltage
         return;
     }
     
@@ -651,15 +1458,14 @@ void CANDataManager::handleGenericMessage(CANMessage& msg) {
         // Sign extend if bit 23 is set
         if (current_ma & 0x800000) current_ma |= 0xFF000000;
         
-        // Convert mA to deciamps (for display with 1 decimal place)
-        // 1340 mA / 1000 = 1 deciamp (displays as 1.3A with 1 decimal)
-        int32_t current_da = current_ma / 1000;
+        // Param 4 is whole amps (1340 mA -> 1 A, -1500 mA -> -2 A)
+        int32_t current_a = MilliCodec::decode(current_ma);
         
         Serial.println("=== IVT-S CURRENT ===");
-        Serial.printf("Raw: %d mA, Scaled: %d dA (%.2f A)\n", current_ma, current_da, current_ma/1000.0);
+        Serial.printf("Raw: %d mA, Scaled: %d A\n", current_ma, current_a);
         Serial.println("=====================");
         
-        updateParameterIfExists(4, current_da);  // ID 4 = Current
+        updateParameterIfExists(4, current_a);  // ID 4 = Current
         return;
     }
     
@@ -669,15 +1475,14 @@ void CANDataManager::handleGenericMessage(CANMessage& msg) {
         // Sign extend if bit 23 is set  
         if (power_w & 0x800000) power_w |= 0xFF000000;
         
-        // Convert W to decikilowatts (for display as kW with 1 decimal)
-        // 1753 W / 1000 = 1 deci-kW (displays as 1.7-1.8 kW with 1 decimal)
-        int32_t power_dkw = power_w / 1000;
+        // Param 2 is 0.1 kW (1753 W -> 18 -> "1.8kW")
+        int32_t power_dkw = WattToKwCodec::decode(power_w);
         
         Serial.println("=== IVT-S POWER ===");
-        Serial.printf("Raw: %d W, Scaled: %d dkW (%.1f kW)\n", power_w, power_dkw, power_w/1000.0);
+        Serial.printf("Raw: %d W, Scaled: %d x0.1 kW\n", power_w, power_dkw);
         Serial.println("===================");
         
-        updateParameterIfExists(2, power_dkw);  // ID 2 = Power
+        updateParameterIfExists(POWER_PARAM_ID, power_dkw);
         return;
     }
     
@@ -688,7 +1493,7 @@ void CANDataManager::handleGenericMessage(CANMessage& msg) {
         if (charge_as & 0x800000) charge_as |= 0xFF000000;
         
         // Convert As to Ah
-        int32_t charge_ah = charge_as / 3600;
+        int32_t charge_ah = AsToAhCodec::decode(charge_as);
         
         Serial.println("=== IVT-S CHARGE ===");
         Serial.printf("Raw: %d As, Scaled: %d Ah\n", charge_as, charge_ah);
@@ -712,8 +1517,8 @@ void CANDataManager::handleGenericMessage(CANMessage& msg) {
         int32_t temp_raw = msg.data[2] | (msg.data[3] << 8) | (msg.data[4] << 16);
         if (temp_raw & 0x800000) temp_raw |= 0xFF000000;
         
-        // Temperature in 0.1°C
-        int32_t temp_c = temp_raw / 10;
+        // Temperature in 0.1°C, param 14 is whole °C
+        int32_t temp_c = DeciCodec::decode(temp_raw);
         
         Serial.println("=== IVT-S TEMP ===");
         Serial.printf("Raw: %d, Scaled: %d °C\n", temp_raw, temp_c);
@@ -747,7 +1552,7 @@ void CANDataManager::handleGenericMessage(CANMessage& msg) {
         uint16_t maxTemp = msg.data[4] | (msg.data[5] << 8);  // 0.1°C
         
         // Convert temp from 0.1°C to °C
-        int16_t maxTempC = maxTemp / 10;
+        int16_t maxTempC = DeciCodec::decode(maxTemp);
         
         #if DEBUG_CAN
         Serial.println("=== VICTRON BMS 0x373 ===");
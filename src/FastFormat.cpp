@@ -0,0 +1,40 @@
+#include "FastFormat.h"
+#include "ValueCodec.h"
+
+TextWriter::TextWriter(char* buffer, size_t size) : buffer(buffer), size(size), len(0) {
+    if (size > 0) buffer[0] = '\0';
+}
+
+TextWriter& TextWriter::str(const char* text) {
+    while (text && *text && len + 1 < size) {
+        buffer[len++] = *text++;
+    }
+    if (size > 0) buffer[len] = '\0';
+    return *this;
+}
+
+TextWriter& TextWriter::num(int32_t value) {
+    return fixed(value, 0);
+}
+
+TextWriter& TextWriter::fixed(int32_t scaled, uint8_t decimals) {
+    if (len + 1 < size) {
+        len += formatScaled(buffer + len, size - len, scaled, decimals);
+    }
+    return *this;
+}
+
+bool setLabelValue(lv_obj_t* label, LabelText& text, const char* prefix,
+                   int32_t scaled, uint8_t decimals, const char* unit) {
+    char next[LABEL_TEXT_SIZE];
+    TextWriter(next, sizeof(next)).str(prefix).fixed(scaled, decimals).str(unit);
+
+    const char* current = lv_label_get_text(label);
+    if (current == text.text && strcmp(next, text.text) == 0) {
+        return false;
+    }
+
+    memcpy(text.text, next, sizeof(next));
+    lv_label_set_text_static(label, text.text);
+    return true;
+}
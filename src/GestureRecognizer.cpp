@@ -0,0 +1,185 @@
+#include "GestureRecognizer.h"
+#include <math.h>
+
+static int32_t distance(const TouchPoint& a, const TouchPoint& b) {
+    int32_t dx = a.x - b.x;
+    int32_t dy = a.y - b.y;
+    return (int32_t)sqrtf((float)(dx * dx + dy * dy));
+}
+
+// Screen y grows downwards, so a growing angle is clockwise
+static float angleOf(const TouchPoint& p) {
+    return atan2f((float)(p.y - SCREEN_CENTER_Y), (float)(p.x - SCREEN_CENTER_X)) * 57.29578f;
+}
+
+static int32_t radiusOf(const TouchPoint& p) {
+    TouchPoint center = { SCREEN_CENTER_X, SCREEN_CENTER_Y };
+    return distance(p, center);
+}
+
+GestureRecognizer::GestureRecognizer() {
+    reset();
+}
+
+void GestureRecognizer::reset() {
+    down = false;
+    downMs = 0;
+    start.x = start.y = 0;
+    last = start;
+    maxFingers = 0;
+    moved = false;
+    longPressed = false;
+    onRing = false;
+    angleValid = false;
+    lastAngle = 0;
+    arc = 0;
+    rotated = false;
+    pinchStart = 0;
+    pinchReported = 0;
+    pinched = false;
+}
+
+void GestureRecognizer::feed(uint32_t ms, uint8_t count, const TouchPoint* points) {
+    if (count == 0) {
+        if (down) release(ms);
+        return;
+    }
+    if (count > GESTURE_MAX_POINTS) count = GESTURE_MAX_POINTS;
+
+    if (!down) {
+        reset();
+        down = true;
+        downMs = ms;
+        start = points[0];
+        last = points[0];
+        onRing = radiusOf(start) >= GESTURE_RING_MIN_RADIUS;
+    }
+
+    if (count >= 2) {
+        if (maxFingers < 2) {
+            pinchStart = distance(points[0], points[1]);
+            pinchReported = 0;
+        }
+        maxFingers = 2;
+        trackPair(ms, points);
+    } else {
+        if (maxFingers < 1) maxFingers = 1;
+        if (maxFingers == 1) trackSingle(ms, points[0]);
+    }
+}
+
+void GestureRecognizer::trackSingle(uint32_t ms, const TouchPoint& point) {
+    last = point;
+    if (!moved && distance(point, start) > GESTURE_TAP_SLOP_PX) {
+        moved = true;
+    }
+
+    if (!moved && !longPressed && ms - downMs >= GESTURE_LONG_PRESS_MS) {
+        longPressed = true;
+        emit(GESTURE_LONG_PRESS, point.x, point.y, 0, ms);
+    }
+
+    if (!onRing || longPressed) return;
+
+    // Near the centre the angle is noise; pick it up again further out
+    if (radiusOf(point) < GESTURE_RING_MIN_RADIUS / 2) {
+        angleValid = false;
+        return;
+    }
+    float angle = angleOf(point);
+    if (angleValid) {
+        float delta = angle - lastAngle;
+        if (delta > 180.0f) delta -= 360.0f;
+        if (delta < -180.0f) delta += 360.0f;
+        arc += delta;
+
+        int16_t steps = (int16_t)(arc / GESTURE_RING_STEP_DEG);
+        if (steps != 0) {
+            arc -= steps * GESTURE_RING_STEP_DEG;
+            rotated = true;
+            emit(GESTURE_ROTATE, point.x, point.y, steps, ms);
+        }
+    }
+    lastAngle = angle;
+    angleValid = true;
+}
+
+void GestureRecognizer::trackPair(uint32_t ms, const TouchPoint* points) {
+    int16_t midX = (points[0].x + points[1].x) / 2;
+    int16_t midY = (points[0].y + points[1].y) / 2;
+    last.x = midX;
+    last.y = midY;
+    if (!moved && distance(points[0], start) > GESTURE_TAP_SLOP_PX) {
+        moved = true;
+    }
+    if (pinchStart <= 0) return;
+
+    int32_t change = (distance(points[0], points[1]) - pinchStart) * 100 / pinchStart;
+    int32_t unreported = change - pinchReported;
+    if (unreported >= GESTURE_PINCH_STEP_PCT || unreported <= -GESTURE_PINCH_STEP_PCT) {
+        pinchReported = change;
+        pinched = true;
+        emit(GESTURE_PINCH, midX, midY, (int16_t)unreported, ms);
+    }
+}
+
+void GestureRecognizer::release(uint32_t ms) {
+    uint32_t held = ms - downMs;
+    down = false;
+
+    if (maxFingers >= 2) {
+        if (!pinched && !moved && held <= GESTURE_TAP_MAX_MS) {
+            emit(GESTURE_TWO_FINGER_TAP, last.x, last.y, 0, ms);
+        }
+        return;
+    }
+    if (rotated || longPressed) return;
+
+    if (!moved) {
+        if (held <= GESTURE_TAP_MAX_MS) {
+            emit(GESTURE_TAP, last.x, last.y, 0, ms);
+        }
+        return;
+    }
+
+    // Drags from the rim belong to the ring, even if they turned < 1 step
+    if (onRing || held > GESTURE_SWIPE_MAX_MS) return;
+
+    int32_t dx = last.x - start.x;
+    int32_t dy = last.y - start.y;
+    int32_t length = distance(last, start);
+    if (length < GESTURE_SWIPE_MIN_PX) return;
+
+    GestureType type;
+    if (abs(dx) >= abs(dy)) {
+        type = dx < 0 ? GESTURE_SWIPE_LEFT : GESTURE_SWIPE_RIGHT;
+    } else {
+        type = dy < 0 ? GESTURE_SWIPE_UP : GESTURE_SWIPE_DOWN;
+    }
+    emit(type, last.x, last.y, (int16_t)length, ms);
+}
+
+void GestureRecognizer::emit(GestureType type, int16_t x, int16_t y, int16_t value, uint32_t ms) {
+    GestureEvent event;
+    event.type = type;
+    event.x = x;
+    event.y = y;
+    event.value = value;
+    event.timestamp = ms;
+    output.push(event);  // Full only if nobody polls; newest is dropped
+}
+
+const char* GestureRecognizer::getName(GestureType type) {
+    switch (type) {
+        case GESTURE_TAP:            return "tap";
+        case GESTURE_LONG_PRESS:     return "long press";
+        case GESTURE_SWIPE_LEFT:     return "swipe left";
+        case GESTURE_SWIPE_RIGHT:    return "swipe right";
+        case GESTURE_SWIPE_UP:       return "swipe up";
+        case GESTURE_SWIPE_DOWN:     return "swipe down";
+        case GESTURE_ROTATE:         return "rotate";
+        case GESTURE_PINCH:          return "pinch";
+        case GESTURE_TWO_FINGER_TAP: return "two-finger tap";
+        default:                     return "none";
+    }
+}
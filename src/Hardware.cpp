@@ -1,4 +1,5 @@
 #include "Hardware.h"
+#include "I2CBus.h"
 #include <esp_sleep.h>
 
 uint8_t Hardware::currentBrightness = DEFAULT_BRIGHTNESS;
@@ -9,6 +10,9 @@ bool Hardware::init() {
     
     M5.begin(cfg);
     
+    // Touch and RFID share M5.In_I2C from different tasks
+    I2CBus::init();
+    
     // Hold power on
     pinMode(POWER_HOLD_PIN, OUTPUT);
     digitalWrite(POWER_HOLD_PIN, HIGH);
@@ -23,31 +27,41 @@ bool Hardware::init() {
     return true;
 }
 
-void Hardware::update() {
-    M5.update();
-}
-
 void Hardware::setBacklight(uint8_t brightness) {
     currentBrightness = brightness;
-    M5.Display.setBrightness(brightness);
+    if (!isSleeping) {
+        M5.Display.setBrightness(brightness);
+    }
 }
 
 uint8_t Hardware::getBacklight() {
     return currentBrightness;
 }
 
+// Lower the backlight without forgetting the setting
+void Hardware::dim(uint8_t brightness) {
+    if (brightness > currentBrightness) brightness = currentBrightness;
+    if (isSleeping) {
+        M5.Display.wakeup();
+        isSleeping = false;
+    }
+    M5.Display.setBrightness(brightness);
+}
+
 void Hardware::sleep() {
     if (!isSleeping) {
-        setBacklight(0);
+        M5.Display.setBrightness(0);
+        M5.Display.sleep();
         isSleeping = true;
     }
 }
 
 void Hardware::wake() {
     if (isSleeping) {
-        setBacklight(currentBrightness);
+        M5.Display.wakeup();
         isSleeping = false;
     }
+    M5.Display.setBrightness(currentBrightness);
 }
 
 void Hardware::powerOn() {
@@ -0,0 +1,39 @@
+#include "I2CBus.h"
+#include <esp_timer.h>
+
+SemaphoreHandle_t I2CBus::mutex = nullptr;
+I2CBusStats I2CBus::stats = {};
+
+void I2CBus::init() {
+    if (!mutex) {
+        mutex = xSemaphoreCreateMutex();
+    }
+}
+
+bool I2CBus::lock(TickType_t wait) {
+    if (!mutex) return true;  // Before init(): only setup() runs
+
+    if (xSemaphoreTake(mutex, 0) == pdTRUE) {
+        stats.acquired++;
+        return true;
+    }
+
+    int64_t start = esp_timer_get_time();
+    if (xSemaphoreTake(mutex, wait) != pdTRUE) {
+        stats.timeouts++;
+        return false;
+    }
+    uint32_t waited = (uint32_t)(esp_timer_get_time() - start);
+    stats.acquired++;
+    stats.contended++;
+    if (waited > stats.maxWaitUs) {
+        stats.maxWaitUs = waited;
+    }
+    return true;
+}
+
+void I2CBus::unlock() {
+    if (mutex) {
+        xSemaphoreGive(mutex);
+    }
+}
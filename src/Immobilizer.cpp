@@ -1,48 +1,85 @@
 #include "Immobilizer.h"
-#include <M5Unified.h>  // M5Unified provides M5.Rfid for M5Dial
-#include <driver/twai.h>  // For CAN SDO commands
-
-// M5Dial has built-in RFID accessible via M5.Rfid API
+#include <M5Unified.h>
 
 Immobilizer::Immobilizer() 
     : unlocked(false), pinEntryMode(false), pinPosition(0), currentDigit(0),
-      lastHeartbeat(0), lastVCUHeartbeat(0) {
+      lastVCUHeartbeat(0), vcuTimer(nullptr), vcuUpSinceMs(0), lastVcuFrameUs(0),
+      vcuAutoLocked(false), canManager(nullptr), limitState(LIMIT_IDLE),
+      limitPending(-1), lastLimitSend(0), limitInterval(IDCMAX_SEND_INTERVAL) {
     // Initialize entered PIN to zeros
     for (int i = 0; i < SECRET_PIN_LENGTH; i++) {
         enteredPIN[i] = 0;
     }
+    memset(&vcu, 0, sizeof(vcu));
+    portMUX_INITIALIZE(&vcuMux);
+    memset(&rfidStatus, 0, sizeof(rfidStatus));
+    publishRfid();
+    memset(&limitStatus, 0, sizeof(limitStatus));
+    limitStatus.acked = -1;
+    publishLimit();
 }
 
-void Immobilizer::init() {
+void Immobilizer::init(CANDataManager* can) {
     Serial.println("=== Immobilizer Init Start ===");
     
+    // idcmax ACKs/aborts come back on the SDO reply ID, handed over by the CAN task
+    canManager = can;
+    if (canManager) {
+        canManager->addFrameListener(SDO_RX_ID, 0x7FF, onSdoReply, this);
+        canManager->addFrameListener(VCU_HEARTBEAT_ID, 0x7FF, onVcuFrame, this);
+    }
+    
+    // Armed by the first 0x500 frame; no VCU on the bus means no auto-lock
+    esp_timer_create_args_t timerArgs;
+    memset(&timerArgs, 0, sizeof(timerArgs));
+    timerArgs.callback = onVcuTimeout;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "vcu_watchdog";
+    if (esp_timer_create(&timerArgs, &vcuTimer) != ESP_OK) {
+        vcuTimer = nullptr;
+        Serial.println("[IMMOBILIZER] VCU watchdog timer unavailable");
+    }
+    
     #if RFID_ENABLED
     Serial.println("Initializing M5Dial WS1850S RFID...");
-    Serial.println("Using M5.Rfid API from M5Unified");
-    
-    // M5.Rfid should be initialized by M5.begin()
-    // Just verify it's available
     
-    delay(100);
+    // Anyone can program a tag with a published example UID
+    if (hasExampleUIDs()) {
+        Serial.println("[RFID] AUTHORIZED_UIDS still holds the example UIDs - RFID disabled");
+        rfidStatus.present = false;
+    } else {
+        rfidStatus.present = rfid.begin(RFID_I2C_ADDR, RFID_IRQ_PIN);
+    }
+    rfidStatus.version = rfid.getVersion();
     
-    Serial.println("===========================================");
-    Serial.println("✓ RFID Ready (WS1850S @ 0x28)");
-    Serial.println(">>> Place RFID card on BACK of M5Dial <<<");
-    Serial.println();
-    Serial.println("Authorized UIDs:");
-    for (int i = 0; i < sizeof(AUTHORIZED_UIDS) / sizeof(AUTHORIZED_UIDS[0]); i++) {
-        Serial.print("  Card ");
-        Serial.print(i + 1);
-        Serial.print(": ");
-        for (int j = 0; j < 4; j++) {
-            if (AUTHORIZED_UIDS[i][j] < 0x10) Serial.print("0");
-            Serial.print(AUTHORIZED_UIDS[i][j], HEX);
-            if (j < 3) Serial.print(" ");
-        }
+    if (rfidStatus.present) {
+        Serial.println("===========================================");
+        Serial.printf("✓ RFID Ready (WS1850S @ 0x%02X, version 0x%02X, %s)\n",
+                      RFID_I2C_ADDR, rfidStatus.version, RFID_IRQ_PIN >= 0 ? "IRQ" : "no IRQ pin");
+        Serial.println(">>> Place RFID card on BACK of M5Dial <<<");
         Serial.println();
+        Serial.println("Authorized UIDs:");
+        for (int i = 0; i < sizeof(AUTHORIZED_UIDS) / sizeof(AUTHORIZED_UIDS[0]); i++) {
+            Serial.print("  Card ");
+            Serial.print(i + 1);
+            Serial.print(": ");
+            for (int j = 0; j < 4; j++) {
+                if (AUTHORIZED_UIDS[i][j] < 0x10) Serial.print("0");
+                Serial.print(AUTHORIZED_UIDS[i][j], HEX);
+                if (j < 3) Serial.print(" ");
+            }
+            Serial.println();
+        }
+        Serial.println("\nNote: Ghost reads (20 20 20 20) are filtered");
+        Serial.println("===========================================");
+        
+        xTaskCreatePinnedToCore(rfidTask, "rfid", RFID_TASK_STACK, this,
+                                RFID_TASK_PRIORITY, nullptr, RFID_TASK_CORE);
+    } else if (!hasExampleUIDs()) {
+        Serial.println("[RFID] No WS1850S at 0x28 - RFID disabled");
     }
-    Serial.println("\nNote: Ghost reads (20 20 20 20) are filtered");
-    Serial.println("===========================================");
+    publishRfid();
     #else
     Serial.println("RFID disabled in config");
     #endif
@@ -56,55 +93,25 @@ void Immobilizer::init() {
 }
 
 void Immobilizer::update() {
-    // Send idcmax continuously via CAN mapping
-    static uint32_t lastSend = 0;
-    if (millis() - lastSend > IDCMAX_SEND_INTERVAL) {
-        lastSend = millis();
-        sendCurrentLimit();  // Send idcmax via CAN
-    }
+    // Keep idcmax asserted (ACK-tracked, never waits for the reply)
+    updateCurrentLimit(millis());
+    publishLimit();
     
-    // Check for VCU timeout (auto-lock if ignition off)
-    // TODO: Monitor specific 0x500 ID when implemented
-    // TEMPORARILY DISABLED - auto-locking too aggressive without real VCU
-    /*
-    if (unlocked && !isVCUActive()) {
-        Serial.println("VCU heartbeat timeout - AUTO-LOCKING");
+    // The watchdog already dropped the unlock; finish the lock here
+    if (vcuAutoLocked) {
+        vcuAutoLocked = false;
         lock();
+        Serial.printf("[IMMOBILIZER] VCU heartbeat lost for %d ms - AUTO-LOCKED (+%lu us)\n",
+                      VCU_TIMEOUT_MS, (unsigned long)vcu.lastLatencyUs);
     }
-    */
-    
-    // Check RFID if enabled
-    #if RFID_ENABLED
-    static uint32_t lastRfidCheck = 0;
-    static uint32_t rfidCheckCount = 0;
-    static uint32_t lastCardTime = 0;
-    
-    // Check every 500ms and print status every 10 seconds
-    if (millis() - lastRfidCheck > 500) {
-        lastRfidCheck = millis();
-        rfidCheckCount++;
-        
-        // Print RFID status every 20 checks (10 seconds)
-        if (rfidCheckCount % 20 == 0) {
-            Serial.println("[RFID] Scanning for cards...");
-        }
-        
-        if (checkRFID()) {
-            // Debounce - only act if at least 2 seconds since last card
-            if (millis() - lastCardTime > 2000) {
-                lastCardTime = millis();
-                
-                if (unlocked) {
-                    lock();
-                    Serial.println("RFID toggle - LOCKED");
-                } else {
-                    unlock();
-                    Serial.println("RFID toggle - UNLOCKED");
-                }
-            }
-        }
-    }
-    #endif
+}
+
+void Immobilizer::schedule(Scheduler* sched) {
+    sched->addJob("immobilizer", updateJobFn, this, IMMOBILIZER_UPDATE_MS, JOB_PRIORITY_NORMAL);
+}
+
+void Immobilizer::updateJobFn(void* context) {
+    ((Immobilizer*)context)->update();
 }
 
 void Immobilizer::lock() {
@@ -112,7 +119,7 @@ void Immobilizer::lock() {
     pinEntryMode = false;
     clearPIN();
     Serial.println(">>> IMMOBILIZER LOCKED <<<");
-    Serial.println("[IMMOBILIZER] Will send idcmax=0 via CAN mapping");
+    Serial.printf("[IMMOBILIZER] Will send idcmax=%d\n", CURRENT_LOCKED);
 }
 
 void Immobilizer::unlock() {
@@ -120,81 +127,121 @@ void Immobilizer::unlock() {
     pinEntryMode = false;
     clearPIN();
     Serial.println(">>> IMMOBILIZER UNLOCKED <<<");
-    Serial.println("[IMMOBILIZER] Will send idcmax=500 via CAN mapping");
+    Serial.printf("[IMMOBILIZER] Will send idcmax=%d\n", CURRENT_UNLOCKED);
 }
 
-void Immobilizer::sendCurrentLimit() {
-    // Send idcmax via SDO Write to parameter 37
-    // HYPOTHESIS: idcmax might NOT use fixed-point encoding!
-    // Trying RAW value (500, not 16000)
+// Write idcmax every IDCMAX_SEND_INTERVAL while the inverter acknowledges it.
+// A write without an ACK within IDCMAX_ACK_TIMEOUT_MS, or an abort, doubles
+// the interval up to IDCMAX_RETRY_MAX_MS; a lock/unlock is sent at once.
+void Immobilizer::updateCurrentLimit(uint32_t now) {
+    int32_t target = unlocked ? CURRENT_UNLOCKED : CURRENT_LOCKED;
     
-    int16_t current = unlocked ? CURRENT_UNLOCKED : CURRENT_LOCKED;
+    if (limitState == LIMIT_WAIT_ACK) {
+        if (now - lastLimitSend < IDCMAX_ACK_TIMEOUT_MS) {
+            return;
+        }
+        limitStatus.timeouts++;
+        limitFailed();
+    }
     
-    // TRY WITHOUT FIXED-POINT ENCODING
-    int32_t encodedValue = current;  // Send 500 directly, not 500*32
+    if (target == limitPending && now - lastLimitSend < limitInterval) {
+        return;
+    }
     
-    twai_message_t msg;
-    msg.identifier = 0x603;  // SDO TX to node 3
-    msg.extd = 0;
-    msg.rtr = 0;
-    msg.data_length_code = 8;
+    // Same SDO channel - never interleave with a transfer another task runs
+    if (!canManager || canManager->getSDO().isTransferActive()) {
+        return;
+    }
+    sendCurrentLimit(target, now);
+}
+
+void Immobilizer::sendCurrentLimit(int32_t current, uint32_t now) {
+    // idcmax takes the raw value (500, not 500*32)
+    uint8_t data[8] = { SDO_CMD_WRITE, SDO_FIXED_BYTE1, SDO_FIXED_BYTE2, IDCMAX_PARAM_ID,
+                        (uint8_t)current, (uint8_t)(current >> 8),
+                        (uint8_t)(current >> 16), (uint8_t)(current >> 24) };
     
-    // SDO Write format - BACK TO PARAMETER 37, NO ENCODING
-    msg.data[0] = 0x23;  // SDO write 4 bytes
-    msg.data[1] = 0x00;  // Index low byte (0x2100)
-    msg.data[2] = 0x21;  // Index high byte (0x2100)
-    msg.data[3] = 37;    // Subindex = parameter ID 37 (idcmax "i" field)
-    msg.data[4] = encodedValue & 0xFF;
-    msg.data[5] = (encodedValue >> 8) & 0xFF;
-    msg.data[6] = (encodedValue >> 16) & 0xFF;
-    msg.data[7] = (encodedValue >> 24) & 0xFF;
+    // TX queue full: nothing changes, so the next cycle tries again
+    if (!canManager->sendMessage(SDO_TX_ID, data, sizeof(data))) {
+        return;
+    }
+    limitPending = current;
+    lastLimitSend = now;
+    limitState = LIMIT_WAIT_ACK;
+    limitStatus.sent++;
+}
+
+void Immobilizer::limitFailed() {
+    limitState = LIMIT_IDLE;
+    if (limitStatus.failures < 255) {
+        limitStatus.failures++;
+    }
     
-    if (twai_transmit(&msg, pdMS_TO_TICKS(10)) == ESP_OK) {
-        // Wait briefly for response (to check for errors)
-        twai_message_t rxMsg;
-        uint32_t startTime = millis();
-        while (millis() - startTime < 50) {  // 50ms timeout
-            if (twai_receive(&rxMsg, pdMS_TO_TICKS(5)) == ESP_OK) {
-                if (rxMsg.identifier == 0x583 &&  // SDO response from node 3
-                    rxMsg.data[1] == 0x00 &&
-                    rxMsg.data[2] == 0x21 &&
-                    rxMsg.data[3] == 37) {  // Response to our idcmax write
-                    
-                    if (rxMsg.data[0] == 0x60) {
-                        // Success response
-                        Serial.println("[IMMOBILIZER] ✓ SDO Write ACK received!");
-                    } else if (rxMsg.data[0] == 0x80) {
-                        // Abort response - ERROR!
-                        uint32_t abortCode = rxMsg.data[4] | 
-                                           (rxMsg.data[5] << 8) | 
-                                           (rxMsg.data[6] << 16) | 
-                                           (rxMsg.data[7] << 24);
-                        Serial.printf("[IMMOBILIZER] ✗ SDO ABORT! Code: 0x%08X\n", abortCode);
-                        if (abortCode == 0x06090011) Serial.println("  -> Subindex does not exist");
-                        if (abortCode == 0x06010000) Serial.println("  -> Unsupported access");
-                        if (abortCode == 0x06090030) Serial.println("  -> Value range exceeded");
-                        if (abortCode == 0x08000020) Serial.println("  -> Data cannot be transferred");
-                        if (abortCode == 0x08000021) Serial.println("  -> Data cannot be transferred (local control)");
-                        if (abortCode == 0x08000022) Serial.println("  -> Data cannot be transferred (device state)");
-                    }
-                    break;
-                }
-            }
-        }
+    // 200, 400, 800 ... ms between writes until one is acknowledged again
+    uint8_t shift = limitStatus.failures < 8 ? limitStatus.failures : 8;
+    limitInterval = (uint32_t)IDCMAX_SEND_INTERVAL << shift;
+    if (limitInterval > IDCMAX_RETRY_MAX_MS) {
+        limitInterval = IDCMAX_RETRY_MAX_MS;
     }
     
-    // Debug output
-    Serial.println("========================================");
-    Serial.printf("[IMMOBILIZER] Status: %s\n", unlocked ? "UNLOCKED" : "LOCKED");
-    Serial.printf("[IMMOBILIZER] Target idcmax: %dA (RAW, no encoding)\n", current);
-    Serial.printf("[IMMOBILIZER] SDO TX: ID=0x603 Param=37 Len=8\n");
-    Serial.print("[IMMOBILIZER] Data: [");
-    for (int i = 0; i < 8; i++) {
-        Serial.printf("%02X", msg.data[i]);
-        if (i < 7) Serial.print(" ");
-    }
-    Serial.println("]");
-    Serial.println("========================================");
+    if (!limitStatus.alarm && limitStatus.failures >= IDCMAX_ALARM_MISSES) {
+        limitStatus.alarm = true;
+        Serial.printf("[IMMOBILIZER] ALARM: idcmax=%d not acknowledged %d times in a row\n",
+                      limitPending, limitStatus.failures);
+    }
+}
+
+// CAN task, for every frame on SDO_RX_ID
+void Immobilizer::onSdoReply(const CANMessage& msg, void* context) {
+    Immobilizer* self = (Immobilizer*)context;
+    if (self->limitState != LIMIT_WAIT_ACK || msg.length < 8 ||
+        msg.data[1] != SDO_FIXED_BYTE1 || msg.data[2] != SDO_FIXED_BYTE2 ||
+        msg.data[3] != IDCMAX_PARAM_ID) {
+        return;
+    }
+    
+    CurrentLimitStatus& status = self->limitStatus;
+    uint32_t now = millis();
+    
+    if (msg.data[0] == SDO_RESP_WRITE) {
+        uint32_t latency = now - self->lastLimitSend;
+        if (latency > status.ackLatencyMaxMs) {
+            status.ackLatencyMaxMs = latency > 0xFFFF ? 0xFFFF : latency;
+        }
+        
+        #if DEBUG_SERIAL
+        if (status.alarm) {
+            Serial.println("[IMMOBILIZER] idcmax acknowledged again, alarm cleared");
+        }
+        if (status.acked != self->limitPending) {
+            Serial.printf("[IMMOBILIZER] idcmax=%d acknowledged (%lu ms)\n",
+                          self->limitPending, (unsigned long)latency);
+        }
+        #endif
+        
+        status.acked = self->limitPending;
+        status.lastAck = now;
+        status.acks++;
+        status.failures = 0;
+        status.alarm = false;
+        self->limitInterval = IDCMAX_SEND_INTERVAL;
+        self->limitState = LIMIT_IDLE;
+    } else if (msg.data[0] == SDO_RESP_ABORT) {
+        status.aborts++;
+        status.lastAbortCode = (uint32_t)msg.data[4] | ((uint32_t)msg.data[5] << 8) |
+                               ((uint32_t)msg.data[6] << 16) | ((uint32_t)msg.data[7] << 24);
+        #if DEBUG_SERIAL
+        Serial.printf("[IMMOBILIZER] idcmax=%d aborted: 0x%08X\n", self->limitPending, status.lastAbortCode);
+        #endif
+        self->limitFailed();
+    }
+    self->publishLimit();
+}
+
+// CAN task only (and the constructor, before it runs)
+void Immobilizer::publishLimit() {
+    limitSnapshot.beginWrite() = limitStatus;
+    limitSnapshot.endWrite();
 }
 
 void Immobilizer::toggleLock() {
@@ -241,102 +288,176 @@ bool Immobilizer::validatePIN() {
     return true;
 }
 
-void Immobilizer::processCANMessage(uint32_t id, uint8_t* data, uint8_t len) {
+void Immobilizer::processCANMessage(uint32_t id, const uint8_t* data, uint8_t len) {
     // Monitor for VCU heartbeat (0x500)
-    if (id == VCU_HEARTBEAT_ID) {
-        lastVCUHeartbeat = millis();
-        
-        // Optional: Log VCU heartbeat
-        // Serial.printf("VCU heartbeat received at %lu\n", lastVCUHeartbeat);
+    if (id != VCU_HEARTBEAT_ID) {
+        return;
+    }
+    uint32_t now = millis();
+    lastVCUHeartbeat = now;
+    bool armed = false;
+    
+    portENTER_CRITICAL(&vcuMux);
+    lastVcuFrameUs = (uint32_t)esp_timer_get_time();
+    vcu.frames++;
+    if (vcu.streak < 0xFFFF) {
+        vcu.streak++;
+    }
+    if (vcu.streak == 1) {
+        vcuUpSinceMs = now;
+    }
+    
+    // Hysteresis: VCU_ONLINE_FRAMES to arm at all, and once the VCU has
+    // dropped out, VCU_REARM_MS without a gap as well. A VCU that keeps
+    // dropping out stays disarmed instead of cutting current each time.
+    if (!vcu.online && vcu.streak >= VCU_ONLINE_FRAMES &&
+        (vcu.timeouts == 0 || now - vcuUpSinceMs >= VCU_REARM_MS)) {
+        vcu.online = true;
+        armed = true;
+    }
+    portEXIT_CRITICAL(&vcuMux);
+    
+    #if DEBUG_SERIAL
+    if (armed) {
+        Serial.println("[IMMOBILIZER] VCU heartbeat online, watchdog armed");
+    }
+    #endif
+    
+    // Push the deadline out to VCU_TIMEOUT_MS after this frame
+    if (vcuTimer) {
+        esp_timer_stop(vcuTimer);
+        esp_timer_start_once(vcuTimer, (uint64_t)VCU_TIMEOUT_MS * 1000);
     }
 }
 
-void Immobilizer::sendHeartbeat() {
-    uint32_t now = millis();
+// CAN task, for every VCU_HEARTBEAT_ID frame
+void Immobilizer::onVcuFrame(const CANMessage& msg, void* context) {
+    ((Immobilizer*)context)->processCANMessage(msg.id, msg.data, msg.length);
+}
+
+// esp_timer task, VCU_TIMEOUT_MS after the last 0x500 frame
+void Immobilizer::onVcuTimeout(void* arg) {
+    Immobilizer* self = (Immobilizer*)arg;
     
-    // Send every HEARTBEAT_INTERVAL ms
-    if (now - lastHeartbeat >= HEARTBEAT_INTERVAL) {
-        lastHeartbeat = now;
-        
-        // Prepare CAN message for ID 0x351
-        uint8_t data[8] = {0};
-        
-        // Bytes 4 and 5 contain the current limit
-        if (unlocked) {
-            data[4] = 0xD0;  // 200A low byte (0x07D0 = 2000 = 200.0A)
-            data[5] = 0x07;  // 200A high byte
-        } else {
-            data[4] = 0x00;  // 0A (locked - no current allowed)
-            data[5] = 0x00;
+    portENTER_CRITICAL(&self->vcuMux);
+    uint32_t sinceUs = (uint32_t)esp_timer_get_time() - self->lastVcuFrameUs;
+    
+    // A frame came in on the other core while this was being dispatched
+    if (sinceUs < (uint32_t)VCU_TIMEOUT_MS * 1000) {
+        portEXIT_CRITICAL(&self->vcuMux);
+        return;
+    }
+    
+    VcuWatchdogStatus& status = self->vcu;
+    status.timeouts++;
+    status.lastLatencyUs = sinceUs - (uint32_t)VCU_TIMEOUT_MS * 1000;
+    if (status.lastLatencyUs > status.maxLatencyUs) {
+        status.maxLatencyUs = status.lastLatencyUs;
+    }
+    
+    bool wasOnline = status.online;
+    status.online = false;
+    status.streak = 0;
+    
+    // Cut current now (the heartbeat task reads this); update() does the rest
+    if (wasOnline && self->unlocked) {
+        self->unlocked = false;
+        status.autoLocks++;
+        self->vcuAutoLocked = true;
+    }
+    portEXIT_CRITICAL(&self->vcuMux);
+}
+
+void Immobilizer::getVcuStatus(VcuWatchdogStatus& out) {
+    portENTER_CRITICAL(&vcuMux);
+    out = vcu;
+    portEXIT_CRITICAL(&vcuMux);
+}
+
+// RFID task (core 0): probe, then sleep. The bus is only held for the
+// register writes around each exchange, never while waiting on the card.
+void Immobilizer::rfidTask(void* arg) {
+    Immobilizer* self = (Immobilizer*)arg;
+    for (;;) {
+        bool acted = self->checkRFID();
+        self->publishRfid();
+        if (acted) {
+            vTaskDelay(pdMS_TO_TICKS(RFID_CARD_HOLDOFF_MS));
         }
-        
-        // TODO: Send via CAN bus
-        // This will be called from main.cpp where CAN access is available
-        // Example: twai_transmit(&message, pdMS_TO_TICKS(10));
+        vTaskDelay(pdMS_TO_TICKS(RFID_PROBE_INTERVAL_MS));
     }
 }
 
+void Immobilizer::publishRfid() {
+    rfidSnapshot.beginWrite() = rfidStatus;
+    rfidSnapshot.endWrite();
+}
+
 bool Immobilizer::checkRFID() {
     #if RFID_ENABLED
-    // Check for new card using M5.Rfid API
-    if (!M5.Rfid.PICC_IsNewCardPresent()) {
+    if (!rfidStatus.present) {
         return false;
     }
     
-    if (!M5.Rfid.PICC_ReadCardSerial()) {
+    int64_t answeredUs;
+    rfidStatus.probes++;
+    if (!rfid.probe(RFID_FIELD_SETTLE_MS, RFID_RESPONSE_MS, answeredUs)) {
         return false;
     }
     
-    // Read UID and check for ghost read (0x20 0x20 0x20 0x20)
     uint8_t uid[4];
-    bool isValid = false;
-    
-    for (byte i = 0; i < M5.Rfid.uid.size && i < 4; i++) {
-        uid[i] = M5.Rfid.uid.uidByte[i];
-        
-        // If any byte is NOT 0x20, it's likely a real card
-        if (uid[i] != 0x20) {
-            isValid = true;
-        }
+    bool read = rfid.readUid(uid, RFID_RESPONSE_MS);
+    rfid.fieldOff();
+    if (!read) {
+        rfidStatus.readErrors++;
+        return false;
     }
     
-    // Filter ghost reads
-    if (!isValid) {
+    // Filter ghost reads (0x20 0x20 0x20 0x20)
+    if (uid[0] == 0x20 && uid[1] == 0x20 && uid[2] == 0x20 && uid[3] == 0x20) {
+        rfidStatus.ghosts++;
         Serial.println("[RFID] Ghost read detected (20 20 20 20), ignoring...");
-        M5.Rfid.PICC_HaltA();
-        M5.Rfid.PCD_StopCrypto1();
         return false;
     }
+    rfidStatus.cards++;
     
-    // Valid card detected
-    Serial.println(">>> RFID: Real card detected! <<<");
-    Serial.print("Card UID:");
-    for (int i = 0; i < 4; i++) {
-        if (uid[i] < 0x10) Serial.print(" 0");
-        else Serial.print(" ");
-        Serial.print(uid[i], HEX);
+    if (!checkAuthorizedUID(uid)) {
+        rfidStatus.rejected++;
+        Serial.printf("[RFID] Card %02X %02X %02X %02X: UNAUTHORIZED\n", uid[0], uid[1], uid[2], uid[3]);
+        return true;
     }
-    Serial.println();
+    rfidStatus.authorized++;
+    toggleLock();
     
-    // Check if authorized
-    bool authorized = checkAuthorizedUID(uid);
-    
-    // Halt card
-    M5.Rfid.PICC_HaltA();
-    M5.Rfid.PCD_StopCrypto1();
-    
-    if (authorized) {
-        Serial.println(">>> AUTHORIZED! <<<");
-        return true;
-    } else {
-        Serial.println(">>> UNAUTHORIZED! <<<");
-        return false;
+    uint32_t latency = (uint32_t)(esp_timer_get_time() - answeredUs);
+    rfidStatus.lastLatencyUs = latency;
+    if (latency > rfidStatus.maxLatencyUs) {
+        rfidStatus.maxLatencyUs = latency;
     }
+    Serial.printf("[RFID] Card %02X %02X %02X %02X: %s %lu us after it answered\n",
+                  uid[0], uid[1], uid[2], uid[3], unlocked ? "UNLOCKED" : "LOCKED",
+                  (unsigned long)latency);
+    return true;
     #endif
     
     return false;
 }
 
+bool Immobilizer::hasExampleUIDs() {
+    static const uint8_t examples[][4] = {
+        {0xDE, 0xAD, 0xBE, 0xEF},
+        {0xCA, 0xFE, 0xBA, 0xBE},
+    };
+    for (int i = 0; i < NUM_AUTHORIZED_UIDS; i++) {
+        for (int e = 0; e < 2; e++) {
+            if (memcmp(AUTHORIZED_UIDS[i], examples[e], 4) == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 bool Immobilizer::checkAuthorizedUID(uint8_t* uid) {
     for (int i = 0; i < NUM_AUTHORIZED_UIDS; i++) {
         bool match = true;
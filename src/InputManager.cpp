@@ -1,27 +1,72 @@
 #include "InputManager.h"
 #include "Config.h"
+#include "I2CBus.h"
 #include <M5Unified.h>
+#include <esp_timer.h>
+
+#define ENCODER_PCNT_UNIT PCNT_UNIT_0
 
 InputManager* InputManager::instance = nullptr;
 
 InputManager::InputManager() 
-    : lastEncoderPosition(0), touchPressed(false), 
-      lastTouchX(0), lastTouchY(0), touchPressTime(0),
-      eventHead(0), eventTail(0),
-      onEncoderRotate(nullptr), onButtonClick(nullptr),
-      onButtonDoubleClick(nullptr), onButtonLongPress(nullptr),
-      onTouchTap(nullptr),
+    : encoderPosition(0), detentsDropped(0), lastDetentUs(0), lastDirection(0),
+      inputTimeUs(0), inputTimePending(false), touchPressed(false), 
+      lastTouchX(0), lastTouchY(0), lastEventMs(0),
       button(ENCODER_BUTTON, true, true) {
     instance = this;
+    memset(&encoderStats, 0, sizeof(encoderStats));
 }
 
 bool InputManager::init() {
-    // Initialize encoder
-    ESP32Encoder::useInternalWeakPullResistors = puType::up;
-    encoder.attachFullQuad(ENCODER_PIN_A, ENCODER_PIN_B);
-    encoder.clearCount();
-    encoder.setCount(0);
-    lastEncoderPosition = 0;
+    // Initialize encoder: full quadrature on both PCNT channels (the same
+    // edge/direction setup ESP32Encoder's attachFullQuad used)
+    pcnt_config_t channel;
+    memset(&channel, 0, sizeof(channel));
+    channel.unit = ENCODER_PCNT_UNIT;
+    channel.counter_h_lim = ENCODER_COUNTS_PER_DETENT;
+    channel.counter_l_lim = -ENCODER_COUNTS_PER_DETENT;
+    
+    channel.channel = PCNT_CHANNEL_0;
+    channel.pulse_gpio_num = ENCODER_PIN_A;
+    channel.ctrl_gpio_num = ENCODER_PIN_B;
+    channel.pos_mode = PCNT_COUNT_DEC;
+    channel.neg_mode = PCNT_COUNT_INC;
+    channel.lctrl_mode = PCNT_MODE_KEEP;
+    channel.hctrl_mode = PCNT_MODE_REVERSE;
+    pcnt_unit_config(&channel);
+    
+    channel.channel = PCNT_CHANNEL_1;
+    channel.pulse_gpio_num = ENCODER_PIN_B;
+    channel.ctrl_gpio_num = ENCODER_PIN_A;
+    channel.pos_mode = PCNT_COUNT_DEC;
+    channel.neg_mode = PCNT_COUNT_INC;
+    channel.lctrl_mode = PCNT_MODE_REVERSE;
+    channel.hctrl_mode = PCNT_MODE_KEEP;
+    pcnt_unit_config(&channel);
+    
+    gpio_pullup_en((gpio_num_t)ENCODER_PIN_A);
+    gpio_pullup_en((gpio_num_t)ENCODER_PIN_B);
+    pcnt_set_filter_value(ENCODER_PCNT_UNIT, ENCODER_FILTER_TICKS);
+    pcnt_filter_enable(ENCODER_PCNT_UNIT);
+    
+    // Reaching +/-4 resets the counter and raises the event: one per detent
+    pcnt_counter_pause(ENCODER_PCNT_UNIT);
+    pcnt_counter_clear(ENCODER_PCNT_UNIT);
+    pcnt_event_enable(ENCODER_PCNT_UNIT, PCNT_EVT_H_LIM);
+    pcnt_event_enable(ENCODER_PCNT_UNIT, PCNT_EVT_L_LIM);
+    pcnt_isr_service_install(0);
+    pcnt_isr_handler_add(ENCODER_PCNT_UNIT, onPcntEvent, this);
+    pcnt_counter_resume(ENCODER_PCNT_UNIT);
+    
+    // Touch: INT held low for as long as a finger is down (FT6336U polling
+    // mode, G_MODE=0), so checkTouch() can skip the bus while it is high
+    #if TOUCH_USE_INT
+    pinMode(TOUCH_INT, INPUT_PULLUP);
+    {
+        I2CBusLock bus;
+        M5.In_I2C.writeRegister8(TOUCH_I2C_ADDR, 0xA4, 0x00, 400000);
+    }
+    #endif
     
     // Initialize button
     button.attachClick(buttonClickCallback);
@@ -41,156 +86,212 @@ void InputManager::update() {
     // Update button
     button.tick();
     
-    // Check encoder with sensitivity adjustment
-    // The encoder is in 4x quadrature mode, so divide by 4 for proper sensitivity
-    int32_t rawPosition = encoder.getCount();
-    int32_t currentPosition = rawPosition / 4;  // Divide by 4 to get actual detent clicks
+    checkEncoder();
+    
+    // Check touch
+    checkTouch();
+}
+
+// PCNT ISR: the counter just hit a limit and went back to 0
+void IRAM_ATTR InputManager::onPcntEvent(void* arg) {
+    InputManager* self = (InputManager*)arg;
+    uint32_t status = 0;
+    pcnt_get_event_status(ENCODER_PCNT_UNIT, &status);
+    
+    EncoderDetent detent;
+    detent.timeUs = (uint32_t)esp_timer_get_time();
+    if (status & PCNT_EVT_H_LIM) {
+        detent.direction = 1;
+    } else if (status & PCNT_EVT_L_LIM) {
+        detent.direction = -1;
+    } else {
+        return;
+    }
     
-    // Debug every 2 seconds (not 500ms)
-    static uint32_t lastDebugTime = 0;
-    if (millis() - lastDebugTime > 2000) {
-        Serial.printf("[ENC] raw=%d divided=%d last=%d\n", rawPosition, currentPosition, lastEncoderPosition);
-        lastDebugTime = millis();
+    self->encoderPosition += detent.direction;
+    if (!self->detents.push(detent)) {
+        self->detentsDropped++;
     }
+}
+
+// Steps for one detent, from the time since the previous one
+int32_t InputManager::accelerate(uint32_t intervalUs) {
+    const uint32_t slowUs = ENCODER_ACCEL_SLOW_MS * 1000;
+    const uint32_t fastUs = ENCODER_ACCEL_FAST_MS * 1000;
     
-    if (currentPosition != lastEncoderPosition) {
-        int32_t delta = currentPosition - lastEncoderPosition;
-        lastEncoderPosition = currentPosition;
-        
-        Serial.println("========================================");
-        Serial.printf("ENCODER ROTATED: raw_delta=%d, actual_delta=%d\n", rawPosition, delta);
-        Serial.println("========================================");
+    if (intervalUs >= slowUs) return 1;
+    if (intervalUs <= fastUs) return ENCODER_ACCEL_MAX;
+    return 1 + (int32_t)((ENCODER_ACCEL_MAX - 1) * (slowUs - intervalUs) / (slowUs - fastUs));
+}
+
+// Hand the queued detents over as one event per run in the same direction
+void InputManager::checkEncoder() {
+    encoderStats.dropped = detentsDropped;
+    
+    EncoderDetent detent;
+    int32_t delta = 0;
+    int32_t steps = 0;
+    uint32_t firstUs = 0;
+    
+    while (true) {
+        bool more = detents.pop(detent);
         
-        InputEvent event;
-        event.type = (delta > 0) ? INPUT_ENCODER_CW : INPUT_ENCODER_CCW;
-        event.encoderDelta = delta;
-        event.timestamp = millis();
-        enqueueEvent(event);
+        // Direction changed (or queue drained): deliver what we have
+        if (delta != 0 && (!more || detent.direction != lastDirection)) {
+            InputEvent event;
+            event.type = (delta > 0) ? INPUT_ENCODER_CW : INPUT_ENCODER_CCW;
+            event.encoderDelta = delta;
+            event.encoderSteps = steps;
+            event.timestamp = millis();
+            enqueueEvent(event);
+            
+            encoderStats.events++;
+            uint16_t count = delta > 0 ? delta : -delta;
+            if (count > encoderStats.maxPerEvent) {
+                encoderStats.maxPerEvent = count;
+            }
+            if (!inputTimePending) {
+                inputTimeUs = firstUs;
+                inputTimePending = true;
+            }
+            delta = 0;
+            steps = 0;
+        }
+        if (!more) {
+            break;
+        }
         
-        if (onEncoderRotate) {
-            onEncoderRotate(delta);
+        uint32_t interval = detent.timeUs - lastDetentUs;
+        int32_t step = (detent.direction == lastDirection) ? accelerate(interval) : 1;
+        if (delta == 0) {
+            firstUs = detent.timeUs;
         }
+        delta += detent.direction;
+        steps += detent.direction * step;
+        lastDetentUs = detent.timeUs;
+        lastDirection = detent.direction;
+        encoderStats.detents++;
     }
-    
-    // Check touch
-    checkTouch();
 }
 
+bool InputManager::takeInputTime(uint32_t& timeUs) {
+    if (!inputTimePending) {
+        return false;
+    }
+    timeUs = inputTimeUs;
+    inputTimePending = false;
+    return true;
+}
+
+// The only touch read per UI cycle (nothing else calls M5.update())
 void InputManager::checkTouch() {
-    M5.update(); // Update touch state
+    #if TOUCH_USE_INT
+    // Nothing touched now or last cycle: no need to ask the controller
+    if (!touchPressed && digitalRead(TOUCH_INT) == HIGH) {
+        return;
+    }
+    #endif
     
-    auto touch = M5.Touch.getDetail();
+    {
+        I2CBusLock bus;  // FT6336U shares the bus with the RFID reader
+        M5.update(); // Update touch state
+    }
+    
+    TouchPoint points[GESTURE_MAX_POINTS];
+    uint8_t count = M5.Touch.getCount();
+    if (count > GESTURE_MAX_POINTS) count = GESTURE_MAX_POINTS;
+    for (uint8_t i = 0; i < count; i++) {
+        auto touch = M5.Touch.getDetail(i);
+        points[i].x = touch.x;
+        points[i].y = touch.y;
+    }
+    uint32_t now = millis();
+    
+    #if DEBUG_TOUCH
+    // One line per sample - the trace format the gesture tests replay
+    Serial.printf("[TOUCH] %lu,%u,%d,%d,%d,%d\n", (unsigned long)now, count,
+                  count > 0 ? points[0].x : 0, count > 0 ? points[0].y : 0,
+                  count > 1 ? points[1].x : 0, count > 1 ? points[1].y : 0);
+    #endif
     
-    if (touch.wasPressed()) {
+    if (count > 0 && !touchPressed) {
         touchPressed = true;
-        lastTouchX = touch.x;
-        lastTouchY = touch.y;
-        touchPressTime = millis();
+        lastTouchX = points[0].x;
+        lastTouchY = points[0].y;
         
         InputEvent event;
         event.type = INPUT_TOUCH_PRESS;
-        event.touchX = touch.x;
-        event.touchY = touch.y;
-        event.timestamp = millis();
+        event.touchX = points[0].x;
+        event.touchY = points[0].y;
+        event.timestamp = now;
         enqueueEvent(event);
+    } else if (count == 0 && touchPressed) {
+        touchPressed = false;
         
-        #if DEBUG_TOUCH
-        Serial.printf("Touch press: %d, %d\n", touch.x, touch.y);
-        #endif
-    }
-    else if (touch.wasReleased()) {
         InputEvent event;
         event.type = INPUT_TOUCH_RELEASE;
-        event.touchX = touch.x;
-        event.touchY = touch.y;
-        event.timestamp = millis();
+        event.touchX = lastTouchX;
+        event.touchY = lastTouchY;
+        event.timestamp = now;
+        enqueueEvent(event);
+    }
+    if (count > 0) {
+        lastTouchX = points[0].x;
+        lastTouchY = points[0].y;
+    }
+    
+    gestures.feed(now, count, points);
+    
+    GestureEvent gesture;
+    while (gestures.poll(gesture)) {
+        InputEvent event;
+        event.type = (gesture.type == GESTURE_TAP) ? INPUT_TOUCH_TAP : INPUT_TOUCH_GESTURE;
+        event.touchX = gesture.x;
+        event.touchY = gesture.y;
+        event.gesture = gesture.type;
+        event.gestureValue = gesture.value;
+        event.timestamp = gesture.timestamp;
         enqueueEvent(event);
         
-        // Check for tap (quick press/release)
-        if (millis() - touchPressTime < 300) {
-            InputEvent tapEvent;
-            tapEvent.type = INPUT_TOUCH_TAP;
-            tapEvent.touchX = touch.x;
-            tapEvent.touchY = touch.y;
-            tapEvent.timestamp = millis();
-            enqueueEvent(tapEvent);
-            
-            if (onTouchTap) {
-                onTouchTap(touch.x, touch.y);
-            }
-            
-            #if DEBUG_TOUCH
-            Serial.printf("Touch tap: %d, %d\n", touch.x, touch.y);
-            #endif
-        }
-        
-        touchPressed = false;
+        #if DEBUG_TOUCH
+        Serial.printf("Touch %s: %d, %d (%d)\n", GestureRecognizer::getName(gesture.type),
+                      gesture.x, gesture.y, gesture.value);
+        #endif
     }
 }
 
 bool InputManager::hasEvent() {
-    return eventHead != eventTail;
+    return !eventQueue.empty();
 }
 
 InputEvent InputManager::getNextEvent() {
     InputEvent event;
     event.type = INPUT_NONE;
-    dequeueEvent(event);
+    eventQueue.pop(event);
     return event;
 }
 
-int32_t InputManager::getEncoderPosition() {
-    return encoder.getCount();
-}
-
-void InputManager::resetEncoderPosition() {
-    encoder.clearCount();
-    encoder.setCount(0);
-    lastEncoderPosition = 0;
-}
-
-void InputManager::setOnEncoderRotate(void (*callback)(int32_t)) {
-    onEncoderRotate = callback;
-}
-
-void InputManager::setOnButtonClick(void (*callback)()) {
-    onButtonClick = callback;
+bool InputManager::getTouchPoint(uint16_t& x, uint16_t& y) {
+    x = lastTouchX;
+    y = lastTouchY;
+    return touchPressed;
 }
 
-void InputManager::setOnButtonDoubleClick(void (*callback)()) {
-    onButtonDoubleClick = callback;
-}
-
-void InputManager::setOnButtonLongPress(void (*callback)()) {
-    onButtonLongPress = callback;
-}
-
-void InputManager::setOnTouchTap(void (*callback)(uint16_t, uint16_t)) {
-    onTouchTap = callback;
+int32_t InputManager::getEncoderPosition() {
+    return encoderPosition;
 }
 
-bool InputManager::enqueueEvent(InputEvent& event) {
-    uint8_t next = (eventHead + 1) % 8;
-    if (next == eventTail) return false;
-    
-    eventQueue[eventHead] = event;
-    eventHead = next;
-    return true;
+void InputManager::resetEncoderPosition() {
+    pcnt_counter_clear(ENCODER_PCNT_UNIT);
+    encoderPosition = 0;
 }
 
-bool InputManager::dequeueEvent(InputEvent& event) {
-    if (eventHead == eventTail) return false;
-    
-    event = eventQueue[eventTail];
-    eventTail = (eventTail + 1) % 8;
-    return true;
+bool InputManager::enqueueEvent(const InputEvent& event) {
+    lastEventMs = millis();
+    return eventQueue.push(event);
 }
 
 void InputManager::buttonClickCallback() {
-    if (instance && instance->onButtonClick) {
-        instance->onButtonClick();
-    }
-    
     if (instance) {
         InputEvent event;
         event.type = INPUT_BUTTON_CLICK;
@@ -200,10 +301,6 @@ void InputManager::buttonClickCallback() {
 }
 
 void InputManager::buttonDoubleClickCallback() {
-    if (instance && instance->onButtonDoubleClick) {
-        instance->onButtonDoubleClick();
-    }
-    
     if (instance) {
         InputEvent event;
         event.type = INPUT_BUTTON_DOUBLE_CLICK;
@@ -213,10 +310,6 @@ void InputManager::buttonDoubleClickCallback() {
 }
 
 void InputManager::buttonLongPressCallback() {
-    if (instance && instance->onButtonLongPress) {
-        instance->onButtonLongPress();
-    }
-    
     if (instance) {
         InputEvent event;
         event.type = INPUT_BUTTON_LONG_PRESS;
@@ -0,0 +1,216 @@
+#include "ParamJsonParser.h"
+
+static void copyText(char* dest, size_t size, const char* src) {
+    strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
+}
+
+ParamJsonParser::ParamJsonParser() {
+    begin(nullptr, nullptr);
+}
+
+void ParamJsonParser::begin(RecordCallback callback, void* context) {
+    this->callback = callback;
+    this->context = context;
+    state = STATE_STRUCTURE;
+    failed = false;
+    expectKey = false;
+    sawRoot = false;
+    depth = 0;
+    recordDepth = 0;
+    key[0] = '\0';
+    text[0] = '\0';
+    textLength = 0;
+    unicodeSkip = 0;
+    parametersArray = false;
+    recordOpenInverter = false;
+    recordHasRange = false;
+    recordCount = 0;
+}
+
+bool ParamJsonParser::feed(const char* data, size_t length) {
+    for (size_t i = 0; i < length && !failed; i++) {
+        if (!processChar(data[i])) {
+            failed = true;
+        }
+    }
+    return !failed;
+}
+
+bool ParamJsonParser::finish() {
+    // A number can end the input only if it is the whole document (never valid here)
+    return !failed && sawRoot && depth == 0 && state == STATE_STRUCTURE;
+}
+
+bool ParamJsonParser::processChar(char c) {
+    switch (state) {
+        case STATE_STRING:
+            if (unicodeSkip > 0) {
+                unicodeSkip--;
+            } else if (c == '\\') {
+                state = STATE_STRING_ESCAPE;
+            } else if (c == '"') {
+                state = STATE_STRUCTURE;
+                text[textLength] = '\0';
+                if (expectKey) {
+                    copyText(key, sizeof(key), text);
+                } else {
+                    endValue(true);
+                }
+            } else if (textLength < TEXT_SIZE - 1) {
+                text[textLength++] = c;
+            }
+            return true;
+
+        case STATE_STRING_ESCAPE:
+            state = STATE_STRING;
+            if (c == 'u') {
+                c = '?';
+                unicodeSkip = 4;
+            } else if (c == 'n' || c == 't' || c == 'r' || c == 'b' || c == 'f') {
+                c = ' ';
+            }
+            if (textLength < TEXT_SIZE - 1) {
+                text[textLength++] = c;
+            }
+            return true;
+
+        case STATE_LITERAL:
+            if (isalnum((unsigned char)c) || c == '.' || c == '-' || c == '+') {
+                if (textLength < TEXT_SIZE - 1) {
+                    text[textLength++] = c;
+                }
+                return true;
+            }
+            text[textLength] = '\0';
+            state = STATE_STRUCTURE;
+            endValue(false);
+            break;  // Delimiter still needs handling below
+
+        case STATE_STRUCTURE:
+            break;
+    }
+
+    switch (c) {
+        case ' ': case '\t': case '\r': case '\n':
+            return true;
+
+        case '{': case '[':
+            return openContainer(c);
+
+        case '}': case ']':
+            return closeContainer(c);
+
+        case ':':
+            if (depth == 0 || stack[depth - 1] != '{' || !expectKey) return false;
+            expectKey = false;
+            return true;
+
+        case ',':
+            if (depth == 0) return false;
+            if (stack[depth - 1] == '{') expectKey = true;
+            return true;
+
+        case '"':
+            if (depth == 0) return false;
+            state = STATE_STRING;
+            textLength = 0;
+            return true;
+
+        default:
+            // Scalars are only valid inside a container and never as a key
+            if (depth == 0 || expectKey) return false;
+            if (c != '-' && !isalnum((unsigned char)c)) return false;
+            state = STATE_LITERAL;
+            textLength = 0;
+            text[textLength++] = c;
+            return true;
+    }
+}
+
+bool ParamJsonParser::openContainer(char c) {
+    if (depth >= MAX_DEPTH || (depth > 0 && expectKey)) return false;
+    if (depth == 0 && sawRoot) return false;  // Trailing document
+
+    if (recordDepth == 0) {
+        if (depth == 1 && stack[0] == '{') {
+            if (c == '[' && strcmp(key, "parameters") == 0) {
+                parametersArray = true;
+            } else if (c == '{') {
+                startRecord(key, true);             // "name": { "i": ... }
+                recordDepth = depth + 1;
+            }
+        } else if (depth == 2 && parametersArray && c == '{') {
+            startRecord("Unknown", false);          // { "id": ..., "name": ... }
+            recordDepth = depth + 1;
+        }
+    }
+
+    stack[depth++] = c;
+    expectKey = (c == '{');
+    sawRoot = true;
+    return true;
+}
+
+bool ParamJsonParser::closeContainer(char c) {
+    if (depth == 0) return false;
+    char open = stack[depth - 1];
+    if ((c == '}' && open != '{') || (c == ']' && open != '[')) return false;
+
+    if (depth == recordDepth) {
+        recordDepth = 0;
+        if (recordOpenInverter && recordHasRange) {
+            record.editable = true;
+        }
+        if (record.hasId) {
+            recordCount++;
+            if (callback) callback(record, context);
+        }
+    }
+
+    depth--;
+    if (depth == 1 && c == ']') {
+        parametersArray = false;
+    }
+    expectKey = false;
+    return true;
+}
+
+void ParamJsonParser::endValue(bool isString) {
+    // Only plain fields of the record itself; nested objects (canrx) are skipped
+    if (recordDepth != 0 && depth == recordDepth && stack[depth - 1] == '{') {
+        applyField(key, isString);
+    }
+}
+
+void ParamJsonParser::startRecord(const char* name, bool openInverter) {
+    memset(&record, 0, sizeof(record));
+    copyText(record.name, sizeof(record.name), name);
+    copyText(record.type, sizeof(record.type), openInverter ? "int32" : "int16");
+    record.maxValue = 100;
+    recordOpenInverter = openInverter;
+    recordHasRange = false;
+}
+
+void ParamJsonParser::applyField(const char* field, bool isString) {
+    if (strcmp(field, "id") == 0 || strcmp(field, "i") == 0) {
+        record.id = (uint16_t)strtol(text, nullptr, 10);
+        record.hasId = true;
+    } else if (strcmp(field, "name") == 0 && isString) {
+        copyText(record.name, sizeof(record.name), text);
+    } else if (strcmp(field, "unit") == 0 && isString) {
+        copyText(record.unit, sizeof(record.unit), text);
+    } else if (strcmp(field, "type") == 0 && isString) {
+        copyText(record.type, sizeof(record.type), text);
+    } else if (strcmp(field, "min") == 0 || strcmp(field, "minimum") == 0) {
+        record.minValue = (int32_t)strtod(text, nullptr);
+        recordHasRange = true;
+    } else if (strcmp(field, "max") == 0 || strcmp(field, "maximum") == 0) {
+        record.maxValue = (int32_t)strtod(text, nullptr);
+        recordHasRange = true;
+    } else if (strcmp(field, "decimals") == 0) {
+        record.decimals = (uint8_t)strtol(text, nullptr, 10);
+    } else if (strcmp(field, "editable") == 0 || strcmp(field, "isparam") == 0) {
+        record.editable = strcmp(text, "true") == 0;
+    }
+}
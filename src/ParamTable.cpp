@@ -0,0 +1,140 @@
+#include "ParamTable.h"
+
+// Parameters with enum/raw values are those the web UI must not scale by 32
+constexpr ParamInfo PARAM_TABLE[PARAM_TABLE_SIZE] = {
+    {0, "Inverter", "0=None, 1=Leaf_Gen1, 2=GS450h, 3=UserCAN, 4=OpenI, 5=Prius_Gen3, 6=RearAC, 7=E65_MT, 8=CanOI, 9=E65_BMW", "General Setup", PARAM_ENC_RAW},
+    {1, "Vehicle", "0=BMW_E46, 1=BMW_E6x+, 2=Classic, 3=None, 4=User, 5=CPC", "General Setup", PARAM_ENC_RAW},
+    {2, "GearLvr", "0=None, 1=BMW_F30, 2=JLR_G1, 3=JLR_G2, 4=VAG, 5=Outlander", "General Setup", PARAM_ENC_RAW},
+    {3, "Transmission", "0=Manual, 1=Auto", "General Setup", PARAM_ENC_RAW},
+    {4, "interface", "0=Unused, 1=i3LIM, 2=Chademo, 3=CPC", "General Setup", PARAM_ENC_RAW},
+    {5, "chargemodes", "0=Off, 1=EXT_DIGI, 2=Volt_A, 3=Volt_A+EXT, 4=i3LIM, 5=i3LIM+EXT, 6=Focci, 7=Leaf_PDM, 8=Outlander, 9=CPC, 10=Leaf_Inverter, 11=Tesla_M3_OBC", "General Setup", PARAM_ENC_RAW},
+    {6, "BMS_Mode", "0=Off, 1=SimpBMS, 2=TiDaisyChain, 3=BMWi3LIM, 4=OutlanderFront, 5=VWeBMS, 6=OutlanderFront+Rear, 7=Volt, 8=LeafGen2, 9=CPC, 10=RenaultZoe, 11=TeslaM3, 12=VictronCAN", "General Setup", PARAM_ENC_RAW},
+    {7, "ShuntType", "0=None, 1=ISA, 2=SBOX, 3=VAG", "General Setup", PARAM_ENC_RAW},
+    {8, "InverterCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {9, "VehicleCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {10, "ShuntCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {11, "LimCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {12, "ChargerCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {13, "BMSCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {14, "OBD2Can", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {15, "CanMapCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {16, "DCDCCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {17, "HeaterCan", "0=CAN1, 1=CAN2", "General Setup", PARAM_ENC_RAW},
+    {18, "MotActive", "0=Mg1and2, 1=Mg1, 2=Mg2, 3=Both", "General Setup", PARAM_ENC_RAW},
+    {19, "potmin", "dig", "Throttle", PARAM_ENC_RAW},
+    {20, "potmax", "dig", "Throttle", PARAM_ENC_RAW},
+    {21, "pot2min", "dig", "Throttle", PARAM_ENC_RAW},
+    {22, "pot2max", "dig", "Throttle", PARAM_ENC_RAW},
+    {23, "regenrpm", "rpm", "Throttle", PARAM_ENC_FIXED32},
+    {24, "regenendrpm", "rpm", "Throttle", PARAM_ENC_FIXED32},
+    {25, "regenmax", "%", "Throttle", PARAM_ENC_FIXED32},
+    {26, "regenBrake", "%", "Throttle", PARAM_ENC_FIXED32},
+    {27, "regenramp", "%/10ms", "Throttle", PARAM_ENC_FIXED32},
+    {28, "potmode", "0=SingleChannel, 1=DualChannel", "Throttle", PARAM_ENC_RAW},
+    {29, "dirmode", "0=Button, 1=Switch, 2=ButtonReversed, 3=SwitchReversed, 4=DefaultForward", "Throttle", PARAM_ENC_RAW},
+    {30, "reversemotor", "0=Off, 1=On, 2=na", "Throttle", PARAM_ENC_RAW},
+    {31, "throtramp", "%/10ms", "Throttle", PARAM_ENC_FIXED32},
+    {32, "throtramprpm", "rpm", "Throttle", PARAM_ENC_FIXED32},
+    {33, "revlim", "rpm", "Throttle", PARAM_ENC_FIXED32},
+    {34, "revRegen", "0=Off, 1=On, 2=na", "Throttle", PARAM_ENC_RAW},
+    {35, "udcmin", "V", "Throttle", PARAM_ENC_FIXED32},
+    {36, "udclim", "V", "Throttle", PARAM_ENC_FIXED32},
+    {37, "idcmax", "A", "Throttle", PARAM_ENC_FIXED32},
+    {38, "idcmin", "A", "Throttle", PARAM_ENC_FIXED32},
+    {39, "tmphsmax", "°C", "Throttle", PARAM_ENC_FIXED32},
+    {40, "tmpmmax", "°C", "Throttle", PARAM_ENC_FIXED32},
+    {41, "throtmax", "%", "Throttle", PARAM_ENC_FIXED32},
+    {42, "throtmin", "%", "Throttle", PARAM_ENC_FIXED32},
+    {43, "throtmaxRev", "%", "Throttle", PARAM_ENC_FIXED32},
+    {44, "throtdead", "%", "Throttle", PARAM_ENC_FIXED32},
+    {45, "RegenBrakeLight", "%", "Throttle", PARAM_ENC_FIXED32},
+    {46, "throtrpmfilt", "rpm/10ms", "Throttle", PARAM_ENC_FIXED32},
+    {47, "Gear", "0=LOW, 1=HIGH, 2=AUTO, 3=HILLHOLD", "Gearbox Control", PARAM_ENC_RAW},
+    {48, "OilPump", "%", "Gearbox Control", PARAM_ENC_FIXED32},
+    {49, "cruisestep", "rpm", "Cruise Control", PARAM_ENC_FIXED32},
+    {50, "cruiseramp", "rpm/100ms", "Cruise Control", PARAM_ENC_FIXED32},
+    {51, "regenlevel", "", "Cruise Control", PARAM_ENC_RAW},
+    {52, "udcsw", "V", "Contactor Control", PARAM_ENC_FIXED32},
+    {53, "cruiselight", "0=Off, 1=On, 2=na", "Contactor Control", PARAM_ENC_RAW},
+    {54, "errlights", "0=Off, 4=EPC, 8=engine", "Contactor Control", PARAM_ENC_RAW},
+    {55, "CAN3Speed", "0=k33.3, 1=k500, 2=k100", "Communication", PARAM_ENC_RAW},
+    {56, "BattCap", "kWh", "Charger Control", PARAM_ENC_FIXED32},
+    {57, "Voltspnt", "V", "Charger Control", PARAM_ENC_FIXED32},
+    {58, "Pwrspnt", "W", "Charger Control", PARAM_ENC_FIXED32},
+    {59, "IdcTerm", "A", "Charger Control", PARAM_ENC_FIXED32},
+    {60, "CCS_ICmd", "A", "Charger Control", PARAM_ENC_FIXED32},
+    {61, "CCS_ILim", "A", "Charger Control", PARAM_ENC_FIXED32},
+    {62, "CCS_SOCLim", "%", "Charger Control", PARAM_ENC_FIXED32},
+    {63, "SOCFC", "%", "Charger Control", PARAM_ENC_FIXED32},
+    {64, "Chgctrl", "0=Enable, 1=Disable, 2=Timer", "Charger Control", PARAM_ENC_RAW},
+    {65, "ChgAcVolt", "Vac", "Charger Control", PARAM_ENC_FIXED32},
+    {66, "ChgEff", "%", "Charger Control", PARAM_ENC_FIXED32},
+    {67, "ConfigFoccci", "0=Off, 1=On, 2=na", "Charger Control", PARAM_ENC_RAW},
+    {68, "DCdc_Type", "0=NoDCDC, 1=TeslaG2", "DC-DC Converter", PARAM_ENC_RAW},
+    {69, "DCSetPnt", "V", "DC-DC Converter", PARAM_ENC_FIXED32},
+    {70, "BMS_Timeout", "sec", "Battery Management", PARAM_ENC_RAW},
+    {71, "BMS_VminLimit", "V", "Battery Management", PARAM_ENC_FIXED32},
+    {72, "BMS_VmaxLimit", "V", "Battery Management", PARAM_ENC_FIXED32},
+    {73, "BMS_TminLimit", "°C", "Battery Management", PARAM_ENC_FIXED32},
+    {74, "BMS_TmaxLimit", "°C", "Battery Management", PARAM_ENC_FIXED32},
+    {75, "Heater", "0=None, 1=Ampera, 2=VW, 3=OpenI, 4=TeslaRear, 5=Outlander, 6=i3", "Heater Module", PARAM_ENC_RAW},
+    {76, "Control", "0=Disable, 1=Enable, 2=Timer", "Heater Module", PARAM_ENC_RAW},
+    {77, "HeatPwr", "W", "Heater Module", PARAM_ENC_FIXED32},
+    {78, "HeatPercnt", "%", "Heater Module", PARAM_ENC_FIXED32},
+    {79, "Set_Day", "0=Sun, 1=Mon, 2=Tue, 3=Wed, 4=Thu, 5=Fri, 6=Sat", "RTC Module", PARAM_ENC_RAW},
+    {80, "Set_Hour", "Hours", "RTC Module", PARAM_ENC_RAW},
+    {81, "Set_Min", "Mins", "RTC Module", PARAM_ENC_RAW},
+    {82, "Set_Sec", "Secs", "RTC Module", PARAM_ENC_RAW},
+    {83, "Chg_Hrs", "Hours", "RTC Module", PARAM_ENC_RAW},
+    {84, "Chg_Min", "Mins", "RTC Module", PARAM_ENC_RAW},
+    {85, "Chg_Dur", "Mins", "RTC Module", PARAM_ENC_RAW},
+    {86, "Pre_Hrs", "Hours", "RTC Module", PARAM_ENC_RAW},
+    {87, "Pre_Min", "Mins", "RTC Module", PARAM_ENC_RAW},
+    {88, "Pre_Dur", "Mins", "RTC Module", PARAM_ENC_RAW},
+    {89, "PumpPWM", "0=GS450hOil, 1=TachoOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {90, "Out1Func", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {91, "Out2Func", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {92, "Out3Func", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {93, "SL1Func", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {94, "SL2Func", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {95, "PWM1Func", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {96, "PWM2Func", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {97, "PWM3Func", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {98, "GP12VInFunc", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {99, "HVReqFunc", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {100, "PB1InFunc", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {101, "PB2InFunc", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {102, "PB3InFunc", "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", PARAM_ENC_RAW},
+    {103, "GPA1Func", "0=None, 1=ProxPilot, 2=BrakePres, 3=BrakeVacuum, 4=DigiPot1, 5=DigiPot2, 6=TempSensor, 7=ISA_CFG", "General Purpose I/O", PARAM_ENC_RAW},
+    {104, "GPA2Func", "0=None, 1=ProxPilot, 2=BrakePres, 3=BrakeVacuum, 4=DigiPot1, 5=DigiPot2, 6=TempSensor, 7=ISA_CFG", "General Purpose I/O", PARAM_ENC_RAW},
+    {105, "ppthresh", "dig", "General Purpose I/O", PARAM_ENC_RAW},
+    {106, "BrkVacThresh", "dig", "General Purpose I/O", PARAM_ENC_RAW},
+    {107, "BrkVacHyst", "dig", "General Purpose I/O", PARAM_ENC_RAW},
+    {108, "DigiPot1Step", "dig", "General Purpose I/O", PARAM_ENC_RAW},
+    {109, "DigiPot2Step", "dig", "General Purpose I/O", PARAM_ENC_RAW},
+    {110, "FanTemp", "°C", "General Purpose I/O", PARAM_ENC_FIXED32},
+    {111, "TachoPPR", "PPR", "General Purpose I/O", PARAM_ENC_RAW},
+    {112, "IsaInit", "0=Off, 1=On, 2=na", "ISA Shunt Control", PARAM_ENC_RAW},
+    {113, "Tim3_Presc", "", "PWM Control", PARAM_ENC_RAW},
+    {114, "Tim3_Period", "", "PWM Control", PARAM_ENC_RAW},
+    {115, "Tim3_1_OC", "", "PWM Control", PARAM_ENC_RAW},
+    {116, "Tim3_2_OC", "", "PWM Control", PARAM_ENC_RAW},
+    {117, "Tim3_3_OC", "", "PWM Control", PARAM_ENC_RAW},
+    {118, "CP_PWM", "", "PWM Control", PARAM_ENC_RAW}
+};
+
+// findParamInfo(id) indexes the table directly, so the ids must match
+constexpr bool paramTableOrdered(uint16_t i) {
+    return i >= PARAM_TABLE_SIZE || (PARAM_TABLE[i].id == i && paramTableOrdered(i + 1));
+}
+static_assert(paramTableOrdered(0), "PARAM_TABLE entry i must have id i");
+
+const ParamInfo* findParamInfo(const char* name) {
+    uint32_t hash = paramNameHash(name);
+    for (uint16_t i = 0; i < PARAM_TABLE_SIZE; i++) {
+        if (PARAM_TABLE[i].nameHash == hash && strcmp(PARAM_TABLE[i].name, name) == 0) {
+            return &PARAM_TABLE[i];
+        }
+    }
+    return nullptr;
+}
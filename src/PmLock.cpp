@@ -0,0 +1,51 @@
+#include "PmLock.h"
+#include <esp_timer.h>
+
+PmLock* PmLock::locks[MAX_PM_LOCKS] = {};
+uint8_t PmLock::count = 0;
+
+PmLock::PmLock(esp_pm_lock_type_t lockType, const char* lockName)
+    : handle(nullptr), type(lockType), name(lockName), acquiredUs(0),
+      acquisitions(0), heldUs(0) {
+}
+
+bool PmLock::create() {
+    if (handle) return true;
+    
+    esp_err_t err = esp_pm_lock_create(type, 0, name, &handle);
+    if (err != ESP_OK) {
+        handle = nullptr;
+        #if DEBUG_SERIAL
+        Serial.printf("[PM] Lock %s not created (%d)\n", name, err);
+        #endif
+        return false;
+    }
+    
+    if (count < MAX_PM_LOCKS) {
+        locks[count++] = this;
+    }
+    return true;
+}
+
+void PmLock::acquire() {
+    if (!handle) return;
+    esp_pm_lock_acquire(handle);
+    acquiredUs = esp_timer_get_time();
+    acquisitions++;
+}
+
+void PmLock::release() {
+    if (!handle) return;
+    heldUs += (uint32_t)(esp_timer_get_time() - acquiredUs);
+    esp_pm_lock_release(handle);
+}
+
+uint32_t PmLock::getTotalHeldUs(esp_pm_lock_type_t lockType) {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (locks[i]->type == lockType) {
+            total += locks[i]->heldUs;
+        }
+    }
+    return total;
+}
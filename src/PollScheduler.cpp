@@ -0,0 +1,118 @@
+#include "PollScheduler.h"
+#include "CANData.h"
+
+PollScheduler::PollScheduler() {
+    reset(0);
+}
+
+void PollScheduler::reset(uint16_t count) {
+    memset(rates, POLL_NORMAL, sizeof(rates));
+    memset(lastRequest, 0, sizeof(lastRequest));
+    memset(&stats, 0, sizeof(stats));
+    tokens = POLL_BUDGET_BURST * 1000;
+    lastRefill = millis();
+    windowStart = lastRefill;
+    windowRequests = 0;
+    stats.polled = count;
+}
+
+void PollScheduler::setRate(uint16_t index, PollRate rate) {
+    if (index < MAX_PARAMETERS) {
+        rates[index] = rate;
+    }
+}
+
+uint32_t PollScheduler::periodFor(uint8_t rate) {
+    switch (rate) {
+        case POLL_FAST:   return POLL_FAST_MS;
+        case POLL_NORMAL: return POLL_NORMAL_MS;
+        case POLL_SLOW:   return POLL_SLOW_MS;
+        default:          return 0;
+    }
+}
+
+int16_t PollScheduler::next(uint32_t now, const uint32_t* updateTimes, const uint8_t* flags, uint16_t count) {
+    // Refill the bus budget
+    uint32_t elapsed = now - lastRefill;
+    lastRefill = now;
+    tokens += elapsed * POLL_BUDGET_PER_SEC;
+    if (tokens > POLL_BUDGET_BURST * 1000) {
+        tokens = POLL_BUDGET_BURST * 1000;
+    }
+
+    if (now - windowStart >= 1000) {
+        updateFreshness(now, updateTimes, flags, count);
+    }
+
+    // Most overdue relative to its own period (score 256 = exactly due)
+    int16_t best = -1;
+    uint32_t bestScore = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t period = periodFor(rates[i]);
+        if (period == 0) continue;
+
+        uint32_t age = now - updateTimes[i];
+        if ((flags[i] & PARAM_FLAG_BROADCAST) && age < POLL_BROADCAST_STALE_MS) continue;
+
+        // A request in flight counts as fresh until it times out or is answered
+        uint32_t sinceRequest = now - lastRequest[i];
+        if (lastRequest[i] != 0 && sinceRequest < period) continue;
+
+        uint32_t score;
+        if (flags[i] & PARAM_FLAG_DIRTY) {
+            score = 0xFFFFFFFF - rates[i];      // Never read: first, fast ones first
+        } else {
+            score = (age >= 0x00FFFFFF) ? 0xFFFFFF00 : (age << 8) / period;
+        }
+
+        if (score >= 256 && score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+
+    if (best < 0) {
+        return -1;
+    }
+    if (tokens < 1000) {
+        stats.budgetDeferred++;
+        return -1;
+    }
+
+    tokens -= 1000;
+    lastRequest[best] = now ? now : 1;
+    stats.requests++;
+    windowRequests++;
+    return best;
+}
+
+void PollScheduler::updateFreshness(uint32_t now, const uint32_t* updateTimes, const uint8_t* flags, uint16_t count) {
+    uint16_t polled = 0;
+    uint16_t broadcast = 0;
+    uint16_t stale = 0;
+    uint32_t worst = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t period = periodFor(rates[i]);
+        if (period == 0) continue;
+
+        uint32_t age = now - updateTimes[i];
+        if ((flags[i] & PARAM_FLAG_BROADCAST) && age < POLL_BROADCAST_STALE_MS) {
+            broadcast++;
+            continue;
+        }
+
+        polled++;
+        if ((flags[i] & PARAM_FLAG_DIRTY) || age > 2 * period) stale++;
+        if (!(flags[i] & PARAM_FLAG_DIRTY) && age > worst) worst = age;
+    }
+
+    stats.polled = polled;
+    stats.broadcast = broadcast;
+    stats.stale = stale;
+    stats.worstAgeMs = worst;
+    stats.requestsPerSec = (uint16_t)((windowRequests * 1000) / (now - windowStart));
+    windowRequests = 0;
+    windowStart = now;
+}
@@ -0,0 +1,275 @@
+#include "PowerManager.h"
+#include "Hardware.h"
+#include "UIManager.h"
+#include "InputManager.h"
+#include "Immobilizer.h"
+#include <esp_pm.h>
+
+static const uint16_t WAKE_PARAMS[] = POWER_WAKE_PARAMS;
+static const uint8_t WAKE_PARAM_COUNT = sizeof(WAKE_PARAMS) / sizeof(WAKE_PARAMS[0]);
+static_assert(WAKE_PARAM_COUNT <= MAX_INTEREST_IDS, "POWER_WAKE_PARAMS must fit one interest set");
+
+PowerManager::PowerManager()
+    : ui(nullptr), input(nullptr), canManager(nullptr), immobilizer(nullptr),
+      state(POWER_ACTIVE), lastActivityMs(0), lastInputMs(0), lastAccountMs(0),
+      activeCpuMhz(240), minCpuMhz(SLEEP_CPU_MHZ), pmMode(PM_MODE_FIXED),
+      uiLock(ESP_PM_CPU_FREQ_MAX, "ui"), uiBoosted(false), lastHeldUs(0), windowMs(0), windowHeldUs(0),
+      wakeValuesValid(false), wasUnlocked(false), activeChargeMaMs(0) {
+    memset(wakeValues, 0, sizeof(wakeValues));
+    memset(chargeMaMs, 0, sizeof(chargeMaMs));
+    memset(&current, 0, sizeof(current));
+}
+
+void PowerManager::begin(UIManager* uiMgr, InputManager* in, CANDataManager* can, Immobilizer* immob) {
+    ui = uiMgr;
+    input = in;
+    canManager = can;
+    immobilizer = immob;
+    
+    activeCpuMhz = getCpuFrequencyMhz();
+    configurePm();
+    
+    lastActivityMs = millis();
+    lastAccountMs = lastActivityMs;
+    lastInputMs = input ? input->getLastEventTime() : 0;
+    wasUnlocked = immobilizer && immobilizer->isUnlocked();
+}
+
+// Frequency scaling, plus light sleep if the SDK was built with tickless
+// idle; anything less leaves the clock to setState()
+void PowerManager::configurePm() {
+    #if PM_ENABLE
+    esp_pm_config_esp32s3_t pm;
+    pm.max_freq_mhz = activeCpuMhz;
+    pm.min_freq_mhz = PM_MIN_CPU_MHZ;
+    pm.light_sleep_enable = PM_LIGHT_SLEEP;
+    
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err == ESP_ERR_NOT_SUPPORTED && pm.light_sleep_enable) {
+        pm.light_sleep_enable = false;
+        err = esp_pm_configure(&pm);
+    }
+    
+    if (err == ESP_OK && uiLock.create()) {
+        pmMode = pm.light_sleep_enable ? PM_MODE_DFS_SLEEP : PM_MODE_DFS;
+        minCpuMhz = PM_MIN_CPU_MHZ;
+    }
+    
+    #if DEBUG_SERIAL
+    Serial.printf("[PM] %s, %lu-%lu MHz (esp_pm_configure: %d)\n",
+                  pmMode == PM_MODE_DFS_SLEEP ? "DFS + light sleep" :
+                  pmMode == PM_MODE_DFS ? "DFS" : "fixed clock",
+                  (unsigned long)minCpuMhz, (unsigned long)activeCpuMhz, err);
+    #endif
+    #endif
+    
+    current.pmMode = pmMode;
+    current.maxCpuMhz = activeCpuMhz;
+    current.minCpuMhz = minCpuMhz;
+}
+
+void PowerManager::update() {
+    uint32_t now = millis();
+    account(now);
+    
+    bool inputSeen = false;
+    if (input && input->getLastEventTime() != lastInputMs) {
+        lastInputMs = input->getLastEventTime();
+        inputSeen = true;
+    }
+    bool canSeen = checkCanWake();
+    
+    // A WiFi upload in progress counts as the display being used
+    if (inputSeen || canSeen || (ui && ui->isWiFiMode())) {
+        lastActivityMs = now;
+        if (state != POWER_ACTIVE) {
+            if (inputSeen) {
+                current.wakesByInput++;
+            } else if (canSeen) {
+                current.wakesByCan++;
+            }
+            setState(POWER_ACTIVE);
+        }
+    } else {
+        uint32_t idle = now - lastActivityMs;
+        if (state != POWER_OFF && idle >= SLEEP_TIMEOUT_MS) {
+            setState(POWER_OFF);
+        } else if (state == POWER_ACTIVE && idle >= DIM_TIMEOUT_MS) {
+            setState(POWER_DIM);
+        }
+    }
+    
+    // Full clock for the rest of this cycle while there is a screen to draw
+    if (state != POWER_OFF) {
+        uiLock.acquire();
+        uiBoosted = true;
+    }
+    
+    // mA*ms to uAh: / 3600
+    uint64_t usedMaMs = 0;
+    for (int s = 0; s < POWER_STATE_COUNT; s++) {
+        current.uAh[s] = (uint32_t)(chargeMaMs[s] / 3600);
+        current.estimateMa[s] = current.ms[s] > 0 ? (uint16_t)(chargeMaMs[s] / current.ms[s]) : 0;
+        usedMaMs += chargeMaMs[s];
+    }
+    current.savedUAh = (uint32_t)((activeChargeMaMs - usedMaMs) / 3600);
+    current.state = state;
+    
+    PowerStats& out = stats.beginWrite();
+    out = current;
+    stats.endWrite();
+}
+
+void PowerManager::cycleDone() {
+    if (uiBoosted) {
+        uiLock.release();
+        uiBoosted = false;
+    }
+}
+
+// Something the driver would want to see: a wake parameter or the lock
+// state changed
+bool PowerManager::checkCanWake() {
+    bool changed = false;
+    
+    if (canManager) {
+        int32_t values[WAKE_PARAM_COUNT];
+        canManager->getValues(WAKE_PARAMS, values, WAKE_PARAM_COUNT);
+        if (wakeValuesValid && memcmp(values, wakeValues, sizeof(values)) != 0) {
+            changed = true;
+        }
+        memcpy(wakeValues, values, sizeof(values));
+        wakeValuesValid = true;
+    }
+    
+    bool unlocked = immobilizer && immobilizer->isUnlocked();
+    if (unlocked != wasUnlocked) {
+        wasUnlocked = unlocked;
+        changed = true;
+    }
+    
+    return changed;
+}
+
+void PowerManager::setState(PowerState next) {
+    if (next == state) return;
+    PowerState previous = state;
+    state = next;
+    
+    switch (next) {
+        case POWER_ACTIVE:
+            if (previous == POWER_OFF) {
+                if (pmMode == PM_MODE_FIXED) setCpuFrequencyMhz(activeCpuMhz);
+                if (ui) ui->setPaused(false);
+            }
+            Hardware::wake();
+            break;
+            
+        case POWER_DIM:
+            Hardware::dim(DIM_BRIGHTNESS);
+            break;
+            
+        case POWER_OFF:
+            Hardware::sleep();
+            if (ui) ui->setPaused(true);
+            
+            // Nothing is shown: only the wake parameters need polling fast
+            // (booked to the splash screen, which polls nothing itself)
+            if (canManager) {
+                canManager->setInterest(INTEREST_SCREEN, SCREEN_SPLASH, WAKE_PARAMS, WAKE_PARAM_COUNT, 0);
+            }
+            
+            // With esp_pm the clock drops by itself once the UI stops
+            // boosting. APB stays at 80 MHz down to an 80 MHz CPU, so TWAI,
+            // I2C and the PCNT filter keep their timing.
+            if (pmMode == PM_MODE_FIXED) setCpuFrequencyMhz(SLEEP_CPU_MHZ);
+            break;
+            
+        default:
+            break;
+    }
+    
+    #if DEBUG_SERIAL
+    Serial.printf("[POWER] %s -> %s\n", getStateName(previous), getStateName(next));
+    #endif
+}
+
+// Book the time since the last call to the current state
+void PowerManager::account(uint32_t now) {
+    uint32_t elapsed = now - lastAccountMs;
+    lastAccountMs = now;
+    if (elapsed == 0) return;
+    
+    // Share of the time the CPU ran at full clock: with esp_pm, while any
+    // CPU_FREQ_MAX lock was held (overlaps count twice, hence the clamp)
+    float boost;
+    if (pmMode != PM_MODE_FIXED) {
+        uint32_t held = PmLock::getTotalHeldUs(ESP_PM_CPU_FREQ_MAX);
+        uint32_t heldDelta = held - lastHeldUs;
+        lastHeldUs = held;
+        boost = (float)heldDelta / (elapsed * 1000.0f);
+        if (boost > 1.0f) boost = 1.0f;
+        
+        windowHeldUs += heldDelta;
+        windowMs += elapsed;
+        if (windowMs >= 1000) {
+            uint32_t pct = windowHeldUs / (windowMs * 10);
+            current.boostPct = pct > 100 ? 100 : pct;
+            windowHeldUs = 0;
+            windowMs = 0;
+        }
+    } else {
+        boost = (state == POWER_OFF) ? 0.0f : 1.0f;
+        current.boostPct = (uint8_t)(boost * 100);
+    }
+    
+    current.ms[state] += elapsed;
+    chargeMaMs[state] += (uint64_t)(modelMa(state, boost) * elapsed);
+    activeChargeMaMs += (uint64_t)(modelMa(POWER_ACTIVE, 1.0f) * elapsed);
+}
+
+// Supply current in a state from the POWER_EST_* model, with the CPU at
+// full clock for `boost` of the time and at its minimum otherwise
+float PowerManager::modelMa(PowerState s, float boost) const {
+    float cpuMhz = minCpuMhz + (activeCpuMhz - minCpuMhz) * boost;
+    float ma = POWER_EST_BOARD_MA + POWER_EST_CPU_MA_PER_MHZ * cpuMhz;
+    uint8_t backlight = Hardware::getBacklight();
+    
+    switch (s) {
+        case POWER_ACTIVE:
+            ma += POWER_EST_PANEL_MA + POWER_EST_BACKLIGHT_MA * backlight / 255.0f;
+            break;
+        case POWER_DIM:
+            if (backlight > DIM_BRIGHTNESS) backlight = DIM_BRIGHTNESS;
+            ma += POWER_EST_PANEL_MA + POWER_EST_BACKLIGHT_MA * backlight / 255.0f;
+            break;
+        default:
+            break;
+    }
+    return ma;
+}
+
+const char* PowerManager::getStateName(PowerState s) {
+    switch (s) {
+        case POWER_ACTIVE: return "ACTIVE";
+        case POWER_DIM:    return "DIM";
+        case POWER_OFF:    return "OFF";
+        default:           return "?";
+    }
+}
+
+void PowerManager::printStats() const {
+    PowerStats s;
+    stats.copy(s);
+    
+    uint32_t usedUAh = s.uAh[POWER_ACTIVE] + s.uAh[POWER_DIM] + s.uAh[POWER_OFF];
+    Serial.printf("[POWER] %s, CPU at max %u%%, active %lu s ~%u mA, dim %lu s ~%u mA, off %lu s ~%u mA, "
+                  "%lu.%03lu mAh used, %lu.%03lu mAh saved, woken %lu by input, %lu by CAN\n",
+                  getStateName(s.state), s.boostPct,
+                  (unsigned long)(s.ms[POWER_ACTIVE] / 1000), s.estimateMa[POWER_ACTIVE],
+                  (unsigned long)(s.ms[POWER_DIM] / 1000), s.estimateMa[POWER_DIM],
+                  (unsigned long)(s.ms[POWER_OFF] / 1000), s.estimateMa[POWER_OFF],
+                  (unsigned long)(usedUAh / 1000), (unsigned long)(usedUAh % 1000),
+                  (unsigned long)(s.savedUAh / 1000), (unsigned long)(s.savedUAh % 1000),
+                  (unsigned long)s.wakesByInput, (unsigned long)s.wakesByCan);
+}
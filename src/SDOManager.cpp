@@ -1,6 +1,33 @@
 #include "SDOManager.h"
+#include "CANData.h"
+
+static uint32_t readLE32(const uint8_t* data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+           ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// CRC-16/CCITT as block transfers use it: x^16 + x^12 + x^5 + 1, start 0
+static uint16_t crc16Ccitt(uint16_t crc, const uint8_t* data, size_t length) {
+    while (length--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
 
 SDOManager::SDOManager() {
+    responseSem = nullptr;
+    transferMutex = nullptr;
+    requestPending = false;
+    pendingParam = 0;
+    transferActive = false;
+    rawMode = RAW_OFF;
+    blockSeq = 0;
+    blockLast = false;
+    batchActive = false;
+    lastBatchMs = 0;
     responseReceived = false;
     responseSuccess = false;
     responseValue = 0;
@@ -12,6 +39,13 @@ SDOManager::SDOManager() {
 }
 
 bool SDOManager::init() {
+    if (!responseSem) responseSem = xSemaphoreCreateBinary();
+    if (!transferMutex) transferMutex = xSemaphoreCreateMutex();
+    if (!responseSem || !transferMutex) {
+        Serial.println("[SDO] Failed to create semaphores");
+        return false;
+    }
+    
     Serial.println("[SDO] Initialized with ZombieVerter custom format");
     Serial.println("[SDO] TX: 0x603, RX: 0x583");
     Serial.println("[SDO] Format: [cmd, 0x01, 0x20, param_id, data...]");
@@ -20,6 +54,16 @@ bool SDOManager::init() {
 }
 
 bool SDOManager::readParameter(uint8_t paramId, int32_t& value) {
+    if (!transferMutex) return false;
+    xSemaphoreTake(transferMutex, portMAX_DELAY);
+    transferActive = true;
+    bool result = readParameterLocked(paramId, value);
+    transferActive = false;
+    xSemaphoreGive(transferMutex);
+    return result;
+}
+
+bool SDOManager::readParameterLocked(uint8_t paramId, int32_t& value) {
     Serial.printf("[SDO] Reading param %d... ", paramId);
     
     for (int retry = 0; retry < SDO_MAX_RETRIES; retry++) {
@@ -60,6 +104,16 @@ bool SDOManager::readParameter(uint8_t paramId, int32_t& value) {
 }
 
 bool SDOManager::writeParameter(uint8_t paramId, int32_t value) {
+    if (!transferMutex) return false;
+    xSemaphoreTake(transferMutex, portMAX_DELAY);
+    transferActive = true;
+    bool result = writeParameterLocked(paramId, value);
+    transferActive = false;
+    xSemaphoreGive(transferMutex);
+    return result;
+}
+
+bool SDOManager::writeParameterLocked(uint8_t paramId, int32_t value) {
     Serial.printf("[SDO] Writing param %d = %d (0x%08X)... ", paramId, value, value);
     
     for (int retry = 0; retry < SDO_MAX_RETRIES; retry++) {
@@ -116,20 +170,589 @@ bool SDOManager::saveToFlash() {
     return success;
 }
 
-void SDOManager::processResponse(const twai_message_t& msg) {
+// ============================================================================
+// Batch writes
+// ============================================================================
+
+bool SDOManager::writeBatch(SDOWrite* writes, uint16_t count, uint8_t options) {
+    if (!transferMutex) return false;
+    xSemaphoreTake(transferMutex, portMAX_DELAY);
+    transferActive = true;
+    clearResponse();
+    BatchReply stale;
+    while (batchReplies.pop(stale)) {}
+    batchActive = true;
+    
+    uint32_t start = millis();
+    bool rollback = (options & SDO_BATCH_ROLLBACK) != 0;
+    bool ok = true;
+    
+    // Without the old values there is nothing to roll back to, so a
+    // failed read here means nothing gets written at all
+    if (rollback) {
+        ok = runBatch(writes, count, BATCH_READ_PREVIOUS, true);
+    }
+    if (ok) {
+        ok = runBatch(writes, count, BATCH_WRITE, rollback);
+    }
+    // Without rollback, whatever was written still gets read back
+    if ((ok || !rollback) && (options & SDO_BATCH_VERIFY)) {
+        ok = runBatch(writes, count, BATCH_VERIFY, rollback) && ok;
+    }
+    if (!ok && rollback) {
+        runBatch(writes, count, BATCH_RESTORE, false);
+    }
+    
+    batchActive = false;
+    transferActive = false;
+    xSemaphoreGive(transferMutex);
+    
+    uint16_t written = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (writes[i].status == SDO_WRITE_PENDING) {
+            writes[i].status = SDO_WRITE_SKIPPED;
+        } else if (writes[i].status == SDO_WRITE_DONE || writes[i].status == SDO_WRITE_VERIFIED) {
+            written++;
+        }
+    }
+    
+    if (ok && (options & SDO_BATCH_SAVE)) {
+        ok = saveToFlash();
+    }
+    lastBatchMs = millis() - start;
+    
+    Serial.printf("[SDO] Batch: %u of %u written in %lu ms%s\n", written, count,
+                  (unsigned long)lastBatchMs, ok ? "" : (rollback ? ", rolled back" : ", with failures"));
+    return ok;
+}
+
+// One phase of a batch: a request per selected entry, up to
+// SDO_BATCH_WINDOW outstanding. Replies only carry the sub-index, so two
+// requests for the same parameter are never in flight together.
+bool SDOManager::runBatch(SDOWrite* writes, uint16_t count, uint8_t op, bool stopOnFailure) {
+    struct InFlight {
+        uint16_t entry;
+        uint32_t sentAt;
+        uint8_t tries;
+    };
+    InFlight slots[SDO_BATCH_WINDOW];
+    uint8_t active = 0;
+    uint16_t next = 0;
+    bool failed = false;
+    bool restore = op == BATCH_RESTORE;
+    uint8_t expected = (op == BATCH_WRITE || restore) ? SDO_RESP_WRITE : SDO_RESP_READ;
+    
+    while (true) {
+        while (!(failed && stopOnFailure) && active < SDO_BATCH_WINDOW && next < count) {
+            SDOWrite& write = writes[next];
+            bool selected;
+            switch (op) {
+                case BATCH_VERIFY:
+                    // Only the last write of a parameter can be read back
+                    selected = write.status == SDO_WRITE_DONE;
+                    for (uint16_t later = next + 1; selected && later < count; later++) {
+                        if (writes[later].paramId == write.paramId && writes[later].status == SDO_WRITE_DONE) {
+                            selected = false;
+                        }
+                    }
+                    break;
+                case BATCH_RESTORE:
+                    selected = write.status == SDO_WRITE_DONE || write.status == SDO_WRITE_VERIFIED ||
+                               write.status == SDO_WRITE_MISMATCH;
+                    break;
+                default:
+                    selected = write.status == SDO_WRITE_PENDING;
+                    break;
+            }
+            if (!selected) {
+                next++;
+                continue;
+            }
+            bool busy = false;
+            for (uint8_t s = 0; s < active; s++) {
+                if (writes[slots[s].entry].paramId == write.paramId) busy = true;
+            }
+            if (busy) break;
+            
+            // A frame the driver would not take is resent on timeout
+            sendBatchRequest(write, op);
+            slots[active].entry = next;
+            slots[active].sentAt = millis();
+            slots[active].tries = 1;
+            active++;
+            next++;
+        }
+        if (active == 0) break;
+        
+        bool progressed = false;
+        BatchReply reply;
+        while (active > 0 && batchReplies.pop(reply)) {
+            uint8_t s = 0;
+            while (s < active && writes[slots[s].entry].paramId != reply.paramId) s++;
+            // Late duplicate of a retried request, or a reply from another phase
+            if (s == active || (reply.cmd != expected && reply.cmd != SDO_RESP_ABORT)) continue;
+            
+            SDOWrite& write = writes[slots[s].entry];
+            slots[s] = slots[--active];
+            progressed = true;
+            
+            if (reply.cmd == SDO_RESP_ABORT) {
+                write.status = restore ? SDO_WRITE_ROLLBACK_FAILED : SDO_WRITE_ABORTED;
+                write.abortCode = reply.data;
+                recordAbort(reply.data);
+                failureCount++;
+                failed = true;
+                continue;
+            }
+            
+            successCount++;
+            switch (op) {
+                case BATCH_READ_PREVIOUS:
+                    write.previous = (int32_t)reply.data;
+                    break;
+                case BATCH_WRITE:
+                    write.status = SDO_WRITE_DONE;
+                    break;
+                case BATCH_VERIFY:
+                    write.readBack = (int32_t)reply.data;
+                    write.status = write.readBack == write.value ? SDO_WRITE_VERIFIED : SDO_WRITE_MISMATCH;
+                    if (write.status == SDO_WRITE_MISMATCH) failed = true;
+                    break;
+                case BATCH_RESTORE:
+                    write.status = SDO_WRITE_ROLLED_BACK;
+                    break;
+            }
+        }
+        
+        // Retry or give up on requests that got no answer
+        uint32_t now = millis();
+        uint32_t wait = SDO_TIMEOUT_MS;
+        for (uint8_t s = 0; s < active;) {
+            uint32_t age = now - slots[s].sentAt;
+            if (age < SDO_TIMEOUT_MS) {
+                if (SDO_TIMEOUT_MS - age < wait) wait = SDO_TIMEOUT_MS - age;
+                s++;
+                continue;
+            }
+            
+            timeoutCount++;
+            SDOWrite& write = writes[slots[s].entry];
+            if (slots[s].tries < SDO_MAX_RETRIES) {
+                sendBatchRequest(write, op);
+                slots[s].sentAt = now;
+                slots[s].tries++;
+                s++;
+            } else {
+                write.status = restore ? SDO_WRITE_ROLLBACK_FAILED : SDO_WRITE_TIMEOUT;
+                write.abortCode = SDO_ABORT_TIMEOUT;
+                strcpy(lastError, "Timeout after retries");
+                failureCount++;
+                failed = true;
+                slots[s] = slots[--active];
+                progressed = true;
+            }
+        }
+        
+        if (!progressed && active > 0) {
+            xSemaphoreTake(responseSem, pdMS_TO_TICKS(wait > 0 ? wait : 1));
+        }
+    }
+    return !failed;
+}
+
+bool SDOManager::sendBatchRequest(const SDOWrite& write, uint8_t op) {
+    bool isWrite = op == BATCH_WRITE || op == BATCH_RESTORE;
+    int32_t value = op == BATCH_RESTORE ? write.previous : (isWrite ? write.value : 0);
+    uint8_t frame[8] = { isWrite ? (uint8_t)SDO_CMD_WRITE : (uint8_t)SDO_CMD_READ,
+                         SDO_FIXED_BYTE1, SDO_FIXED_BYTE2, write.paramId,
+                         (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+    return sendFrame(frame);
+}
+
+const char* SDOManager::getWriteStatusName(uint8_t status) {
+    switch (status) {
+        case SDO_WRITE_PENDING:         return "pending";
+        case SDO_WRITE_DONE:            return "written";
+        case SDO_WRITE_VERIFIED:        return "verified";
+        case SDO_WRITE_MISMATCH:        return "mismatch";
+        case SDO_WRITE_ABORTED:         return "aborted";
+        case SDO_WRITE_TIMEOUT:         return "timeout";
+        case SDO_WRITE_SKIPPED:         return "skipped";
+        case SDO_WRITE_ROLLED_BACK:     return "rolled back";
+        case SDO_WRITE_ROLLBACK_FAILED: return "rollback failed";
+        case SDO_WRITE_DIRECT:          return "sent";
+        default:                        return "unknown";
+    }
+}
+
+// ============================================================================
+// Segmented / block upload
+// ============================================================================
+
+struct BufferSink {
+    uint8_t* buffer;
+    size_t capacity;
+    size_t length;
+};
+
+static bool appendToBuffer(const uint8_t* data, size_t length, void* context) {
+    BufferSink* sink = (BufferSink*)context;
+    if (sink->length + length > sink->capacity) return false;
+    memcpy(sink->buffer + sink->length, data, length);
+    sink->length += length;
+    return true;
+}
+
+bool SDOManager::upload(uint16_t index, uint8_t subIndex, uint8_t* buffer, size_t capacity, size_t& length,
+                        bool allowBlock) {
+    BufferSink sink = { buffer, capacity, 0 };
+    bool ok = upload(index, subIndex, appendToBuffer, &sink, nullptr, allowBlock);
+    length = sink.length;
+    return ok;
+}
+
+bool SDOManager::upload(uint16_t index, uint8_t subIndex, UploadSink sink, void* context,
+                        uint32_t* length, bool allowBlock) {
+    if (!transferMutex) return false;
+    xSemaphoreTake(transferMutex, portMAX_DELAY);
+    transferActive = true;
+    rawMode = RAW_HOLD;
+    
+    uint32_t start = millis();
+    uint32_t total = 0;
+    bool unsupported = true;
+    bool ok = false;
+    const char* mode = "block";
+    
+    if (allowBlock) {
+        ok = uploadBlock(index, subIndex, sink, context, total, unsupported);
+    }
+    if (!ok && unsupported) {
+        // Nothing was delivered yet, so the segmented protocol starts clean
+        mode = "segmented";
+        total = 0;
+        ok = uploadSegmented(index, subIndex, sink, context, total);
+    }
+    
+    rawMode = RAW_OFF;
+    transferActive = false;
+    xSemaphoreGive(transferMutex);
+    
+    if (ok) {
+        successCount++;
+        Serial.printf("[SDO] Upload 0x%04X.%02X: %lu bytes in %lu ms (%s)\n", index, subIndex,
+                      (unsigned long)total, (unsigned long)(millis() - start), mode);
+    } else {
+        failureCount++;
+        Serial.printf("[SDO] Upload 0x%04X.%02X failed: %s\n", index, subIndex, lastError);
+    }
+    
+    if (length) *length = total;
+    return ok;
+}
+
+bool SDOManager::uploadSegmented(uint16_t index, uint8_t subIndex, UploadSink sink, void* context,
+                                 uint32_t& total) {
+    uint8_t request[8] = { SDO_CMD_READ, (uint8_t)index, (uint8_t)(index >> 8), subIndex, 0, 0, 0, 0 };
+    if (!transact(request, true)) {
+        sendAbort(index, subIndex, SDO_ABORT_TIMEOUT);
+        return false;
+    }
+    
+    uint8_t cmd = rawFrame[0];
+    if (cmd == SDO_RESP_ABORT) {
+        recordAbort(readLE32(rawFrame + 4));
+        return false;
+    }
+    if ((cmd & 0xE0) != SDO_SCS_UPLOAD_INIT) {
+        sendAbort(index, subIndex, SDO_ABORT_CMD_INVALID);
+        return false;
+    }
+    
+    // Short objects come back expedited even when asked this way
+    if (cmd & 0x02) {
+        uint8_t size = (cmd & 0x01) ? 4 - ((cmd >> 2) & 0x03) : 4;
+        total = size;
+        return sink(rawFrame + 4, size, context);
+    }
+    
+    uint32_t expected = (cmd & 0x01) ? readLE32(rawFrame + 4) : 0;
+    uint8_t toggle = 0;
+    
+    while (true) {
+        memset(request, 0, sizeof(request));
+        request[0] = SDO_CMD_UPLOAD_SEGMENT | toggle;
+        if (!transact(request, false)) {
+            sendAbort(index, subIndex, SDO_ABORT_TIMEOUT);
+            return false;
+        }
+        
+        cmd = rawFrame[0];
+        if (cmd == SDO_RESP_ABORT) {
+            recordAbort(readLE32(rawFrame + 4));
+            return false;
+        }
+        if ((cmd & 0xE0) != SDO_SCS_UPLOAD_SEGMENT) {
+            sendAbort(index, subIndex, SDO_ABORT_CMD_INVALID);
+            return false;
+        }
+        if ((cmd & 0x10) != toggle) {
+            sendAbort(index, subIndex, SDO_ABORT_TOGGLE);
+            return false;
+        }
+        
+        uint8_t size = 7 - ((cmd >> 1) & 0x07);
+        if (!sink(rawFrame + 1, size, context)) {
+            sendAbort(index, subIndex, SDO_ABORT_MEMORY);
+            return false;
+        }
+        total += size;
+        
+        if (cmd & 0x01) break;  // Last segment
+        toggle ^= 0x10;
+    }
+    
+    if (expected && total != expected) {
+        snprintf(lastError, sizeof(lastError), "Size mismatch: %lu of %lu bytes",
+                 (unsigned long)total, (unsigned long)expected);
+        return false;
+    }
+    return true;
+}
+
+bool SDOManager::uploadBlock(uint16_t index, uint8_t subIndex, UploadSink sink, void* context,
+                             uint32_t& total, bool& unsupported) {
+    uint8_t request[8] = { SDO_CMD_BLOCK_UPLOAD | SDO_BLOCK_CRC | SDO_BLOCK_INITIATE,
+                           (uint8_t)index, (uint8_t)(index >> 8), subIndex,
+                           SDO_BLOCK_SIZE, 0, 0, 0 };  // No protocol switch
+    
+    // A server without block support aborts or stays silent - fall back
+    unsupported = true;
+    if (!transact(request, true)) {
+        return false;
+    }
+    uint8_t cmd = rawFrame[0];
+    if ((cmd & 0xE1) != (SDO_SCS_BLOCK_UPLOAD | SDO_BLOCK_INITIATE)) {
+        if (cmd == SDO_RESP_ABORT) {
+            recordAbort(readLE32(rawFrame + 4));
+        } else {
+            sendAbort(index, subIndex, SDO_ABORT_CMD_INVALID);
+        }
+        return false;
+    }
+    unsupported = false;
+    
+    bool useCrc = (cmd & SDO_BLOCK_CRC) != 0;
+    uint32_t expected = (cmd & 0x02) ? readLE32(rawFrame + 4) : 0;
+    uint16_t crc = 0;
+    uint8_t held[7];    // Final segment - the end frame says how much is data
+    bool last = false;
+    
+    memset(request, 0, sizeof(request));
+    request[0] = SDO_CMD_BLOCK_UPLOAD | SDO_BLOCK_START;
+    
+    bool timedOut = false;
+    
+    while (!last) {
+        // The CAN task files segments straight into blockData and wakes us
+        // at the end of the block
+        blockSeq = 0;
+        blockLast = false;
+        xSemaphoreTake(responseSem, 0);
+        rawMode = RAW_BLOCK;
+        if (!sendFrame(request) || xSemaphoreTake(responseSem, pdMS_TO_TICKS(SDO_TIMEOUT_MS)) != pdTRUE) {
+            rawMode = RAW_HOLD;
+            timeoutCount++;
+            if (timedOut) {
+                sendAbort(index, subIndex, SDO_ABORT_TIMEOUT);
+                return false;
+            }
+            // The segment ending the block was lost; the server is waiting
+            // for an ack, so confirm what did arrive once before giving up
+            timedOut = true;
+            rawFrame[0] = 0;
+        } else {
+            timedOut = false;
+        }
+        if (rawFrame[0] == SDO_RESP_ABORT) {
+            recordAbort(readLE32(rawFrame + 4));
+            return false;
+        }
+        
+        uint8_t received = blockSeq;
+        last = blockLast;
+        size_t bytes = received * 7;
+        if (last) {
+            bytes -= 7;
+            memcpy(held, blockData + bytes, 7);
+        }
+        if (bytes > 0) {
+            if (!sink(blockData, bytes, context)) {
+                sendAbort(index, subIndex, SDO_ABORT_MEMORY);
+                return false;
+            }
+            crc = crc16Ccitt(crc, blockData, bytes);
+            total += bytes;
+        }
+        
+        // Confirm what arrived in order; the server repeats the rest
+        memset(request, 0, sizeof(request));
+        request[0] = SDO_CMD_BLOCK_UPLOAD | SDO_BLOCK_ACK;
+        request[1] = received;
+        request[2] = SDO_BLOCK_SIZE;
+    }
+    
+    // Acknowledging the last block brings the end frame
+    if (!transact(request, false)) {
+        sendAbort(index, subIndex, SDO_ABORT_TIMEOUT);
+        return false;
+    }
+    cmd = rawFrame[0];
+    if (cmd == SDO_RESP_ABORT) {
+        recordAbort(readLE32(rawFrame + 4));
+        return false;
+    }
+    if ((cmd & 0xE3) != (SDO_SCS_BLOCK_UPLOAD | SDO_BLOCK_END)) {
+        sendAbort(index, subIndex, SDO_ABORT_CMD_INVALID);
+        return false;
+    }
+    
+    uint8_t size = 7 - ((cmd >> 2) & 0x07);
+    if (!sink(held, size, context)) {
+        sendAbort(index, subIndex, SDO_ABORT_MEMORY);
+        return false;
+    }
+    crc = crc16Ccitt(crc, held, size);
+    total += size;
+    
+    if (useCrc && crc != (uint16_t)(rawFrame[1] | (rawFrame[2] << 8))) {
+        sendAbort(index, subIndex, SDO_ABORT_CRC);
+        return false;
+    }
+    if (expected && total != expected) {
+        sendAbort(index, subIndex, SDO_ABORT_GENERAL);
+        return false;
+    }
+    
+    memset(request, 0, sizeof(request));
+    request[0] = SDO_CMD_BLOCK_UPLOAD | SDO_BLOCK_END;
+    sendFrame(request);
+    return true;
+}
+
+// Send one request and wait for the next server frame in rawFrame. With
+// matchIndex a late reply to an earlier request is skipped by its index.
+bool SDOManager::transact(const uint8_t* request, bool matchIndex) {
+    xSemaphoreTake(responseSem, 0);
+    rawMode = RAW_FRAME;
+    if (!sendFrame(request)) {
+        rawMode = RAW_HOLD;
+        return false;
+    }
+    
+    uint32_t start = millis();
+    while (true) {
+        uint32_t elapsed = millis() - start;
+        if (elapsed >= SDO_TIMEOUT_MS ||
+            xSemaphoreTake(responseSem, pdMS_TO_TICKS(SDO_TIMEOUT_MS - elapsed)) != pdTRUE) {
+            rawMode = RAW_HOLD;
+            timeoutCount++;
+            strcpy(lastError, "Timeout");
+            return false;
+        }
+        if (!matchIndex || memcmp(rawFrame + 1, request + 1, 3) == 0) {
+            return true;
+        }
+        rawMode = RAW_FRAME;
+    }
+}
+
+void SDOManager::sendAbort(uint16_t index, uint8_t subIndex, uint32_t code) {
+    uint8_t frame[8] = { SDO_CMD_ABORT, (uint8_t)index, (uint8_t)(index >> 8), subIndex,
+                         (uint8_t)code, (uint8_t)(code >> 8), (uint8_t)(code >> 16), (uint8_t)(code >> 24) };
+    sendFrame(frame);
+    recordAbort(code);
+}
+
+void SDOManager::recordAbort(uint32_t code) {
+    lastAbortCode = code;
+    snprintf(lastError, sizeof(lastError), "Abort 0x%08X: %s", code, getAbortCodeDescription(code));
+}
+
+bool SDOManager::sendFrame(const uint8_t* data) {
+    twai_message_t txMsg;
+    memset(&txMsg, 0, sizeof(txMsg));
+    txMsg.identifier = SDO_TX_ID;
+    txMsg.data_length_code = 8;
+    memcpy(txMsg.data, data, 8);
+    return CANDataManager::transmit(txMsg, pdMS_TO_TICKS(10));
+}
+
+bool SDOManager::processResponse(uint32_t id, const uint8_t* data, uint8_t len) {
     // Only process SDO responses
-    if (msg.identifier != SDO_RX_ID) {
-        return;
+    if (id != SDO_RX_ID) {
+        return false;
+    }
+    
+    // Segmented/block transfer running: every server frame belongs to it
+    switch (rawMode) {
+        case RAW_FRAME:
+            memset(rawFrame, 0, sizeof(rawFrame));
+            memcpy(rawFrame, data, len > 8 ? 8 : len);
+            rawMode = RAW_HOLD;
+            xSemaphoreGive(responseSem);
+            return true;
+        
+        case RAW_BLOCK: {
+            uint8_t seq = data[0] & 0x7F;
+            if (len == 8 && data[0] != SDO_RESP_ABORT && seq == blockSeq + 1) {
+                memcpy(blockData + (seq - 1) * 7, data + 1, 7);
+                blockSeq = seq;
+                blockLast = (data[0] & 0x80) != 0;
+            }
+            // A block ends at its last sequence number, the c bit or an abort
+            if (seq >= SDO_BLOCK_SIZE || (data[0] & 0x80)) {
+                memset(rawFrame, 0, sizeof(rawFrame));
+                memcpy(rawFrame, data, len > 8 ? 8 : len);
+                rawMode = RAW_HOLD;
+                xSemaphoreGive(responseSem);
+            }
+            return true;
+        }
+        
+        case RAW_HOLD:
+            return true;
+        
+        default:
+            break;
     }
     
-    if (msg.data_length_code < 4) {
-        return; // Invalid SDO message
+    if (len < 4) {
+        return false; // Invalid SDO message
     }
     
-    uint8_t cmd = msg.data[0];
-    uint8_t byte1 = msg.data[1];
-    uint8_t byte2 = msg.data[2];
-    uint8_t paramId = msg.data[3];
+    // Batch running: queue every parameter reply for writeBatch(). The
+    // frame is still decoded by the caller, so read-backs reach the store.
+    if (batchActive) {
+        if (len == 8 && data[1] == SDO_FIXED_BYTE1 && data[2] == SDO_FIXED_BYTE2) {
+            // Every expedited upload size is a read reply to runBatch()
+            uint32_t value = readLE32(data + 4);
+            uint8_t cmd = decodeExpedited(data, len, value) ? SDO_RESP_READ : data[0];
+            batchReplies.push(BatchReply{ cmd, data[3], value });
+            xSemaphoreGive(responseSem);
+        }
+        return false;
+    }
+    
+    uint8_t cmd = data[0];
+    uint8_t byte1 = data[1];
+    uint8_t byte2 = data[2];
+    uint8_t paramId = data[3];
+    
+    // Ignore responses nobody is waiting for (e.g. replies to the poller)
+    if (!requestPending || paramId != pendingParam) {
+        return false;
+    }
     
     // Verify fixed bytes
     if (byte1 != SDO_FIXED_BYTE1 || byte2 != SDO_FIXED_BYTE2) {
@@ -138,13 +761,16 @@ void SDOManager::processResponse(const twai_message_t& msg) {
         // Continue processing anyway
     }
     
+    // 0x4B (2 bytes) etc. complete a read just like 0x43
+    uint32_t readValue = 0;
+    if (decodeExpedited(data, len, readValue)) {
+        cmd = SDO_RESP_READ;
+    }
+    
     switch (cmd) {
         case SDO_RESP_READ: {
-            // Read response: extract 32-bit value
-            responseValue = msg.data[4] | 
-                          (msg.data[5] << 8) | 
-                          (msg.data[6] << 16) | 
-                          (msg.data[7] << 24);
+            // Read response: extract the value
+            responseValue = (int32_t)readValue;
             responseSuccess = true;
             responseReceived = true;
             
@@ -164,10 +790,10 @@ void SDOManager::processResponse(const twai_message_t& msg) {
         
         case SDO_RESP_ABORT: {
             // Abort response: extract 32-bit abort code
-            lastAbortCode = msg.data[4] | 
-                          (msg.data[5] << 8) | 
-                          (msg.data[6] << 16) | 
-                          (msg.data[7] << 24);
+            lastAbortCode = data[4] | 
+                          (data[5] << 8) | 
+                          (data[6] << 16) | 
+                          (data[7] << 24);
             
             const char* desc = getAbortCodeDescription(lastAbortCode);
             snprintf(lastError, sizeof(lastError), "Abort 0x%08X: %s", 
@@ -185,6 +811,24 @@ void SDOManager::processResponse(const twai_message_t& msg) {
             Serial.printf("[SDO] RX Unknown command: 0x%02X\n", cmd);
             break;
     }
+    
+    if (responseReceived) {
+        requestPending = false;
+        xSemaphoreGive(responseSem);
+    }
+    return false;
+}
+
+bool SDOManager::decodeExpedited(const uint8_t* data, uint8_t len, uint32_t& value) {
+    if (len < 8 || (data[0] & SDO_RESP_READ_MASK) != SDO_RESP_READ) {
+        return false;
+    }
+    uint8_t size = 4 - ((data[0] >> 2) & 0x03);
+    value = 0;
+    for (uint8_t i = 0; i < size; i++) {
+        value |= (uint32_t)data[4 + i] << (8 * i);
+    }
+    return true;
 }
 
 bool SDOManager::sendSDORequest(uint8_t cmd, uint8_t paramId, int32_t value) {
@@ -207,50 +851,37 @@ bool SDOManager::sendSDORequest(uint8_t cmd, uint8_t paramId, int32_t value) {
     txMsg.data[6] = (value >> 16) & 0xFF;   // Value byte 2
     txMsg.data[7] = (value >> 24) & 0xFF;   // Value byte 3 (MSB)
     
-    // Send CAN message
-    esp_err_t result = twai_transmit(&txMsg, pdMS_TO_TICKS(10));
+    // Arm the response matcher before the reply can possibly arrive
+    pendingParam = paramId;
+    requestPending = true;
     
-    if (result == ESP_OK) {
+    // Send CAN message
+    if (CANDataManager::transmit(txMsg, pdMS_TO_TICKS(10))) {
         Serial.printf("[SDO] TX [%02X %02X %02X %02X %02X %02X %02X %02X]\n",
                      txMsg.data[0], txMsg.data[1], txMsg.data[2], txMsg.data[3],
                      txMsg.data[4], txMsg.data[5], txMsg.data[6], txMsg.data[7]);
         return true;
     } else {
-        Serial.printf("[SDO] TX FAILED: %s\n", esp_err_to_name(result));
+        requestPending = false;
+        Serial.println("[SDO] TX FAILED: driver queue full");
         return false;
     }
 }
 
 bool SDOManager::waitForResponse(uint32_t timeoutMs) {
-    uint32_t startTime = millis();
-    int messageCount = 0;
-    
-    // Loop through messages like jamiejones does
-    while (millis() - startTime < timeoutMs && messageCount < 100) {
-        twai_message_t rxMsg;
-        
-        // Try to receive a message (short timeout)
-        if (twai_receive(&rxMsg, pdMS_TO_TICKS(10)) == ESP_OK) {
-            messageCount++;
-            
-            // Check if it's an SDO response (0x583)
-            if (rxMsg.identifier == SDO_RX_ID) {
-                // Process this SDO response
-                processResponse(rxMsg);
-                
-                // If we got a response (success or abort), we're done
-                if (responseReceived) {
-                    return true;
-                }
-            }
-            // Otherwise it's a broadcast message, ignore and keep looking
-        }
+    // The CAN task owns the receive path and hands us the matching response
+    // through processResponse(), so just sleep until it arrives
+    if (xSemaphoreTake(responseSem, pdMS_TO_TICKS(timeoutMs)) == pdTRUE) {
+        return responseReceived;
     }
     
+    requestPending = false;
     return false;
 }
 
 void SDOManager::clearResponse() {
+    requestPending = false;
+    xSemaphoreTake(responseSem, 0);  // Drop a late give from a timed-out request
     responseReceived = false;
     responseSuccess = false;
     responseValue = 0;
@@ -264,6 +895,14 @@ const char* SDOManager::getAbortCodeDescription(uint32_t abortCode) {
             return "SDO protocol timed out";
         case SDO_ABORT_CMD_INVALID:
             return "Invalid or unknown command";
+        case SDO_ABORT_BLOCK_SIZE:
+            return "Invalid block size";
+        case SDO_ABORT_SEQUENCE:
+            return "Invalid sequence number";
+        case SDO_ABORT_CRC:
+            return "CRC error";
+        case SDO_ABORT_MEMORY:
+            return "Out of memory";
         case SDO_ABORT_PARAM_INVALID:
             return "Object does not exist";
         case SDO_ABORT_PARAM_RANGE:
@@ -0,0 +1,101 @@
+#include "SafetyHeartbeat.h"
+#include <driver/twai.h>
+#include <esp_timer.h>
+
+SafetyHeartbeat::SafetyHeartbeat()
+    : immobilizer(nullptr), cpuLock(ESP_PM_CPU_FREQ_MAX, "heartbeat"), lastSendUs(0), windowMin(UINT32_MAX), windowMax(0),
+      windowSum(0), windowJitter(0), windowCount(0), windowFaults(0) {
+    memset(&current, 0, sizeof(current));
+}
+
+void SafetyHeartbeat::begin(Immobilizer* immob) {
+    immobilizer = immob;
+    cpuLock.create();
+}
+
+void SafetyHeartbeat::fillFrame(uint8_t* data, bool unlocked) {
+    memset(data, 0, 8);
+
+    // Locked must always go out as an explicit 0 A
+    uint16_t limit = (unlocked ? CURRENT_UNLOCKED : CURRENT_LOCKED) * 10;
+    data[4] = limit & 0xFF;
+    data[5] = limit >> 8;
+}
+
+void SafetyHeartbeat::cycle() {
+    cpuLock.acquire();
+    
+    bool unlocked = immobilizer && immobilizer->isUnlocked();
+
+    twai_message_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.identifier = IMMOBILIZER_CAN_ID;
+    msg.data_length_code = 8;
+    fillFrame(msg.data, unlocked);
+
+    // No wait: a frame that cannot go out now is late anyway
+    int64_t now = esp_timer_get_time();
+    if (twai_transmit(&msg, 0) == ESP_OK) {
+        if (lastSendUs != 0) {
+            recordPeriod((uint32_t)(now - lastSendUs));
+        }
+        lastSendUs = now;
+        current.sent++;
+    } else {
+        current.txFailed++;
+        windowFaults++;
+    }
+    current.unlocked = unlocked;
+
+    HeartbeatStats& out = stats.beginWrite();
+    out = current;
+    stats.endWrite();
+    
+    cpuLock.release();
+}
+
+// Gap between two frames the driver took - what the receiver sees
+void SafetyHeartbeat::recordPeriod(uint32_t periodUs) {
+    const uint32_t nominalUs = HEARTBEAT_INTERVAL * 1000;
+
+    if (periodUs > (HEARTBEAT_INTERVAL + HEARTBEAT_DEADLINE_SLACK_MS) * 1000) {
+        current.deadlineMisses++;
+        windowFaults++;
+    }
+    if (periodUs > current.worstPeriodUs) {
+        current.worstPeriodUs = periodUs;
+    }
+
+    uint32_t jitter = periodUs > nominalUs ? periodUs - nominalUs : nominalUs - periodUs;
+    if (jitter > windowJitter) windowJitter = jitter;
+    if (periodUs < windowMin) windowMin = periodUs;
+    if (periodUs > windowMax) windowMax = periodUs;
+    windowSum += periodUs;
+
+    if (++windowCount >= HEARTBEAT_STATS_WINDOW) {
+        current.periodMinUs = windowMin;
+        current.periodMaxUs = windowMax;
+        current.periodAvgUs = (uint32_t)(windowSum / windowCount);
+        current.jitterMaxUs = windowJitter;
+        current.windowFaults = windowFaults;
+
+        windowMin = UINT32_MAX;
+        windowMax = 0;
+        windowSum = 0;
+        windowJitter = 0;
+        windowCount = 0;
+        windowFaults = 0;
+    }
+}
+
+void SafetyHeartbeat::printStats() const {
+    HeartbeatStats s;
+    stats.copy(s);
+    Serial.printf("[HEARTBEAT] %s, period %lu-%lu us (avg %lu), jitter %lu us, "
+                  "%lu missed, %lu TX failed, worst %lu us\n",
+                  s.unlocked ? "UNLOCKED" : "LOCKED",
+                  (unsigned long)s.periodMinUs, (unsigned long)s.periodMaxUs,
+                  (unsigned long)s.periodAvgUs, (unsigned long)s.jitterMaxUs,
+                  (unsigned long)s.deadlineMisses, (unsigned long)s.txFailed,
+                  (unsigned long)s.worstPeriodUs);
+}
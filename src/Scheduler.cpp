@@ -0,0 +1,143 @@
+#include "Scheduler.h"
+#include <esp_timer.h>
+
+Scheduler::Scheduler() : jobCount(0) {
+    for (uint8_t i = 0; i < MAX_JOBS; i++) {
+        jobs[i].fn = nullptr;
+        jobs[i].context = nullptr;
+        jobs[i].dueUs = INT64_MAX;
+        memset(&jobs[i].current, 0, sizeof(JobStats));
+    }
+}
+
+int8_t Scheduler::addJob(const char* name, JobFn fn, void* context,
+                         uint32_t periodMs, uint8_t priority, int32_t firstMs) {
+    if (jobCount >= MAX_JOBS || !fn) {
+        return -1;
+    }
+
+    int8_t id = jobCount++;
+    Job& job = jobs[id];
+    job.fn = fn;
+    job.context = context;
+    job.current.name = name;
+    job.current.periodMs = periodMs;
+    job.current.priority = priority;
+    publish(job);
+
+    if (periodMs > 0) {
+        runIn(id, firstMs >= 0 ? (uint32_t)firstMs : periodMs);
+    }
+    return id;
+}
+
+void Scheduler::runIn(int8_t id, uint32_t delayMs) {
+    if (id < 0 || id >= jobCount) return;
+    Job& job = jobs[id];
+    job.dueUs = esp_timer_get_time() + (int64_t)delayMs * 1000;
+    if (!job.current.armed) {
+        job.current.armed = true;
+        publish(job);
+    }
+}
+
+void Scheduler::cancel(int8_t id) {
+    if (id < 0 || id >= jobCount) return;
+    Job& job = jobs[id];
+    job.dueUs = INT64_MAX;
+    job.current.armed = false;
+    publish(job);
+}
+
+uint8_t Scheduler::runDue() {
+    // Bounded, so a job that is always late cannot starve the task's sleep
+    uint8_t ran = 0;
+    while (ran < jobCount * 2) {
+        int64_t now = esp_timer_get_time();
+        int8_t id = nextDue(now);
+        if (id < 0) break;
+        run(jobs[id], now);
+        ran++;
+    }
+    return ran;
+}
+
+// Highest priority among the due jobs, earliest deadline first among equals
+int8_t Scheduler::nextDue(int64_t now) const {
+    int8_t best = -1;
+    for (uint8_t i = 0; i < jobCount; i++) {
+        const Job& job = jobs[i];
+        if (job.dueUs > now) continue;
+        if (best < 0 ||
+            job.current.priority > jobs[best].current.priority ||
+            (job.current.priority == jobs[best].current.priority && job.dueUs < jobs[best].dueUs)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+void Scheduler::run(Job& job, int64_t now) {
+    JobStats& s = job.current;
+    uint32_t late = (uint32_t)(now - job.dueUs);
+
+    // Next deadline before the run, so the job can re-arm itself. Periodic
+    // jobs keep their phase; one that fell a whole period behind restarts
+    // from now rather than running back to back to catch up.
+    if (s.periodMs > 0) {
+        int64_t periodUs = (int64_t)s.periodMs * 1000;
+        job.dueUs += periodUs;
+        if (job.dueUs <= now) {
+            s.skipped += (uint32_t)((now - job.dueUs) / periodUs) + 1;
+            job.dueUs = now + periodUs;
+        }
+    } else {
+        job.dueUs = INT64_MAX;
+        s.armed = false;
+    }
+
+    job.fn(job.context);
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - now);
+
+    s.runs++;
+    s.lastRunUs = elapsed;
+    s.totalRunUs += elapsed;
+    if (elapsed > s.maxRunUs) s.maxRunUs = elapsed;
+    s.lastLateUs = late;
+    s.totalLateUs += late;
+    if (late > s.maxLateUs) s.maxLateUs = late;
+    publish(job);
+}
+
+void Scheduler::publish(Job& job) {
+    JobStats& out = job.stats.beginWrite();
+    out = job.current;
+    job.stats.endWrite();
+}
+
+int64_t Scheduler::getNextDueUs() const {
+    int64_t next = INT64_MAX;
+    for (uint8_t i = 0; i < jobCount; i++) {
+        if (jobs[i].dueUs < next) next = jobs[i].dueUs;
+    }
+    return next;
+}
+
+void Scheduler::getStats(uint8_t id, JobStats& out) const {
+    if (id >= jobCount) id = 0;
+    jobs[id].stats.copy(out);
+}
+
+void Scheduler::printStats() const {
+    Serial.println("[SCHED] job        prio period   runs  avgUs  maxUs  lateAvg lateMax skipped");
+    for (uint8_t i = 0; i < jobCount; i++) {
+        JobStats s;
+        jobs[i].stats.copy(s);
+        uint32_t runs = s.runs > 0 ? s.runs : 1;
+        Serial.printf("[SCHED] %-10s %4d %6lu %6lu %6lu %6lu %8lu %7lu %7lu\n",
+                      s.name, s.priority, (unsigned long)s.periodMs, (unsigned long)s.runs,
+                      (unsigned long)(s.totalRunUs / runs), (unsigned long)s.maxRunUs,
+                      (unsigned long)(s.totalLateUs / runs), (unsigned long)s.maxLateUs,
+                      (unsigned long)s.skipped);
+    }
+}
@@ -0,0 +1,254 @@
+#include "SchemaSync.h"
+#include "Config.h"
+#include "ParamJsonParser.h"
+#include <SPIFFS.h>
+#include <esp_rom_crc.h>
+
+static const uint32_t SCHEMA_KEY_MAGIC = 0x4B484353;  // "SCHK"
+
+static uint32_t readLE32(const uint8_t* data) {
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+           ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static uint32_t crcFile(const char* path, uint32_t& size) {
+    uint8_t chunk[PARAM_LOAD_CHUNK_SIZE];
+    uint32_t crc = 0;
+    size = 0;
+
+    File file = SPIFFS.open(path, "r");
+    if (!file) return 0;
+    while (file.available()) {
+        size_t n = file.read(chunk, sizeof(chunk));
+        if (n == 0) break;
+        crc = esp_rom_crc32_le(crc, chunk, n);
+        size += n;
+    }
+    file.close();
+    return crc;
+}
+
+SchemaSync::SchemaSync()
+    : canManager(nullptr), checked(false), synced(false), connectedSince(0) {
+    memset(&status, 0, sizeof(status));
+    status.result = "not checked";
+}
+
+void SchemaSync::begin(CANDataManager* can) {
+    canManager = can;
+}
+
+void SchemaSync::update() {
+    if (checked || !canManager) return;
+
+    if (!canManager->isConnected()) {
+        connectedSince = 0;
+        return;
+    }
+    if (connectedSince == 0) {
+        connectedSince = millis();
+        return;
+    }
+    if (millis() - connectedSince < SCHEMA_SYNC_DELAY_MS) return;
+
+    // One automatic check per boot; /schema/sync forces another
+    checked = true;
+    sync(false);
+}
+
+bool SchemaSync::sync(bool force) {
+    if (!canManager) return false;
+    status.lastCheck = millis();
+    status.size = 0;
+    status.downloadMs = 0;
+
+    if (!canManager->isConnected()) {
+        status.result = "inverter not connected";
+        return false;
+    }
+
+    uint32_t serial, firmware;
+    if (!readFingerprint(serial, firmware)) {
+        status.result = "could not read serial/version";
+        return false;
+    }
+    status.serial = serial;
+    status.firmware = firmware;
+
+    // Same inverter and firmware as the cached JSON: nothing to fetch
+    SchemaKey key;
+    if (!force && loadKey(key) && key.serial == serial && key.firmware == firmware &&
+        SPIFFS.exists(PARAM_JSON_PATH)) {
+        synced = true;
+        status.result = "up to date";
+        #if DEBUG_SERIAL
+        Serial.printf("[SCHEMA] Firmware 0x%08X unchanged, using cached %s\n", firmware, PARAM_JSON_PATH);
+        #endif
+        return true;
+    }
+
+    uint32_t start = millis();
+    uint32_t crc, size;
+    if (!download(SCHEMA_DOWNLOAD_PATH, crc, size)) {
+        SPIFFS.remove(SCHEMA_DOWNLOAD_PATH);
+        status.result = "download failed";
+        return false;
+    }
+    status.size = size;
+    status.downloadMs = millis() - start;
+
+    // Byte-identical to what is loaded: only remember the firmware
+    uint32_t cachedSize;
+    uint32_t cachedCrc = crcFile(PARAM_JSON_PATH, cachedSize);
+    if (cachedSize == size && cachedCrc == crc) {
+        SPIFFS.remove(SCHEMA_DOWNLOAD_PATH);
+        saveKey(serial, firmware, crc, size);
+        synced = true;
+        status.added = status.removed = status.changed = 0;
+        status.unchanged = canManager->getParameterCount();
+        status.result = "unchanged";
+        #if DEBUG_SERIAL
+        Serial.printf("[SCHEMA] Downloaded %lu bytes in %lu ms, identical to %s\n",
+                      (unsigned long)size, (unsigned long)status.downloadMs, PARAM_JSON_PATH);
+        #endif
+        return true;
+    }
+
+    if (!diff(SCHEMA_DOWNLOAD_PATH)) {
+        SPIFFS.remove(SCHEMA_DOWNLOAD_PATH);
+        status.result = "downloaded JSON did not parse";
+        return false;
+    }
+
+    SPIFFS.remove(PARAM_JSON_PATH);
+    if (!SPIFFS.rename(SCHEMA_DOWNLOAD_PATH, PARAM_JSON_PATH)) {
+        SPIFFS.remove(SCHEMA_DOWNLOAD_PATH);
+        status.result = "could not replace params.json";
+        return false;
+    }
+    saveKey(serial, firmware, crc, size);
+    synced = true;
+
+    // The CAN task owns the table; it rebuilds the binary cache as it loads.
+    // Wait for it, so the next request here already sees the new schema.
+    canManager->requestReload();
+    uint32_t waitStart = millis();
+    while (canManager->isReloadPending() && millis() - waitStart < 2000) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    status.result = "updated";
+
+    #if DEBUG_SERIAL
+    Serial.printf("[SCHEMA] Downloaded %lu bytes in %lu ms: %d added, %d removed, %d changed, %d unchanged\n",
+                  (unsigned long)size, (unsigned long)status.downloadMs,
+                  status.added, status.removed, status.changed, status.unchanged);
+    #endif
+    return true;
+}
+
+bool SchemaSync::readFingerprint(uint32_t& serial, uint32_t& firmware) {
+    SDOManager& sdo = canManager->getSDO();
+    uint8_t data[16];
+    size_t length;
+
+    // Both are single words - expedited, no point offering block mode
+    if (!sdo.upload(SCHEMA_SERIAL_INDEX, 0, data, sizeof(data), length, false) || length < 4) {
+        return false;
+    }
+    serial = readLE32(data);
+
+    if (!sdo.upload(0x2100 | (SCHEMA_VERSION_UID >> 8), SCHEMA_VERSION_UID & 0xFF,
+                    data, sizeof(data), length, false) || length < 4) {
+        return false;
+    }
+    firmware = readLE32(data);
+    return true;
+}
+
+bool SchemaSync::loadKey(SchemaKey& key) {
+    File file = SPIFFS.open(SCHEMA_KEY_PATH, "r");
+    if (!file) return false;
+    bool ok = file.read((uint8_t*)&key, sizeof(key)) == sizeof(key) && key.magic == SCHEMA_KEY_MAGIC;
+    file.close();
+    return ok;
+}
+
+bool SchemaSync::saveKey(uint32_t serial, uint32_t firmware, uint32_t crc, uint32_t size) {
+    SchemaKey key = { SCHEMA_KEY_MAGIC, serial, firmware, crc, size };
+    File file = SPIFFS.open(SCHEMA_KEY_PATH, "w");
+    if (!file) return false;
+    bool ok = file.write((const uint8_t*)&key, sizeof(key)) == sizeof(key);
+    file.close();
+    return ok;
+}
+
+bool SchemaSync::writeChunk(const uint8_t* data, size_t length, void* context) {
+    DownloadState* state = (DownloadState*)context;
+    if (state->size + length > SCHEMA_MAX_SIZE) return false;
+    if (state->file->write(data, length) != length) return false;  // SPIFFS full
+
+    state->crc = esp_rom_crc32_le(state->crc, data, length);
+    state->size += length;
+    return true;
+}
+
+// Stream the JSON from the inverter straight into a SPIFFS file
+bool SchemaSync::download(const char* path, uint32_t& crc, uint32_t& size) {
+    File file = SPIFFS.open(path, "w");
+    if (!file) return false;
+
+    DownloadState state = { &file, 0, 0 };
+    bool ok = canManager->getSDO().upload(SCHEMA_SDO_INDEX, 0, writeChunk, &state);
+    file.close();
+
+    crc = state.crc;
+    size = state.size;
+    return ok && size > 0;
+}
+
+void SchemaSync::diffParam(const ParamRecord& record, void* context) {
+    DiffState* state = (DiffState*)context;
+    const ParamMeta* old = state->manager->getParameter(record.id);
+
+    if (!old) {
+        state->added++;
+    } else if (strcmp(old->name, record.name) == 0 && strcmp(old->unit, record.unit) == 0 &&
+               old->minValue == record.minValue && old->maxValue == record.maxValue &&
+               old->decimalPlaces == record.decimals && old->editable == record.editable) {
+        state->unchanged++;
+    } else {
+        state->changed++;
+    }
+}
+
+// Compare the downloaded JSON with the loaded table, parameter by parameter.
+// Also proves the download parses before it replaces anything.
+bool SchemaSync::diff(const char* path) {
+    File file = SPIFFS.open(path, "r");
+    if (!file) return false;
+
+    // diffParam() compares against the loaded metadata
+    ParamTableLock table(canManager);
+    ParamJsonParser parser;
+    DiffState state = { canManager, 0, 0, 0 };
+    parser.begin(diffParam, &state);
+
+    char chunk[PARAM_LOAD_CHUNK_SIZE];
+    while (file.available()) {
+        size_t n = file.read((uint8_t*)chunk, sizeof(chunk));
+        if (n == 0 || !parser.feed(chunk, n)) break;
+    }
+    file.close();
+
+    if (!parser.finish() || parser.getRecordCount() == 0) {
+        return false;
+    }
+
+    uint16_t matched = state.changed + state.unchanged;
+    uint16_t oldCount = canManager->getParameterCount();
+    status.added = state.added;
+    status.changed = state.changed;
+    status.unchanged = state.unchanged;
+    status.removed = oldCount > matched ? oldCount - matched : 0;
+    return true;
+}
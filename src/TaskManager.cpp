@@ -0,0 +1,156 @@
+#include "TaskManager.h"
+#include <esp_timer.h>
+
+TaskManager::TaskManager() : taskCount(0) {
+    memset(tasks, 0, sizeof(tasks));
+}
+
+bool TaskManager::addTask(const char* name, void (*cycle)(), uint8_t core,
+                          uint8_t priority, uint32_t stackSize, uint32_t periodMs) {
+    if (taskCount >= MAX_TASKS || !cycle) {
+        return false;
+    }
+
+    TaskSlot& slot = tasks[taskCount++];
+    slot.cycle = cycle;
+    slot.stackSize = stackSize;
+    slot.stats.name = name;
+    slot.stats.core = core;
+    slot.stats.priority = priority;
+    slot.stats.periodMs = periodMs;
+    return true;
+}
+
+bool TaskManager::addTask(const char* name, Scheduler* scheduler, uint8_t core,
+                          uint8_t priority, uint32_t stackSize) {
+    if (taskCount >= MAX_TASKS || !scheduler) {
+        return false;
+    }
+
+    TaskSlot& slot = tasks[taskCount++];
+    slot.scheduler = scheduler;
+    slot.stackSize = stackSize;
+    slot.stats.name = name;
+    slot.stats.core = core;
+    slot.stats.priority = priority;
+    slot.stats.periodMs = 0;
+    return true;
+}
+
+bool TaskManager::begin() {
+    bool ok = true;
+
+    for (uint8_t i = 0; i < taskCount; i++) {
+        TaskSlot& slot = tasks[i];
+        slot.windowStartUs = esp_timer_get_time();
+
+        BaseType_t result = xTaskCreatePinnedToCore(
+            taskEntry, slot.stats.name, slot.stackSize, &slot,
+            slot.stats.priority, &slot.handle, slot.stats.core);
+
+        if (result != pdPASS) {
+            Serial.printf("[TASK] Failed to create %s\n", slot.stats.name);
+            ok = false;
+            continue;
+        }
+
+        #if DEBUG_SERIAL
+        if (slot.scheduler) {
+            Serial.printf("[TASK] %s: core %d, prio %d, %d jobs\n",
+                          slot.stats.name, slot.stats.core, slot.stats.priority,
+                          slot.scheduler->getJobCount());
+        } else {
+            Serial.printf("[TASK] %s: core %d, prio %d, every %dms\n",
+                          slot.stats.name, slot.stats.core, slot.stats.priority, slot.stats.periodMs);
+        }
+        #endif
+    }
+
+    return ok;
+}
+
+void TaskManager::taskEntry(void* arg) {
+    TaskSlot* slot = (TaskSlot*)arg;
+    const TickType_t period = pdMS_TO_TICKS(slot->stats.periodMs) > 0 ? pdMS_TO_TICKS(slot->stats.periodMs) : 1;
+    TickType_t lastWake = xTaskGetTickCount();
+
+    while (true) {
+        uint64_t start = esp_timer_get_time();
+        if (slot->scheduler) {
+            slot->scheduler->runDue();
+        } else {
+            slot->cycle();
+        }
+        uint64_t end = esp_timer_get_time();
+
+        uint32_t elapsed = (uint32_t)(end - start);
+        slot->stats.lastCycleUs = elapsed;
+        slot->stats.cycles++;
+        slot->busyUs += elapsed;
+        if (elapsed > slot->windowMaxUs) {
+            slot->windowMaxUs = elapsed;
+        }
+
+        // Close the measurement window
+        uint64_t window = end - slot->windowStartUs;
+        if (window >= (uint64_t)TASK_STATS_INTERVAL_MS * 1000) {
+            slot->stats.cpuPercent = (uint8_t)((slot->busyUs * 100) / window);
+            slot->stats.maxCycleUs = slot->windowMaxUs;
+            slot->stats.stackFree = uxTaskGetStackHighWaterMark(nullptr);
+            slot->busyUs = 0;
+            slot->windowMaxUs = 0;
+            slot->windowStartUs = end;
+        }
+
+        if (slot->scheduler) {
+            sleepUntilDue(slot);
+            continue;
+        }
+
+        // Fixed-rate wakeups. If the cycle overran, restart the schedule and
+        // still yield a tick so lower priority tasks on this core get to run.
+        TickType_t now = xTaskGetTickCount();
+        if (now - lastWake >= period) {
+            lastWake = now;
+            vTaskDelay(1);
+        } else {
+            vTaskDelayUntil(&lastWake, period);
+        }
+    }
+}
+
+// Sleep to the scheduler's next deadline, rounded up to a whole tick (a
+// tick early would only wake to find nothing due). Always at least one
+// tick, so lower priority tasks on this core get to run.
+void TaskManager::sleepUntilDue(TaskSlot* slot) {
+    const int64_t tickUs = (int64_t)portTICK_PERIOD_MS * 1000;
+    int64_t untilUs = slot->scheduler->getNextDueUs() - (int64_t)esp_timer_get_time();
+
+    TickType_t ticks = 1;
+    if (untilUs > (int64_t)TASK_STATS_INTERVAL_MS * 1000) {
+        // Nothing armed soon: still come round for the stats window
+        ticks = pdMS_TO_TICKS(TASK_STATS_INTERVAL_MS);
+    } else if (untilUs > tickUs) {
+        ticks = (TickType_t)((untilUs + tickUs - 1) / tickUs);
+    }
+    vTaskDelay(ticks);
+}
+
+const TaskStats& TaskManager::getStats(uint8_t index) {
+    if (index >= taskCount) index = 0;
+    return tasks[index].stats;
+}
+
+Scheduler* TaskManager::getScheduler(uint8_t index) {
+    if (index >= taskCount) return nullptr;
+    return tasks[index].scheduler;
+}
+
+void TaskManager::printStats() {
+    Serial.println("[TASK] name       core prio  cpu%  maxUs  stack");
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const TaskStats& s = tasks[i].stats;
+        Serial.printf("[TASK] %-10s %4d %4d %5d %6d %6d\n",
+                      s.name, s.core, s.priority, s.cpuPercent, s.maxCycleUs, s.stackFree);
+    }
+}
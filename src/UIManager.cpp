@@ -1,18 +1,69 @@
 #include "UIManager.h"
 #include "Immobilizer.h"  // Need full definition, not just forward declaration
+#include "InputManager.h"
+#include "WiFiManager.h"
 #include <M5GFX.h>
+#include <esp_timer.h>
 
 // Static instance for callbacks
 UIManager* UIManager::instance = nullptr;
 
+// Parameters each screen shows. setScreen() hands the set to the CAN task,
+// which polls it fast and runs the optional decoders it asks for, and
+// update() only redraws when one of them changed. In ScreenID order.
+struct ScreenParams {
+    const uint16_t* ids;
+    uint8_t count;
+    uint8_t decode;     // DECODE_* groups
+};
+
+static const uint16_t DASHBOARD_PARAMS[] = {1, 3, 2, 7};
+static const uint16_t POWER_PARAMS[] = {2, 3, 4, 7};
+static const uint16_t TEMPERATURE_PARAMS[] = {5, 6, 14};
+static const uint16_t BATTERY_PARAMS[] = {7, 3, 4, 14};
+static const uint16_t BMS_PARAMS[] = {7, 20, 21, 24};
+static const uint16_t GEAR_PARAMS[] = {27};
+static const uint16_t MOTOR_PARAMS[] = {129};
+static const uint16_t REGEN_PARAMS[] = {61};
+
+#define SCREEN_PARAMS_OF(ids, decode) { ids, sizeof(ids) / sizeof(ids[0]), decode }
+
+static const ScreenParams SCREEN_PARAMS[] = {
+    { nullptr, 0, 0 },                                  // Splash
+    { nullptr, 0, 0 },                                  // Lock
+    SCREEN_PARAMS_OF(DASHBOARD_PARAMS, 0),
+    SCREEN_PARAMS_OF(POWER_PARAMS, 0),
+    SCREEN_PARAMS_OF(TEMPERATURE_PARAMS, 0),
+    SCREEN_PARAMS_OF(BATTERY_PARAMS, 0),
+    SCREEN_PARAMS_OF(BMS_PARAMS, DECODE_BMS_CELLS),
+    SCREEN_PARAMS_OF(GEAR_PARAMS, 0),
+    SCREEN_PARAMS_OF(MOTOR_PARAMS, 0),
+    SCREEN_PARAMS_OF(REGEN_PARAMS, 0),
+    { nullptr, 0, 0 },                                  // WiFi
+    { nullptr, 0, 0 }                                   // Settings
+};
+static_assert(sizeof(SCREEN_PARAMS) / sizeof(SCREEN_PARAMS[0]) == SCREEN_COUNT,
+              "SCREEN_PARAMS must list every screen");
+static_assert(SCREEN_COUNT <= MAX_INTEREST_TAGS, "Screen ids are interest tags");
+
 UIManager::UIManager() 
-    : canManager(nullptr), immobilizer(nullptr), currentScreen(SCREEN_SPLASH), 
-      lastUpdateTime(0), buf1(nullptr), buf2(nullptr), editMode(false) {
+    : canManager(nullptr), immobilizer(nullptr), heartbeat(nullptr), input(nullptr),
+      wifiManager(nullptr), currentScreen(SCREEN_SPLASH), 
+      scheduler(nullptr), refreshJob(-1), lastDataTime(0), buf1(nullptr), buf2(nullptr), editMode(false),
+      wifiMode(false), paused(false), encoderIndev(nullptr), encoderDiff(0), encoderClicks(0),
+      encoderPressed(false), touchDown(false), touchUp(false), touchX(0), touchY(0),
+      regenPending(false), inputUs(0), inputPending(false) {
     instance = this;
+    memset(&inputLatency, 0, sizeof(inputLatency));
     
     // Initialize screen array
     for (int i = 0; i < SCREEN_COUNT; i++) {
         screens[i] = nullptr;
+        groups[i] = nullptr;
+        editGroups[i] = nullptr;
+        dials[i] = nullptr;
+        refreshCount[i] = 0;
+        refreshSkipped[i] = 0;
     }
 }
 
@@ -49,12 +100,18 @@ bool UIManager::init(CANDataManager* canMgr, Immobilizer* immob) {
     disp_drv.user_data = this;
     lv_disp_drv_register(&disp_drv);
     
-    // Initialize input device driver (for encoder)
+    // Input devices: the encoder (dial + button) and the touch panel
     lv_indev_drv_init(&indev_drv);
     indev_drv.type = LV_INDEV_TYPE_ENCODER;
     indev_drv.read_cb = lvgl_encoder_read_cb;
     indev_drv.user_data = this;
-    lv_indev_drv_register(&indev_drv);
+    encoderIndev = lv_indev_drv_register(&indev_drv);
+    
+    lv_indev_drv_init(&pointer_drv);
+    pointer_drv.type = LV_INDEV_TYPE_POINTER;
+    pointer_drv.read_cb = lvgl_pointer_read_cb;
+    pointer_drv.user_data = this;
+    lv_indev_drv_register(&pointer_drv);
     
     // Apply default theme
     lv_theme_t* theme = lv_theme_default_init(
@@ -79,6 +136,7 @@ bool UIManager::init(CANDataManager* canMgr, Immobilizer* immob) {
     createRegenScreen();
     createWiFiScreen();
     createSettingsScreen();
+    createInputGroups();
     
     // Load splash screen
     setScreen(SCREEN_SPLASH);
@@ -97,28 +155,262 @@ void UIManager::lvgl_flush_cb(lv_disp_drv_t* disp, const lv_area_t* area, lv_col
     M5.Display.pushPixels((uint16_t*)&color_p->full, w * h, true);
     M5.Display.endWrite();
     
+    // Last area of the first frame drawn since the input: it is on screen
+    UIManager* ui = (UIManager*)disp->user_data;
+    if (ui->inputPending && lv_disp_flush_is_last(disp)) {
+        uint32_t latency = (uint32_t)esp_timer_get_time() - ui->inputUs;
+        ui->inputPending = false;
+        ui->inputLatency.samples++;
+        ui->inputLatency.lastUs = latency;
+        ui->inputLatency.totalUs += latency;
+        if (latency > ui->inputLatency.maxUs) {
+            ui->inputLatency.maxUs = latency;
+        }
+    }
+    
     lv_disp_flush_ready(disp);
 }
 
+void UIManager::markInput(uint32_t timeUs) {
+    // Keep the older input if the last one has not been drawn yet
+    if (inputPending) return;
+    inputUs = timeUs;
+    inputPending = true;
+}
+
 void UIManager::lvgl_encoder_read_cb(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
-    // This will be handled by InputManager externally
-    // For now, just report no change
-    data->enc_diff = 0;
-    data->state = LV_INDEV_STATE_RELEASED;
+    UIManager* ui = (UIManager*)indev_drv->user_data;
+    
+    data->enc_diff = (int16_t)ui->encoderDiff;
+    ui->encoderDiff = 0;
+    
+    // A click is a press in one read and its release in the next
+    if (ui->encoderPressed) {
+        ui->encoderPressed = false;
+    } else if (ui->encoderClicks > 0) {
+        ui->encoderClicks--;
+        ui->encoderPressed = true;
+    }
+    data->key = LV_KEY_ENTER;
+    data->state = ui->encoderPressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->continue_reading = ui->encoderPressed || ui->encoderClicks > 0;
+}
+
+void UIManager::lvgl_pointer_read_cb(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
+    UIManager* ui = (UIManager*)indev_drv->user_data;
+    
+    // Follow the finger while it is down
+    if (ui->touchDown && !ui->touchUp && ui->input) {
+        ui->input->getTouchPoint(ui->touchX, ui->touchY);
+    }
+    data->point.x = ui->touchX;
+    data->point.y = ui->touchY;
+    data->state = ui->touchDown ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    
+    // Pressed and lifted within one UI cycle: LVGL still sees the press,
+    // then the release in a second read
+    if (ui->touchDown && ui->touchUp) {
+        ui->touchDown = false;
+        ui->touchUp = false;
+        data->continue_reading = true;
+    }
+}
+
+// Hand what InputManager queued to the LVGL indevs. The few inputs that
+// are not about the focused widget (lock toggle, dashboard, swipes) are
+// acted on here.
+void UIManager::readInput() {
+    if (!input) return;
+    
+    bool fresh = false;
+    while (input->hasEvent()) {
+        InputEvent event = input->getNextEvent();
+        
+        switch (event.type) {
+            case INPUT_ENCODER_CW:
+            case INPUT_ENCODER_CCW:
+                // The regen arc takes the accelerated steps, everything
+                // else (focus, screens, PIN digits) goes one per detent
+                encoderDiff += (editMode && currentScreen == SCREEN_REGEN)
+                                   ? event.encoderSteps : event.encoderDelta;
+                fresh = true;
+                break;
+            case INPUT_BUTTON_CLICK:
+                encoderClicks++;
+                fresh = true;
+                break;
+            case INPUT_TOUCH_PRESS:
+                touchDown = true;
+                touchUp = false;
+                touchX = event.touchX;
+                touchY = event.touchY;
+                fresh = true;
+                break;
+            case INPUT_TOUCH_RELEASE:
+                if (touchDown) {
+                    touchUp = true;
+                    touchX = event.touchX;
+                    touchY = event.touchY;
+                    fresh = true;
+                }
+                break;
+            case INPUT_TOUCH_GESTURE:
+                // A finger around the rim turns the dial like the encoder
+                if (event.gesture == GESTURE_ROTATE) {
+                    encoderDiff += event.gestureValue;
+                    fresh = true;
+                } else {
+                    handleGesture(event);
+                }
+                break;
+            case INPUT_BUTTON_DOUBLE_CLICK:
+                // Toggles the immobilizer (for testing)
+                if (immobilizer) {
+                    immobilizer->toggleLock();
+                    Serial.printf(">>> IMMOBILIZER: %s (via double-click) <<<\n", 
+                                  immobilizer->isUnlocked() ? "UNLOCKED" : "LOCKED");
+                    if (!immobilizer->isUnlocked()) {
+                        setScreen(SCREEN_LOCK);
+                    }
+                }
+                break;
+            case INPUT_BUTTON_LONG_PRESS:
+                // Back to dashboard (works in any mode)
+                if (wifiMode) {
+                    setWiFiMode(false);
+                } else {
+                    setScreen(SCREEN_DASHBOARD);
+                }
+                break;
+            default:
+                // Taps: the pointer indev already delivered the click
+                break;
+        }
+    }
+    
+    // Read it in this lv_timer_handler() call rather than up to
+    // LV_INDEV_DEF_READ_PERIOD later
+    if (fresh) {
+        lv_timer_ready(indev_drv.read_timer);
+        lv_timer_ready(pointer_drv.read_timer);
+    }
+}
+
+void UIManager::discardInput() {
+    if (!input) return;
+    while (input->hasEvent()) {
+        input->getNextEvent();
+    }
+}
+
+void UIManager::setPaused(bool pause) {
+    if (pause == paused) return;
+    paused = pause;
+    
+    if (!paused) {
+        // The turn or touch that woke the display only wakes it
+        discardInput();
+        inputPending = false;
+        
+        // The power manager had the CAN task poll its own set meanwhile
+        if (canManager) {
+            const ScreenParams& params = SCREEN_PARAMS[currentScreen];
+            canManager->setInterest(INTEREST_SCREEN, currentScreen, params.ids, params.count, params.decode);
+        }
+        lastDataTime = UINT32_MAX;
+        lv_obj_invalidate(lv_scr_act());
+    }
+}
+
+void UIManager::handleGesture(const InputEvent& event) {
+    // Needs the car unlocked, and no edit in progress
+    if (isLocked() || wifiMode || editMode) {
+        return;
+    }
+    
+    switch (event.gesture) {
+        case GESTURE_SWIPE_LEFT:
+            setScreen(getNextScreen());
+            break;
+        case GESTURE_SWIPE_RIGHT:
+            setScreen(getPreviousScreen());
+            break;
+        case GESTURE_LONG_PRESS:
+            setScreen(SCREEN_DASHBOARD);
+            break;
+        default:
+            break;
+    }
 }
 
 void UIManager::update() {
+    if (paused) {
+        discardInput();
+        return;
+    }
+    
+    readInput();
+    
     // Handle LVGL tasks
     lv_timer_handler();
     
+    // The arc may have taken several steps in that pass: one write for all
+    if (regenPending) {
+        regenPending = false;
+        if (canManager) {
+            canManager->setParameter(61, lv_arc_get_value(regen_arc));
+            #if DEBUG_SERIAL
+            Serial.printf("Regen: %d\n", lv_arc_get_value(regen_arc));
+            #endif
+        }
+    }
+    
+    // Nothing redrew within half a second: that input had no visible effect
+    if (inputPending && (uint32_t)esp_timer_get_time() - inputUs > 500000) {
+        inputPending = false;
+        inputLatency.unrendered++;
+    }
+    
     // Update lock screen if active
     if (currentScreen == SCREEN_LOCK && immobilizer) {
         updateLockScreen();
     }
     
-    // Update current screen data every 100ms
-    if (millis() - lastUpdateTime >= 100) {
-        lastUpdateTime = millis();
+    // No wait for the next refresh while an edit is on its way to the screen
+    if (inputPending && scheduler) {
+        scheduler->runIn(refreshJob, 0);
+    }
+}
+
+void UIManager::schedule(Scheduler* sched) {
+    scheduler = sched;
+    refreshJob = sched->addJob("screen", refreshJobFn, this, UI_REFRESH_MS, JOB_PRIORITY_NORMAL);
+    sched->addJob("settings", settingsJobFn, this, UI_SETTINGS_REFRESH_MS, JOB_PRIORITY_NORMAL);
+}
+
+void UIManager::refreshJobFn(void* context) {
+    ((UIManager*)context)->refreshScreen();
+}
+
+// System info has no CAN parameters, just refresh it twice a second
+void UIManager::settingsJobFn(void* context) {
+    UIManager* self = (UIManager*)context;
+    if (!self->paused && self->currentScreen == SCREEN_SETTINGS) {
+        self->updateSettings();
+    }
+}
+
+// Redraw the current screen's values, if any of them moved
+void UIManager::refreshScreen() {
+    const ScreenParams& params = SCREEN_PARAMS[currentScreen];
+    if (!paused && params.count > 0 && canManager) {
+        uint32_t newest = canManager->getLastUpdate(params.ids, params.count);
+        if (newest == lastDataTime) {
+            if (!inputPending) refreshSkipped[currentScreen]++;
+            return;
+        }
+        lastDataTime = newest;
+        refreshCount[currentScreen]++;
         
         switch (currentScreen) {
             case SCREEN_LOCK:
@@ -157,13 +449,53 @@ void UIManager::update() {
 void UIManager::setScreen(ScreenID screen) {
     if (screen >= SCREEN_COUNT) return;
     
+    #if DEBUG_SERIAL
+    if (screen != currentScreen) {
+        printScreenCost(currentScreen);
+    }
+    #endif
+    
+    // Leaving a screen mid-edit drops back to navigation
+    if (editMode) {
+        toggleEditMode();
+    }
+    
     currentScreen = screen;
+    lastDataTime = UINT32_MAX;  // Draw the new screen once whatever the data
+    
+    if (encoderIndev && groups[screen]) {
+        lv_indev_set_group(encoderIndev, groups[screen]);
+    }
+    
+    if (canManager) {
+        const ScreenParams& params = SCREEN_PARAMS[screen];
+        canManager->setInterest(INTEREST_SCREEN, screen, params.ids, params.count, params.decode);
+    }
     
     if (screens[screen]) {
         lv_scr_load_anim(screens[screen], LV_SCR_LOAD_ANIM_FADE_IN, 200, 0, false);
     }
 }
 
+// What a screen has cost so far, all visits together: SDO reads and CAN
+// decode time on the CAN task, and how many redraws the change check saved
+void UIManager::printScreenCost(ScreenID screen) {
+    if (!canManager) return;
+    
+    const InterestStats& cost = canManager->getInterestStats(screen);
+    if (cost.activeMs < 1000) return;
+    
+    Serial.printf("[SCREEN] %d: %lu s shown, %lu.%lu SDO/s, decode %lu us/s, "
+                  "%lu frames/s skipped, %lu/%lu redraws skipped\n",
+                  screen, (unsigned long)(cost.activeMs / 1000),
+                  (unsigned long)((uint64_t)cost.sdoRequests * 1000 / cost.activeMs),
+                  (unsigned long)((uint64_t)cost.sdoRequests * 10000 / cost.activeMs % 10),
+                  (unsigned long)((uint64_t)cost.decodeUs * 1000 / cost.activeMs),
+                  (unsigned long)((uint64_t)cost.framesSkipped * 1000 / cost.activeMs),
+                  (unsigned long)refreshSkipped[screen],
+                  (unsigned long)(refreshSkipped[screen] + refreshCount[screen]));
+}
+
 ScreenID UIManager::getNextScreen() {
     int next = (int)currentScreen + 1;
     if (next >= SCREEN_COUNT) next = 0;
@@ -621,12 +953,20 @@ void UIManager::createGearScreen() {
         lv_obj_set_style_text_color(gear_option_labels[i], lv_palette_darken(LV_PALETTE_GREY, 1), 0);
         lv_obj_set_pos(gear_option_labels[i], positions[i][0], positions[i][1]);
         
+        // Tap to select: LVGL hit-tests the label, with some slack around it
+        lv_obj_add_flag(gear_option_labels[i], LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_set_ext_click_area(gear_option_labels[i], 12);
+        lv_obj_set_user_data(gear_option_labels[i], (void*)(intptr_t)i);
+        lv_obj_add_event_cb(gear_option_labels[i], onOptionEvent, LV_EVENT_FOCUSED, this);
+        lv_obj_add_event_cb(gear_option_labels[i], onOptionEvent, LV_EVENT_CLICKED, this);
+        
         // Indicator LED
         gear_indicators[i] = lv_obj_create(screens[SCREEN_GEAR]);
         lv_obj_set_size(gear_indicators[i], 8, 8);
         lv_obj_set_style_radius(gear_indicators[i], LV_RADIUS_CIRCLE, 0);
         lv_obj_set_style_bg_color(gear_indicators[i], lv_palette_darken(LV_PALETTE_GREY, 3), 0);
         lv_obj_set_style_border_width(gear_indicators[i], 0, 0);
+        lv_obj_clear_flag(gear_indicators[i], LV_OBJ_FLAG_CLICKABLE);
         lv_obj_set_pos(gear_indicators[i], positions[i][0] - 15, positions[i][1] + 5);
     }
     
@@ -676,12 +1016,20 @@ void UIManager::createMotorScreen() {
         lv_obj_set_style_text_color(motor_option_labels[i], lv_palette_darken(LV_PALETTE_GREY, 1), 0);
         lv_obj_set_pos(motor_option_labels[i], positions[i][0], positions[i][1]);
         
+        // Tap to select: LVGL hit-tests the label, with some slack around it
+        lv_obj_add_flag(motor_option_labels[i], LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_set_ext_click_area(motor_option_labels[i], 12);
+        lv_obj_set_user_data(motor_option_labels[i], (void*)(intptr_t)i);
+        lv_obj_add_event_cb(motor_option_labels[i], onOptionEvent, LV_EVENT_FOCUSED, this);
+        lv_obj_add_event_cb(motor_option_labels[i], onOptionEvent, LV_EVENT_CLICKED, this);
+        
         // Indicator LED
         motor_indicators[i] = lv_obj_create(screens[SCREEN_MOTOR]);
         lv_obj_set_size(motor_indicators[i], 8, 8);
         lv_obj_set_style_radius(motor_indicators[i], LV_RADIUS_CIRCLE, 0);
         lv_obj_set_style_bg_color(motor_indicators[i], lv_palette_darken(LV_PALETTE_GREY, 3), 0);
         lv_obj_set_style_border_width(motor_indicators[i], 0, 0);
+        lv_obj_clear_flag(motor_indicators[i], LV_OBJ_FLAG_CLICKABLE);
         lv_obj_set_pos(motor_indicators[i], positions[i][0] - 15, positions[i][1] + 5);
     }
     
@@ -721,7 +1069,9 @@ void UIManager::createRegenScreen() {
     lv_obj_set_style_arc_color(regen_arc, lv_palette_darken(LV_PALETTE_GREY, 3), LV_PART_MAIN);
     lv_obj_set_style_arc_color(regen_arc, lv_palette_main(LV_PALETTE_GREEN), LV_PART_INDICATOR);
     lv_obj_remove_style(regen_arc, NULL, LV_PART_KNOB);
-    lv_obj_clear_flag(regen_arc, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(regen_arc, LV_OBJ_FLAG_CLICKABLE);  // The rim is the dial gesture
+    lv_obj_add_event_cb(regen_arc, onRegenEvent, LV_EVENT_VALUE_CHANGED, this);
+    lv_obj_add_event_cb(regen_arc, onRegenEvent, LV_EVENT_CLICKED, this);
     
     // Regen value (center)
     regen_value_label = lv_label_create(screens[SCREEN_REGEN]);
@@ -737,6 +1087,18 @@ void UIManager::createRegenScreen() {
     lv_obj_set_style_text_color(inst, lv_palette_darken(LV_PALETTE_GREY, 2), 0);
     lv_obj_set_style_text_align(inst, LV_TEXT_ALIGN_CENTER, 0);
     lv_obj_align(inst, LV_ALIGN_BOTTOM_MID, 0, -15);
+    
+    // Invisible tap zones over each half (the labels above take no clicks)
+    regen_down_zone = lv_obj_create(screens[SCREEN_REGEN]);
+    regen_up_zone = lv_obj_create(screens[SCREEN_REGEN]);
+    lv_obj_t* zones[] = {regen_down_zone, regen_up_zone};
+    for (int i = 0; i < 2; i++) {
+        lv_obj_remove_style_all(zones[i]);
+        lv_obj_set_size(zones[i], SCREEN_CENTER_X, SCREEN_HEIGHT);
+        lv_obj_set_pos(zones[i], i * SCREEN_CENTER_X, 0);
+        lv_obj_clear_flag(zones[i], LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_event_cb(zones[i], onRegenEvent, LV_EVENT_CLICKED, this);
+    }
 }
 
 // ============================================================================
@@ -822,13 +1184,27 @@ void UIManager::createSettingsScreen() {
     lv_obj_set_style_text_color(settings_param_count_label, lv_color_white(), 0);
     lv_obj_align(settings_param_count_label, LV_ALIGN_CENTER, 0, -10);
     
+    // 0x351 heartbeat timing (worst jitter of the last window, faults)
+    settings_heartbeat_label = lv_label_create(screens[SCREEN_SETTINGS]);
+    lv_label_set_text(settings_heartbeat_label, "HB: --");
+    lv_obj_set_style_text_font(settings_heartbeat_label, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(settings_heartbeat_label, lv_palette_main(LV_PALETTE_GREEN), 0);
+    lv_obj_align(settings_heartbeat_label, LV_ALIGN_CENTER, 0, 10);
+    
+    // idcmax as the inverter last acknowledged it, red while it does not
+    settings_limit_label = lv_label_create(screens[SCREEN_SETTINGS]);
+    lv_label_set_text(settings_limit_label, "idcmax --");
+    lv_obj_set_style_text_font(settings_limit_label, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_text_color(settings_limit_label, lv_palette_darken(LV_PALETTE_GREY, 1), 0);
+    lv_obj_align(settings_limit_label, LV_ALIGN_CENTER, 0, 26);
+    
     // Version
     settings_version_label = lv_label_create(screens[SCREEN_SETTINGS]);
     lv_label_set_text(settings_version_label, "Version: 1.1.0\nLVGL UI");
     lv_obj_set_style_text_font(settings_version_label, &lv_font_montserrat_12, 0);
     lv_obj_set_style_text_color(settings_version_label, lv_palette_lighten(LV_PALETTE_GREY, 2), 0);
     lv_obj_set_style_text_align(settings_version_label, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_align(settings_version_label, LV_ALIGN_CENTER, 0, 30);
+    lv_obj_align(settings_version_label, LV_ALIGN_CENTER, 0, 54);
     
     // Hardware info
     lv_obj_t* hw_info = lv_label_create(screens[SCREEN_SETTINGS]);
@@ -852,32 +1228,29 @@ void UIManager::createSettingsScreen() {
 void UIManager::updateDashboard() {
     if (!canManager) return;
     
+    int32_t value;
+    
     // Update RPM (divide by 100 for x100 scale)
-    CANParameter* rpm = canManager->getParameter(1);  // Motor RPM
-    if (rpm) {
-        int32_t value = rpm->getValueAsInt() / 100;  // Convert to x100 scale
+    if (canManager->getValue(1, value)) {  // Motor RPM
+        value /= 100;  // Convert to x100 scale
         lv_meter_set_indicator_value(dash_rpm_meter, dash_rpm_needle, value);
         lv_meter_set_indicator_end_value(dash_rpm_meter, dash_rpm_arc, value);
     }
     
     // Update voltage
-    CANParameter* voltage = canManager->getParameter(3);  // DC Voltage
-    if (voltage) {
-        int32_t value = voltage->getValueAsInt();  // Already in volts
-        lv_label_set_text_fmt(dash_voltage_label, "%dV", value);
+    if (canManager->getValue(3, value)) {  // DC Voltage
+        // Already in volts
+        setLabelInt(dash_voltage_label, dash_voltage_text, "", value, "V");
     }
     
     // Update power
-    CANParameter* power = canManager->getParameter(2);  // Power
-    if (power) {
-        int32_t value = power->getValueAsInt();  // in 0.1kW
-        lv_label_set_text_fmt(dash_power_label, "%d.%dkW", value / 10, abs(value % 10));
+    if (canManager->getValue(2, value)) {  // Power
+        // in 0.1kW
+        setLabelValue(dash_power_label, dash_power_text, "", value, 1, "kW");
     }
     
     // Update SOC ring
-    CANParameter* soc = canManager->getParameter(7);  // SOC
-    if (soc) {
-        int32_t value = soc->getValueAsInt();
+    if (canManager->getValue(7, value)) {  // SOC
         lv_arc_set_value(dash_soc_arc, value);
         
         // Color code based on SOC
@@ -894,10 +1267,11 @@ void UIManager::updateDashboard() {
 void UIManager::updatePower() {
     if (!canManager) return;
     
+    int32_t value;
+    
     // Update power meter
-    CANParameter* power = canManager->getParameter(2);
-    if (power) {
-        int32_t value = power->getValueAsInt();  // in 0.1kW
+    if (canManager->getValue(2, value)) {
+        // in 0.1kW
         
         lv_meter_set_indicator_value(power_meter, power_needle, value);
         
@@ -911,7 +1285,7 @@ void UIManager::updatePower() {
         }
         
         // Update label
-        lv_label_set_text_fmt(power_label, "%d.%d", value / 10, abs(value % 10));
+        setLabelValue(power_label, power_text, "", value, 1, "");
         
         // Color code
         if (value < 0) {
@@ -926,24 +1300,18 @@ void UIManager::updatePower() {
     }
     
     // Update voltage
-    CANParameter* voltage = canManager->getParameter(3);
-    if (voltage) {
-        int32_t value = voltage->getValueAsInt();
-        lv_label_set_text_fmt(power_voltage_label, "%d.%dV", value / 10, abs(value % 10));
+    if (canManager->getValue(3, value)) {
+        setLabelInt(power_voltage_label, power_voltage_text, "", value, "V");  // Whole volts
     }
     
     // Update current
-    CANParameter* current = canManager->getParameter(4);
-    if (current) {
-        int32_t value = current->getValueAsInt();
-        lv_label_set_text_fmt(power_current_label, "%d.%dA", value / 10, abs(value % 10));
+    if (canManager->getValue(4, value)) {
+        setLabelInt(power_current_label, power_current_text, "", value, "A");  // Whole amps
     }
     
     // Update SOC
-    CANParameter* soc = canManager->getParameter(7);
-    if (soc) {
-        int32_t value = soc->getValueAsInt();
-        lv_label_set_text_fmt(power_soc_label, "SOC: %d%%", value);
+    if (canManager->getValue(7, value)) {
+        setLabelInt(power_soc_label, power_soc_text, "SOC: ", value, "%");
         
         if (value > 80) {
             lv_obj_set_style_text_color(power_soc_label, lv_palette_main(LV_PALETTE_GREEN), 0);
@@ -958,12 +1326,12 @@ void UIManager::updatePower() {
 void UIManager::updateTemperature() {
     if (!canManager) return;
     
+    int32_t value;
+    
     // Update motor temp
-    CANParameter* motorTemp = canManager->getParameter(5);
-    if (motorTemp) {
-        int32_t value = motorTemp->getValueAsInt();
+    if (canManager->getValue(5, value)) {
         lv_arc_set_value(temp_motor_arc, value);
-        lv_label_set_text_fmt(temp_motor_label, "Motor\n%d°C", value);
+        setLabelInt(temp_motor_label, temp_motor_text, "Motor\n", value, "°C");
         
         // Color code
         if (value < 60) {
@@ -979,11 +1347,9 @@ void UIManager::updateTemperature() {
     }
     
     // Update inverter temp
-    CANParameter* invTemp = canManager->getParameter(6);
-    if (invTemp) {
-        int32_t value = invTemp->getValueAsInt();
+    if (canManager->getValue(6, value)) {
         lv_arc_set_value(temp_inverter_arc, value);
-        lv_label_set_text_fmt(temp_inverter_label, "Inverter\n%d°C", value);
+        setLabelInt(temp_inverter_label, temp_inverter_text, "Inverter\n", value, "°C");
         
         // Color code
         if (value < 60) {
@@ -999,23 +1365,21 @@ void UIManager::updateTemperature() {
     }
     
     // Update battery temp (if available)
-    CANParameter* batTemp = canManager->getParameter(14);  // Shunt temperature
-    if (batTemp) {
-        int32_t value = batTemp->getValueAsInt();
-        lv_label_set_text_fmt(temp_battery_label, "Battery: %d°C", value / 10);
+    if (canManager->getValue(14, value)) {  // Shunt temperature
+        setLabelInt(temp_battery_label, temp_battery_text, "Battery: ", value, "°C");  // Decoded to °C
     }
 }
 
 void UIManager::updateBattery() {
     if (!canManager) return;
     
+    int32_t value;
+    
     // Update SOC
-    CANParameter* soc = canManager->getParameter(7);
-    if (soc) {
-        int32_t value = soc->getValueAsInt();
+    if (canManager->getValue(7, value)) {
         lv_meter_set_indicator_value(battery_soc_meter, battery_soc_needle, value);
         lv_meter_set_indicator_end_value(battery_soc_meter, battery_soc_arc, value);
-        lv_label_set_text_fmt(battery_soc_label, "%d", value);
+        setLabelInt(battery_soc_label, battery_soc_text, "", value, "");
         
         // Color code
         if (value > 80) {
@@ -1031,38 +1395,32 @@ void UIManager::updateBattery() {
     }
     
     // Update voltage
-    CANParameter* voltage = canManager->getParameter(3);
-    if (voltage) {
-        int32_t value = voltage->getValueAsInt();
-        lv_label_set_text_fmt(battery_voltage_label, "Voltage: %dV", value);
+    if (canManager->getValue(3, value)) {
+        setLabelInt(battery_voltage_label, battery_voltage_text, "Voltage: ", value, "V");
     }
     
     // Update current
-    CANParameter* current = canManager->getParameter(4);
-    if (current) {
-        int32_t value = current->getValueAsInt();
-        lv_label_set_text_fmt(battery_current_label, "Current: %d.%dA", value / 10, abs(value % 10));
+    if (canManager->getValue(4, value)) {
+        setLabelInt(battery_current_label, battery_current_text, "Current: ", value, "A");
     }
     
     // Update temperature
-    CANParameter* temp = canManager->getParameter(14);
-    if (temp) {
-        int32_t value = temp->getValueAsInt();
-        lv_label_set_text_fmt(battery_temp_label, "Temp: %d°C", value / 10);
+    if (canManager->getValue(14, value)) {
+        setLabelInt(battery_temp_label, battery_temp_text, "Temp: ", value, "°C");
     }
 }
 
 void UIManager::updateBMS() {
     if (!canManager) return;
     
+    int32_t value;
+    
     // Update cell voltages (if BMS data available)
     // These would come from BMS CAN messages (0x373, etc.)
     // For now, show static text since BMS integration is optional
     
     // Update SOC bar
-    CANParameter* soc = canManager->getParameter(7);
-    if (soc) {
-        int32_t value = soc->getValueAsInt();
+    if (canManager->getValue(7, value)) {
         lv_bar_set_value(bms_soc_bar, value, LV_ANIM_ON);
     }
 }
@@ -1070,9 +1428,9 @@ void UIManager::updateBMS() {
 void UIManager::updateGear() {
     if (!canManager) return;
     
-    CANParameter* gear = canManager->getParameter(27);  // Gear parameter
-    if (gear) {
-        int32_t value = gear->getValueAsInt();
+    int32_t value;
+    
+    if (canManager->getValue(27, value)) {  // Gear parameter
         const char* gearNames[] = {"LOW", "HIGH", "AUTO", "HI/LO"};
         
         if (value >= 0 && value < 4) {
@@ -1095,9 +1453,9 @@ void UIManager::updateGear() {
 void UIManager::updateMotor() {
     if (!canManager) return;
     
-    CANParameter* motor = canManager->getParameter(129);  // Motor Active parameter
-    if (motor) {
-        int32_t value = motor->getValueAsInt();
+    int32_t value;
+    
+    if (canManager->getValue(129, value)) {  // Motor Active parameter
         const char* motorNames[] = {"MG1 only", "MG2 only", "MG1+MG2", "Blended"};
         
         if (value >= 0 && value < 4) {
@@ -1120,11 +1478,12 @@ void UIManager::updateMotor() {
 void UIManager::updateRegen() {
     if (!canManager) return;
     
-    CANParameter* regen = canManager->getParameter(61);  // Regen Max parameter
-    if (regen) {
-        int32_t value = regen->getValueAsInt();  // -35 to 0
+    int32_t value;
+    
+    if (canManager->getValue(61, value)) {  // Regen Max parameter
+        // -35 to 0
         lv_arc_set_value(regen_arc, value);
-        lv_label_set_text_fmt(regen_value_label, "%d%%", value);
+        setLabelInt(regen_value_label, regen_value_text, "", value, "%");
         
         // Color code based on how much regen
         int absValue = abs(value);
@@ -1141,8 +1500,58 @@ void UIManager::updateRegen() {
     }
 }
 
-// WiFi and Settings screens don't need real-time updates
-// They update on screen entry or when WiFi state changes
+// WiFi screen doesn't need real-time updates
+// It updates on screen entry or when WiFi state changes
+
+void UIManager::updateSettings() {
+    updateLimitStatus();
+    if (!heartbeat) return;
+    
+    HeartbeatStats beat;
+    heartbeat->getStats(beat);
+    
+    // "HB jitter 0.4ms", plus "!n" when frames were late or refused
+    char next[LABEL_TEXT_SIZE];
+    TextWriter text(next, sizeof(next));
+    text.str("HB jitter ").fixed(beat.jitterMaxUs / 100, 1).str("ms");
+    if (beat.windowFaults > 0) {
+        text.str(" !").num(beat.windowFaults);
+    }
+    
+    if (strcmp(next, settings_heartbeat_text.text) != 0) {
+        memcpy(settings_heartbeat_text.text, next, sizeof(next));
+        lv_label_set_text_static(settings_heartbeat_label, settings_heartbeat_text.text);
+        lv_obj_set_style_text_color(settings_heartbeat_label,
+            lv_palette_main(beat.windowFaults > 0 ? LV_PALETTE_RED : LV_PALETTE_GREEN), 0);
+    }
+}
+
+// "idcmax 500A", or "idcmax NO ACK !n" once the alarm is up
+void UIManager::updateLimitStatus() {
+    if (!immobilizer) return;
+    
+    CurrentLimitStatus limit;
+    immobilizer->getLimitStatus(limit);
+    
+    char next[LABEL_TEXT_SIZE];
+    TextWriter text(next, sizeof(next));
+    lv_palette_t color = LV_PALETTE_GREEN;
+    if (limit.alarm) {
+        text.str("idcmax NO ACK !").num(limit.failures);
+        color = LV_PALETTE_RED;
+    } else if (limit.acked < 0) {
+        text.str("idcmax --");
+        color = LV_PALETTE_GREY;
+    } else {
+        text.str("idcmax ").num(limit.acked).str("A");
+    }
+    
+    if (strcmp(next, settings_limit_text.text) != 0) {
+        memcpy(settings_limit_text.text, next, sizeof(next));
+        lv_label_set_text_static(settings_limit_label, settings_limit_text.text);
+        lv_obj_set_style_text_color(settings_limit_label, lv_palette_main(color), 0);
+    }
+}
 
 // ============================================================================
 // EDIT MODE CONTROL - For programmable screens
@@ -1167,6 +1576,21 @@ void UIManager::toggleEditMode() {
                 }
             }
         }
+        
+        // The encoder moves over to the value widgets and back
+        lv_group_t* group = editMode ? editGroups[currentScreen] : groups[currentScreen];
+        if (encoderIndev && group) {
+            lv_indev_set_group(encoderIndev, group);
+        }
+        
+        // Start from the option that is active now
+        if (editMode && canManager && currentScreen != SCREEN_REGEN) {
+            bool gear = (currentScreen == SCREEN_GEAR);
+            int32_t value;
+            if (canManager->getValue(gear ? 27 : 129, value) && value >= 0 && value < 4) {
+                lv_group_focus_obj(gear ? gear_option_labels[value] : motor_option_labels[value]);
+            }
+        }
     }
 }
 
@@ -1176,6 +1600,182 @@ bool UIManager::isEditableScreen() {
             currentScreen == SCREEN_REGEN);
 }
 
+// Click while editing: done, on to the next screen
+void UIManager::finishEdit() {
+    toggleEditMode();
+    setScreen(getNextScreen());
+}
+
+// ============================================================================
+// INPUT ROUTING - LVGL groups and the widgets' event handlers
+// ============================================================================
+
+void UIManager::createInputGroups() {
+    for (int i = 0; i < SCREEN_COUNT; i++) {
+        dials[i] = lv_obj_create(screens[i]);
+        lv_obj_remove_style_all(dials[i]);
+        lv_obj_set_size(dials[i], 0, 0);
+        lv_obj_clear_flag(dials[i], LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_clear_flag(dials[i], LV_OBJ_FLAG_SCROLLABLE);
+        lv_obj_add_event_cb(dials[i], onDialEvent, LV_EVENT_KEY, this);
+        
+        // Always editing, so rotation arrives as keys instead of moving focus
+        groups[i] = lv_group_create();
+        lv_group_add_obj(groups[i], dials[i]);
+        lv_group_set_editing(groups[i], true);
+    }
+    
+    // Gear and motor edit mode: rotation moves focus over the options
+    // (wrapping around), and the focused option is the selection
+    editGroups[SCREEN_GEAR] = lv_group_create();
+    editGroups[SCREEN_MOTOR] = lv_group_create();
+    for (int i = 0; i < 4; i++) {
+        lv_group_add_obj(editGroups[SCREEN_GEAR], gear_option_labels[i]);
+        lv_group_add_obj(editGroups[SCREEN_MOTOR], motor_option_labels[i]);
+    }
+    
+    // Regen edit mode: the arc takes the keys itself, 1% per step
+    editGroups[SCREEN_REGEN] = lv_group_create();
+    lv_group_add_obj(editGroups[SCREEN_REGEN], regen_arc);
+    lv_group_set_editing(editGroups[SCREEN_REGEN], true);
+}
+
+void UIManager::onDialEvent(lv_event_t* e) {
+    UIManager* ui = (UIManager*)lv_event_get_user_data(e);
+    
+    // Keys left over from a burst that already switched screens
+    if (lv_event_get_target(e) != ui->dials[ui->currentScreen]) return;
+    
+    ui->dialKey(lv_event_get_key(e));
+}
+
+// Rotation and click when no value widget has the encoder
+void UIManager::dialKey(uint32_t key) {
+    // IMMOBILIZER: the dial enters the PIN, and does nothing else, while locked
+    if (isLocked()) {
+        if (currentScreen != SCREEN_LOCK || !immobilizer) return;
+        
+        if (key == LV_KEY_RIGHT) {
+            immobilizer->incrementDigit();
+        } else if (key == LV_KEY_LEFT) {
+            immobilizer->decrementDigit();
+        } else if (key == LV_KEY_ENTER) {
+            immobilizer->enterDigit(immobilizer->getCurrentDigit());
+            if (immobilizer->isUnlocked()) {
+                Serial.println(">>> UNLOCKED <<<");
+                setScreen(SCREEN_DASHBOARD);
+            }
+        }
+        return;
+    }
+    
+    if (key == LV_KEY_RIGHT || key == LV_KEY_LEFT) {
+        // Rotating leaves WiFi mode
+        if (wifiMode) {
+            setWiFiMode(false);
+            return;
+        }
+        setScreen(key == LV_KEY_RIGHT ? getNextScreen() : getPreviousScreen());
+    } else if (key == LV_KEY_ENTER) {
+        if (isEditableScreen()) {
+            toggleEditMode();
+            #if DEBUG_SERIAL
+            Serial.printf("Edit mode toggled: %s\n", editMode ? "ON" : "OFF");
+            #endif
+        } else {
+            setWiFiMode(!wifiMode);
+        }
+    }
+}
+
+// Gear and motor option labels
+void UIManager::onOptionEvent(lv_event_t* e) {
+    UIManager* ui = (UIManager*)lv_event_get_user_data(e);
+    if (ui->isLocked()) return;
+    
+    // A press that outlived its screen (long press went to the dashboard)
+    if (ui->currentScreen != SCREEN_GEAR && ui->currentScreen != SCREEN_MOTOR) return;
+    
+    lv_event_code_t code = lv_event_get_code(e);
+    int32_t option = (int32_t)(intptr_t)lv_obj_get_user_data(lv_event_get_target(e));
+    uint16_t paramId = (ui->currentScreen == SCREEN_GEAR) ? 27 : 129;
+    lv_indev_t* indev = lv_indev_get_act();
+    bool fromEncoder = indev && lv_indev_get_type(indev) == LV_INDEV_TYPE_ENCODER;
+    
+    if (code == LV_EVENT_FOCUSED && fromEncoder) {
+        // Turning in edit mode selects as it goes
+        ui->selectOption(paramId, option);
+    } else if (code == LV_EVENT_CLICKED) {
+        // Tapped, or the button pressed on it to finish the edit
+        ui->selectOption(paramId, option);
+        if (fromEncoder) {
+            ui->finishEdit();
+        }
+    }
+}
+
+void UIManager::selectOption(uint16_t paramId, int32_t option) {
+    if (!canManager) return;
+    
+    int32_t current = -1;
+    if (canManager->getValue(paramId, current) && current == option) return;
+    canManager->setParameter(paramId, option);
+    
+    #if DEBUG_SERIAL
+    Serial.printf("%s: %d -> %d\n", paramId == 27 ? "Gear" : "Motor", current, option);
+    #endif
+}
+
+// Regen arc keys and clicks, and taps on either half of the screen
+void UIManager::onRegenEvent(lv_event_t* e) {
+    UIManager* ui = (UIManager*)lv_event_get_user_data(e);
+    if (ui->isLocked() || ui->currentScreen != SCREEN_REGEN) return;
+    
+    lv_event_code_t code = lv_event_get_code(e);
+    lv_obj_t* target = lv_event_get_target(e);
+    
+    if (target == ui->regen_arc) {
+        if (code == LV_EVENT_VALUE_CHANGED) {
+            ui->regenPending = true;
+        } else if (code == LV_EVENT_CLICKED) {
+            ui->finishEdit();
+        }
+        return;
+    }
+    
+    // Left half = more negative (stronger regen), right half = lighter
+    int32_t step = (target == ui->regen_down_zone) ? -5 : 5;
+    lv_arc_set_value(ui->regen_arc, lv_arc_get_value(ui->regen_arc) + step);  // Clamps to -35..0
+    ui->regenPending = true;
+}
+
+bool UIManager::isLocked() {
+    return immobilizer && !immobilizer->isUnlocked();
+}
+
+void UIManager::setWiFiMode(bool enable) {
+    if (!wifiManager || enable == wifiMode) return;
+    wifiMode = enable;
+    
+    if (wifiMode) {
+        wifiManager->startAP();
+        setScreen(SCREEN_WIFI);
+        #if DEBUG_SERIAL
+        Serial.println("WiFi mode enabled");
+        Serial.print("Connect to SSID: ");
+        Serial.println(WIFI_AP_SSID);
+        Serial.print("IP: ");
+        Serial.println(wifiManager->getIPAddress());
+        #endif
+    } else {
+        wifiManager->stopAP();
+        setScreen(SCREEN_DASHBOARD);
+        #if DEBUG_SERIAL
+        Serial.println("WiFi mode disabled");
+        #endif
+    }
+}
+
 // ============================================================================
 // LOCK SCREEN - Immobilizer UI
 // ============================================================================
@@ -1238,7 +1838,7 @@ void UIManager::updateLockScreen() {
     pinDisplay[7] = '\0';
     
     lv_label_set_text(lock_pin_display, pinDisplay);
-    lv_label_set_text_fmt(lock_digit_label, "%d", immobilizer->getCurrentDigit());
+    setLabelInt(lock_digit_label, lock_digit_text, "", immobilizer->getCurrentDigit(), "");
     
     if (immobilizer->isUnlocked()) {
         lv_obj_set_style_text_color(lock_icon, lv_palette_main(LV_PALETTE_GREEN), 0);
@@ -0,0 +1,81 @@
+#include "ValueCodec.h"
+
+size_t formatScaled(char* buffer, size_t size, int32_t scaled, uint8_t decimals, const char* unit) {
+    if (size == 0) return 0;
+
+    // Digits are produced backwards into a scratch buffer (int32 + point + sign)
+    char digits[16];
+    uint8_t count = 0;
+    uint32_t magnitude = scaled < 0 ? 0u - (uint32_t)scaled : (uint32_t)scaled;
+
+    if (decimals > 9) decimals = 9;
+    do {
+        if (count == decimals && decimals > 0) {
+            digits[count++] = '.';
+        }
+        digits[count++] = '0' + (magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0 || count <= decimals);
+
+    // The sign comes from the scaled value, so -0.5 keeps its minus
+    if (scaled < 0) {
+        digits[count++] = '-';
+    }
+
+    size_t length = 0;
+    while (count > 0 && length < size - 1) {
+        buffer[length++] = digits[--count];
+    }
+    while (unit && *unit && length < size - 1) {
+        buffer[length++] = *unit++;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+bool parseScaled(const char* text, uint8_t decimals, int32_t& scaled) {
+    if (!text) return false;
+
+    bool negative = false;
+    if (*text == '-' || *text == '+') {
+        negative = (*text == '-');
+        text++;
+    }
+
+    int64_t value = 0;
+    uint8_t fraction = 0;
+    bool seenDigit = false;
+    bool seenPoint = false;
+    bool roundUp = false;
+
+    for (; *text; text++) {
+        char c = *text;
+        if (c == '.' && !seenPoint) {
+            seenPoint = true;
+        } else if (c >= '0' && c <= '9') {
+            seenDigit = true;
+            if (seenPoint && fraction >= decimals) {
+                // First digit past the wanted precision decides the rounding
+                if (fraction == decimals) roundUp = (c >= '5');
+                fraction = decimals + 1;
+                continue;
+            }
+            value = value * 10 + (c - '0');
+            if (seenPoint) fraction++;
+            if (value > 0x7FFFFFFFLL) return false;
+        } else {
+            return false;
+        }
+    }
+    if (!seenDigit) return false;
+
+    for (uint8_t i = seenPoint ? (fraction > decimals ? decimals : fraction) : 0; i < decimals; i++) {
+        value *= 10;
+        if (value > 0x7FFFFFFFLL) return false;
+    }
+    if (roundUp) value++;
+    if (value > 0x7FFFFFFFLL) return false;
+
+    scaled = (int32_t)(negative ? -value : value);
+    return true;
+}
@@ -0,0 +1,160 @@
+#include "WS1850S.h"
+#include "I2CBus.h"
+#include <M5Unified.h>
+#include <esp_timer.h>
+
+#define WS_I2C_FREQ 400000
+
+WS1850S::WS1850S()
+    : address(0), irqPin(-1), version(0), irqSemaphore(nullptr), irqUs(0) {
+}
+
+bool WS1850S::begin(uint8_t addr, int8_t pin) {
+    address = addr;
+    irqPin = pin;
+
+    {
+        I2CBusLock bus;
+        if (!writeReg(WS_REG_COMMAND, WS_CMD_SOFT_RESET)) {
+            return false;
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(50));
+
+    I2CBusLock bus;
+    version = readReg(WS_REG_VERSION);
+    if (version == 0x00 || version == 0xFF) {
+        return false;
+    }
+
+    // Same analog setup as the MFRC522 reference init: 106 kbit/s, 100% ASK,
+    // CRC preset 0x6363, antenna off until a probe
+    writeReg(WS_REG_TX_MODE, 0x00);
+    writeReg(WS_REG_RX_MODE, 0x00);
+    writeReg(WS_REG_MOD_WIDTH, 0x26);
+    writeReg(WS_REG_T_MODE, 0x80);
+    writeReg(WS_REG_T_PRESCALER, 0xA9);
+    writeReg(WS_REG_T_RELOAD_H, 0x03);
+    writeReg(WS_REG_T_RELOAD_L, 0xE8);
+    writeReg(WS_REG_TX_ASK, 0x40);
+    writeReg(WS_REG_MODE, 0x3D);
+    writeReg(WS_REG_TX_CONTROL, 0x80);
+
+    if (irqPin >= 0) {
+        // IRQ active low, push-pull, only for a received frame
+        irqSemaphore = xSemaphoreCreateBinary();
+        writeReg(WS_REG_COM_IEN, 0x80 | WS_IRQ_RX);
+        writeReg(WS_REG_DIV_IEN, 0x80);
+        pinMode(irqPin, INPUT_PULLUP);
+        attachInterruptArg(irqPin, onIrq, this, FALLING);
+    }
+    return true;
+}
+
+void IRAM_ATTR WS1850S::onIrq(void* arg) {
+    WS1850S* self = (WS1850S*)arg;
+    self->irqUs = esp_timer_get_time();
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(self->irqSemaphore, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+bool WS1850S::probe(uint16_t settleMs, uint16_t responseMs, int64_t& answeredUs) {
+    {
+        I2CBusLock bus;
+        if (!writeReg(WS_REG_TX_CONTROL, 0x83)) {
+            return false;
+        }
+    }
+
+    // A card needs the field for a few ms before it can answer
+    vTaskDelay(pdMS_TO_TICKS(settleMs));
+
+    uint8_t reqa = PICC_CMD_REQA;
+    uint8_t atqa[2];
+    if (startTransceive(&reqa, 1, 7) &&
+        finishTransceive(responseMs, atqa, sizeof(atqa), answeredUs) == sizeof(atqa)) {
+        return true;
+    }
+    fieldOff();
+    return false;
+}
+
+bool WS1850S::readUid(uint8_t* uid, uint16_t responseMs) {
+    uint8_t anticoll[2] = { PICC_CMD_SEL_CL1, 0x20 };
+    uint8_t back[5];
+    int64_t answeredUs;
+
+    if (!startTransceive(anticoll, sizeof(anticoll), 0) ||
+        finishTransceive(responseMs, back, sizeof(back), answeredUs) != sizeof(back)) {
+        return false;
+    }
+    if ((back[0] ^ back[1] ^ back[2] ^ back[3]) != back[4]) {
+        return false;
+    }
+    memcpy(uid, back, 4);
+    return true;
+}
+
+void WS1850S::fieldOff() {
+    I2CBusLock bus;
+    writeReg(WS_REG_COMMAND, WS_CMD_IDLE);
+    writeReg(WS_REG_TX_CONTROL, 0x80);
+}
+
+// Load the FIFO and send; the bus is free again while the card answers
+bool WS1850S::startTransceive(const uint8_t* data, uint8_t length, uint8_t txLastBits) {
+    if (irqSemaphore) {
+        xSemaphoreTake(irqSemaphore, 0);  // Stale edge from the last exchange
+    }
+
+    I2CBusLock bus;
+    return writeReg(WS_REG_COMMAND, WS_CMD_IDLE) &&
+           writeReg(WS_REG_COM_IRQ, 0x7F) &&
+           writeReg(WS_REG_FIFO_LEVEL, 0x80) &&
+           writeReg(WS_REG_FIFO_DATA, data, length) &&
+           writeReg(WS_REG_COMMAND, WS_CMD_TRANSCEIVE) &&
+           writeReg(WS_REG_BIT_FRAMING, 0x80 | txLastBits);
+}
+
+// Bytes received, 0 for no answer or a corrupted one
+uint8_t WS1850S::finishTransceive(uint16_t responseMs, uint8_t* back, uint8_t backSize, int64_t& answeredUs) {
+    if (irqSemaphore) {
+        if (xSemaphoreTake(irqSemaphore, pdMS_TO_TICKS(responseMs)) != pdTRUE) {
+            return 0;
+        }
+        answeredUs = irqUs;
+    } else {
+        vTaskDelay(pdMS_TO_TICKS(responseMs));
+        answeredUs = esp_timer_get_time();
+    }
+
+    I2CBusLock bus;
+    if (!(readReg(WS_REG_COM_IRQ) & WS_IRQ_RX) || (readReg(WS_REG_ERROR) & WS_ERR_MASK)) {
+        return 0;
+    }
+    uint8_t level = readReg(WS_REG_FIFO_LEVEL) & 0x7F;
+    if (level == 0 || level > backSize) {
+        return 0;
+    }
+    if (!M5.In_I2C.readRegister(address, WS_REG_FIFO_DATA, back, level, WS_I2C_FREQ)) {
+        return 0;
+    }
+    return level;
+}
+
+bool WS1850S::writeReg(uint8_t reg, uint8_t value) {
+    return M5.In_I2C.writeRegister8(address, reg, value, WS_I2C_FREQ);
+}
+
+// Several bytes to one register (the FIFO)
+bool WS1850S::writeReg(uint8_t reg, const uint8_t* data, size_t length) {
+    return M5.In_I2C.writeRegister(address, reg, data, length, WS_I2C_FREQ);
+}
+
+uint8_t WS1850S::readReg(uint8_t reg) {
+    return M5.In_I2C.readRegister8(address, reg, WS_I2C_FREQ);
+}
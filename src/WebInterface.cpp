@@ -1,9 +1,15 @@
 #include "WebInterface.h"
 #include <SPIFFS.h>
 #include <driver/twai.h>
+#include "I2CBus.h"
+#include "ParamTable.h"
+#include "ValueCodec.h"
+
+WebInterface* WebInterface::instance = nullptr;
 
 WebInterface::WebInterface(CANDataManager* can) 
-    : canManager(can), server(80), apMode(false), corsEnabled(true), canLogIndex(0), canLoggingEnabled(true) {
+    : canManager(can), taskManager(nullptr), schemaSync(nullptr), heartbeat(nullptr), power(nullptr), immobilizer(nullptr), server(80), apMode(false), corsEnabled(true), canLogLastPoll(0), canLoggingEnabled(true) {
+    instance = this;
 }
 
 bool WebInterface::init() {
@@ -28,11 +34,18 @@ bool WebInterface::init() {
     server.on("/cmd", HTTP_GET, [this]() { handleCmd(); });  // jamiejones85 compatibility
     server.on("/get", HTTP_GET, [this]() { handleGet(); });
     server.on("/set", HTTP_GET, [this]() { handleSet(); });
+    server.on("/set/batch", HTTP_POST, [this]() { handleSetBatch(); });
     server.on("/save", HTTP_GET, [this]() { handleSave(); });
     server.on("/load", HTTP_GET, [this]() { handleLoad(); });
     server.on("/spot", HTTP_GET, [this]() { handleSpot(); });
     server.on("/can/send", HTTP_GET, [this]() { handleCanSend(); });
     server.on("/can/log", HTTP_GET, [this]() { handleCanLog(); });
+    server.on("/can/stats", HTTP_GET, [this]() { handleCanStats(); });
+    server.on("/tasks", HTTP_GET, [this]() { handleTasks(); });
+    server.on("/power", HTTP_GET, [this]() { handlePower(); });
+    server.on("/sched", HTTP_GET, [this]() { handleSchedule(); });
+    server.on("/schema", HTTP_GET, [this]() { handleSchema(); });
+    server.on("/schema/sync", HTTP_GET, [this]() { handleSchemaSync(); });
     server.on("/params/upload", HTTP_POST, [this]() { handleParamsUpload(); });
     
     // Enable CORS for all routes if needed
@@ -41,6 +54,11 @@ bool WebInterface::init() {
     server.onNotFound([this]() { handleNotFound(); });
     
     server.begin();
+    
+    // Log frames as CANDataManager receives them (never read the driver here,
+    // that would steal frames from the CAN decoder)
+    canManager->setOnMessageReceived(canMessageCallback);
+    
     Serial.println("[WEB] HTTP server started");
     Serial.printf("[WEB] Access at: http://%s\n", getIPAddress().c_str());
     
@@ -49,13 +67,12 @@ bool WebInterface::init() {
 
 void WebInterface::update() {
     server.handleClient();
-    
-    // Capture CAN messages for logging (non-blocking)
-    if (canLoggingEnabled) {
-        twai_message_t msg;
-        while (twai_receive(&msg, 0) == ESP_OK) {  // Non-blocking receive
-            logCanMessage(msg.identifier, msg.data, msg.data_length_code, true);
-        }
+}
+
+void WebInterface::canMessageCallback(const CANMessage& msg) {
+    if (instance && instance->canLoggingEnabled &&
+        millis() - instance->canLogLastPoll < CAN_LOG_IDLE_MS) {
+        instance->logCanMessage(msg.id, (uint8_t*)msg.data, msg.length, true);
     }
 }
 
@@ -172,7 +189,11 @@ void WebInterface::handleGet() {
         return;
     }
     
-    int paramId = server.arg("param").toInt();
+    int paramId = resolveParamArg(server.arg("param"));
+    if (paramId < 0) {
+        server.send(404, "text/plain", "Unknown parameter");
+        return;
+    }
     int32_t value = getParameterValue(paramId);
     
     server.send(200, "text/plain", String(value));
@@ -186,16 +207,113 @@ void WebInterface::handleSet() {
         return;
     }
     
-    int paramId = server.arg("param").toInt();
-    int32_t value = server.arg("value").toInt();
-    
-    if (setParameterValue(paramId, value)) {
+    int paramId = resolveParamArg(server.arg("param"));
+    if (paramId < 0) {
+        server.send(404, "text/plain", "Unknown parameter");
+        return;
+    }
+    if (setParameterValue(paramId, server.arg("value"))) {
         server.send(200, "text/plain", "OK");
     } else {
         server.send(500, "text/plain", "Failed to set parameter");
     }
 }
 
+// Entries may be numbers, strings or the objects /json returns, so a
+// saved /json dump can be posted back as it is
+static String batchValueText(JsonVariant value) {
+    if (value.is<JsonObject>()) {
+        return batchValueText(value["value"]);
+    }
+    if (value.is<const char*>()) {
+        return String(value.as<const char*>());
+    }
+    String text;
+    serializeJson(value, text);
+    return text;
+}
+
+// POST {"params": {"name or id": value, ...}, "verify": true, "rollback": false, "save": false}
+void WebInterface::handleSetBatch() {
+    if (corsEnabled) addCORSHeaders();
+    
+    if (!server.hasArg("plain")) {
+        server.send(400, "text/plain", "No JSON body provided");
+        return;
+    }
+    
+    JsonDocument request;
+    DeserializationError error = deserializeJson(request, server.arg("plain"));
+    if (error) {
+        server.send(400, "text/plain", String("Invalid JSON: ") + error.c_str());
+        return;
+    }
+    
+    JsonObject params = request["params"];
+    uint16_t count = params.size();
+    if (count == 0 || count > SET_BATCH_MAX) {
+        server.send(400, "text/plain", "params must hold 1 to " + String(SET_BATCH_MAX) + " values");
+        return;
+    }
+    
+    SDOWrite* writes = (SDOWrite*)malloc(count * sizeof(SDOWrite));
+    if (!writes) {
+        server.send(500, "text/plain", "Out of memory");
+        return;
+    }
+    
+    // Resolve and encode everything before the first write goes out
+    uint16_t i = 0;
+    for (JsonPair entry : params) {
+        int paramId = resolveParamArg(entry.key().c_str());
+        int32_t encoded;
+        if (paramId < 0 || paramId > 0xFF || !encodeParamValue(paramId, batchValueText(entry.value()), encoded)) {
+            free(writes);
+            server.send(400, "text/plain", String("Bad parameter or value: ") + entry.key().c_str());
+            return;
+        }
+        memset(&writes[i], 0, sizeof(SDOWrite));
+        writes[i].paramId = paramId;
+        writes[i].value = encoded;
+        i++;
+    }
+    
+    uint8_t options = 0;
+    if (request["verify"] | true) options |= SDO_BATCH_VERIFY;
+    if (request["rollback"] | false) options |= SDO_BATCH_ROLLBACK;
+    if (request["save"] | false) options |= SDO_BATCH_SAVE;
+    
+    Serial.printf("[WEB] /set/batch: %u parameters, options 0x%02X\n", count, options);
+    bool ok = canManager->writeParameters(writes, count, options);
+    
+    JsonDocument doc;
+    doc["ok"] = ok;
+    doc["saved"] = ok && (options & SDO_BATCH_SAVE);
+    doc["ms"] = canManager->getSDO().getLastBatchMs();
+    JsonArray results = doc.createNestedArray("results");
+    i = 0;
+    for (JsonPair entry : params) {
+        JsonObject result = results.createNestedObject();
+        result["param"] = entry.key().c_str();
+        result["i"] = writes[i].paramId;
+        result["status"] = SDOManager::getWriteStatusName(writes[i].status);
+        if (writes[i].status == SDO_WRITE_MISMATCH) {
+            result["readBack"] = writes[i].readBack;
+        }
+        if (writes[i].abortCode) {
+            char code[12];
+            snprintf(code, sizeof(code), "0x%08X", writes[i].abortCode);
+            result["abort"] = code;
+        }
+        i++;
+    }
+    free(writes);
+    
+    String response;
+    serializeJson(doc, response);
+    server.send(ok ? 200 : 500, "application/json", response);
+}
+
 void WebInterface::handleSave() {
     if (corsEnabled) addCORSHeaders();
     
@@ -216,7 +334,7 @@ void WebInterface::handleSave() {
     msg.data[6] = 0x00;
     msg.data[7] = 0x00;
     
-    if (twai_transmit(&msg, pdMS_TO_TICKS(100)) == ESP_OK) {
+    if (CANDataManager::transmit(msg, pdMS_TO_TICKS(100))) {
         server.send(200, "text/plain", "Parameters saved to flash");
     } else {
         server.send(500, "text/plain", "Failed to send save command");
@@ -239,27 +357,27 @@ void WebInterface::handleSpot() {
     
     JsonDocument doc;  // Use JsonDocument instead of DynamicJsonDocument
     
-    // Add key real-time parameters
-    CANParameter* rpm = canManager->getParameter(1);
-    if (rpm) doc["speed"] = rpm->getValueAsInt();
-    
-    CANParameter* voltage = canManager->getParameter(3);
-    if (voltage) doc["udc"] = voltage->getValueAsInt();
-    
-    CANParameter* current = canManager->getParameter(4);
-    if (current) doc["idc"] = current->getValueAsInt();
-    
-    CANParameter* power = canManager->getParameter(2);
-    if (power) doc["power"] = power->getValueAsInt() / 10.0;
-    
-    CANParameter* motorTemp = canManager->getParameter(5);
-    if (motorTemp) doc["tmpm"] = motorTemp->getValueAsInt();
-    
-    CANParameter* invTemp = canManager->getParameter(6);
-    if (invTemp) doc["tmphs"] = invTemp->getValueAsInt();
-    
-    CANParameter* soc = canManager->getParameter(7);
-    if (soc) doc["soc"] = soc->getValueAsInt();
+    // Add key real-time parameters, all from the same CAN update
+    static const uint16_t ids[] = {1, 3, 4, 2, 5, 6, 7};
+    static const char* const keys[] = {"speed", "udc", "idc", "power", "tmpm", "tmphs", "soc"};
+    const uint8_t count = sizeof(ids) / sizeof(ids[0]);
+    int32_t values[count];
+    canManager->getValues(ids, values, count);
+    
+    // Keep these polled fast while a browser is watching
+    canManager->setInterest(INTEREST_WEB, 0, ids, count, 0, SPOT_INTEREST_TTL_MS);
+    
+    ParamTableLock table(canManager);
+    for (uint8_t i = 0; i < count; i++) {
+        if (!canManager->getParameter(ids[i])) continue;
+        if (ids[i] == 2) {
+            char text[16];
+            formatScaled(text, sizeof(text), values[i], 1);  // 0.1 kW
+            doc[keys[i]] = serialized(String(text));
+        } else {
+            doc[keys[i]] = values[i];
+        }
+    }
     
     String response;
     serializeJson(doc, response);
@@ -285,318 +403,82 @@ void WebInterface::addCORSHeaders() {
 // Helper Functions
 // ============================================================================
 
-// Determines if a parameter uses raw values (no fixed-point encoding)
-bool WebInterface::usesRawValue(const char* paramName) {
-    // Configuration enums - use raw values
-    if (strcmp(paramName, "Inverter") == 0) return true;
-    if (strcmp(paramName, "Vehicle") == 0) return true;
-    if (strcmp(paramName, "GearLvr") == 0) return true;
-    if (strcmp(paramName, "Transmission") == 0) return true;
-    if (strcmp(paramName, "interface") == 0) return true;
-    if (strcmp(paramName, "chargemodes") == 0) return true;
-    if (strcmp(paramName, "BMS_Mode") == 0) return true;
-    if (strcmp(paramName, "ShuntType") == 0) return true;
-    if (strcmp(paramName, "Gear") == 0) return true;
-    if (strcmp(paramName, "potmode") == 0) return true;
-    if (strcmp(paramName, "dirmode") == 0) return true;
-    if (strcmp(paramName, "reversemotor") == 0) return true;
-    if (strcmp(paramName, "revRegen") == 0) return true;
-    if (strcmp(paramName, "cruiselight") == 0) return true;
-    if (strcmp(paramName, "errlights") == 0) return true;
-    if (strcmp(paramName, "Chgctrl") == 0) return true;
-    if (strcmp(paramName, "ConfigFoccci") == 0) return true;
-    if (strcmp(paramName, "DCdc_Type") == 0) return true;
-    if (strcmp(paramName, "Heater") == 0) return true;
-    if (strcmp(paramName, "Control") == 0) return true;
-    if (strcmp(paramName, "IsaInit") == 0) return true;
-    
-    // CAN bus assignments - use raw values
-    if (strcmp(paramName, "InverterCan") == 0) return true;
-    if (strcmp(paramName, "VehicleCan") == 0) return true;
-    if (strcmp(paramName, "ShuntCan") == 0) return true;
-    if (strcmp(paramName, "LimCan") == 0) return true;
-    if (strcmp(paramName, "ChargerCan") == 0) return true;
-    if (strcmp(paramName, "BMSCan") == 0) return true;
-    if (strcmp(paramName, "OBD2Can") == 0) return true;
-    if (strcmp(paramName, "CanMapCan") == 0) return true;
-    if (strcmp(paramName, "DCDCCan") == 0) return true;
-    if (strcmp(paramName, "HeaterCan") == 0) return true;
-    if (strcmp(paramName, "CAN3Speed") == 0) return true;
-    
-    // GPIO function assignments - use raw values
-    if (strcmp(paramName, "MotActive") == 0) return true;
-    if (strcmp(paramName, "PumpPWM") == 0) return true;
-    if (strcmp(paramName, "Out1Func") == 0) return true;
-    if (strcmp(paramName, "Out2Func") == 0) return true;
-    if (strcmp(paramName, "Out3Func") == 0) return true;
-    if (strcmp(paramName, "SL1Func") == 0) return true;
-    if (strcmp(paramName, "SL2Func") == 0) return true;
-    if (strcmp(paramName, "PWM1Func") == 0) return true;
-    if (strcmp(paramName, "PWM2Func") == 0) return true;
-    if (strcmp(paramName, "PWM3Func") == 0) return true;
-    if (strcmp(paramName, "GP12VInFunc") == 0) return true;
-    if (strcmp(paramName, "HVReqFunc") == 0) return true;
-    if (strcmp(paramName, "PB1InFunc") == 0) return true;
-    if (strcmp(paramName, "PB2InFunc") == 0) return true;
-    if (strcmp(paramName, "PB3InFunc") == 0) return true;
-    if (strcmp(paramName, "GPA1Func") == 0) return true;
-    if (strcmp(paramName, "GPA2Func") == 0) return true;
-    
-    // Digital ADC values - use raw values
-    if (strcmp(paramName, "potmin") == 0) return true;
-    if (strcmp(paramName, "potmax") == 0) return true;
-    if (strcmp(paramName, "pot2min") == 0) return true;
-    if (strcmp(paramName, "pot2max") == 0) return true;
-    if (strcmp(paramName, "ppthresh") == 0) return true;
-    if (strcmp(paramName, "BrkVacThresh") == 0) return true;
-    if (strcmp(paramName, "BrkVacHyst") == 0) return true;
-    if (strcmp(paramName, "DigiPot1Step") == 0) return true;
-    if (strcmp(paramName, "DigiPot2Step") == 0) return true;
-    
-    // Time values - use raw values
-    if (strcmp(paramName, "Set_Day") == 0) return true;
-    if (strcmp(paramName, "Set_Hour") == 0) return true;
-    if (strcmp(paramName, "Set_Min") == 0) return true;
-    if (strcmp(paramName, "Set_Sec") == 0) return true;
-    if (strcmp(paramName, "Chg_Hrs") == 0) return true;
-    if (strcmp(paramName, "Chg_Min") == 0) return true;
-    if (strcmp(paramName, "Chg_Dur") == 0) return true;
-    if (strcmp(paramName, "Pre_Hrs") == 0) return true;
-    if (strcmp(paramName, "Pre_Min") == 0) return true;
-    if (strcmp(paramName, "Pre_Dur") == 0) return true;
-    if (strcmp(paramName, "BMS_Timeout") == 0) return true;
-    
-    // PWM timer registers - use raw values
-    if (strcmp(paramName, "Tim3_Presc") == 0) return true;
-    if (strcmp(paramName, "Tim3_Period") == 0) return true;
-    if (strcmp(paramName, "Tim3_1_OC") == 0) return true;
-    if (strcmp(paramName, "Tim3_2_OC") == 0) return true;
-    if (strcmp(paramName, "Tim3_3_OC") == 0) return true;
-    if (strcmp(paramName, "CP_PWM") == 0) return true;
-    
-    // Other special cases
-    if (strcmp(paramName, "regenlevel") == 0) return true;
-    if (strcmp(paramName, "TachoPPR") == 0) return true;
-    
-    // All others use fixed-point encoding (×32)
-    return false;
+// "param" may be a numeric id or a parameter name (OpenInverter style)
+int WebInterface::resolveParamArg(const String& arg) {
+    if (arg.length() > 0 && isdigit((unsigned char)arg.c_str()[0])) {
+        return arg.toInt();
+    }
+    
+    const ParamInfo* info = findParamInfo(arg.c_str());
+    return info ? info->id : -1;
 }
 
 String WebInterface::buildJSONResponse(bool includeHidden) {
     JsonDocument doc;
     
-    Serial.println("[WEB] Building JSON response - using hardcoded parameters (no SPIFFS)");
-    
-    // Hardcoded parameters to avoid SPIFFS partition issues
-    struct ParamDef {
-        const char* name;
-        int id;
-        const char* unit;
-        const char* category;
-        bool isEditable;
-    };
-    
-    ParamDef params[] = {
-        {"Inverter", 0, "0=None, 1=Leaf_Gen1, 2=GS450h, 3=UserCAN, 4=OpenI, 5=Prius_Gen3, 6=RearAC, 7=E65_MT, 8=CanOI, 9=E65_BMW", "General Setup", true},
-        {"Vehicle", 1, "0=BMW_E46, 1=BMW_E6x+, 2=Classic, 3=None, 4=User, 5=CPC", "General Setup", true},
-        {"GearLvr", 2, "0=None, 1=BMW_F30, 2=JLR_G1, 3=JLR_G2, 4=VAG, 5=Outlander", "General Setup", true},
-        {"Transmission", 3, "0=Manual, 1=Auto", "General Setup", true},
-        {"interface", 4, "0=Unused, 1=i3LIM, 2=Chademo, 3=CPC", "General Setup", true},
-        {"chargemodes", 5, "0=Off, 1=EXT_DIGI, 2=Volt_A, 3=Volt_A+EXT, 4=i3LIM, 5=i3LIM+EXT, 6=Focci, 7=Leaf_PDM, 8=Outlander, 9=CPC, 10=Leaf_Inverter, 11=Tesla_M3_OBC", "General Setup", true},
-        {"BMS_Mode", 6, "0=Off, 1=SimpBMS, 2=TiDaisyChain, 3=BMWi3LIM, 4=OutlanderFront, 5=VWeBMS, 6=OutlanderFront+Rear, 7=Volt, 8=LeafGen2, 9=CPC, 10=RenaultZoe, 11=TeslaM3, 12=VictronCAN", "General Setup", true},
-        {"ShuntType", 7, "0=None, 1=ISA, 2=SBOX, 3=VAG", "General Setup", true},
-        {"InverterCan", 8, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"VehicleCan", 9, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"ShuntCan", 10, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"LimCan", 11, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"ChargerCan", 12, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"BMSCan", 13, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"OBD2Can", 14, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"CanMapCan", 15, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"DCDCCan", 16, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"HeaterCan", 17, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"MotActive", 18, "0=Mg1and2, 1=Mg1, 2=Mg2, 3=Both", "General Setup", true},
-        {"potmin", 19, "dig", "Throttle", true},
-        {"potmax", 20, "dig", "Throttle", true},
-        {"pot2min", 21, "dig", "Throttle", true},
-        {"pot2max", 22, "dig", "Throttle", true},
-        {"regenrpm", 23, "rpm", "Throttle", true},
-        {"regenendrpm", 24, "rpm", "Throttle", true},
-        {"regenmax", 25, "%", "Throttle", true},
-        {"regenBrake", 26, "%", "Throttle", true},
-        {"regenramp", 27, "%/10ms", "Throttle", true},
-        {"potmode", 28, "0=SingleChannel, 1=DualChannel", "Throttle", true},
-        {"dirmode", 29, "0=Button, 1=Switch, 2=ButtonReversed, 3=SwitchReversed, 4=DefaultForward", "Throttle", true},
-        {"reversemotor", 30, "0=Off, 1=On, 2=na", "Throttle", true},
-        {"throtramp", 31, "%/10ms", "Throttle", true},
-        {"throtramprpm", 32, "rpm", "Throttle", true},
-        {"revlim", 33, "rpm", "Throttle", true},
-        {"revRegen", 34, "0=Off, 1=On, 2=na", "Throttle", true},
-        {"udcmin", 35, "V", "Throttle", true},
-        {"udclim", 36, "V", "Throttle", true},
-        {"idcmax", 37, "A", "Throttle", true},
-        {"idcmin", 38, "A", "Throttle", true},
-        {"tmphsmax", 39, "°C", "Throttle", true},
-        {"tmpmmax", 40, "°C", "Throttle", true},
-        {"throtmax", 41, "%", "Throttle", true},
-        {"throtmin", 42, "%", "Throttle", true},
-        {"throtmaxRev", 43, "%", "Throttle", true},
-        {"throtdead", 44, "%", "Throttle", true},
-        {"RegenBrakeLight", 45, "%", "Throttle", true},
-        {"throtrpmfilt", 46, "rpm/10ms", "Throttle", true},
-        {"Gear", 47, "0=LOW, 1=HIGH, 2=AUTO, 3=HILLHOLD", "Gearbox Control", true},
-        {"OilPump", 48, "%", "Gearbox Control", true},
-        {"cruisestep", 49, "rpm", "Cruise Control", true},
-        {"cruiseramp", 50, "rpm/100ms", "Cruise Control", true},
-        {"regenlevel", 51, "", "Cruise Control", true},
-        {"udcsw", 52, "V", "Contactor Control", true},
-        {"cruiselight", 53, "0=Off, 1=On, 2=na", "Contactor Control", true},
-        {"errlights", 54, "0=Off, 4=EPC, 8=engine", "Contactor Control", true},
-        {"CAN3Speed", 55, "0=k33.3, 1=k500, 2=k100", "Communication", true},
-        {"BattCap", 56, "kWh", "Charger Control", true},
-        {"Voltspnt", 57, "V", "Charger Control", true},
-        {"Pwrspnt", 58, "W", "Charger Control", true},
-        {"IdcTerm", 59, "A", "Charger Control", true},
-        {"CCS_ICmd", 60, "A", "Charger Control", true},
-        {"CCS_ILim", 61, "A", "Charger Control", true},
-        {"CCS_SOCLim", 62, "%", "Charger Control", true},
-        {"SOCFC", 63, "%", "Charger Control", true},
-        {"Chgctrl", 64, "0=Enable, 1=Disable, 2=Timer", "Charger Control", true},
-        {"ChgAcVolt", 65, "Vac", "Charger Control", true},
-        {"ChgEff", 66, "%", "Charger Control", true},
-        {"ConfigFoccci", 67, "0=Off, 1=On, 2=na", "Charger Control", true},
-        {"DCdc_Type", 68, "0=NoDCDC, 1=TeslaG2", "DC-DC Converter", true},
-        {"DCSetPnt", 69, "V", "DC-DC Converter", true},
-        {"BMS_Timeout", 70, "sec", "Battery Management", true},
-        {"BMS_VminLimit", 71, "V", "Battery Management", true},
-        {"BMS_VmaxLimit", 72, "V", "Battery Management", true},
-        {"BMS_TminLimit", 73, "°C", "Battery Management", true},
-        {"BMS_TmaxLimit", 74, "°C", "Battery Management", true},
-        {"Heater", 75, "0=None, 1=Ampera, 2=VW, 3=OpenI, 4=TeslaRear, 5=Outlander, 6=i3", "Heater Module", true},
-        {"Control", 76, "0=Disable, 1=Enable, 2=Timer", "Heater Module", true},
-        {"HeatPwr", 77, "W", "Heater Module", true},
-        {"HeatPercnt", 78, "%", "Heater Module", true},
-        {"Set_Day", 79, "0=Sun, 1=Mon, 2=Tue, 3=Wed, 4=Thu, 5=Fri, 6=Sat", "RTC Module", true},
-        {"Set_Hour", 80, "Hours", "RTC Module", true},
-        {"Set_Min", 81, "Mins", "RTC Module", true},
-        {"Set_Sec", 82, "Secs", "RTC Module", true},
-        {"Chg_Hrs", 83, "Hours", "RTC Module", true},
-        {"Chg_Min", 84, "Mins", "RTC Module", true},
-        {"Chg_Dur", 85, "Mins", "RTC Module", true},
-        {"Pre_Hrs", 86, "Hours", "RTC Module", true},
-        {"Pre_Min", 87, "Mins", "RTC Module", true},
-        {"Pre_Dur", 88, "Mins", "RTC Module", true},
-        {"PumpPWM", 89, "0=GS450hOil, 1=TachoOut", "General Purpose I/O", true},
-        {"Out1Func", 90, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"Out2Func", 91, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"Out3Func", 92, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"SL1Func", 93, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"SL2Func", 94, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PWM1Func", 95, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PWM2Func", 96, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PWM3Func", 97, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"GP12VInFunc", 98, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"HVReqFunc", 99, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PB1InFunc", 100, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PB2InFunc", 101, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PB3InFunc", 102, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"GPA1Func", 103, "0=None, 1=ProxPilot, 2=BrakePres, 3=BrakeVacuum, 4=DigiPot1, 5=DigiPot2, 6=TempSensor, 7=ISA_CFG", "General Purpose I/O", true},
-        {"GPA2Func", 104, "0=None, 1=ProxPilot, 2=BrakePres, 3=BrakeVacuum, 4=DigiPot1, 5=DigiPot2, 6=TempSensor, 7=ISA_CFG", "General Purpose I/O", true},
-        {"ppthresh", 105, "dig", "General Purpose I/O", true},
-        {"BrkVacThresh", 106, "dig", "General Purpose I/O", true},
-        {"BrkVacHyst", 107, "dig", "General Purpose I/O", true},
-        {"DigiPot1Step", 108, "dig", "General Purpose I/O", true},
-        {"DigiPot2Step", 109, "dig", "General Purpose I/O", true},
-        {"FanTemp", 110, "°C", "General Purpose I/O", true},
-        {"TachoPPR", 111, "PPR", "General Purpose I/O", true},
-        {"IsaInit", 112, "0=Off, 1=On, 2=na", "ISA Shunt Control", true},
-        {"Tim3_Presc", 113, "", "PWM Control", true},
-        {"Tim3_Period", 114, "", "PWM Control", true},
-        {"Tim3_1_OC", 115, "", "PWM Control", true},
-        {"Tim3_2_OC", 116, "", "PWM Control", true},
-        {"Tim3_3_OC", 117, "", "PWM Control", true},
-        {"CP_PWM", 118, "", "PWM Control", true}
-    };
-    
-    int paramCount = sizeof(params) / sizeof(params[0]);
+    // Names and units come from the schema synced from the inverter when
+    // there is one, otherwise from the built-in table. Held to the end: the
+    // document points into its metadata until it is serialized.
+    ParamTableLock table(canManager);
+    bool useSchema = schemaSync && schemaSync->isSynced() && canManager->getParameterCount() > 0;
+    int paramCount = useSchema ? canManager->getParameterCount() : PARAM_TABLE_SIZE;
+    
+    Serial.printf("[WEB] Building JSON response from the %s\n", useSchema ? "inverter schema" : "parameter table");
     Serial.printf("[WEB] Querying %d parameters via SDO\n", paramCount);
     
     for (int idx = 0; idx < paramCount; idx++) {
-        ParamDef& p = params[idx];
+        ParamInfo p = PARAM_TABLE[useSchema ? 0 : idx];
+        bool isParam = true;
+        if (useSchema) {
+            const ParamMeta* meta = canManager->getParameterByIndex(idx);
+            const ParamInfo* info = findParamInfo(meta->id);
+            bool known = info && strcmp(info->name, meta->name) == 0;
+            p = ParamInfo(meta->id, meta->name, meta->unit, known ? info->category : "",
+                          known ? info->encoding : PARAM_ENC_FIXED32);
+            isParam = meta->editable;
+        }
         int32_t value = 0;
         bool gotValue = false;
         
         Serial.printf("[WEB] Querying param %d (%s)...\n", p.id, p.name);
         
-        // Flush RX buffer
-        twai_message_t dummyMsg;
-        while (twai_receive(&dummyMsg, 0) == ESP_OK) {}
-        
-        // Send SDO Upload request
-        twai_message_t txMsg;
-        txMsg.identifier = 0x603;
-        txMsg.extd = 0;
-        txMsg.rtr = 0;
-        txMsg.data_length_code = 8;
-        txMsg.data[0] = 0x40;
-        txMsg.data[1] = 0x00;
-        txMsg.data[2] = 0x21;
-        txMsg.data[3] = p.id & 0xFF;
-        txMsg.data[4] = 0x00;
-        txMsg.data[5] = 0x00;
-        txMsg.data[6] = 0x00;
-        txMsg.data[7] = 0x00;
-        
-        if (twai_transmit(&txMsg, pdMS_TO_TICKS(10)) == ESP_OK) {
-            uint32_t startTime = millis();
-            int messagesChecked = 0;
-            while (millis() - startTime < 500 && messagesChecked < 50) {
-                twai_message_t rxMsg;
-                if (twai_receive(&rxMsg, pdMS_TO_TICKS(10)) == ESP_OK) {
-                    messagesChecked++;
-                    
-                    if (rxMsg.identifier == 0x583 &&
-                        rxMsg.data[1] == 0x00 &&
-                        rxMsg.data[2] == 0x21 &&
-                        rxMsg.data[3] == (p.id & 0xFF)) {
-                        
-                        if (rxMsg.data[0] == 0x43 || rxMsg.data[0] == 0x4B) {
-                            value = rxMsg.data[4] | 
-                                   (rxMsg.data[5] << 8) | 
-                                   (rxMsg.data[6] << 16) | 
-                                   (rxMsg.data[7] << 24);
-                            gotValue = true;
-                            Serial.printf("[WEB] ✓ Got value for %s: %d (checked %d msgs)\n", p.name, value, messagesChecked);
-                            break;
-                        } else if (rxMsg.data[0] == 0x80) {
-                            Serial.printf("[WEB] ✗ Param %s doesn't exist (abort)\n", p.name);
-                            break;
-                        }
-                    }
-                }
-            }
-            
-            if (!gotValue && messagesChecked > 0) {
-                Serial.printf("[WEB] ✗ No response for %s after %d messages\n", p.name, messagesChecked);
+        // The CAN task routes the 0x583 reply back to us; this task just sleeps.
+        // Ids above 255 (spot values from 2000 up) don't fit the 8-bit
+        // subindex - OpenInverter spreads them over 0x2100 | (uid >> 8).
+        if (p.id > 0xFF) {
+            uint8_t data[4];
+            size_t length = 0;
+            gotValue = canManager->getSDO().upload(0x2100 | (p.id >> 8), p.id & 0xFF,
+                                                   data, sizeof(data), length, false) && length == 4;
+            if (gotValue) {
+                value = (int32_t)((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+                                  ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
             }
+        } else {
+            gotValue = canManager->getSDO().readParameter(p.id, value);
+        }
+        if (gotValue) {
+            Serial.printf("[WEB] ✓ Got value for %s: %d\n", p.name, value);
+        } else {
+            Serial.printf("[WEB] ✗ No value for %s (%s)\n", p.name, canManager->getSDO().getLastError());
+            value = 0;
         }
         
         // Build JSON response
         JsonObject paramObj = doc.createNestedObject(p.name);
         
-        // Apply fixed-point conversion (divide by 32) for parameters that need it
-        float displayValue = value;
-        if (!usesRawValue(p.name)) {
-            displayValue = value / 32.0f;
+        // Fixed-point parameters are decoded from x32, exactly and without floats
+        if (p.encoding == PARAM_ENC_FIXED32) {
+            char text[16];
+            formatScaled(text, sizeof(text), OpenInverterCodec::decode(value), OpenInverterCodec::decimals);
+            paramObj["value"] = serialized(String(text));
+        } else {
+            paramObj["value"] = value;
         }
-        
-        paramObj["value"] = displayValue;
         paramObj["unit"] = p.unit;
-        paramObj["isparam"] = p.isEditable;
+        paramObj["isparam"] = isParam;
         paramObj["i"] = p.id;
         paramObj["category"] = p.category;
-        
-        delay(5);
     }
     
     Serial.printf("[WEB] ========================================\n");
@@ -615,159 +497,34 @@ String WebInterface::buildJSONResponse(bool includeHidden) {
 }
 
 
-bool WebInterface::setParameterValue(int paramId, int32_t value) {
-    Serial.printf("[WEB] Setting param %d to %d\n", paramId, value);
-    
-    // Find parameter name from ID
-    const char* paramName = nullptr;
-    
-    // Use the hardcoded params array to look up name
-    struct ParamDef {
-        const char* name;
-        int id;
-        const char* unit;
-        const char* category;
-        bool isEditable;
-    };
-    
-    ParamDef params[] = {
-        {"Inverter", 0, "0=None, 1=Leaf_Gen1, 2=GS450h, 3=UserCAN, 4=OpenI, 5=Prius_Gen3, 6=RearAC, 7=E65_MT, 8=CanOI, 9=E65_BMW", "General Setup", true},
-        {"Vehicle", 1, "0=BMW_E46, 1=BMW_E6x+, 2=Classic, 3=None, 4=User, 5=CPC", "General Setup", true},
-        {"GearLvr", 2, "0=None, 1=BMW_F30, 2=JLR_G1, 3=JLR_G2, 4=VAG, 5=Outlander", "General Setup", true},
-        {"Transmission", 3, "0=Manual, 1=Auto", "General Setup", true},
-        {"interface", 4, "0=Unused, 1=i3LIM, 2=Chademo, 3=CPC", "General Setup", true},
-        {"chargemodes", 5, "0=Off, 1=EXT_DIGI, 2=Volt_A, 3=Volt_A+EXT, 4=i3LIM, 5=i3LIM+EXT, 6=Focci, 7=Leaf_PDM, 8=Outlander, 9=CPC, 10=Leaf_Inverter, 11=Tesla_M3_OBC", "General Setup", true},
-        {"BMS_Mode", 6, "0=Off, 1=SimpBMS, 2=TiDaisyChain, 3=BMWi3LIM, 4=OutlanderFront, 5=VWeBMS, 6=OutlanderFront+Rear, 7=Volt, 8=LeafGen2, 9=CPC, 10=RenaultZoe, 11=TeslaM3, 12=VictronCAN", "General Setup", true},
-        {"ShuntType", 7, "0=None, 1=ISA, 2=SBOX, 3=VAG", "General Setup", true},
-        {"InverterCan", 8, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"VehicleCan", 9, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"ShuntCan", 10, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"LimCan", 11, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"ChargerCan", 12, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"BMSCan", 13, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"OBD2Can", 14, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"CanMapCan", 15, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"DCDCCan", 16, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"HeaterCan", 17, "0=CAN1, 1=CAN2", "General Setup", true},
-        {"MotActive", 18, "0=Mg1and2, 1=Mg1, 2=Mg2, 3=Both", "General Setup", true},
-        {"potmin", 19, "dig", "Throttle", true},
-        {"potmax", 20, "dig", "Throttle", true},
-        {"pot2min", 21, "dig", "Throttle", true},
-        {"pot2max", 22, "dig", "Throttle", true},
-        {"regenrpm", 23, "rpm", "Throttle", true},
-        {"regenendrpm", 24, "rpm", "Throttle", true},
-        {"regenmax", 25, "%", "Throttle", true},
-        {"regenBrake", 26, "%", "Throttle", true},
-        {"regenramp", 27, "%/10ms", "Throttle", true},
-        {"potmode", 28, "0=SingleChannel, 1=DualChannel", "Throttle", true},
-        {"dirmode", 29, "0=Button, 1=Switch, 2=ButtonReversed, 3=SwitchReversed, 4=DefaultForward", "Throttle", true},
-        {"reversemotor", 30, "0=Off, 1=On, 2=na", "Throttle", true},
-        {"throtramp", 31, "%/10ms", "Throttle", true},
-        {"throtramprpm", 32, "rpm", "Throttle", true},
-        {"revlim", 33, "rpm", "Throttle", true},
-        {"revRegen", 34, "0=Off, 1=On, 2=na", "Throttle", true},
-        {"udcmin", 35, "V", "Throttle", true},
-        {"udclim", 36, "V", "Throttle", true},
-        {"idcmax", 37, "A", "Throttle", true},
-        {"idcmin", 38, "A", "Throttle", true},
-        {"tmphsmax", 39, "°C", "Throttle", true},
-        {"tmpmmax", 40, "°C", "Throttle", true},
-        {"throtmax", 41, "%", "Throttle", true},
-        {"throtmin", 42, "%", "Throttle", true},
-        {"throtmaxRev", 43, "%", "Throttle", true},
-        {"throtdead", 44, "%", "Throttle", true},
-        {"RegenBrakeLight", 45, "%", "Throttle", true},
-        {"throtrpmfilt", 46, "rpm/10ms", "Throttle", true},
-        {"Gear", 47, "0=LOW, 1=HIGH, 2=AUTO, 3=HILLHOLD", "Gearbox Control", true},
-        {"OilPump", 48, "%", "Gearbox Control", true},
-        {"cruisestep", 49, "rpm", "Cruise Control", true},
-        {"cruiseramp", 50, "rpm/100ms", "Cruise Control", true},
-        {"regenlevel", 51, "", "Cruise Control", true},
-        {"udcsw", 52, "V", "Contactor Control", true},
-        {"cruiselight", 53, "0=Off, 1=On, 2=na", "Contactor Control", true},
-        {"errlights", 54, "0=Off, 4=EPC, 8=engine", "Contactor Control", true},
-        {"CAN3Speed", 55, "0=k33.3, 1=k500, 2=k100", "Communication", true},
-        {"BattCap", 56, "kWh", "Charger Control", true},
-        {"Voltspnt", 57, "V", "Charger Control", true},
-        {"Pwrspnt", 58, "W", "Charger Control", true},
-        {"IdcTerm", 59, "A", "Charger Control", true},
-        {"CCS_ICmd", 60, "A", "Charger Control", true},
-        {"CCS_ILim", 61, "A", "Charger Control", true},
-        {"CCS_SOCLim", 62, "%", "Charger Control", true},
-        {"SOCFC", 63, "%", "Charger Control", true},
-        {"Chgctrl", 64, "0=Enable, 1=Disable, 2=Timer", "Charger Control", true},
-        {"ChgAcVolt", 65, "Vac", "Charger Control", true},
-        {"ChgEff", 66, "%", "Charger Control", true},
-        {"ConfigFoccci", 67, "0=Off, 1=On, 2=na", "Charger Control", true},
-        {"DCdc_Type", 68, "0=NoDCDC, 1=TeslaG2", "DC-DC Converter", true},
-        {"DCSetPnt", 69, "V", "DC-DC Converter", true},
-        {"BMS_Timeout", 70, "sec", "Battery Management", true},
-        {"BMS_VminLimit", 71, "V", "Battery Management", true},
-        {"BMS_VmaxLimit", 72, "V", "Battery Management", true},
-        {"BMS_TminLimit", 73, "°C", "Battery Management", true},
-        {"BMS_TmaxLimit", 74, "°C", "Battery Management", true},
-        {"Heater", 75, "0=None, 1=Ampera, 2=VW, 3=OpenI, 4=TeslaRear, 5=Outlander, 6=i3", "Heater Module", true},
-        {"Control", 76, "0=Disable, 1=Enable, 2=Timer", "Heater Module", true},
-        {"HeatPwr", 77, "W", "Heater Module", true},
-        {"HeatPercnt", 78, "%", "Heater Module", true},
-        {"Set_Day", 79, "0=Sun, 1=Mon, 2=Tue, 3=Wed, 4=Thu, 5=Fri, 6=Sat", "RTC Module", true},
-        {"Set_Hour", 80, "Hours", "RTC Module", true},
-        {"Set_Min", 81, "Mins", "RTC Module", true},
-        {"Set_Sec", 82, "Secs", "RTC Module", true},
-        {"Chg_Hrs", 83, "Hours", "RTC Module", true},
-        {"Chg_Min", 84, "Mins", "RTC Module", true},
-        {"Chg_Dur", 85, "Mins", "RTC Module", true},
-        {"Pre_Hrs", 86, "Hours", "RTC Module", true},
-        {"Pre_Min", 87, "Mins", "RTC Module", true},
-        {"Pre_Dur", 88, "Mins", "RTC Module", true},
-        {"PumpPWM", 89, "0=GS450hOil, 1=TachoOut", "General Purpose I/O", true},
-        {"Out1Func", 90, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"Out2Func", 91, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"Out3Func", 92, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"SL1Func", 93, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"SL2Func", 94, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PWM1Func", 95, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PWM2Func", 96, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PWM3Func", 97, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"GP12VInFunc", 98, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"HVReqFunc", 99, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PB1InFunc", 100, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PB2InFunc", 101, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"PB3InFunc", 102, "0=None, 1=ChaDeMoAlw, 2=OBCEnable, 3=OBCWakeup, 4=ChargeLight, 5=NegContactorOut", "General Purpose I/O", true},
-        {"GPA1Func", 103, "0=None, 1=ProxPilot, 2=BrakePres, 3=BrakeVacuum, 4=DigiPot1, 5=DigiPot2, 6=TempSensor, 7=ISA_CFG", "General Purpose I/O", true},
-        {"GPA2Func", 104, "0=None, 1=ProxPilot, 2=BrakePres, 3=BrakeVacuum, 4=DigiPot1, 5=DigiPot2, 6=TempSensor, 7=ISA_CFG", "General Purpose I/O", true},
-        {"ppthresh", 105, "dig", "General Purpose I/O", true},
-        {"BrkVacThresh", 106, "dig", "General Purpose I/O", true},
-        {"BrkVacHyst", 107, "dig", "General Purpose I/O", true},
-        {"DigiPot1Step", 108, "dig", "General Purpose I/O", true},
-        {"DigiPot2Step", 109, "dig", "General Purpose I/O", true},
-        {"FanTemp", 110, "°C", "General Purpose I/O", true},
-        {"TachoPPR", 111, "PPR", "General Purpose I/O", true},
-        {"IsaInit", 112, "0=Off, 1=On, 2=na", "ISA Shunt Control", true},
-        {"Tim3_Presc", 113, "", "PWM Control", true},
-        {"Tim3_Period", 114, "", "PWM Control", true},
-        {"Tim3_1_OC", 115, "", "PWM Control", true},
-        {"Tim3_2_OC", 116, "", "PWM Control", true},
-        {"Tim3_3_OC", 117, "", "PWM Control", true},
-        {"CP_PWM", 118, "", "PWM Control", true}
-    };
-    
-    int paramCount = sizeof(params) / sizeof(params[0]);
-    for (int i = 0; i < paramCount; i++) {
-        if (params[i].id == paramId) {
-            paramName = params[i].name;
-            break;
+bool WebInterface::encodeParamValue(int paramId, const String& valueText, int32_t& encodedValue) {
+    const ParamInfo* info = findParamInfo(paramId);
+    
+    // Fixed-point parameters accept decimals ("12.5") and are encoded x32
+    if (info && info->encoding == PARAM_ENC_FIXED32) {
+        int32_t scaled;
+        if (!parseScaled(valueText.c_str(), OpenInverterCodec::decimals, scaled)) {
+            return false;
+        }
+        encodedValue = OpenInverterCodec::encode(scaled);
+        Serial.printf("[WEB] Encoded %s -> %d (x32) for %s\n", valueText.c_str(), encodedValue, info->name);
+    } else {
+        if (!parseScaled(valueText.c_str(), 0, encodedValue)) {
+            return false;
+        }
+        if (info) {
+            Serial.printf("[WEB] Using raw value %d for %s (no encoding)\n", encodedValue, info->name);
         }
     }
+    return true;
+}
+
+bool WebInterface::setParameterValue(int paramId, const String& valueText) {
+    Serial.printf("[WEB] Setting param %d to %s\n", paramId, valueText.c_str());
     
-    // Apply fixed-point encoding (multiply by 32) for parameters that need it
-    int32_t encodedValue = value;
-    
-    if (paramName && !usesRawValue(paramName)) {
-        encodedValue = value * 32;
-        Serial.printf("[WEB] Encoded %d -> %d (x32) for %s\n", value, encodedValue, paramName);
-    } else if (paramName) {
-        Serial.printf("[WEB] Using raw value %d for %s (no encoding)\n", value, paramName);
+    int32_t encodedValue;
+    if (!encodeParamValue(paramId, valueText, encodedValue)) {
+        return false;
     }
     
     // Use CANDataManager's setParameter method which handles:
@@ -782,9 +539,9 @@ bool WebInterface::setParameterValue(int paramId, int32_t value) {
 }
 
 int32_t WebInterface::getParameterValue(int paramId) {
-    CANParameter* param = canManager->getParameter(paramId);
-    if (param) {
-        return param->getValueAsInt();
+    int32_t value;
+    if (canManager->getValue(paramId, value)) {
+        return value;
     }
     return 0;
 }
@@ -820,9 +577,7 @@ void WebInterface::handleCanSend() {
     }
     msg.data_length_code = byteIndex;
     
-    esp_err_t result = twai_transmit(&msg, pdMS_TO_TICKS(100));
-    
-    if (result == ESP_OK) {
+    if (CANDataManager::transmit(msg, pdMS_TO_TICKS(100))) {
         // Log the transmitted message
         logCanMessage(canId, msg.data, byteIndex, false);
         
@@ -844,14 +599,10 @@ void WebInterface::handleCanLog() {
     JsonDocument doc;
     JsonArray messages = doc.to<JsonArray>();
     
-    // Return messages in reverse order (newest first)
-    for (int i = 0; i < CAN_LOG_SIZE; i++) {
-        int idx = (canLogIndex - 1 - i + CAN_LOG_SIZE) % CAN_LOG_SIZE;
-        CANLogMessage& msg = canLogBuffer[idx];
-        
-        // Skip empty slots
-        if (msg.timestamp == 0) continue;
-        
+    // Hand over everything logged since the last poll, oldest first
+    canLogLastPoll = millis();
+    CANLogMessage msg;
+    while (canLog.pop(msg)) {
         JsonObject msgObj = messages.createNestedObject();
         msgObj["id"] = msg.id;
         msgObj["rx"] = msg.isRx;
@@ -871,15 +622,291 @@ void WebInterface::handleCanLog() {
     server.send(200, "application/json", response);
 }
 
+void WebInterface::handleCanStats() {
+    if (corsEnabled) addCORSHeaders();
+    
+    const CANStats& stats = canManager->getStats();
+    
+    JsonDocument doc;
+    doc["rxFrames"] = stats.rxFrames;
+    doc["rxBurstMax"] = stats.rxBurstMax;
+    doc["driverRxPeak"] = stats.driverRxPeak;
+    doc["driverRxQueueLen"] = CAN_DRIVER_RX_QUEUE_LEN;
+    doc["driverRxMissed"] = stats.driverRxMissed;
+    doc["driverRxOverrun"] = stats.driverRxOverrun;
+    doc["txFrames"] = stats.txFrames;
+    doc["txFailed"] = stats.txFailed;
+    doc["txQueueFull"] = stats.txQueueFull;
+    
+    const PollStats& poll = canManager->getPollStats();
+    JsonObject polling = doc.createNestedObject("poll");
+    polling["requests"] = poll.requests;
+    polling["requestsPerSec"] = poll.requestsPerSec;
+    polling["budgetPerSec"] = POLL_BUDGET_PER_SEC;
+    polling["budgetDeferred"] = poll.budgetDeferred;
+    polling["polled"] = poll.polled;
+    polling["broadcast"] = poll.broadcast;
+    polling["stale"] = poll.stale;
+    polling["worstAgeMs"] = poll.worstAgeMs;
+    
+    if (heartbeat) {
+        HeartbeatStats beat;
+        heartbeat->getStats(beat);
+        JsonObject hb = doc.createNestedObject("heartbeat");
+        hb["unlocked"] = beat.unlocked;
+        hb["sent"] = beat.sent;
+        hb["txFailed"] = beat.txFailed;
+        hb["deadlineMisses"] = beat.deadlineMisses;
+        hb["periodMinUs"] = beat.periodMinUs;
+        hb["periodMaxUs"] = beat.periodMaxUs;
+        hb["periodAvgUs"] = beat.periodAvgUs;
+        hb["jitterMaxUs"] = beat.jitterMaxUs;
+        hb["windowFaults"] = beat.windowFaults;
+        hb["worstPeriodUs"] = beat.worstPeriodUs;
+    }
+    
+    // idcmax writes and their ACKs; alarm = the inverter stopped acknowledging
+    if (immobilizer) {
+        CurrentLimitStatus limit;
+        immobilizer->getLimitStatus(limit);
+        JsonObject idcmax = doc.createNestedObject("idcmax");
+        idcmax["alarm"] = limit.alarm;
+        idcmax["acked"] = limit.acked;
+        idcmax["ackAgeMs"] = limit.acks > 0 ? millis() - limit.lastAck : 0;
+        idcmax["sent"] = limit.sent;
+        idcmax["acks"] = limit.acks;
+        idcmax["timeouts"] = limit.timeouts;
+        idcmax["aborts"] = limit.aborts;
+        idcmax["lastAbortCode"] = limit.lastAbortCode;
+        idcmax["failures"] = limit.failures;
+        idcmax["ackLatencyMaxMs"] = limit.ackLatencyMaxMs;
+
+        // VCU heartbeat watchdog; latency = how late a dropout was detected
+        VcuWatchdogStatus vcuStatus;
+        immobilizer->getVcuStatus(vcuStatus);
+        JsonObject vcu = doc.createNestedObject("vcu");
+        vcu["online"] = vcuStatus.online;
+        vcu["frames"] = vcuStatus.frames;
+        vcu["streak"] = vcuStatus.streak;
+        vcu["timeouts"] = vcuStatus.timeouts;
+        vcu["autoLocks"] = vcuStatus.autoLocks;
+        vcu["lastLatencyUs"] = vcuStatus.lastLatencyUs;
+        vcu["maxLatencyUs"] = vcuStatus.maxLatencyUs;
+
+        RfidStatus rfidStatus;
+        immobilizer->getRfidStatus(rfidStatus);
+        JsonObject rfid = doc.createNestedObject("rfid");
+        rfid["present"] = rfidStatus.present;
+        rfid["version"] = rfidStatus.version;
+        rfid["probes"] = rfidStatus.probes;
+        rfid["cards"] = rfidStatus.cards;
+        rfid["ghosts"] = rfidStatus.ghosts;
+        rfid["readErrors"] = rfidStatus.readErrors;
+        rfid["authorized"] = rfidStatus.authorized;
+        rfid["rejected"] = rfidStatus.rejected;
+        rfid["lastLatencyUs"] = rfidStatus.lastLatencyUs;
+        rfid["maxLatencyUs"] = rfidStatus.maxLatencyUs;
+    }
+    
+    // Internal I2C bus shared by touch and RFID (word-sized counters)
+    I2CBusStats bus = I2CBus::getStats();
+    JsonObject i2c = doc.createNestedObject("i2c");
+    i2c["acquired"] = bus.acquired;
+    i2c["contended"] = bus.contended;
+    i2c["timeouts"] = bus.timeouts;
+    i2c["maxWaitUs"] = bus.maxWaitUs;
+    
+    // Cost per dial screen (ScreenID), for comparing what each one loads
+    JsonArray screens = doc.createNestedArray("screens");
+    for (uint8_t tag = 0; tag < MAX_INTEREST_TAGS; tag++) {
+        const InterestStats& cost = canManager->getInterestStats(tag);
+        if (cost.activeMs < 1000) continue;
+        JsonObject screen = screens.createNestedObject();
+        screen["screen"] = tag;
+        screen["activeMs"] = cost.activeMs;
+        screen["sdoPerSec"] = (uint32_t)((uint64_t)cost.sdoRequests * 1000 / cost.activeMs);
+        screen["decodeUsPerSec"] = (uint32_t)((uint64_t)cost.decodeUs * 1000 / cost.activeMs);
+        screen["framesDecoded"] = cost.framesDecoded;
+        screen["framesSkipped"] = cost.framesSkipped;
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebInterface::handleTasks() {
+    if (corsEnabled) addCORSHeaders();
+    
+    JsonDocument doc;
+    JsonArray tasks = doc.to<JsonArray>();
+    
+    if (taskManager) {
+        for (uint8_t i = 0; i < taskManager->getTaskCount(); i++) {
+            const TaskStats& stats = taskManager->getStats(i);
+            JsonObject task = tasks.createNestedObject();
+            task["name"] = stats.name;
+            task["core"] = stats.core;
+            task["priority"] = stats.priority;
+            task["periodMs"] = stats.periodMs;
+            task["cpu"] = stats.cpuPercent;
+            task["cycles"] = stats.cycles;
+            task["maxCycleUs"] = stats.maxCycleUs;
+            task["stackFree"] = stats.stackFree;
+        }
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+// Every scheduler job by task: run time and how late it started
+void WebInterface::handleSchedule() {
+    if (corsEnabled) addCORSHeaders();
+    
+    JsonDocument doc;
+    JsonArray jobs = doc.to<JsonArray>();
+    
+    if (taskManager) {
+        for (uint8_t i = 0; i < taskManager->getTaskCount(); i++) {
+            Scheduler* scheduler = taskManager->getScheduler(i);
+            if (!scheduler) continue;
+            
+            for (uint8_t j = 0; j < scheduler->getJobCount(); j++) {
+                JobStats stats;
+                scheduler->getStats(j, stats);
+                uint32_t runs = stats.runs > 0 ? stats.runs : 1;
+                
+                JsonObject job = jobs.createNestedObject();
+                job["task"] = taskManager->getStats(i).name;
+                job["name"] = stats.name;
+                job["priority"] = stats.priority;
+                job["periodMs"] = stats.periodMs;
+                job["armed"] = stats.armed;
+                job["runs"] = stats.runs;
+                job["skipped"] = stats.skipped;
+                job["lastRunUs"] = stats.lastRunUs;
+                job["avgRunUs"] = (uint32_t)(stats.totalRunUs / runs);
+                job["maxRunUs"] = stats.maxRunUs;
+                job["lastLateUs"] = stats.lastLateUs;
+                job["avgLateUs"] = (uint32_t)(stats.totalLateUs / runs);
+                job["maxLateUs"] = stats.maxLateUs;
+            }
+        }
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+// Display state, CPU clocking and the energy estimate, next to the
+// heartbeat timing it must not disturb
+void WebInterface::handlePower() {
+    if (corsEnabled) addCORSHeaders();
+    
+    JsonDocument doc;
+    if (power) {
+        PowerStats stats;
+        power->getStats(stats);
+        doc["state"] = PowerManager::getStateName(stats.state);
+        
+        JsonObject pm = doc.createNestedObject("pm");
+        pm["mode"] = stats.pmMode == PM_MODE_DFS_SLEEP ? "dfs+lightsleep" :
+                     stats.pmMode == PM_MODE_DFS ? "dfs" : "fixed";
+        pm["maxMhz"] = stats.maxCpuMhz;
+        pm["minMhz"] = stats.minCpuMhz;
+        pm["boostPct"] = stats.boostPct;
+        
+        JsonArray states = doc.createNestedArray("states");
+        uint32_t usedUAh = 0;
+        for (uint8_t i = 0; i < POWER_STATE_COUNT; i++) {
+            JsonObject state = states.createNestedObject();
+            state["name"] = PowerManager::getStateName((PowerState)i);
+            state["ms"] = stats.ms[i];
+            state["avgMa"] = stats.estimateMa[i];
+            state["uAh"] = stats.uAh[i];
+            usedUAh += stats.uAh[i];
+        }
+        doc["usedUAh"] = usedUAh;
+        doc["savedUAh"] = stats.savedUAh;
+        doc["wakesByInput"] = stats.wakesByInput;
+        doc["wakesByCan"] = stats.wakesByCan;
+    }
+    
+    // Who kept the clock up, and for how long
+    JsonArray locks = doc.createNestedArray("locks");
+    for (uint8_t i = 0; i < PmLock::getCount(); i++) {
+        const PmLock* lock = PmLock::get(i);
+        JsonObject entry = locks.createNestedObject();
+        entry["name"] = lock->getName();
+        entry["acquisitions"] = lock->getAcquisitions();
+        entry["heldMs"] = lock->getHeldUs() / 1000;
+    }
+    
+    if (heartbeat) {
+        HeartbeatStats beat;
+        heartbeat->getStats(beat);
+        JsonObject hb = doc.createNestedObject("heartbeat");
+        hb["jitterMaxUs"] = beat.jitterMaxUs;
+        hb["periodMaxUs"] = beat.periodMaxUs;
+        hb["deadlineMisses"] = beat.deadlineMisses;
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebInterface::handleSchema() {
+    if (corsEnabled) addCORSHeaders();
+    
+    JsonDocument doc;
+    if (schemaSync) {
+        const SchemaStatus& status = schemaSync->getStatus();
+        doc["synced"] = schemaSync->isSynced();
+        doc["result"] = status.result;
+        doc["serial"] = status.serial;
+        doc["firmware"] = status.firmware;
+        doc["size"] = status.size;
+        doc["downloadMs"] = status.downloadMs;
+        doc["added"] = status.added;
+        doc["removed"] = status.removed;
+        doc["changed"] = status.changed;
+        doc["unchanged"] = status.unchanged;
+        doc["lastCheck"] = status.lastCheck;
+    }
+    doc["parameters"] = canManager->getParameterCount();
+    
+    String response;
+    serializeJson(doc, response);
+    server.send(200, "application/json", response);
+}
+
+void WebInterface::handleSchemaSync() {
+    if (corsEnabled) addCORSHeaders();
+    
+    if (!schemaSync) {
+        server.send(503, "text/plain", "Schema sync not available");
+        return;
+    }
+    
+    // Blocks this task for the download (block SDO, typically well under a second)
+    bool force = !server.hasArg("check");
+    schemaSync->sync(force);
+    handleSchema();
+}
+
 void WebInterface::logCanMessage(uint32_t id, uint8_t* data, uint8_t len, bool isRx) {
-    CANLogMessage& msg = canLogBuffer[canLogIndex];
+    CANLogMessage msg;
     msg.id = id;
-    msg.len = len;
+    msg.len = len > 8 ? 8 : len;
     msg.isRx = isRx;
     msg.timestamp = millis();
-    memcpy(msg.data, data, len);
+    memcpy(msg.data, data, msg.len);
     
-    canLogIndex = (canLogIndex + 1) % CAN_LOG_SIZE;
+    canLog.push(msg);  // Dropped if the browser stopped polling mid-burst
 }
 
 void WebInterface::handleParamsUpload() {
@@ -257,42 +257,40 @@ void WiFiManager::handleFileUpload() {
         Serial.printf("Upload complete: %d bytes\n", uploadSize);
         #endif
         
-        // Validate and load parameters
-        File file = SPIFFS.open("/params.json", "r");
-        if (file) {
-            String jsonContent = file.readString();
-            file.close();
-            
-            // Basic JSON validation
-            if (jsonContent.length() == 0 || jsonContent.length() > MAX_JSON_SIZE) {
-                #if DEBUG_SERIAL
-                Serial.println("Invalid file size");
-                #endif
-                SPIFFS.remove("/params.json");
-                server->sendHeader("Location", "/?error=2");
-                server->send(303);
-                return;
-            }
+        // Validate size
+        if (uploadSize == 0 || !SPIFFS.exists("/params.json")) {
+            #if DEBUG_SERIAL
+            Serial.println("Invalid file size");
+            #endif
+            SPIFFS.remove("/params.json");
+            server->sendHeader("Location", "/?error=2");
+            server->send(303);
+            return;
+        }
+        
+        // The CAN task parses it (streamed from SPIFFS, no copy in RAM),
+        // swaps the table and rebuilds the cache; this is the UI task
+        canManager->requestReload();
+        uint32_t waitStart = millis();
+        while (canManager->isReloadPending() && millis() - waitStart < 2000) {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+        
+        if (!canManager->isReloadPending() && canManager->didReloadSucceed()) {
+            #if DEBUG_SERIAL
+            Serial.println("Parameters loaded successfully");
+            #endif
             
-            // Try to parse
-            if (canManager->loadParametersFromJSON(jsonContent.c_str())) {
-                #if DEBUG_SERIAL
-                Serial.println("Parameters loaded successfully");
-                #endif
-                
-                server->sendHeader("Location", "/?success=1");
-                server->send(303);
-            } else {
-                #if DEBUG_SERIAL
-                Serial.println("Failed to parse parameters");
-                #endif
-                
-                SPIFFS.remove("/params.json");
-                server->sendHeader("Location", "/?error=1");
-                server->send(303);
-            }
+            server->sendHeader("Location", "/?success=1");
+            server->send(303);
         } else {
-            server->sendHeader("Location", "/?error=3");
+            #if DEBUG_SERIAL
+            Serial.println("Failed to parse parameters");
+            #endif
+            
+            SPIFFS.remove("/params.json");
+            SPIFFS.remove("/params.bin");
+            server->sendHeader("Location", "/?error=1");
             server->send(303);
         }
     } else if (upload.status == UPLOAD_FILE_ABORTED) {
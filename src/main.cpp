@@ -1,6 +1,5 @@
 #include <Arduino.h>
 #include <SPIFFS.h>
-#include <esp_timer.h>
 #include <driver/twai.h>
 #include "Config.h"
 #include "Hardware.h"
@@ -10,6 +9,11 @@
 #include "WiFiManager.h"
 #include "Immobilizer.h"
 #include "WebInterface.h"
+#include "TaskManager.h"
+#include "Scheduler.h"
+#include "SchemaSync.h"
+#include "SafetyHeartbeat.h"
+#include "PowerManager.h"
 
 // Global objects
 CANDataManager canManager;
@@ -18,15 +22,22 @@ UIManager uiManager;
 WiFiManager wifiManager;
 Immobilizer immobilizer;
 WebInterface webInterface(&canManager);
+TaskManager taskManager;
+Scheduler canJobs;
+Scheduler uiJobs;
+SchemaSync schemaSync;
+SafetyHeartbeat heartbeat;
+PowerManager power;
 
 // State tracking
 bool systemReady = false;
-bool wifiMode = false;
-uint32_t lastParamRequestTime = 0;
-uint8_t currentParamIndex = 0;
 
-// CAN heartbeat timer
-esp_timer_handle_t canHeartbeatTimer;
+// Task cycles and scheduler jobs (run by taskManager, defined below setup())
+void heartbeatCycle();
+void canJob(void* context);
+void uiJob(void* context);
+void statsJob(void* context);
+void webCycle();
 
 // Sample parameters JSON (this would normally be loaded from SPIFFS)
 const char* sampleParams = R"(
@@ -59,280 +70,6 @@ const char* sampleParams = R"(
 }
 )";
 
-// CAN heartbeat callback
-void IRAM_ATTR sendCanHeartbeat(void* arg) {
-    static uint32_t debugCounter = 0;
-    
-    twai_message_t msg;
-    msg.identifier = 0x351;
-    msg.extd = 0;
-    msg.rtr = 0;
-    msg.data_length_code = 8;
-    
-    // Initialize all bytes to 0
-    for (int i = 0; i < 8; i++) {
-        msg.data[i] = 0x00;
-    }
-    
-    // CRITICAL: Only send current limit if unlocked
-    if (immobilizer.isUnlocked()) {
-        // 500A = 5000 in 0.1A units = 0x1388
-        msg.data[4] = 0x88;  // Low byte of 5000
-        msg.data[5] = 0x13;  // High byte of 5000
-        
-        // Debug every 50 messages (5 seconds)
-        if (debugCounter % 50 == 0) {
-            Serial.println("[IMMOBILIZER] UNLOCKED - Sending 500A");
-        }
-    } else {
-        // LOCKED: Explicitly set 0A limit (safety critical!)
-        msg.data[4] = 0x00;  // 0A low byte
-        msg.data[5] = 0x00;  // 0A high byte
-        
-        // Debug every 50 messages (5 seconds)
-        if (debugCounter % 50 == 0) {
-            Serial.println("[IMMOBILIZER] LOCKED - Sending 0A");
-        }
-    }
-    
-    debugCounter++;
-    twai_transmit(&msg, 0);
-}
-
-// Input callbacks
-void onEncoderRotate(int32_t delta) {
-    // IMMOBILIZER: Lock screen handling
-    if (uiManager.getCurrentScreen() == SCREEN_LOCK && !immobilizer.isUnlocked()) {
-        if (delta > 0) {
-            immobilizer.incrementDigit();
-        } else {
-            immobilizer.decrementDigit();
-        }
-        return;
-    }
-    
-    // IMMOBILIZER: Block navigation if locked
-    if (!immobilizer.isUnlocked()) {
-        return;
-    }
-    
-    #if DEBUG_SERIAL
-    Serial.println("========================================");
-    Serial.printf("ENCODER ROTATED: delta = %d\n", delta);
-    Serial.printf("WiFi mode: %s\n", wifiMode ? "YES" : "NO");
-    Serial.printf("Current screen: %d\n", uiManager.getCurrentScreen());
-    Serial.println("========================================");
-    #endif
-    
-    if (wifiMode) {
-        // Exit WiFi mode
-        wifiMode = false;
-        wifiManager.stopAP();
-        uiManager.setScreen(SCREEN_DASHBOARD);
-        #if DEBUG_SERIAL
-        Serial.println("WiFi mode disabled");
-        #endif
-        return;
-    }
-    
-    // Check if on editable screen
-    if (uiManager.isEditableScreen()) {
-        if (uiManager.isEditMode()) {
-            // IN EDIT MODE - adjust parameter
-            ScreenID currentScreen = uiManager.getCurrentScreen();
-            
-            if (currentScreen == SCREEN_GEAR) {
-                CANParameter* gear = canManager.getParameter(27);
-                if (gear) {
-                    int32_t currentGear = gear->getValueAsInt();
-                    int32_t newGear = (delta > 0) ? (currentGear + 1) % 4 : (currentGear - 1 + 4) % 4;
-                    canManager.setParameter(27, newGear);
-                    #if DEBUG_SERIAL
-                    Serial.printf("Gear: %d -> %d\n", currentGear, newGear);
-                    #endif
-                }
-            } else if (currentScreen == SCREEN_MOTOR) {
-                CANParameter* motor = canManager.getParameter(129);
-                if (motor) {
-                    int32_t currentMotor = motor->getValueAsInt();
-                    int32_t newMotor = (delta > 0) ? (currentMotor + 1) % 4 : (currentMotor - 1 + 4) % 4;
-                    canManager.setParameter(129, newMotor);
-                    #if DEBUG_SERIAL
-                    Serial.printf("Motor: %d -> %d\n", currentMotor, newMotor);
-                    #endif
-                }
-            } else if (currentScreen == SCREEN_REGEN) {
-                CANParameter* regen = canManager.getParameter(61);
-                if (regen) {
-                    int32_t currentRegen = regen->getValueAsInt();
-                    int32_t newRegen = currentRegen + (delta > 0 ? 1 : -1);
-                    if (newRegen > 0) newRegen = 0;
-                    if (newRegen < -35) newRegen = -35;
-                    canManager.setParameter(61, newRegen);
-                    #if DEBUG_SERIAL
-                    Serial.printf("Regen: %d -> %d\n", currentRegen, newRegen);
-                    #endif
-                }
-            }
-        } else {
-            // NOT in edit mode - navigate screens
-            if (delta > 0) {
-                uiManager.setScreen(uiManager.getNextScreen());
-            } else {
-                uiManager.setScreen(uiManager.getPreviousScreen());
-            }
-        }
-    } else {
-        // Not editable screen - navigate
-        if (delta > 0) {
-            uiManager.setScreen(uiManager.getNextScreen());
-        } else {
-            uiManager.setScreen(uiManager.getPreviousScreen());
-        }
-    }
-}
-
-void onButtonClick() {
-    ScreenID currentScreen = uiManager.getCurrentScreen();
-    
-    // IMMOBILIZER: Lock screen PIN entry
-    if (currentScreen == SCREEN_LOCK && !immobilizer.isUnlocked()) {
-        immobilizer.enterDigit(immobilizer.getCurrentDigit());
-        if (immobilizer.isUnlocked()) {
-            Serial.println(">>> UNLOCKED <<<");
-            uiManager.setScreen(SCREEN_DASHBOARD);
-        }
-        return;
-    }
-    
-    // IMMOBILIZER: Block button if locked
-    if (!immobilizer.isUnlocked()) {
-        return;
-    }
-    
-    // On editable screens - toggle edit mode
-    if (uiManager.isEditableScreen()) {
-        uiManager.toggleEditMode();
-        #if DEBUG_SERIAL
-        Serial.printf("Edit mode toggled: %s\n", uiManager.isEditMode() ? "ON" : "OFF");
-        #endif
-        
-        // If exiting edit mode, go to next screen
-        if (!uiManager.isEditMode()) {
-            uiManager.setScreen(uiManager.getNextScreen());
-        }
-        return;
-    }
-    
-    // Otherwise, toggle WiFi mode
-    if (!wifiMode) {
-        wifiMode = true;
-        wifiManager.startAP();
-        uiManager.setScreen(SCREEN_WIFI);
-        #if DEBUG_SERIAL
-        Serial.println("WiFi mode enabled");
-        Serial.print("Connect to SSID: ");
-        Serial.println(WIFI_AP_SSID);
-        Serial.print("IP: ");
-        Serial.println(wifiManager.getIPAddress());
-        #endif
-    } else {
-        wifiMode = false;
-        wifiManager.stopAP();
-        uiManager.setScreen(SCREEN_DASHBOARD);
-        #if DEBUG_SERIAL
-        Serial.println("WiFi mode disabled");
-        #endif
-    }
-}
-
-void onButtonDoubleClick() {
-    // Double-click toggles immobilizer lock state (for testing)
-    immobilizer.toggleLock();
-    Serial.printf(">>> IMMOBILIZER: %s (via double-click) <<<\n", 
-                  immobilizer.isUnlocked() ? "UNLOCKED" : "LOCKED");
-    
-    // If locked, go to lock screen
-    if (!immobilizer.isUnlocked()) {
-        uiManager.setScreen(SCREEN_LOCK);
-    }
-}
-
-void onButtonLongPress() {
-    // Back to dashboard (works in any mode)
-    if (wifiMode) {
-        wifiMode = false;
-        wifiManager.stopAP();
-        #if DEBUG_SERIAL
-        Serial.println("WiFi mode disabled");
-        #endif
-    }
-    uiManager.setScreen(SCREEN_DASHBOARD);
-}
-
-void onTouchTap(uint16_t x, uint16_t y) {
-    ScreenID currentScreen = uiManager.getCurrentScreen();
-    
-    // Gear screen - tap to select gear directly
-    if (currentScreen == SCREEN_GEAR) {
-        // Touch zones for 4 gear options
-        // Screen is 240x240, options displayed at y ~170-236 (bottom area)
-        if (y >= 170 && y <= 236) {
-            int option = (y - 170) / 22;  // 22 pixels per option
-            if (option >= 0 && option <= 3) {
-                #if DEBUG_SERIAL
-                Serial.printf("Touch selected gear: %d\n", option);
-                #endif
-                canManager.setParameter(27, option);
-            }
-        }
-    }
-    
-    // Motor screen - tap to select motor mode directly
-    if (currentScreen == SCREEN_MOTOR) {
-        // Touch zones for 4 motor options (same layout as gear)
-        if (y >= 170 && y <= 236) {
-            int option = (y - 170) / 22;  // 22 pixels per option
-            if (option >= 0 && option <= 3) {
-                #if DEBUG_SERIAL
-                Serial.printf("Touch selected motor: %d\n", option);
-                #endif
-                canManager.setParameter(129, option);
-            }
-        }
-    }
-    
-    // Regen screen - tap left/right for adjustment
-    if (currentScreen == SCREEN_REGEN) {
-        CANParameter* regen = canManager.getParameter(61);
-        if (regen) {
-            int32_t currentRegen = regen->getValueAsInt();
-            int32_t newRegen = currentRegen;
-            
-            // Left half = decrease (more regen), right half = increase (less regen)
-            if (x < SCREEN_CENTER_X) {
-                // Left tap - decrease by 5 (more negative = stronger regen)
-                newRegen = currentRegen - 5;
-                if (newRegen < -35) newRegen = -35;
-            } else {
-                // Right tap - increase by 5 (less negative = lighter regen)
-                newRegen = currentRegen + 5;
-                if (newRegen > 0) newRegen = 0;
-            }
-            
-            #if DEBUG_SERIAL
-            Serial.printf("Touch adjusted regen: %d -> %d\n", currentRegen, newRegen);
-            #endif
-            
-            canManager.setParameter(61, newRegen);
-        }
-    }
-    
-    #if DEBUG_TOUCH
-    Serial.printf("Tap at: %d, %d\n", x, y);
-    #endif
-}
-
 void setup() {
     #if DEBUG_SERIAL
     Serial.begin(115200);
@@ -372,33 +109,12 @@ void setup() {
     Serial.println("CAN initialized");
     #endif
     
-    // Start CAN heartbeat timer
-    const esp_timer_create_args_t timerArgs = {
-        .callback = &sendCanHeartbeat,
-        .arg = nullptr,
-        .dispatch_method = ESP_TIMER_TASK,
-        .name = "can_heartbeat",
-        .skip_unhandled_events = false
-    };
-    esp_timer_create(&timerArgs, &canHeartbeatTimer);
-    esp_timer_start_periodic(canHeartbeatTimer, 100000);
-    #if DEBUG_SERIAL
-    Serial.println("CAN heartbeat timer started (100ms)");
-    #endif
-    
     // Initialize immobilizer
-    immobilizer.init();
+    immobilizer.init(&canManager);
     #if DEBUG_SERIAL
     Serial.println("Immobilizer initialized");
     #endif
     
-    // Load parameters
-    if (canManager.loadParametersFromJSON(sampleParams)) {
-        #if DEBUG_SERIAL
-        Serial.printf("Loaded %d parameters\n", canManager.getParameterCount());
-        #endif
-    }
-    
     // Initialize input
     if (!inputManager.init()) {
         #if DEBUG_SERIAL
@@ -443,49 +159,21 @@ void setup() {
     Serial.println("========================================");
     #endif
     
-    wifiMode = false;  // Start with WiFi OFF
     // Do NOT start WiFi automatically
     // uiManager.setScreen will be set below after loading parameters
     
-    // Try to load parameters from SPIFFS
-    if (SPIFFS.exists("/params.json")) {
-        File paramFile = SPIFFS.open("/params.json", "r");
-        if (paramFile) {
-            size_t fileSize = paramFile.size();
-            
+    // Load parameters once: binary cache of /params.json, the JSON itself,
+    // or the built-in defaults (SPIFFS is mounted by the WiFi manager above)
+    if (SPIFFS.exists(PARAM_JSON_PATH)) {
+        if (canManager.loadParametersCached(PARAM_JSON_PATH, PARAM_CACHE_PATH)) {
             #if DEBUG_SERIAL
-            Serial.printf("Found params.json (%d bytes)\n", fileSize);
+            Serial.printf("Loaded %d parameters from SPIFFS\n", canManager.getParameterCount());
             #endif
-            
-            // Check file size is reasonable
-            if (fileSize > 0 && fileSize < MAX_JSON_SIZE) {
-                String jsonContent = paramFile.readString();
-                paramFile.close();
-                
-                if (canManager.loadParametersFromJSON(jsonContent.c_str())) {
-                    #if DEBUG_SERIAL
-                    Serial.printf("Loaded %d parameters from SPIFFS\n", canManager.getParameterCount());
-                    #endif
-                } else {
-                    #if DEBUG_SERIAL
-                    Serial.println("Failed to parse saved parameters, using defaults");
-                    #endif
-                    // Load defaults on parse failure
-                    canManager.loadParametersFromJSON(sampleParams);
-                }
-            } else {
-                paramFile.close();
-                #if DEBUG_SERIAL
-                Serial.println("Saved parameters file invalid, using defaults");
-                #endif
-                // Delete corrupted file
-                SPIFFS.remove("/params.json");
-                canManager.loadParametersFromJSON(sampleParams);
-            }
         } else {
             #if DEBUG_SERIAL
-            Serial.println("Failed to open saved parameters, using defaults");
+            Serial.println("Failed to parse saved parameters, using defaults");
             #endif
+            // Load defaults on parse failure
             canManager.loadParametersFromJSON(sampleParams);
         }
     } else {
@@ -495,12 +183,11 @@ void setup() {
         canManager.loadParametersFromJSON(sampleParams);
     }
     
-    // Set input callbacks
-    inputManager.setOnEncoderRotate(onEncoderRotate);
-    inputManager.setOnButtonClick(onButtonClick);
-    inputManager.setOnButtonDoubleClick(onButtonDoubleClick);
-    inputManager.setOnButtonLongPress(onButtonLongPress);
-    inputManager.setOnTouchTap(onTouchTap);
+    // Input goes through LVGL: the UI drains InputManager's queue into its
+    // encoder and touch indevs, and the widgets on each screen handle it
+    uiManager.setInput(&inputManager);
+    uiManager.setWiFiManager(&wifiManager);
+    power.begin(&uiManager, &inputManager, &canManager, &immobilizer);
     
     // Set initial screen based on lock state
     if (!immobilizer.isUnlocked()) {
@@ -512,7 +199,37 @@ void setup() {
         uiManager.setScreen(SCREEN_DASHBOARD);
     }
     
+    // Hand everything over to the pinned tasks (see Config.h for the layout)
+    heartbeat.begin(&immobilizer);
+    uiManager.setHeartbeat(&heartbeat);
+    webInterface.setHeartbeat(&heartbeat);
+    webInterface.setPowerManager(&power);
+    webInterface.setImmobilizer(&immobilizer);
+    taskManager.addTask("heartbeat", heartbeatCycle, HEARTBEAT_TASK_CORE,
+                        HEARTBEAT_TASK_PRIORITY, HEARTBEAT_TASK_STACK, HEARTBEAT_INTERVAL);
+    
+    // The CAN and UI tasks sleep until their next job is due
+    canJobs.addJob("can", canJob, nullptr, CAN_TASK_PERIOD_MS, JOB_PRIORITY_HIGH);
+    immobilizer.schedule(&canJobs);
+    uiJobs.addJob("ui", uiJob, nullptr, UI_TASK_PERIOD_MS, JOB_PRIORITY_HIGH);
+    uiManager.schedule(&uiJobs);
+    #if DEBUG_SERIAL
+    uiJobs.addJob("stats", statsJob, nullptr, TASK_STATS_INTERVAL_MS, JOB_PRIORITY_LOW);
+    #endif
+    taskManager.addTask("can", &canJobs, CAN_TASK_CORE, CAN_TASK_PRIORITY, CAN_TASK_STACK);
+    taskManager.addTask("ui", &uiJobs, UI_TASK_CORE, UI_TASK_PRIORITY, UI_TASK_STACK);
+    taskManager.addTask("web", webCycle, WEB_TASK_CORE,
+                        WEB_TASK_PRIORITY, WEB_TASK_STACK, WEB_TASK_PERIOD_MS);
+    webInterface.setTaskManager(&taskManager);
+    schemaSync.begin(&canManager);
+    webInterface.setSchemaSync(&schemaSync);
+    
+    #if DEBUG_SERIAL
+    canManager.printFootprint();
+    #endif
+    
     systemReady = true;
+    taskManager.begin();
     
     #if DEBUG_SERIAL
     Serial.println("System ready!");
@@ -543,62 +260,71 @@ void setup() {
     #endif
 }
 
-void loop() {
-    if (!systemReady) return;
-    
-    // Update hardware
-    Hardware::update();
-    
-    // Update input
+// ============================================
+// Task Cycles
+// ============================================
+
+// Heartbeat task (core 1, above everything else): the 0x351 current limit frame
+void heartbeatCycle() {
+    heartbeat.cycle();
+}
+
+// CAN task (core 1): drain/decode RX, flush TX, parameter polling.
+// The immobilizer's idcmax upkeep is a job of its own on the same task.
+void canJob(void* context) {
+    canManager.update();
+}
+
+// UI task (core 0): input, LVGL and the WiFi upload page. Screen refreshes
+// are UIManager's own jobs on the same task.
+void uiJob(void* context) {
     inputManager.update();
     
-    // Update immobilizer
-    immobilizer.update();
+    // Dim/off after inactivity; wakes (and resumes LVGL) on input or CAN.
+    // With the display on, the rest of the cycle runs at full clock.
+    power.update();
     
-    // Update web interface (handles HTTP requests)
-    webInterface.update();
+    // Time the input's way to the screen (ends in the LVGL flush)
+    uint32_t inputUs;
+    if (inputManager.takeInputTime(inputUs)) {
+        uiManager.markInput(inputUs);
+    }
     
     // Update WiFi if in WiFi mode
-    if (wifiMode) {
+    if (uiManager.isWiFiMode()) {
         wifiManager.update();
     }
     
-    // Update CAN and track last ID received
-    static uint32_t lastCanID = 0;
-    static bool hadConnection = false;
-    canManager.update();
-    
-    // Check if CAN connection status changed and update UI with last CAN ID
-    bool nowConnected = canManager.isConnected();
-    if (nowConnected != hadConnection || nowConnected) {
-        // For debugging: assume we're getting SOME CAN traffic
-        // We'll update with a placeholder - real implementation would track in CAN manager
-        if (nowConnected) {
-            // Just show that we're connected - actual CAN ID tracking needs more work
-            // For now, this will at least show connection status
-        }
-        hadConnection = nowConnected;
-    }
-    
-    // Request parameters periodically
-    if (millis() - lastParamRequestTime > PARAM_UPDATE_INTERVAL_MS) {
-        lastParamRequestTime = millis();
-        
-        // Request next parameter
-        CANParameter* param = canManager.getParameterByIndex(currentParamIndex);
-        if (param && param->dirty) {
-            canManager.requestParameter(param->id);
-            #if DEBUG_CAN
-            Serial.printf("Requesting param %d (%s)\n", param->id, param->name);
-            #endif
-        }
-        
-        currentParamIndex = (currentParamIndex + 1) % canManager.getParameterCount();
-    }
-    
-    // Update UI
     uiManager.update();
     
-    // Small delay to prevent watchdog
-    delay(10);
+    power.cycleDone();
+}
+
+// UI task, every TASK_STATS_INTERVAL_MS (DEBUG_SERIAL builds)
+void statsJob(void* context) {
+    taskManager.printStats();
+    canJobs.printStats();
+    uiJobs.printStats();
+    heartbeat.printStats();
+    power.printStats();
+    
+    const InputLatency& input = uiManager.getInputLatency();
+    const EncoderStats& encoder = inputManager.getEncoderStats();
+    if (input.samples > 0) {
+        Serial.printf("[INPUT] %lu detents (%lu dropped), input to screen avg %lu us, max %lu us, last %lu us\n",
+                      (unsigned long)encoder.detents, (unsigned long)encoder.dropped,
+                      (unsigned long)(input.totalUs / input.samples),
+                      (unsigned long)input.maxUs, (unsigned long)input.lastUs);
+    }
+}
+
+// Web task (core 0, below UI): HTTP requests, may block on SDO transfers
+void webCycle() {
+    webInterface.update();
+    schemaSync.update();
+}
+
+void loop() {
+    // All work runs in the tasks started at the end of setup()
+    vTaskDelete(nullptr);
 }
@@ -0,0 +1,82 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// ============================================
+// Host stand-ins for the native test env
+// ============================================
+//
+// Just enough of the Arduino core for the modules under test to compile and
+// run on the build machine. Time is real (steady clock) unless a test
+// simulates it (native_clock.h), Serial output is dropped - Unity reports
+// the results.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "native_clock.h"
+
+#define HEX 16
+#define DEC 10
+#define IRAM_ATTR
+
+inline uint32_t millis() {
+    return (uint32_t)(nativeTimeUs() / 1000);
+}
+
+inline uint32_t micros() {
+    return (uint32_t)nativeTimeUs();
+}
+
+inline void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+class HardwareSerial {
+public:
+    template <typename T>
+    size_t print(const T&, int = DEC) { return 0; }
+    template <typename T>
+    size_t println(const T&, int = DEC) { return 0; }
+    size_t println() { return 0; }
+    size_t printf(const char*, ...) { return 0; }
+};
+
+// Just what the modules under test build paths and messages with
+class String {
+public:
+    String(const char* text = "") : text(text) {}
+    String operator+(const char* more) const { return String((text + more).c_str()); }
+    String operator+(const String& more) const { return String((text + more.text).c_str()); }
+    const char* c_str() const { return text.c_str(); }
+    size_t length() const { return text.size(); }
+    bool operator==(const char* other) const { return text == other; }
+
+private:
+    std::string text;
+};
+
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 0; }
+};
+
+inline EspClass& nativeEsp() {
+    static EspClass esp;
+    return esp;
+}
+#define ESP nativeEsp()
+
+inline HardwareSerial& nativeSerial() {
+    static HardwareSerial serial;
+    return serial;
+}
+#define Serial nativeSerial()
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,90 @@
+#ifndef NATIVE_FS_H
+#define NATIVE_FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Files live in memory for the life of the test binary; a suite resets the
+// filesystem with SPIFFS.format().
+namespace fs {
+
+typedef std::shared_ptr<std::vector<uint8_t> > FileData;
+
+class File {
+public:
+    File() : pos(0), writable(false) {}
+    File(FileData data, bool writable) : data(data), pos(0), writable(writable) {}
+
+    operator bool() const { return data != nullptr; }
+    size_t size() const { return data ? data->size() : 0; }
+    int available() const { return data ? (int)(data->size() - pos) : 0; }
+    bool seek(uint32_t to) {
+        if (!data || to > data->size()) return false;
+        pos = to;
+        return true;
+    }
+    size_t read(uint8_t* buf, size_t len) {
+        if (!data) return 0;
+        size_t n = data->size() - pos < len ? data->size() - pos : len;
+        memcpy(buf, data->data() + pos, n);
+        pos += n;
+        return n;
+    }
+    size_t write(const uint8_t* buf, size_t len) {
+        if (!data || !writable) return 0;
+        data->insert(data->end(), buf, buf + len);
+        return len;
+    }
+    void close() { data.reset(); }
+
+private:
+    FileData data;
+    size_t pos;
+    bool writable;
+};
+
+class FS {
+public:
+    FS() : writeOpens(0) {}
+
+    bool begin(bool formatOnFail = false) { return true; }
+    bool format() {
+        files.clear();
+        return true;
+    }
+    bool exists(const char* path) { return files.count(path) > 0; }
+    File open(const char* path, const char* mode = "r") {
+        if (mode[0] == 'w') {
+            writeOpens++;
+            files[path] = FileData(new std::vector<uint8_t>());
+            return File(files[path], true);
+        }
+        std::map<std::string, FileData>::iterator it = files.find(path);
+        if (it == files.end()) return File();
+        return File(it->second, mode[0] == 'a');
+    }
+    bool remove(const char* path) { return files.erase(path) > 0; }
+    bool rename(const char* from, const char* to) {
+        std::map<std::string, FileData>::iterator it = files.find(from);
+        if (it == files.end()) return false;
+        files[to] = it->second;
+        files.erase(it);
+        return true;
+    }
+
+    // Files opened for writing so far (flash wear in a test)
+    uint32_t writeCount() const { return writeOpens; }
+
+private:
+    std::map<std::string, FileData> files;
+    uint32_t writeOpens;
+};
+
+}
+using fs::File;
+using fs::FS;
+
+#endif // NATIVE_FS_H
@@ -0,0 +1,8 @@
+#ifndef NATIVE_M5UNIFIED_H
+#define NATIVE_M5UNIFIED_H
+
+// Included by modules under test that never touch M5 themselves; a suite
+// that needs the hardware (WS1850S, displays) provides its own seams.
+#include <Arduino.h>
+
+#endif // NATIVE_M5UNIFIED_H
@@ -0,0 +1,12 @@
+#ifndef NATIVE_SPIFFS_H
+#define NATIVE_SPIFFS_H
+
+#include "FS.h"
+
+inline fs::FS& nativeSpiffs() {
+    static fs::FS spiffs;
+    return spiffs;
+}
+#define SPIFFS nativeSpiffs()
+
+#endif // NATIVE_SPIFFS_H
@@ -0,0 +1,172 @@
+#ifndef NATIVE_DRIVER_TWAI_H
+#define NATIVE_DRIVER_TWAI_H
+
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// The driver as the application sees it: an RX queue of rx_queue_len frames
+// filled by the test through nativeTwaiDeliver() (the ISR's part), counting
+// a full queue in rx_missed_count. Transmitted frames are kept in
+// nativeTwai().sent.
+
+typedef struct {
+    union {
+        struct {
+            uint32_t extd: 1;
+            uint32_t rtr: 1;
+            uint32_t ss: 1;
+            uint32_t self: 1;
+            uint32_t dlc_non_comp: 1;
+            uint32_t reserved: 27;
+        };
+        uint32_t flags;
+    };
+    uint32_t identifier;
+    uint8_t data_length_code;
+    uint8_t data[8];
+} twai_message_t;
+
+typedef int gpio_num_t;
+
+typedef enum {
+    TWAI_MODE_NORMAL,
+    TWAI_MODE_NO_ACK,
+    TWAI_MODE_LISTEN_ONLY
+} twai_mode_t;
+
+typedef enum {
+    TWAI_STATE_STOPPED,
+    TWAI_STATE_RUNNING,
+    TWAI_STATE_BUS_OFF,
+    TWAI_STATE_RECOVERING
+} twai_state_t;
+
+typedef struct {
+    twai_mode_t mode;
+    gpio_num_t tx_io;
+    gpio_num_t rx_io;
+    uint32_t tx_queue_len;
+    uint32_t rx_queue_len;
+    int intr_flags;
+} twai_general_config_t;
+
+typedef struct {
+    uint32_t brp;
+} twai_timing_config_t;
+
+typedef struct {
+    uint32_t acceptance_code;
+    uint32_t acceptance_mask;
+    bool single_filter;
+} twai_filter_config_t;
+
+typedef struct {
+    twai_state_t state;
+    uint32_t msgs_to_tx;
+    uint32_t msgs_to_rx;
+    uint32_t tx_error_counter;
+    uint32_t rx_error_counter;
+    uint32_t tx_failed_count;
+    uint32_t rx_missed_count;
+    uint32_t rx_overrun_count;
+    uint32_t arb_lost_count;
+    uint32_t bus_error_count;
+} twai_status_info_t;
+
+#define TWAI_MSG_FLAG_NONE   0x00
+#define TWAI_MSG_FLAG_EXTD   0x01
+
+#define ESP_INTR_FLAG_LEVEL1 (1 << 1)
+#define ESP_INTR_FLAG_IRAM   (1 << 10)
+
+#define TWAI_TIMING_CONFIG_500KBITS() { 8 }
+#define TWAI_FILTER_CONFIG_ACCEPT_ALL() { 0, 0xFFFFFFFF, true }
+#define TWAI_GENERAL_CONFIG_DEFAULT(tx, rx, op_mode) { op_mode, tx, rx, 5, 5, ESP_INTR_FLAG_LEVEL1 }
+
+struct NativeTwai {
+    bool installed;
+    bool running;
+    uint32_t rxQueueLen;
+    std::deque<twai_message_t> rx;
+    std::vector<twai_message_t> sent;
+    uint32_t rxMissed;
+    uint32_t rxPeak;
+};
+
+inline NativeTwai& nativeTwai() {
+    static NativeTwai twai = { false, false, 0, std::deque<twai_message_t>(), std::vector<twai_message_t>(), 0, 0 };
+    return twai;
+}
+
+// A frame comes off the bus; false if the RX queue had no room for it
+inline bool nativeTwaiDeliver(const twai_message_t& msg) {
+    NativeTwai& twai = nativeTwai();
+    if (!twai.running) return false;
+    if (twai.rx.size() >= twai.rxQueueLen) {
+        twai.rxMissed++;
+        return false;
+    }
+    twai.rx.push_back(msg);
+    if (twai.rx.size() > twai.rxPeak) twai.rxPeak = (uint32_t)twai.rx.size();
+    return true;
+}
+
+inline esp_err_t twai_driver_install(const twai_general_config_t* g, const twai_timing_config_t* t,
+                                     const twai_filter_config_t* f) {
+    NativeTwai& twai = nativeTwai();
+    if (twai.installed) return ESP_ERR_INVALID_STATE;
+    twai.installed = true;
+    twai.running = false;
+    twai.rxQueueLen = g->rx_queue_len;
+    twai.rx.clear();
+    twai.sent.clear();
+    twai.rxMissed = 0;
+    twai.rxPeak = 0;
+    return ESP_OK;
+}
+
+inline esp_err_t twai_driver_uninstall() {
+    NativeTwai& twai = nativeTwai();
+    if (!twai.installed) return ESP_ERR_INVALID_STATE;
+    twai.installed = false;
+    twai.running = false;
+    return ESP_OK;
+}
+
+inline esp_err_t twai_start() {
+    NativeTwai& twai = nativeTwai();
+    if (!twai.installed || twai.running) return ESP_ERR_INVALID_STATE;
+    twai.running = true;
+    return ESP_OK;
+}
+
+inline esp_err_t twai_receive(twai_message_t* msg, TickType_t wait) {
+    NativeTwai& twai = nativeTwai();
+    if (twai.rx.empty()) return ESP_ERR_TIMEOUT;
+    *msg = twai.rx.front();
+    twai.rx.pop_front();
+    return ESP_OK;
+}
+
+inline esp_err_t twai_transmit(const twai_message_t* msg, TickType_t wait) {
+    NativeTwai& twai = nativeTwai();
+    if (!twai.running) return ESP_ERR_INVALID_STATE;
+    twai.sent.push_back(*msg);
+    return ESP_OK;
+}
+
+inline esp_err_t twai_get_status_info(twai_status_info_t* status) {
+    NativeTwai& twai = nativeTwai();
+    if (!twai.installed) return ESP_ERR_INVALID_STATE;
+    memset(status, 0, sizeof(*status));
+    status->state = twai.running ? TWAI_STATE_RUNNING : TWAI_STATE_STOPPED;
+    status->msgs_to_rx = (uint32_t)twai.rx.size();
+    status->rx_missed_count = twai.rxMissed;
+    return ESP_OK;
+}
+
+#endif // NATIVE_DRIVER_TWAI_H
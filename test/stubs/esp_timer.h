@@ -0,0 +1,95 @@
+#ifndef NATIVE_ESP_TIMER_H
+#define NATIVE_ESP_TIMER_H
+
+#include <stdint.h>
+#include <vector>
+#include "esp_err.h"
+#include "native_clock.h"
+
+// Nothing dispatches timers on its own: a test finds them in nativeTimers()
+// and calls nativeFireTimer() when it decides the esp_timer task runs.
+
+typedef void (*esp_timer_cb_t)(void* arg);
+
+typedef enum {
+    ESP_TIMER_TASK
+} esp_timer_dispatch_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    const char* name;
+    bool active;
+    int64_t dueUs;
+    uint64_t periodUs;          // 0 = one-shot
+};
+typedef esp_timer* esp_timer_handle_t;
+
+inline std::vector<esp_timer*>& nativeTimers() {
+    static std::vector<esp_timer*> timers;
+    return timers;
+}
+
+inline int64_t esp_timer_get_time() {
+    return nativeTimeUs();
+}
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+    esp_timer* timer = new esp_timer;
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    timer->name = args->name;
+    timer->active = false;
+    timer->dueUs = 0;
+    timer->periodUs = 0;
+    nativeTimers().push_back(timer);
+    *out = timer;
+    return ESP_OK;
+}
+
+// Like ESP-IDF: starting a running timer or stopping a stopped one fails
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+    if (timer->active) return ESP_ERR_INVALID_STATE;
+    timer->active = true;
+    timer->dueUs = esp_timer_get_time() + (int64_t)timeoutUs;
+    timer->periodUs = 0;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+    if (timer->active) return ESP_ERR_INVALID_STATE;
+    timer->active = true;
+    timer->dueUs = esp_timer_get_time() + (int64_t)periodUs;
+    timer->periodUs = periodUs;
+    return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (!timer->active) return ESP_ERR_INVALID_STATE;
+    timer->active = false;
+    return ESP_OK;
+}
+
+inline bool esp_timer_is_active(esp_timer_handle_t timer) {
+    return timer->active;
+}
+
+// Run a due timer's callback as the esp_timer task would
+inline void nativeFireTimer(esp_timer* timer) {
+    if (timer->periodUs > 0) {
+        timer->dueUs += (int64_t)timer->periodUs;
+    } else {
+        timer->active = false;
+    }
+    timer->callback(timer->arg);
+}
+
+#endif // NATIVE_ESP_TIMER_H
@@ -0,0 +1,25 @@
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+#include <stdint.h>
+#include <mutex>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms) / portTICK_PERIOD_MS)
+
+// Critical sections are a plain mutex between host threads
+typedef std::mutex portMUX_TYPE;
+#define portMUX_INITIALIZE(mux)     ((void)(mux))
+#define portENTER_CRITICAL(mux)     ((mux)->lock())
+#define portEXIT_CRITICAL(mux)      ((mux)->unlock())
+#define portENTER_CRITICAL_ISR(mux) ((mux)->lock())
+#define portEXIT_CRITICAL_ISR(mux)  ((mux)->unlock())
+
+#endif // NATIVE_FREERTOS_H
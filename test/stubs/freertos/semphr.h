@@ -0,0 +1,49 @@
+#ifndef NATIVE_FREERTOS_SEMPHR_H
+#define NATIVE_FREERTOS_SEMPHR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "FreeRTOS.h"
+
+// Counting semaphore on a condition variable. Binary semaphores and mutexes
+// are the count 0/1 cases (no priority inheritance - nothing here needs it).
+struct QueueDefinition {
+    std::mutex lock;
+    std::condition_variable changed;
+    UBaseType_t count;
+    UBaseType_t max;
+};
+typedef QueueDefinition* SemaphoreHandle_t;
+
+inline SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) {
+    SemaphoreHandle_t sem = new QueueDefinition;
+    sem->count = initial;
+    sem->max = max;
+    return sem;
+}
+inline SemaphoreHandle_t xSemaphoreCreateBinary() { return xSemaphoreCreateCounting(1, 0); }
+inline SemaphoreHandle_t xSemaphoreCreateMutex() { return xSemaphoreCreateCounting(1, 1); }
+inline void vSemaphoreDelete(SemaphoreHandle_t sem) { delete sem; }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait) {
+    std::unique_lock<std::mutex> guard(sem->lock);
+    if (wait == portMAX_DELAY) {
+        sem->changed.wait(guard, [sem] { return sem->count > 0; });
+    } else if (!sem->changed.wait_for(guard, std::chrono::milliseconds(wait * portTICK_PERIOD_MS),
+                                      [sem] { return sem->count > 0; })) {
+        return pdFALSE;
+    }
+    sem->count--;
+    return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    std::lock_guard<std::mutex> guard(sem->lock);
+    if (sem->count >= sem->max) return pdFALSE;
+    sem->count++;
+    sem->changed.notify_one();
+    return pdTRUE;
+}
+
+#endif // NATIVE_FREERTOS_SEMPHR_H
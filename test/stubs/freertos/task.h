@@ -0,0 +1,17 @@
+#ifndef NATIVE_FREERTOS_TASK_H
+#define NATIVE_FREERTOS_TASK_H
+
+#include <chrono>
+#include <thread>
+#include "FreeRTOS.h"
+#include "../native_clock.h"
+
+inline void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+inline TickType_t xTaskGetTickCount() {
+    return (TickType_t)(nativeTimeUs() / 1000 / portTICK_PERIOD_MS);
+}
+
+#endif // NATIVE_FREERTOS_TASK_H
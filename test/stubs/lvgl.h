@@ -0,0 +1,21 @@
+#ifndef NATIVE_LVGL_H
+#define NATIVE_LVGL_H
+
+#include <stdint.h>
+
+// Labels only: a label remembers its text and counts how often it was set
+typedef struct _lv_obj_t {
+    const char* text;
+    uint32_t textSets;
+} lv_obj_t;
+
+inline char* lv_label_get_text(const lv_obj_t* label) {
+    return (char*)label->text;
+}
+
+inline void lv_label_set_text_static(lv_obj_t* label, const char* text) {
+    label->text = text;
+    label->textSets++;
+}
+
+#endif // NATIVE_LVGL_H
@@ -0,0 +1,25 @@
+#ifndef NATIVE_CLOCK_H
+#define NATIVE_CLOCK_H
+
+#include <stdint.h>
+#include <chrono>
+
+// Time for millis() and esp_timer_get_time(): the steady clock since the
+// first call, unless a simulation has taken over with nativeSetTimeUs().
+inline int64_t& nativeSimTimeUs() {
+    static int64_t simUs = -1;
+    return simUs;
+}
+
+inline void nativeSetTimeUs(int64_t us) {
+    nativeSimTimeUs() = us;
+}
+
+inline int64_t nativeTimeUs() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (nativeSimTimeUs() >= 0) return nativeSimTimeUs();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+#endif // NATIVE_CLOCK_H
@@ -0,0 +1,217 @@
+// CAN receive path at full bus load, in simulated time: back-to-back frames
+// at 500 kbit/s go into the TWAI driver queue (the ISR's part) while the CAN
+// task calls CANDataManager::update() every CAN_TASK_PERIOD_MS. Every frame
+// must reach the application exactly once and in order, and when the task
+// is held off longer than the driver queue covers, the loss must show up in
+// CANStats rather than go unnoticed.
+
+#include <unity.h>
+#include <stdio.h>
+#include "CANData.h"
+#include "../../src/CANData.cpp"
+#include "../../src/SDOManager.cpp"
+#include "../../src/PollScheduler.cpp"
+#include "../../src/ParamJsonParser.cpp"
+#include "../../src/ValueCodec.cpp"
+#include "../../src/ParamTable.cpp"
+
+// Shortest 8-byte standard frame (111 bits with EOF) plus 3 bits of
+// interframe space, so the highest frame rate the bus can carry
+#define FRAME_BITS      114
+#define BUS_BITRATE     500000
+#define FRAME_US        ((int64_t)FRAME_BITS * 1000000 / BUS_BITRATE)
+#define TASK_US         ((int64_t)CAN_TASK_PERIOD_MS * 1000)
+
+// How long the CAN task may be held off before the driver queue overflows
+#define HEADROOM_US     ((int64_t)CAN_DRIVER_RX_QUEUE_LEN * FRAME_US)
+
+static CANDataManager* can = nullptr;
+static uint32_t sentCount = 0;
+static uint32_t receivedCount = 0;
+static uint32_t outOfOrder = 0;
+static uint32_t nextExpected = 0;
+
+// The replayed traffic: a SimpBMS cell sweep (24 frames, 0x460-0x477)
+// followed by the inverter TPDOs and ZombieVerter broadcasts, repeated.
+static uint32_t traceId(uint32_t seq) {
+    static const uint32_t broadcasts[] = { 0x183, 0x283, 0x383, 0x483, 0x521, 0x522, 0x523, 0x524 };
+    uint32_t pos = seq % (24 + 8);
+    return pos < 24 ? 0x460 + pos : broadcasts[pos - 24];
+}
+
+static void onFrame(const CANMessage& msg) {
+    uint32_t seq = (uint32_t)msg.data[4] | ((uint32_t)msg.data[5] << 8) |
+                   ((uint32_t)msg.data[6] << 16) | ((uint32_t)msg.data[7] << 24);
+    if (seq != nextExpected || msg.id != traceId(seq)) {
+        outOfOrder++;
+    }
+    nextExpected = seq + 1;
+    receivedCount++;
+}
+
+// Full load for durationUs. The CAN task runs every TASK_US, except that it
+// is held off for stallUs once, stallAtUs into the run (loop() busy, flash
+// write); frames keep arriving meanwhile.
+static void replay(int64_t durationUs, int64_t stallAtUs, int64_t stallUs) {
+    int64_t start = nativeTimeUs();
+    int64_t nextFrame = start;
+    int64_t nextTask = start + TASK_US / 2;
+    bool stalled = false;
+
+    while (nextFrame < start + durationUs || nextTask < start + durationUs) {
+        if (nextFrame <= nextTask) {
+            nativeSetTimeUs(nextFrame);
+            twai_message_t msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.identifier = traceId(sentCount);
+            msg.data_length_code = 8;
+            msg.data[4] = (uint8_t)sentCount;
+            msg.data[5] = (uint8_t)(sentCount >> 8);
+            msg.data[6] = (uint8_t)(sentCount >> 16);
+            msg.data[7] = (uint8_t)(sentCount >> 24);
+            nativeTwaiDeliver(msg);
+            // Sequence numbers count bus frames, delivered or not
+            sentCount++;
+            nextFrame += FRAME_US;
+        } else {
+            nativeSetTimeUs(nextTask);
+            if (!stalled && stallUs > 0 && nextTask >= start + stallAtUs) {
+                stalled = true;
+                nextTask += stallUs;
+                continue;
+            }
+            can->update();
+            nextTask += TASK_US;
+        }
+    }
+    // Let the task catch up with what is still queued
+    can->update();
+}
+
+void setUp() {
+    nativeSetTimeUs(1000000);
+    twai_driver_uninstall();
+    sentCount = receivedCount = outOfOrder = nextExpected = 0;
+    can = new CANDataManager();
+    TEST_ASSERT_TRUE(can->init());
+    can->setOnMessageReceived(onFrame);
+}
+
+void tearDown() {
+    delete can;
+    can = nullptr;
+}
+
+void test_full_load_loses_nothing() {
+    replay(2000000, 0, 0);
+    const CANStats& stats = can->getStats();
+
+    TEST_ASSERT_GREATER_THAN_UINT32(8000, sentCount);
+    TEST_ASSERT_EQUAL_UINT32(sentCount, receivedCount);
+    TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+    TEST_ASSERT_EQUAL_UINT32(sentCount, stats.rxFrames);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.driverRxMissed);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.driverRxOverrun);
+    // One task period of frames, nowhere near the queue length
+    TEST_ASSERT_TRUE(stats.driverRxPeak <= TASK_US / FRAME_US + 1);
+}
+
+// A burst deeper than rxQueue but within the driver queue: update() has to
+// keep draining after the ring fills instead of dropping the rest
+void test_burst_deeper_than_ring() {
+    int64_t stallUs = HEADROOM_US - TASK_US - 2 * FRAME_US;
+    replay(500000, 100000, stallUs);
+    const CANStats& stats = can->getStats();
+
+    TEST_ASSERT_TRUE(stats.rxBurstMax > RX_QUEUE_SIZE);
+    TEST_ASSERT_TRUE(stats.driverRxPeak < CAN_DRIVER_RX_QUEUE_LEN);
+    TEST_ASSERT_EQUAL_UINT32(sentCount, receivedCount);
+    TEST_ASSERT_EQUAL_UINT32(0, outOfOrder);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.driverRxMissed);
+}
+
+// Held off past the headroom: frames are lost, and the counters say how many
+void test_overflow_is_counted() {
+    replay(500000, 100000, HEADROOM_US + 10 * FRAME_US);
+    const CANStats& stats = can->getStats();
+
+    TEST_ASSERT_EQUAL_UINT32(CAN_DRIVER_RX_QUEUE_LEN, stats.driverRxPeak);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats.driverRxMissed);
+    TEST_ASSERT_EQUAL_UINT32(sentCount - receivedCount, stats.driverRxMissed);
+    TEST_ASSERT_EQUAL_UINT32(receivedCount, stats.rxFrames);
+    // The gap shows up as one jump in sequence, nothing reordered after it
+    TEST_ASSERT_EQUAL_UINT32(1, outOfOrder);
+}
+
+// An SDO read reply for `id` from the inverter, through the driver
+static void replySDO(uint8_t id, int32_t value) {
+    twai_message_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.identifier = 0x580 + CAN_NODE_ID;
+    msg.data_length_code = 8;
+    msg.data[0] = 0x43;
+    msg.data[1] = 0x00;
+    msg.data[2] = 0x21;
+    msg.data[3] = id;
+    msg.data[4] = (uint8_t)value;
+    msg.data[5] = (uint8_t)(value >> 8);
+    msg.data[6] = (uint8_t)(value >> 16);
+    msg.data[7] = (uint8_t)(value >> 24);
+    nativeTwaiDeliver(msg);
+}
+
+// SDO replies are decoded by the parameter's encoding: x32 unless the
+// built-in table has that very parameter as raw
+void test_sdo_replies_decoded() {
+    TEST_ASSERT_TRUE(can->loadParametersFromJSON(
+        "{\"power\":{\"i\":2},\"tmpm\":{\"i\":5},\"BMS_Mode\":{\"i\":6}}"));
+    replySDO(2, -12 * 32 - 16);     // -12.5 kW
+    replySDO(5, 45 * 32);           // 45 degC, not the table's "chargemodes"
+    replySDO(6, 11);                // TeslaM3, sent as is
+    can->update();
+
+    int32_t value = 0;
+    TEST_ASSERT_TRUE(can->getValue(2, value));
+    TEST_ASSERT_EQUAL_INT32(-125, value);
+    TEST_ASSERT_TRUE(can->getValue(5, value));
+    TEST_ASSERT_EQUAL_INT32(45, value);
+    TEST_ASSERT_TRUE(can->getValue(6, value));
+    TEST_ASSERT_EQUAL_INT32(11, value);
+}
+
+// A params.json that repeats an id loads with the first entry, and the
+// cache written from it is taken on the next boot instead of being rebuilt
+void test_duplicate_ids_cached_once() {
+    static const char json[] =
+        "{\"udc\":{\"i\":3,\"unit\":\"V\"},\"idc\":{\"i\":4,\"unit\":\"A\"},"
+        "\"udc2\":{\"i\":3,\"unit\":\"V\"}}";
+    SPIFFS.format();
+    File file = SPIFFS.open("/params.json", "w");
+    file.write((const uint8_t*)json, sizeof(json) - 1);
+    file.close();
+
+    TEST_ASSERT_TRUE(can->loadParametersCached("/params.json", "/params.bin"));
+    TEST_ASSERT_EQUAL_UINT16(2, can->getParameterCount());
+    TEST_ASSERT_EQUAL_STRING("udc", can->getParameter(3)->name);
+    uint32_t writes = SPIFFS.writeCount();
+
+    delete can;
+    can = new CANDataManager();
+    TEST_ASSERT_TRUE(can->loadParametersCached("/params.json", "/params.bin"));
+    TEST_ASSERT_EQUAL_UINT32(writes, SPIFFS.writeCount());
+    TEST_ASSERT_EQUAL_UINT16(2, can->getParameterCount());
+    TEST_ASSERT_EQUAL_STRING("udc", can->getParameter(3)->name);
+    TEST_ASSERT_EQUAL_STRING("A", can->getParameter(4)->unit);
+}
+
+int main(int argc, char** argv) {
+    printf("frame %lld us, task period %lld us, driver queue covers %lld us\n",
+           (long long)FRAME_US, (long long)TASK_US, (long long)HEADROOM_US);
+    UNITY_BEGIN();
+    RUN_TEST(test_full_load_loses_nothing);
+    RUN_TEST(test_burst_deeper_than_ring);
+    RUN_TEST(test_overflow_is_counted);
+    RUN_TEST(test_sdo_replies_decoded);
+    RUN_TEST(test_duplicate_ids_cached_once);
+    return UNITY_END();
+}
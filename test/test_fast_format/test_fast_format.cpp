@@ -0,0 +1,95 @@
+// TextWriter/setLabelValue against snprintf, and what replacing
+// lv_label_set_text_fmt's vsnprintf with them saves per label update.
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <chrono>
+#include "FastFormat.h"
+#include "../../src/FastFormat.cpp"
+#include "../../src/ValueCodec.cpp"
+
+#define BENCH_ITERATIONS 2000000
+
+// What lv_label_set_text_fmt does with the arguments
+static int formatVa(char* buffer, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return n;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_matches_printf() {
+    char fast[LABEL_TEXT_SIZE];
+    char ref[LABEL_TEXT_SIZE];
+    for (int32_t v = -20000; v <= 20000; v++) {
+        TextWriter(fast, sizeof(fast)).str("Current: ").fixed(v, 1).str("A");
+        snprintf(ref, sizeof(ref), "Current: %s%d.%dA", v < 0 ? "-" : "", abs(v / 10), abs(v % 10));
+        TEST_ASSERT_EQUAL_STRING(ref, fast);
+
+        TextWriter(fast, sizeof(fast)).num(v).str(" rpm");
+        snprintf(ref, sizeof(ref), "%d rpm", (int)v);
+        TEST_ASSERT_EQUAL_STRING(ref, fast);
+    }
+}
+
+static void test_truncates_and_terminates() {
+    char buffer[8];
+    TextWriter writer(buffer, sizeof(buffer));
+    writer.str("Voltage ").fixed(-12345, 2).str("V");
+    TEST_ASSERT_EQUAL_STRING("Voltage", buffer);
+    TEST_ASSERT_EQUAL_UINT32(7, writer.length());
+
+    TextWriter(buffer, sizeof(buffer)).str("x").fixed(INT32_MIN, 0);
+    TEST_ASSERT_EQUAL_INT(7, (int)strlen(buffer));
+}
+
+static void test_unchanged_text_skips_label() {
+    lv_obj_t label = { "", 0 };
+    LabelText text;
+    text.text[0] = '\0';
+
+    TEST_ASSERT_TRUE(setLabelValue(&label, text, "SOC: ", 875, 1, "%"));
+    TEST_ASSERT_EQUAL_STRING("SOC: 87.5%", label.text);
+    TEST_ASSERT_FALSE(setLabelValue(&label, text, "SOC: ", 875, 1, "%"));
+    TEST_ASSERT_TRUE(setLabelValue(&label, text, "SOC: ", 876, 1, "%"));
+    TEST_ASSERT_EQUAL_UINT32(2, label.textSets);
+    TEST_ASSERT_TRUE(label.text == text.text);
+}
+
+// The numbers behind the switch: "Current: -12.3A" both ways
+static void test_faster_than_vsnprintf() {
+    char buffer[LABEL_TEXT_SIZE];
+    volatile uint32_t sink = 0;
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        TextWriter(buffer, sizeof(buffer)).str("Current: ").fixed(i % 20001 - 10000, 1).str("A");
+        sink += buffer[10];
+    }
+    std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        int v = i % 20001 - 10000;
+        formatVa(buffer, sizeof(buffer), "Current: %s%d.%dA", v < 0 ? "-" : "", abs(v / 10), abs(v % 10));
+        sink += buffer[10];
+    }
+    std::chrono::steady_clock::time_point t2 = std::chrono::steady_clock::now();
+
+    double fastNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / BENCH_ITERATIONS;
+    double printfNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / BENCH_ITERATIONS;
+    printf("TextWriter %.1f ns, vsnprintf %.1f ns per label\n", fastNs, printfNs);
+    TEST_ASSERT_TRUE(fastNs < printfNs);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_printf);
+    RUN_TEST(test_truncates_and_terminates);
+    RUN_TEST(test_unchanged_text_skips_label);
+    RUN_TEST(test_faster_than_vsnprintf);
+    return UNITY_END();
+}
@@ -0,0 +1,94 @@
+// GestureRecognizer against recorded touch traces: each trace is replayed
+// sample by sample and the gestures it emits are compared with the ones
+// its "# expect:" line lists.
+
+#include <unity.h>
+#include <stdio.h>
+#include <string>
+#include "GestureRecognizer.h"
+#include "../../src/GestureRecognizer.cpp"
+#include "traces.h"
+
+static const char* findTrace(const char* name) {
+    for (size_t i = 0; i < sizeof(TRACES) / sizeof(TRACES[0]); i++) {
+        if (strcmp(TRACES[i].name, name) == 0) return TRACES[i].text;
+    }
+    return nullptr;
+}
+
+// Feed every "[TOUCH]" line, collect "name[ value]" per gesture
+static void replay(const char* name) {
+    const char* text = findTrace(name);
+    TEST_ASSERT_NOT_NULL(text);
+
+    GestureRecognizer recognizer;
+    std::string expected;
+    std::string got;
+
+    while (*text) {
+        const char* end = strchr(text, '\n');
+        std::string line(text, end ? end - text : strlen(text));
+        text = end ? end + 1 : text + line.length();
+
+        if (line.compare(0, 9, "# expect:") == 0) {
+            size_t first = line.find_first_not_of(' ', 9);
+            expected = first == std::string::npos ? "" : line.substr(first);
+            continue;
+        }
+
+        unsigned long ms;
+        unsigned count;
+        int x0, y0, x1, y1;
+        if (sscanf(line.c_str(), "[TOUCH] %lu,%u,%d,%d,%d,%d", &ms, &count, &x0, &y0, &x1, &y1) != 6) {
+            continue;
+        }
+        TouchPoint points[GESTURE_MAX_POINTS] = { { (int16_t)x0, (int16_t)y0 }, { (int16_t)x1, (int16_t)y1 } };
+        recognizer.feed((uint32_t)ms, (uint8_t)count, points);
+
+        GestureEvent event;
+        while (recognizer.poll(event)) {
+            if (!got.empty()) got += ",";
+            got += GestureRecognizer::getName(event.type);
+            if (event.type == GESTURE_ROTATE || event.type == GESTURE_PINCH) {
+                char value[8];
+                snprintf(value, sizeof(value), " %+d", event.value);
+                got += value;
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.c_str(), got.c_str(), name);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_tap() { replay("tap"); }
+static void test_long_press() { replay("long_press"); }
+static void test_swipe_left() { replay("swipe_left"); }
+static void test_swipe_up() { replay("swipe_up"); }
+static void test_slow_drag_is_no_swipe() { replay("slow_drag"); }
+static void test_ring_cw_90() { replay("ring_cw_90"); }
+static void test_ring_ccw_180() { replay("ring_ccw_180"); }
+static void test_ring_short_is_silent() { replay("ring_short"); }
+static void test_pinch_in() { replay("pinch_in"); }
+static void test_pinch_out() { replay("pinch_out"); }
+static void test_two_finger_tap() { replay("two_finger_tap"); }
+static void test_second_finger_cancels_swipe() { replay("second_finger_mid_swipe"); }
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tap);
+    RUN_TEST(test_long_press);
+    RUN_TEST(test_swipe_left);
+    RUN_TEST(test_swipe_up);
+    RUN_TEST(test_slow_drag_is_no_swipe);
+    RUN_TEST(test_ring_cw_90);
+    RUN_TEST(test_ring_ccw_180);
+    RUN_TEST(test_ring_short_is_silent);
+    RUN_TEST(test_pinch_in);
+    RUN_TEST(test_pinch_out);
+    RUN_TEST(test_two_finger_tap);
+    RUN_TEST(test_second_finger_cancels_swipe);
+    return UNITY_END();
+}
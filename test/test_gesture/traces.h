@@ -0,0 +1,339 @@
+#ifndef GESTURE_TRACES_H
+#define GESTURE_TRACES_H
+
+// Touch traces in the DEBUG_TOUCH log format ("[TOUCH] ms,n,x0,y0,x1,y1",
+// one line per UI cycle). "# expect:" lists the gestures the trace must
+// produce, in order; rotate and pinch carry their value.
+
+struct GestureTrace {
+    const char* name;
+    const char* text;
+};
+
+static const GestureTrace TRACES[] = {
+    { "long_press", R"(# expect: long press
+[TOUCH] 1000,1,110,130,0,0
+[TOUCH] 1015,1,110,131,0,0
+[TOUCH] 1030,1,110,132,0,0
+[TOUCH] 1045,1,110,130,0,0
+[TOUCH] 1060,1,110,131,0,0
+[TOUCH] 1075,1,110,132,0,0
+[TOUCH] 1090,1,110,130,0,0
+[TOUCH] 1105,1,110,131,0,0
+[TOUCH] 1120,1,110,132,0,0
+[TOUCH] 1135,1,110,130,0,0
+[TOUCH] 1150,1,110,131,0,0
+[TOUCH] 1165,1,110,132,0,0
+[TOUCH] 1180,1,110,130,0,0
+[TOUCH] 1195,1,110,131,0,0
+[TOUCH] 1210,1,110,132,0,0
+[TOUCH] 1225,1,110,130,0,0
+[TOUCH] 1240,1,110,131,0,0
+[TOUCH] 1255,1,110,132,0,0
+[TOUCH] 1270,1,110,130,0,0
+[TOUCH] 1285,1,110,131,0,0
+[TOUCH] 1300,1,110,132,0,0
+[TOUCH] 1315,1,110,130,0,0
+[TOUCH] 1330,1,110,131,0,0
+[TOUCH] 1345,1,110,132,0,0
+[TOUCH] 1360,1,110,130,0,0
+[TOUCH] 1375,1,110,131,0,0
+[TOUCH] 1390,1,110,132,0,0
+[TOUCH] 1405,1,110,130,0,0
+[TOUCH] 1420,1,110,131,0,0
+[TOUCH] 1435,1,110,132,0,0
+[TOUCH] 1450,1,110,130,0,0
+[TOUCH] 1465,1,110,131,0,0
+[TOUCH] 1480,1,110,132,0,0
+[TOUCH] 1495,1,110,130,0,0
+[TOUCH] 1510,1,110,131,0,0
+[TOUCH] 1525,1,110,132,0,0
+[TOUCH] 1540,1,110,130,0,0
+[TOUCH] 1555,1,110,131,0,0
+[TOUCH] 1570,1,110,132,0,0
+[TOUCH] 1585,1,110,130,0,0
+[TOUCH] 1600,1,110,131,0,0
+[TOUCH] 1615,1,110,132,0,0
+[TOUCH] 1630,1,110,130,0,0
+[TOUCH] 1645,1,110,131,0,0
+[TOUCH] 1660,1,110,132,0,0
+[TOUCH] 1675,1,110,130,0,0
+[TOUCH] 1690,1,110,131,0,0
+[TOUCH] 1705,1,110,132,0,0
+[TOUCH] 1720,1,110,130,0,0
+[TOUCH] 1735,1,110,131,0,0
+[TOUCH] 1750,1,110,132,0,0
+[TOUCH] 1765,1,110,130,0,0
+[TOUCH] 1780,1,110,131,0,0
+[TOUCH] 1795,1,110,132,0,0
+[TOUCH] 1810,1,110,130,0,0
+[TOUCH] 1825,1,110,131,0,0
+[TOUCH] 1840,1,110,132,0,0
+[TOUCH] 1855,1,110,130,0,0
+[TOUCH] 1870,1,110,131,0,0
+[TOUCH] 1885,1,110,132,0,0
+[TOUCH] 1900,1,110,130,0,0
+[TOUCH] 1915,1,110,131,0,0
+[TOUCH] 1930,1,110,132,0,0
+[TOUCH] 1945,1,110,130,0,0
+[TOUCH] 1960,1,110,131,0,0
+[TOUCH] 1975,1,110,132,0,0
+[TOUCH] 1990,1,110,130,0,0
+[TOUCH] 2005,1,110,131,0,0
+[TOUCH] 2020,1,110,132,0,0
+[TOUCH] 2035,1,110,130,0,0
+[TOUCH] 2050,0,0,0,0,0
+)" },
+    { "pinch_in", R"(# expect: pinch -25,pinch -25
+[TOUCH] 1000,2,60,120,180,120
+[TOUCH] 1015,2,63,120,177,120
+[TOUCH] 1030,2,66,120,174,120
+[TOUCH] 1045,2,69,120,171,120
+[TOUCH] 1060,2,72,120,168,120
+[TOUCH] 1075,2,75,120,165,120
+[TOUCH] 1090,2,78,120,162,120
+[TOUCH] 1105,2,81,120,159,120
+[TOUCH] 1120,2,84,120,156,120
+[TOUCH] 1135,2,87,120,153,120
+[TOUCH] 1150,2,90,120,150,120
+[TOUCH] 1165,2,93,120,147,120
+[TOUCH] 1180,2,96,120,144,120
+[TOUCH] 1195,2,99,120,141,120
+[TOUCH] 1210,0,0,0,0,0
+)" },
+    { "pinch_out", R"(# expect: pinch +30,pinch +30,pinch +30,pinch +30,pinch +30,pinch +30
+[TOUCH] 1000,1,100,120,0,0
+[TOUCH] 1015,2,100,120,140,120
+[TOUCH] 1030,2,97,120,143,120
+[TOUCH] 1045,2,94,120,146,120
+[TOUCH] 1060,2,91,120,149,120
+[TOUCH] 1075,2,88,120,152,120
+[TOUCH] 1090,2,85,120,155,120
+[TOUCH] 1105,2,82,120,158,120
+[TOUCH] 1120,2,79,120,161,120
+[TOUCH] 1135,2,76,120,164,120
+[TOUCH] 1150,2,73,120,167,120
+[TOUCH] 1165,2,70,120,170,120
+[TOUCH] 1180,2,67,120,173,120
+[TOUCH] 1195,2,64,120,176,120
+[TOUCH] 1210,0,0,0,0,0
+)" },
+    { "ring_ccw_180", R"(# expect: rotate -1,rotate -1,rotate -1,rotate -1,rotate -1,rotate -1
+[TOUCH] 1000,1,120,220,0,0
+[TOUCH] 1015,1,126,220,0,0
+[TOUCH] 1030,1,133,219,0,0
+[TOUCH] 1045,1,139,218,0,0
+[TOUCH] 1060,1,145,217,0,0
+[TOUCH] 1075,1,152,215,0,0
+[TOUCH] 1090,1,158,213,0,0
+[TOUCH] 1105,1,163,210,0,0
+[TOUCH] 1120,1,169,207,0,0
+[TOUCH] 1135,1,175,204,0,0
+[TOUCH] 1150,1,180,200,0,0
+[TOUCH] 1165,1,185,196,0,0
+[TOUCH] 1180,1,190,192,0,0
+[TOUCH] 1195,1,194,187,0,0
+[TOUCH] 1210,1,198,182,0,0
+[TOUCH] 1225,1,202,177,0,0
+[TOUCH] 1240,1,206,172,0,0
+[TOUCH] 1255,1,209,166,0,0
+[TOUCH] 1270,1,211,160,0,0
+[TOUCH] 1285,1,214,155,0,0
+[TOUCH] 1300,1,216,148,0,0
+[TOUCH] 1315,1,217,142,0,0
+[TOUCH] 1330,1,219,136,0,0
+[TOUCH] 1345,1,220,130,0,0
+[TOUCH] 1360,1,220,123,0,0
+[TOUCH] 1375,1,220,117,0,0
+[TOUCH] 1390,1,220,110,0,0
+[TOUCH] 1405,1,219,104,0,0
+[TOUCH] 1420,1,217,98,0,0
+[TOUCH] 1435,1,216,92,0,0
+[TOUCH] 1450,1,214,85,0,0
+[TOUCH] 1465,1,211,80,0,0
+[TOUCH] 1480,1,209,74,0,0
+[TOUCH] 1495,1,206,68,0,0
+[TOUCH] 1510,1,202,63,0,0
+[TOUCH] 1525,1,198,58,0,0
+[TOUCH] 1540,1,194,53,0,0
+[TOUCH] 1555,1,190,48,0,0
+[TOUCH] 1570,1,185,44,0,0
+[TOUCH] 1585,1,180,40,0,0
+[TOUCH] 1600,1,175,36,0,0
+[TOUCH] 1615,1,169,33,0,0
+[TOUCH] 1630,1,163,30,0,0
+[TOUCH] 1645,1,158,27,0,0
+[TOUCH] 1660,1,152,25,0,0
+[TOUCH] 1675,1,145,23,0,0
+[TOUCH] 1690,1,139,22,0,0
+[TOUCH] 1705,1,133,21,0,0
+[TOUCH] 1720,1,126,20,0,0
+[TOUCH] 1735,1,120,20,0,0
+[TOUCH] 1750,0,0,0,0,0
+)" },
+    { "ring_cw_90", R"(# expect: rotate +1,rotate +1,rotate +1
+[TOUCH] 1000,1,120,20,0,0
+[TOUCH] 1015,1,125,20,0,0
+[TOUCH] 1030,1,131,21,0,0
+[TOUCH] 1045,1,136,21,0,0
+[TOUCH] 1060,1,141,22,0,0
+[TOUCH] 1075,1,147,24,0,0
+[TOUCH] 1090,1,152,25,0,0
+[TOUCH] 1105,1,157,27,0,0
+[TOUCH] 1120,1,162,29,0,0
+[TOUCH] 1135,1,167,32,0,0
+[TOUCH] 1150,1,172,34,0,0
+[TOUCH] 1165,1,176,37,0,0
+[TOUCH] 1180,1,181,40,0,0
+[TOUCH] 1195,1,185,44,0,0
+[TOUCH] 1210,1,189,47,0,0
+[TOUCH] 1225,1,193,51,0,0
+[TOUCH] 1240,1,196,55,0,0
+[TOUCH] 1255,1,200,59,0,0
+[TOUCH] 1270,1,203,64,0,0
+[TOUCH] 1285,1,206,68,0,0
+[TOUCH] 1300,1,208,73,0,0
+[TOUCH] 1315,1,211,78,0,0
+[TOUCH] 1330,1,213,83,0,0
+[TOUCH] 1345,1,215,88,0,0
+[TOUCH] 1360,1,216,93,0,0
+[TOUCH] 1375,1,218,99,0,0
+[TOUCH] 1390,1,219,104,0,0
+[TOUCH] 1405,1,219,109,0,0
+[TOUCH] 1420,1,220,115,0,0
+[TOUCH] 1435,1,220,120,0,0
+[TOUCH] 1450,0,0,0,0,0
+)" },
+    { "ring_short", R"(# expect: 
+[TOUCH] 1000,1,120,20,0,0
+[TOUCH] 1015,1,124,20,0,0
+[TOUCH] 1030,1,128,20,0,0
+[TOUCH] 1045,1,132,21,0,0
+[TOUCH] 1060,1,135,21,0,0
+[TOUCH] 1075,1,139,22,0,0
+[TOUCH] 1090,1,143,23,0,0
+[TOUCH] 1105,1,147,24,0,0
+[TOUCH] 1120,1,151,25,0,0
+[TOUCH] 1135,1,154,26,0,0
+[TOUCH] 1150,0,0,0,0,0
+)" },
+    { "second_finger_mid_swipe", R"(# expect: 
+[TOUCH] 1000,1,170,120,0,0
+[TOUCH] 1015,1,162,120,0,0
+[TOUCH] 1030,1,154,120,0,0
+[TOUCH] 1045,1,146,120,0,0
+[TOUCH] 1060,1,138,120,0,0
+[TOUCH] 1075,1,130,120,0,0
+[TOUCH] 1090,2,122,120,120,60
+[TOUCH] 1105,2,114,120,120,60
+[TOUCH] 1120,2,106,120,120,60
+[TOUCH] 1135,2,98,120,120,60
+[TOUCH] 1150,2,90,120,120,60
+[TOUCH] 1165,2,82,120,120,60
+[TOUCH] 1180,0,0,0,0,0
+)" },
+    { "slow_drag", R"(# expect: 
+[TOUCH] 1000,1,150,120,0,0
+[TOUCH] 1020,1,148,120,0,0
+[TOUCH] 1040,1,146,120,0,0
+[TOUCH] 1060,1,144,120,0,0
+[TOUCH] 1080,1,142,120,0,0
+[TOUCH] 1100,1,140,120,0,0
+[TOUCH] 1120,1,138,120,0,0
+[TOUCH] 1140,1,136,120,0,0
+[TOUCH] 1160,1,134,120,0,0
+[TOUCH] 1180,1,132,120,0,0
+[TOUCH] 1200,1,130,120,0,0
+[TOUCH] 1220,1,128,120,0,0
+[TOUCH] 1240,1,126,120,0,0
+[TOUCH] 1260,1,124,120,0,0
+[TOUCH] 1280,1,122,120,0,0
+[TOUCH] 1300,1,120,120,0,0
+[TOUCH] 1320,1,118,120,0,0
+[TOUCH] 1340,1,116,120,0,0
+[TOUCH] 1360,1,114,120,0,0
+[TOUCH] 1380,1,112,120,0,0
+[TOUCH] 1400,1,110,120,0,0
+[TOUCH] 1420,1,108,120,0,0
+[TOUCH] 1440,1,106,120,0,0
+[TOUCH] 1460,1,104,120,0,0
+[TOUCH] 1480,1,102,120,0,0
+[TOUCH] 1500,1,100,120,0,0
+[TOUCH] 1520,1,98,120,0,0
+[TOUCH] 1540,1,96,120,0,0
+[TOUCH] 1560,1,94,120,0,0
+[TOUCH] 1580,1,92,120,0,0
+[TOUCH] 1600,1,90,120,0,0
+[TOUCH] 1620,1,88,120,0,0
+[TOUCH] 1640,1,86,120,0,0
+[TOUCH] 1660,1,84,120,0,0
+[TOUCH] 1680,1,82,120,0,0
+[TOUCH] 1700,1,80,120,0,0
+[TOUCH] 1720,1,78,120,0,0
+[TOUCH] 1740,1,76,120,0,0
+[TOUCH] 1760,1,74,120,0,0
+[TOUCH] 1780,1,72,120,0,0
+[TOUCH] 1800,1,70,120,0,0
+[TOUCH] 1820,1,68,120,0,0
+[TOUCH] 1840,1,66,120,0,0
+[TOUCH] 1860,1,64,120,0,0
+[TOUCH] 1880,1,62,120,0,0
+[TOUCH] 1900,1,60,120,0,0
+[TOUCH] 1920,1,58,120,0,0
+[TOUCH] 1940,1,56,120,0,0
+[TOUCH] 1960,1,54,120,0,0
+[TOUCH] 1980,1,52,120,0,0
+[TOUCH] 2000,0,0,0,0,0
+)" },
+    { "swipe_left", R"(# expect: swipe left
+[TOUCH] 1000,1,170,120,0,0
+[TOUCH] 1015,1,162,120,0,0
+[TOUCH] 1030,1,154,120,0,0
+[TOUCH] 1045,1,146,121,0,0
+[TOUCH] 1060,1,138,121,0,0
+[TOUCH] 1075,1,130,121,0,0
+[TOUCH] 1090,1,122,122,0,0
+[TOUCH] 1105,1,114,122,0,0
+[TOUCH] 1120,1,106,122,0,0
+[TOUCH] 1135,1,98,123,0,0
+[TOUCH] 1150,1,90,123,0,0
+[TOUCH] 1165,1,82,123,0,0
+[TOUCH] 1180,1,74,124,0,0
+[TOUCH] 1195,1,66,124,0,0
+[TOUCH] 1210,0,0,0,0,0
+)" },
+    { "swipe_up", R"(# expect: swipe up
+[TOUCH] 1000,1,120,160,0,0
+[TOUCH] 1015,1,120,153,0,0
+[TOUCH] 1030,1,120,146,0,0
+[TOUCH] 1045,1,120,139,0,0
+[TOUCH] 1060,1,120,132,0,0
+[TOUCH] 1075,1,120,125,0,0
+[TOUCH] 1090,1,120,118,0,0
+[TOUCH] 1105,1,120,111,0,0
+[TOUCH] 1120,1,120,104,0,0
+[TOUCH] 1135,1,120,97,0,0
+[TOUCH] 1150,1,120,90,0,0
+[TOUCH] 1165,1,120,83,0,0
+[TOUCH] 1180,0,0,0,0,0
+)" },
+    { "tap", R"(# expect: tap
+[TOUCH] 1000,1,120,120,0,0
+[TOUCH] 1015,1,121,120,0,0
+[TOUCH] 1030,1,120,120,0,0
+[TOUCH] 1045,1,121,120,0,0
+[TOUCH] 1060,1,120,120,0,0
+[TOUCH] 1075,1,121,120,0,0
+[TOUCH] 1090,0,0,0,0,0
+)" },
+    { "two_finger_tap", R"(# expect: two-finger tap
+[TOUCH] 1000,1,100,120,0,0
+[TOUCH] 1015,2,100,120,150,120
+[TOUCH] 1030,2,100,121,150,120
+[TOUCH] 1045,2,100,121,150,120
+[TOUCH] 1060,1,100,121,0,0
+[TOUCH] 1075,0,0,0,0,0
+)" },
+};
+
+#endif // GESTURE_TRACES_H
@@ -0,0 +1,153 @@
+// PollScheduler in simulated time: 200 parameters, next() called every CAN
+// task cycle, each read answered 5 ms later. Checks the bus budget, the age
+// of the FAST values and that broadcast and NEVER values are left alone.
+
+#include <unity.h>
+#include <stdio.h>
+#include "PollScheduler.h"
+#include "../../src/PollScheduler.cpp"
+
+#define PARAMS          200
+#define FAST_COUNT      6       // 0..5
+#define SLOW_END        150     // 6..149 SLOW
+#define NEVER_END       170     // 150..169 NEVER, 170..199 NORMAL
+#define BROADCAST_FIRST 180     // 180..189 kept fresh by broadcast frames
+#define BROADCAST_END   190
+#define BROADCAST_MS    100
+#define REPLY_MS        5
+#define WARMUP_MS       10000   // First read of the whole table, dirty values first
+#define RUN_MS          120000
+
+static PollScheduler* poller = nullptr;
+static uint32_t updated[PARAMS];
+static uint8_t flags[PARAMS];
+static uint32_t reads[PARAMS];
+static uint32_t now;
+
+// Runs the CAN task loop until `until`; broadcasts stop at broadcastUntil.
+// Returns the worst age any FAST value reached.
+static uint32_t run(uint32_t until, uint32_t broadcastUntil) {
+    uint32_t worstFast = 0;
+    for (; now < until; now += CAN_TASK_PERIOD_MS) {
+        nativeSetTimeUs((int64_t)now * 1000);
+        if (now < broadcastUntil && now % BROADCAST_MS == 0) {
+            for (int i = BROADCAST_FIRST; i < BROADCAST_END; i++) {
+                updated[i] = now;
+                flags[i] = PARAM_FLAG_BROADCAST;
+            }
+        }
+        for (int i = 0; i < FAST_COUNT; i++) {
+            // A reply lands REPLY_MS after the read, so skip reads in flight
+            if (!(flags[i] & PARAM_FLAG_DIRTY) && (int32_t)(now - updated[i]) > (int32_t)worstFast) {
+                worstFast = now - updated[i];
+            }
+        }
+        int16_t index = poller->next(now, updated, flags, PARAMS);
+        if (index >= 0) {
+            reads[index]++;
+            updated[index] = now + REPLY_MS;
+            flags[index] &= ~PARAM_FLAG_DIRTY;
+        }
+    }
+    return worstFast;
+}
+
+void setUp() {
+    now = BROADCAST_MS;     // Broadcasts are on the bus from the start
+    nativeSetTimeUs((int64_t)now * 1000);
+    poller = new PollScheduler();
+    poller->reset(PARAMS);
+    for (int i = 0; i < PARAMS; i++) {
+        updated[i] = 0;
+        flags[i] = PARAM_FLAG_DIRTY;
+        reads[i] = 0;
+        if (i < FAST_COUNT) poller->setRate(i, POLL_FAST);
+        else if (i < SLOW_END) poller->setRate(i, POLL_SLOW);
+        else if (i < NEVER_END) poller->setRate(i, POLL_NEVER);
+    }
+}
+
+void tearDown() {
+    delete poller;
+    poller = nullptr;
+}
+
+void test_mixed_table() {
+    run(WARMUP_MS, RUN_MS);
+    for (int i = 0; i < PARAMS; i++) {
+        if (i < SLOW_END || i >= NEVER_END) {
+            TEST_ASSERT_FALSE_MESSAGE(flags[i] & PARAM_FLAG_DIRTY, "not read during warm-up");
+        }
+    }
+
+    uint32_t warmupReads = 0;
+    for (int i = 0; i < PARAMS; i++) warmupReads += reads[i];
+    uint32_t worstFast = run(RUN_MS, RUN_MS);
+    const PollStats& stats = poller->getStats();
+
+    uint32_t total = 0;
+    for (int i = 0; i < PARAMS; i++) total += reads[i];
+    uint32_t steadyMs = RUN_MS - WARMUP_MS - BROADCAST_MS;
+    printf("%.1f reads/s, worst FAST age %u ms, %u deferred, %u stale\n",
+           (total - warmupReads) * 1000.0 / steadyMs, worstFast, stats.budgetDeferred, stats.stale);
+
+    TEST_ASSERT_TRUE((total - warmupReads) * 1000 / steadyMs <= POLL_BUDGET_PER_SEC);
+    TEST_ASSERT_TRUE(stats.requestsPerSec <= POLL_BUDGET_PER_SEC);
+    // Due after POLL_FAST_MS, then possibly queued behind the other FAST
+    // values for bus tokens, then the reply
+    uint32_t fastBound = POLL_FAST_MS + FAST_COUNT * 1000 / POLL_BUDGET_PER_SEC + REPLY_MS;
+    TEST_ASSERT_TRUE(worstFast <= fastBound);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.stale);
+    TEST_ASSERT_EQUAL_UINT16(BROADCAST_END - BROADCAST_FIRST, stats.broadcast);
+
+    for (int i = 0; i < PARAMS; i++) {
+        if (i >= SLOW_END && i < NEVER_END) {
+            TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, reads[i], "NEVER parameter polled");
+        } else if (i >= BROADCAST_FIRST && i < BROADCAST_END) {
+            TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, reads[i], "broadcast parameter polled");
+        } else {
+            TEST_ASSERT_TRUE_MESSAGE(reads[i] > 0, "parameter never polled");
+        }
+    }
+    for (int i = 0; i < FAST_COUNT; i++) {
+        TEST_ASSERT_TRUE(reads[i] >= steadyMs / fastBound);
+    }
+}
+
+// Broadcast frames stop: the values go back to being polled after
+// POLL_BROADCAST_STALE_MS
+void test_broadcast_silence_resumes_polling() {
+    // Last broadcast at 4900 ms
+    run(4900 + POLL_BROADCAST_STALE_MS, 5000);
+    for (int i = BROADCAST_FIRST; i < BROADCAST_END; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, reads[i]);
+    }
+    run(15000, 5000);
+    for (int i = BROADCAST_FIRST; i < BROADCAST_END; i++) {
+        TEST_ASSERT_TRUE(reads[i] > 0);
+    }
+}
+
+// Everything on screen at once: the token bucket holds the line
+void test_budget_caps_reads() {
+    for (int i = 0; i < PARAMS; i++) {
+        poller->setRate(i, POLL_FAST);
+    }
+    run(10002, 0);
+    const PollStats& stats = poller->getStats();
+
+    uint32_t total = 0;
+    for (int i = 0; i < PARAMS; i++) total += reads[i];
+    TEST_ASSERT_TRUE(total <= POLL_BUDGET_BURST + 10 * POLL_BUDGET_PER_SEC);
+    TEST_ASSERT_TRUE(total >= 10 * POLL_BUDGET_PER_SEC - POLL_BUDGET_PER_SEC / 10);
+    TEST_ASSERT_TRUE(stats.budgetDeferred > 0);
+    TEST_ASSERT_TRUE(stats.requestsPerSec <= POLL_BUDGET_PER_SEC);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mixed_table);
+    RUN_TEST(test_broadcast_silence_resumes_polling);
+    RUN_TEST(test_budget_caps_reads);
+    return UNITY_END();
+}
@@ -0,0 +1,197 @@
+// Ring buffer stress: producers and consumer on real threads, every item
+// must arrive exactly once, in order per producer and untorn.
+
+#include <unity.h>
+#include <thread>
+#include "RingBuffer.h"
+
+#define STRESS_ITEMS   2000000
+#define MPSC_PRODUCERS 4
+
+// Big enough that a torn copy shows up as a bad check word
+struct Item {
+    uint32_t producer;
+    uint32_t seq;
+    uint32_t check;
+};
+
+static Item makeItem(uint32_t producer, uint32_t seq) {
+    Item item = { producer, seq, ~(producer * 0x9E3779B9u ^ seq) };
+    return item;
+}
+
+static bool intact(const Item& item) {
+    return item.check == ~(item.producer * 0x9E3779B9u ^ item.seq);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_spsc_boundaries() {
+    static RingBuffer<uint32_t, 8> ring;
+    uint32_t value;
+
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_FALSE(ring.pop(value));
+    for (uint32_t i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    TEST_ASSERT_TRUE(ring.full());
+    TEST_ASSERT_FALSE(ring.push(99));
+
+    uint32_t more[4] = { 8, 9, 10, 11 };
+    TEST_ASSERT_EQUAL_UINT32(0, ring.pushBulk(more, 4));
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_UINT32(0, value);
+    TEST_ASSERT_EQUAL_UINT32(1, ring.pushBulk(more, 4));
+
+    uint32_t out[16];
+    TEST_ASSERT_EQUAL_UINT32(8, ring.popBulk(out, 16));
+    for (uint32_t i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i + 1, out[i]);
+    }
+    TEST_ASSERT_NULL(ring.front());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.size());
+}
+
+static void test_spsc_stress() {
+    static RingBuffer<Item, 64> ring;
+
+    std::thread producer([] {
+        uint32_t seq = 0;
+        while (seq < STRESS_ITEMS) {
+            if (ring.push(makeItem(0, seq))) {
+                seq++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t bad = 0;
+    Item item;
+    while (expected < STRESS_ITEMS) {
+        if (!ring.pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item.seq != expected || !intact(item)) bad++;
+        expected++;
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, bad);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+// Odd chunk sizes so bulk copies keep straddling the wrap point
+static void test_spsc_bulk_stress() {
+    static RingBuffer<Item, 32> ring;
+
+    std::thread producer([] {
+        Item chunk[7];
+        uint32_t seq = 0;
+        uint32_t size = 1;
+        while (seq < STRESS_ITEMS) {
+            uint32_t want = size;
+            if (want > STRESS_ITEMS - seq) want = STRESS_ITEMS - seq;
+            for (uint32_t i = 0; i < want; i++) {
+                chunk[i] = makeItem(0, seq + i);
+            }
+            size_t pushed = ring.pushBulk(chunk, want);
+            if (pushed == 0) std::this_thread::yield();
+            seq += pushed;
+            size = size % 7 + 1;
+        }
+    });
+
+    Item chunk[5];
+    uint32_t expected = 0;
+    uint32_t bad = 0;
+    while (expected < STRESS_ITEMS) {
+        // Alternate bulk pops and in-place reads
+        if (expected & 1) {
+            Item* item = ring.front();
+            if (!item) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (item->seq != expected || !intact(*item)) bad++;
+            ring.popFront();
+            expected++;
+            continue;
+        }
+        size_t popped = ring.popBulk(chunk, 5);
+        if (popped == 0) std::this_thread::yield();
+        for (size_t i = 0; i < popped; i++) {
+            if (chunk[i].seq != expected || !intact(chunk[i])) bad++;
+            expected++;
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(0, bad);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+static void test_mpsc_stress() {
+    static MpscRingBuffer<Item, 64> ring;
+    const uint32_t perProducer = STRESS_ITEMS / MPSC_PRODUCERS;
+
+    std::thread producers[MPSC_PRODUCERS];
+    for (uint32_t p = 0; p < MPSC_PRODUCERS; p++) {
+        producers[p] = std::thread([p, perProducer] {
+            uint32_t seq = 0;
+            while (seq < perProducer) {
+                // Half the producers go through pushBulk
+                if (p & 1) {
+                    Item pair[2] = { makeItem(p, seq), makeItem(p, seq + 1) };
+                    size_t pushed = ring.pushBulk(pair, seq + 1 < perProducer ? 2 : 1);
+                    if (pushed == 0) std::this_thread::yield();
+                    seq += pushed;
+                } else if (ring.push(makeItem(p, seq))) {
+                    seq++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    uint32_t next[MPSC_PRODUCERS] = { 0 };
+    uint32_t received = 0;
+    uint32_t bad = 0;
+    Item chunk[8];
+    while (received < perProducer * MPSC_PRODUCERS) {
+        size_t popped = ring.popBulk(chunk, 8);
+        if (popped == 0) std::this_thread::yield();
+        for (size_t i = 0; i < popped; i++) {
+            const Item& item = chunk[i];
+            if (item.producer >= MPSC_PRODUCERS || !intact(item) || item.seq != next[item.producer]) {
+                bad++;
+            } else {
+                next[item.producer]++;
+            }
+            received++;
+        }
+    }
+    for (uint32_t p = 0; p < MPSC_PRODUCERS; p++) {
+        producers[p].join();
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, bad);
+    for (uint32_t p = 0; p < MPSC_PRODUCERS; p++) {
+        TEST_ASSERT_EQUAL_UINT32(perProducer, next[p]);
+    }
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_spsc_boundaries);
+    RUN_TEST(test_spsc_stress);
+    RUN_TEST(test_spsc_bulk_stress);
+    RUN_TEST(test_mpsc_stress);
+    return UNITY_END();
+}
@@ -0,0 +1,659 @@
+// SDO segmented and block upload and batch writes against a simulated
+// CANopen server. The client is the real SDOManager; CANDataManager::
+// transmit() is replaced by the node, whose thread plays the CAN task and
+// hands every reply to processResponse() just as the firmware does.
+
+#include <unity.h>
+#include <stdio.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CANData.h"
+#include "../../src/SDOManager.cpp"
+
+#define OBJECT_INDEX 0x5001
+#define OBJECT_SUB   0x02
+
+struct Frame {
+    uint8_t data[8];
+    std::chrono::steady_clock::time_point due;    // Delayed replies only
+};
+
+// Server for one object plus the 0x2100 parameters. Faults are injected
+// through the public flags.
+class SimulatedNode {
+public:
+    std::vector<uint8_t> object;
+    std::map<uint8_t, int32_t> params;
+    uint8_t readSize;           // Bytes indicated in parameter read replies
+    bool blockSupported;
+    uint8_t dropSegment;        // Block segment lost once (0 = none)
+    bool wrongToggle;           // Send the first segment with the toggle bit set
+    bool corruptCrc;
+    uint32_t abortCode;         // Abort any initiate with this code (0 = none)
+    uint32_t replyDelayMs;      // Parameter replies leave this long after the request
+    std::map<uint8_t, int32_t> maxValue;    // Writes above this are aborted
+    std::map<uint8_t, int32_t> clampTo;     // Writes above this store it instead
+    int dropParamOnce;          // First request for this parameter is lost (-1 = none)
+
+    // What the client did
+    uint32_t blockInitiates;
+    uint32_t segmentedInitiates;
+    uint32_t segmentRequests;
+    std::vector<uint8_t> acks;  // ackseq of every block ack
+    bool endConfirmed;
+    uint32_t clientAbort;
+    uint32_t paramRequests;
+    uint32_t saves;
+    uint32_t maxInFlight;       // Most parameter requests waiting for a reply
+
+    SimulatedNode(SDOManager* sdo) : sdo(sdo), stopping(false), busy(false) {
+        readSize = 4;
+        blockSupported = true;
+        dropSegment = 0;
+        wrongToggle = false;
+        corruptCrc = false;
+        abortCode = 0;
+        replyDelayMs = 0;
+        dropParamOnce = -1;
+        blockInitiates = 0;
+        segmentedInitiates = 0;
+        segmentRequests = 0;
+        endConfirmed = false;
+        clientAbort = 0;
+        paramRequests = 0;
+        saves = 0;
+        maxInFlight = 0;
+        inFlight = 0;
+        offset = 0;
+        blockStart = 0;
+        blockSize = SDO_BLOCK_SIZE;
+        worker = std::thread([this] { run(); });
+    }
+
+    ~SimulatedNode() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    // Client -> bus
+    bool receive(const twai_message_t& msg) {
+        if (msg.identifier != SDO_TX_ID || msg.data_length_code != 8) return false;
+        Frame frame;
+        memcpy(frame.data, msg.data, 8);
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queue.push_back(frame);
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    // Wait until every frame sent so far has been handled
+    void drain() {
+        std::unique_lock<std::mutex> guard(lock);
+        idle.wait(guard, [this] { return queue.empty() && delayed.empty() && !busy; });
+    }
+
+private:
+    SDOManager* sdo;
+    std::thread worker;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<Frame> queue;
+    std::deque<Frame> delayed;  // Replies in due order (one fixed delay)
+    uint32_t inFlight;
+    bool stopping;
+    bool busy;
+
+    size_t offset;
+    size_t blockStart;
+    uint8_t blockSize;
+
+    void run() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            if (delayed.empty()) {
+                wake.wait(guard, [this] { return stopping || !queue.empty(); });
+            } else {
+                wake.wait_until(guard, delayed.front().due, [this] { return stopping || !queue.empty(); });
+            }
+            while (!delayed.empty() && delayed.front().due <= std::chrono::steady_clock::now()) {
+                Frame reply = delayed.front();
+                delayed.pop_front();
+                inFlight--;
+                busy = true;
+                guard.unlock();
+                send(reply.data);
+                guard.lock();
+                busy = false;
+                idle.notify_all();
+            }
+            if (queue.empty()) {
+                if (stopping) return;
+                continue;
+            }
+            Frame frame = queue.front();
+            queue.pop_front();
+            busy = true;
+            guard.unlock();
+            handle(frame.data);
+            guard.lock();
+            busy = false;
+            idle.notify_all();
+        }
+    }
+
+    void send(const uint8_t* data) {
+        sdo->processResponse(SDO_RX_ID, data, 8);
+    }
+
+    void sendAbort(uint32_t code) {
+        uint8_t frame[8] = { SDO_RESP_ABORT, (uint8_t)OBJECT_INDEX, (uint8_t)(OBJECT_INDEX >> 8), OBJECT_SUB,
+                             (uint8_t)code, (uint8_t)(code >> 8), (uint8_t)(code >> 16), (uint8_t)(code >> 24) };
+        send(frame);
+    }
+
+    void handle(const uint8_t* request) {
+        uint8_t cmd = request[0];
+
+        if (cmd == SDO_CMD_ABORT) {
+            clientAbort = readLE32(request + 4);
+            return;
+        }
+        if (request[1] == SDO_FIXED_BYTE1 && request[2] == SDO_FIXED_BYTE2) {
+            handleParam(request);
+            return;
+        }
+        if (cmd == SDO_CMD_READ) {
+            segmentedInitiates++;
+            initiateSegmented();
+            return;
+        }
+        if ((cmd & 0xE0) == SDO_CMD_UPLOAD_SEGMENT) {
+            segmentRequests++;
+            sendSegment(cmd & 0x10);
+            return;
+        }
+        if ((cmd & 0xE0) == SDO_CMD_BLOCK_UPLOAD) {
+            switch (cmd & 0x03) {
+                case SDO_BLOCK_INITIATE:
+                    blockInitiates++;
+                    blockSize = request[4];
+                    initiateBlock();
+                    break;
+                case SDO_BLOCK_START:
+                    sendBlock();
+                    break;
+                case SDO_BLOCK_ACK:
+                    acks.push_back(request[1]);
+                    blockSize = request[2];
+                    offset = blockStart + request[1] * 7;
+                    if (offset >= object.size()) {
+                        endBlock();
+                    } else {
+                        sendBlock();
+                    }
+                    break;
+                case SDO_BLOCK_END:
+                    endConfirmed = true;
+                    break;
+            }
+        }
+    }
+
+    void handleParam(const uint8_t* request) {
+        paramRequests++;
+        if (dropParamOnce == request[3]) {
+            dropParamOnce = -1;
+            return;
+        }
+        uint8_t frame[8];
+        memcpy(frame, request, 4);
+        memset(frame + 4, 0, 4);
+        int32_t value = (int32_t)readLE32(request + 4);
+        std::map<uint8_t, int32_t>::iterator param = params.find(request[3]);
+        if (request[0] == SDO_CMD_WRITE && request[3] == 0 && value == 6) {
+            saves++;
+            frame[0] = SDO_RESP_WRITE;
+        } else if (param == params.end() ||
+                   (request[0] == SDO_CMD_WRITE && maxValue.count(request[3]) && value > maxValue[request[3]])) {
+            uint32_t code = param == params.end() ? SDO_ABORT_PARAM_INVALID : SDO_ABORT_PARAM_RANGE;
+            frame[0] = SDO_RESP_ABORT;
+            memcpy(frame + 4, &code, 4);
+        } else if (request[0] == SDO_CMD_READ) {
+            frame[0] = SDO_RESP_READ | (uint8_t)((4 - readSize) << 2);
+            uint32_t current = (uint32_t)param->second;
+            for (uint8_t i = 0; i < readSize; i++) {
+                frame[4 + i] = (uint8_t)(current >> (8 * i));
+            }
+        } else if (request[0] == SDO_CMD_WRITE) {
+            bool clamp = clampTo.count(request[3]) && value > clampTo[request[3]];
+            param->second = clamp ? clampTo[request[3]] : value;
+            frame[0] = SDO_RESP_WRITE;
+        } else {
+            return;
+        }
+        if (replyDelayMs == 0) {
+            send(frame);
+            return;
+        }
+        Frame reply;
+        memcpy(reply.data, frame, 8);
+        reply.due = std::chrono::steady_clock::now() + std::chrono::milliseconds(replyDelayMs);
+        std::lock_guard<std::mutex> guard(lock);
+        delayed.push_back(reply);
+        inFlight++;
+        if (inFlight > maxInFlight) maxInFlight = inFlight;
+    }
+
+    void fillHeader(uint8_t* frame, uint8_t cmd) {
+        memset(frame, 0, 8);
+        frame[0] = cmd;
+        frame[1] = (uint8_t)OBJECT_INDEX;
+        frame[2] = (uint8_t)(OBJECT_INDEX >> 8);
+        frame[3] = OBJECT_SUB;
+    }
+
+    void initiateSegmented() {
+        if (abortCode) {
+            sendAbort(abortCode);
+            return;
+        }
+        uint8_t frame[8];
+        offset = 0;
+        if (object.size() <= 4) {
+            // Expedited, size indicated
+            fillHeader(frame, SDO_SCS_UPLOAD_INIT | ((4 - object.size()) << 2) | 0x02 | 0x01);
+            memcpy(frame + 4, object.data(), object.size());
+        } else {
+            fillHeader(frame, SDO_SCS_UPLOAD_INIT | 0x01);
+            writeSize(frame + 4);
+        }
+        send(frame);
+    }
+
+    void sendSegment(uint8_t toggle) {
+        if (wrongToggle) toggle ^= 0x10;
+        size_t chunk = object.size() - offset < 7 ? object.size() - offset : 7;
+        bool last = offset + chunk >= object.size();
+        uint8_t frame[8] = { 0 };
+        frame[0] = SDO_SCS_UPLOAD_SEGMENT | toggle | (uint8_t)((7 - chunk) << 1) | (last ? 0x01 : 0x00);
+        memcpy(frame + 1, object.data() + offset, chunk);
+        offset += chunk;
+        send(frame);
+    }
+
+    void initiateBlock() {
+        if (!blockSupported) {
+            sendAbort(SDO_ABORT_CMD_INVALID);
+            return;
+        }
+        if (abortCode) {
+            sendAbort(abortCode);
+            return;
+        }
+        uint8_t frame[8];
+        fillHeader(frame, SDO_SCS_BLOCK_UPLOAD | SDO_BLOCK_CRC | 0x02 | SDO_BLOCK_INITIATE);
+        writeSize(frame + 4);
+        offset = 0;
+        send(frame);
+    }
+
+    void sendBlock() {
+        blockStart = offset;
+        size_t position = offset;
+        for (uint8_t seq = 1; seq <= blockSize && position < object.size(); seq++) {
+            size_t chunk = object.size() - position < 7 ? object.size() - position : 7;
+            bool last = position + chunk >= object.size();
+            uint8_t frame[8] = { 0 };
+            frame[0] = seq | (last ? 0x80 : 0x00);
+            memcpy(frame + 1, object.data() + position, chunk);
+            position += chunk;
+            if (seq == dropSegment) {
+                dropSegment = 0;
+                continue;
+            }
+            send(frame);
+        }
+    }
+
+    void endBlock() {
+        size_t lastBytes = object.size() % 7 ? object.size() % 7 : 7;
+        uint16_t crc = crc16Ccitt(0, object.data(), object.size());
+        if (corruptCrc) crc ^= 0x0001;
+        uint8_t frame[8] = { 0 };
+        frame[0] = SDO_SCS_BLOCK_UPLOAD | (uint8_t)((7 - lastBytes) << 2) | SDO_BLOCK_END;
+        frame[1] = (uint8_t)crc;
+        frame[2] = (uint8_t)(crc >> 8);
+        send(frame);
+    }
+
+    void writeSize(uint8_t* out) {
+        uint32_t size = object.size();
+        out[0] = (uint8_t)size;
+        out[1] = (uint8_t)(size >> 8);
+        out[2] = (uint8_t)(size >> 16);
+        out[3] = (uint8_t)(size >> 24);
+    }
+};
+
+static SDOManager* sdo;
+static SimulatedNode* node;
+
+bool CANDataManager::transmit(const twai_message_t& msg, TickType_t wait) {
+    return node && node->receive(msg);
+}
+
+static std::vector<uint8_t> pattern(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)(i * 31 + (i >> 8) + 7);
+    }
+    return data;
+}
+
+// Upload into a buffer; true if it succeeded with exactly the node's object
+static bool uploadMatches(bool allowBlock, size_t capacity = 4096) {
+    std::vector<uint8_t> buffer(capacity);
+    size_t length = 0;
+    bool ok = sdo->upload(OBJECT_INDEX, OBJECT_SUB, buffer.data(), capacity, length, allowBlock);
+    node->drain();
+    return ok && length == node->object.size() && memcmp(buffer.data(), node->object.data(), length) == 0;
+}
+
+void setUp() {
+    sdo = new SDOManager();
+    sdo->init();
+    node = new SimulatedNode(sdo);
+}
+
+void tearDown() {
+    SimulatedNode* old = node;
+    node = nullptr;
+    delete old;
+    delete sdo;
+}
+
+static void test_crc_check_value() {
+    // CRC-16/XMODEM check value, the variant CiA 301 block transfers use
+    TEST_ASSERT_EQUAL_HEX16(0x31C3, crc16Ccitt(0, (const uint8_t*)"123456789", 9));
+}
+
+static void test_block_upload_several_blocks() {
+    node->object = pattern(2000);   // Three blocks of up to 127 segments
+
+    TEST_ASSERT_TRUE(uploadMatches(true));
+    TEST_ASSERT_EQUAL_UINT32(1, node->blockInitiates);
+    TEST_ASSERT_EQUAL_UINT32(0, node->segmentedInitiates);
+    TEST_ASSERT_EQUAL_UINT32(3, node->acks.size());
+    TEST_ASSERT_EQUAL_UINT8(SDO_BLOCK_SIZE, node->acks[0]);
+    TEST_ASSERT_TRUE(node->endConfirmed);
+    TEST_ASSERT_FALSE(sdo->isTransferActive());
+}
+
+static void test_block_upload_exact_block() {
+    node->object = pattern(SDO_BLOCK_SIZE * 7);  // Last segment is full and ends the block
+
+    TEST_ASSERT_TRUE(uploadMatches(true));
+    TEST_ASSERT_EQUAL_UINT32(1, node->acks.size());
+    TEST_ASSERT_EQUAL_UINT8(SDO_BLOCK_SIZE, node->acks[0]);
+    TEST_ASSERT_TRUE(node->endConfirmed);
+}
+
+static void test_block_upload_repeats_lost_segment() {
+    node->object = pattern(2000);
+    node->dropSegment = 5;
+
+    TEST_ASSERT_TRUE(uploadMatches(true));
+    TEST_ASSERT_EQUAL_UINT8(4, node->acks[0]);  // Confirmed up to the gap
+    TEST_ASSERT_TRUE(node->endConfirmed);
+}
+
+static void test_block_upload_bad_crc_aborts() {
+    node->object = pattern(300);
+    node->corruptCrc = true;
+
+    TEST_ASSERT_FALSE(uploadMatches(true));
+    TEST_ASSERT_EQUAL_HEX32(SDO_ABORT_CRC, sdo->getLastAbortCode());
+    TEST_ASSERT_EQUAL_HEX32(SDO_ABORT_CRC, node->clientAbort);
+}
+
+static void test_block_upload_buffer_too_small_aborts() {
+    node->object = pattern(2000);
+
+    TEST_ASSERT_FALSE(uploadMatches(true, 1000));
+    TEST_ASSERT_EQUAL_HEX32(SDO_ABORT_MEMORY, node->clientAbort);
+    TEST_ASSERT_FALSE(node->endConfirmed);
+}
+
+static void test_falls_back_to_segmented() {
+    node->object = pattern(100);
+    node->blockSupported = false;
+
+    TEST_ASSERT_TRUE(uploadMatches(true));
+    TEST_ASSERT_EQUAL_UINT32(1, node->blockInitiates);
+    TEST_ASSERT_EQUAL_UINT32(1, node->segmentedInitiates);
+    TEST_ASSERT_EQUAL_UINT32(15, node->segmentRequests);   // ceil(100 / 7)
+}
+
+static void test_segmented_upload() {
+    node->object = pattern(15);     // Two full segments and one with a byte
+
+    TEST_ASSERT_TRUE(uploadMatches(false));
+    TEST_ASSERT_EQUAL_UINT32(0, node->blockInitiates);
+    TEST_ASSERT_EQUAL_UINT32(3, node->segmentRequests);
+}
+
+static void test_segmented_upload_expedited_reply() {
+    node->object = pattern(3);
+
+    TEST_ASSERT_TRUE(uploadMatches(false));
+    TEST_ASSERT_EQUAL_UINT32(0, node->segmentRequests);
+}
+
+static void test_segmented_upload_toggle_error_aborts() {
+    node->object = pattern(50);
+    node->wrongToggle = true;
+
+    TEST_ASSERT_FALSE(uploadMatches(false));
+    TEST_ASSERT_EQUAL_HEX32(SDO_ABORT_TOGGLE, sdo->getLastAbortCode());
+    TEST_ASSERT_EQUAL_HEX32(SDO_ABORT_TOGGLE, node->clientAbort);
+}
+
+static void test_server_abort_is_reported() {
+    node->object = pattern(50);
+    node->abortCode = 0x06020000;   // Object does not exist
+
+    TEST_ASSERT_FALSE(uploadMatches(true));
+    TEST_ASSERT_EQUAL_HEX32(0x06020000, sdo->getLastAbortCode());
+    TEST_ASSERT_EQUAL_UINT32(1, node->segmentedInitiates);
+    TEST_ASSERT_EQUAL_UINT32(0, node->clientAbort);
+}
+
+static void test_read_parameter() {
+    node->params[7] = -1234;
+
+    int32_t value = 0;
+    TEST_ASSERT_TRUE(sdo->readParameter(7, value));
+    TEST_ASSERT_EQUAL_INT32(-1234, value);
+    TEST_ASSERT_FALSE(sdo->readParameter(8, value));
+    TEST_ASSERT_EQUAL_HEX32(SDO_ABORT_PARAM_INVALID, sdo->getLastAbortCode());
+}
+
+// 0x4B (two bytes indicated) completes a read like 0x43
+static void test_read_parameter_short_reply() {
+    node->params[7] = 0x1234;
+    node->readSize = 2;
+
+    int32_t value = 0;
+    TEST_ASSERT_TRUE(sdo->readParameter(7, value));
+    TEST_ASSERT_EQUAL_INT32(0x1234, value);
+    TEST_ASSERT_EQUAL_UINT32(0, sdo->getTimeoutCount());
+}
+
+// Parameters 1..count on the node at id * 10, written to 1000 + id
+static std::vector<SDOWrite> batchOf(uint8_t count) {
+    std::vector<SDOWrite> writes(count);
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t id = i + 1;
+        node->params[id] = id * 10;
+        memset(&writes[i], 0, sizeof(SDOWrite));
+        writes[i].paramId = id;
+        writes[i].status = SDO_WRITE_PENDING;
+        writes[i].value = 1000 + id;
+    }
+    return writes;
+}
+
+static bool runBatch(std::vector<SDOWrite>& writes, uint8_t options) {
+    bool ok = sdo->writeBatch(writes.data(), (uint16_t)writes.size(), options);
+    node->drain();
+    return ok;
+}
+
+// A 100-parameter restore with verify and save, against one request at a
+// time as readParameter()/writeParameter() do it. The node answers each
+// request 2 ms later, roughly one CAN task tick plus its service time.
+static void test_batch_pipelines_writes() {
+    node->replyDelayMs = 2;
+    std::vector<SDOWrite> writes = batchOf(100);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < writes.size(); i++) {
+        int32_t value;
+        TEST_ASSERT_TRUE(sdo->writeParameter(writes[i].paramId, writes[i].value));
+        TEST_ASSERT_TRUE(sdo->readParameter(writes[i].paramId, value));
+    }
+    TEST_ASSERT_TRUE(sdo->saveToFlash());
+    uint32_t oneAtATimeMs = (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+    TEST_ASSERT_EQUAL_UINT32(1, node->maxInFlight);
+
+    writes = batchOf(100);
+    TEST_ASSERT_TRUE(runBatch(writes, SDO_BATCH_VERIFY | SDO_BATCH_SAVE));
+    printf("100 parameters: one at a time %u ms, writeBatch %u ms\n", oneAtATimeMs, sdo->getLastBatchMs());
+
+    for (size_t i = 0; i < writes.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_VERIFIED, writes[i].status);
+        TEST_ASSERT_EQUAL_INT32(writes[i].value, node->params[writes[i].paramId]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, node->saves);
+    TEST_ASSERT_EQUAL_UINT32(SDO_BATCH_WINDOW, node->maxInFlight);
+    TEST_ASSERT_TRUE(sdo->getLastBatchMs() * 2 < oneAtATimeMs);
+}
+
+// Without rollback an abort costs only its own entry
+static void test_batch_abort_without_rollback() {
+    std::vector<SDOWrite> writes = batchOf(10);
+    node->maxValue[5] = 100;
+
+    TEST_ASSERT_FALSE(runBatch(writes, SDO_BATCH_VERIFY | SDO_BATCH_SAVE));
+    for (size_t i = 0; i < writes.size(); i++) {
+        if (writes[i].paramId == 5) {
+            TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_ABORTED, writes[i].status);
+            TEST_ASSERT_EQUAL_HEX32(SDO_ABORT_PARAM_RANGE, writes[i].abortCode);
+            TEST_ASSERT_EQUAL_INT32(50, node->params[5]);
+        } else {
+            TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_VERIFIED, writes[i].status);
+            TEST_ASSERT_EQUAL_INT32(writes[i].value, node->params[writes[i].paramId]);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, node->saves);
+}
+
+// With rollback an abort stops the batch and puts back what was written
+static void test_batch_abort_rolls_back() {
+    node->replyDelayMs = 2;     // Keep the window full when the abort lands
+    std::vector<SDOWrite> writes = batchOf(20);
+    node->maxValue[5] = 100;
+
+    TEST_ASSERT_FALSE(runBatch(writes, SDO_BATCH_ROLLBACK | SDO_BATCH_VERIFY | SDO_BATCH_SAVE));
+    for (size_t i = 0; i < writes.size(); i++) {
+        uint8_t id = writes[i].paramId;
+        TEST_ASSERT_EQUAL_INT32_MESSAGE(id * 10, node->params[id], "not restored");
+        TEST_ASSERT_EQUAL_INT32(id * 10, writes[i].previous);
+        if (id == 5) {
+            TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_ABORTED, writes[i].status);
+        } else if (id < 5) {
+            TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_ROLLED_BACK, writes[i].status);
+        } else {
+            // Still in the window when the abort came, or never sent
+            TEST_ASSERT_TRUE(writes[i].status == SDO_WRITE_ROLLED_BACK || writes[i].status == SDO_WRITE_SKIPPED);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_SKIPPED, writes.back().status);
+    TEST_ASSERT_EQUAL_UINT32(0, node->saves);
+}
+
+// The node accepts a value but stores another: verify catches it
+static void test_batch_mismatch_rolls_back() {
+    std::vector<SDOWrite> writes = batchOf(8);
+    node->clampTo[3] = 500;
+
+    TEST_ASSERT_FALSE(runBatch(writes, SDO_BATCH_ROLLBACK | SDO_BATCH_VERIFY));
+    TEST_ASSERT_EQUAL_INT32(500, writes[2].readBack);
+    for (size_t i = 0; i < writes.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_ROLLED_BACK, writes[i].status);
+        TEST_ASSERT_EQUAL_INT32(writes[i].paramId * 10, node->params[writes[i].paramId]);
+    }
+}
+
+// A lost request is sent again after SDO_TIMEOUT_MS
+static void test_batch_retries_lost_request() {
+    std::vector<SDOWrite> writes = batchOf(10);
+    node->dropParamOnce = 4;
+
+    TEST_ASSERT_TRUE(runBatch(writes, SDO_BATCH_VERIFY));
+    for (size_t i = 0; i < writes.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_VERIFIED, writes[i].status);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, sdo->getTimeoutCount());
+    TEST_ASSERT_EQUAL_UINT32(2 * writes.size() + 1, node->paramRequests);
+    TEST_ASSERT_TRUE(sdo->getLastBatchMs() >= SDO_TIMEOUT_MS);
+}
+
+// The same parameter twice: written in order, only the last one read back
+static void test_batch_repeated_id() {
+    std::vector<SDOWrite> writes = batchOf(3);
+    writes[2].paramId = 1;
+    writes[2].value = 7;
+
+    TEST_ASSERT_TRUE(runBatch(writes, SDO_BATCH_VERIFY));
+    TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_DONE, writes[0].status);
+    TEST_ASSERT_EQUAL_UINT8(SDO_WRITE_VERIFIED, writes[2].status);
+    TEST_ASSERT_EQUAL_INT32(7, node->params[1]);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc_check_value);
+    RUN_TEST(test_block_upload_several_blocks);
+    RUN_TEST(test_block_upload_exact_block);
+    RUN_TEST(test_block_upload_repeats_lost_segment);
+    RUN_TEST(test_block_upload_bad_crc_aborts);
+    RUN_TEST(test_block_upload_buffer_too_small_aborts);
+    RUN_TEST(test_falls_back_to_segmented);
+    RUN_TEST(test_segmented_upload);
+    RUN_TEST(test_segmented_upload_expedited_reply);
+    RUN_TEST(test_segmented_upload_toggle_error_aborts);
+    RUN_TEST(test_server_abort_is_reported);
+    RUN_TEST(test_read_parameter);
+    RUN_TEST(test_read_parameter_short_reply);
+    RUN_TEST(test_batch_pipelines_writes);
+    RUN_TEST(test_batch_abort_without_rollback);
+    RUN_TEST(test_batch_abort_rolls_back);
+    RUN_TEST(test_batch_mismatch_rolls_back);
+    RUN_TEST(test_batch_retries_lost_request);
+    RUN_TEST(test_batch_repeated_id);
+    return UNITY_END();
+}
@@ -0,0 +1,113 @@
+// Seqlock stress: one writer publishing as fast as it can, readers on other
+// threads must only ever see whole snapshots, never going backwards.
+
+#include <unity.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "Seqlock.h"
+
+#define PUBLISHES 2000000
+#define READERS   3
+#define WORDS     31
+
+// Every word is derived from seq, so a mix of two publishes is detectable
+struct Snapshot {
+    uint32_t seq;
+    uint32_t word[WORDS];
+};
+
+static void fill(Snapshot& s, uint32_t seq) {
+    s.seq = seq;
+    for (uint32_t i = 0; i < WORDS; i++) {
+        s.word[i] = seq * (i + 1) ^ 0xA5A5A5A5u;
+    }
+}
+
+static bool consistent(const Snapshot& s) {
+    for (uint32_t i = 0; i < WORDS; i++) {
+        if (s.word[i] != (s.seq * (i + 1) ^ 0xA5A5A5A5u)) return false;
+    }
+    return true;
+}
+
+static Seqlock<Snapshot> lock;
+static std::atomic<bool> writing;
+
+void setUp() {}
+void tearDown() {}
+
+static void test_published_is_last_write() {
+    Seqlock<Snapshot> local;
+    fill(local.beginWrite(), 7);
+    local.endWrite();
+    fill(local.beginWrite(), 8);
+    local.endWrite();
+
+    TEST_ASSERT_EQUAL_UINT32(8, local.published().seq);
+    Snapshot out;
+    local.copy(out);
+    TEST_ASSERT_EQUAL_UINT32(8, out.seq);
+    TEST_ASSERT_TRUE(consistent(out));
+    TEST_ASSERT_EQUAL_UINT32(8 * 3 ^ 0xA5A5A5A5u, local.read([](const Snapshot& s) { return s.word[2]; }));
+}
+
+static void test_readers_never_see_torn_snapshots() {
+    fill(lock.beginWrite(), 0);
+    lock.endWrite();
+    writing = true;
+
+    uint32_t torn[READERS] = { 0 };
+    uint32_t backwards[READERS] = { 0 };
+    uint32_t reads[READERS] = { 0 };
+    std::thread readers[READERS];
+    for (uint32_t r = 0; r < READERS; r++) {
+        readers[r] = std::thread([r, &torn, &backwards, &reads] {
+            uint32_t last = 0;
+            Snapshot s;
+            while (writing.load()) {
+                // Alternate whole copies and a lambda that yields half way,
+                // so the writer laps it even on a single core
+                if (reads[r] & 1) {
+                    lock.copy(s);
+                } else {
+                    lock.read([&s](const Snapshot& data) {
+                        s.seq = data.seq;
+                        memcpy(s.word, data.word, sizeof(s.word) / 2);
+                        std::this_thread::yield();
+                        memcpy((uint8_t*)s.word + sizeof(s.word) / 2, (const uint8_t*)data.word + sizeof(s.word) / 2,
+                               sizeof(s.word) - sizeof(s.word) / 2);
+                        return true;
+                    });
+                }
+                if (!consistent(s)) torn[r]++;
+                if (s.seq < last) backwards[r]++;
+                last = s.seq;
+                reads[r]++;
+            }
+        });
+    }
+
+    for (uint32_t seq = 1; seq <= PUBLISHES; seq++) {
+        fill(lock.beginWrite(), seq);
+        lock.endWrite();
+    }
+    writing = false;
+    for (uint32_t r = 0; r < READERS; r++) {
+        readers[r].join();
+    }
+
+    for (uint32_t r = 0; r < READERS; r++) {
+        TEST_ASSERT_EQUAL_UINT32(0, torn[r]);
+        TEST_ASSERT_EQUAL_UINT32(0, backwards[r]);
+        TEST_ASSERT_GREATER_THAN_UINT32(0, reads[r]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(PUBLISHES, lock.published().seq);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_published_is_last_write);
+    RUN_TEST(test_readers_never_see_torn_snapshots);
+    return UNITY_END();
+}
@@ -0,0 +1,209 @@
+// ValueCodec against straightforward references: every raw value in a wide
+// window around zero plus a stride through the whole int32 range.
+
+#include <unity.h>
+#include <stdio.h>
+#include "ValueCodec.h"
+#include "../../src/ValueCodec.cpp"
+
+#define WINDOW 0x100000     // Exhaustive for |raw| <= WINDOW
+#define STRIDE 65521        // Prime, so the sweep hits every residue pattern
+
+// n / d rounded half away from zero, the slow obvious way
+static int64_t refDivRound(int64_t n, int64_t d) {
+    int64_t q = n / d;
+    int64_t r = n % d;
+    if (r < 0) r = -r;
+    if (2 * r >= d) q += (n < 0) ? -1 : 1;
+    return q;
+}
+
+static int64_t refPow10(uint8_t n) {
+    int64_t p = 1;
+    while (n--) p *= 10;
+    return p;
+}
+
+// Calls fn for the exhaustive window and the int32 sweep, extremes included
+template <typename F>
+static void forRaw(F fn) {
+    for (int32_t raw = -WINDOW; raw <= WINDOW; raw++) {
+        fn(raw);
+    }
+    for (int64_t raw = INT32_MIN; raw <= INT32_MAX; raw += STRIDE) {
+        fn((int32_t)raw);
+    }
+    fn(INT32_MIN);
+    fn(INT32_MAX);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_div_round() {
+    const int64_t divisors[] = { 1, 2, 3, 10, 32, 1000, 3600 };
+    for (size_t i = 0; i < sizeof(divisors) / sizeof(divisors[0]); i++) {
+        int64_t d = divisors[i];
+        uint32_t bad = 0;
+        forRaw([d, &bad](int32_t n) {
+            if (divRound(n, d) != refDivRound(n, d)) bad++;
+        });
+        TEST_ASSERT_EQUAL_UINT32(0, bad);
+    }
+    TEST_ASSERT_EQUAL_INT32(1, divRound(1, 2));
+    TEST_ASSERT_EQUAL_INT32(-1, divRound(-1, 2));
+    TEST_ASSERT_EQUAL_INT32(0, divRound(-1, 3));
+}
+
+// decode() is the rounded exact value; encode(decode(raw)) gives raw back
+// whenever the scaled step is finer than the raw step
+template <typename Codec>
+static void checkFixedPoint(uint8_t fracBits, bool roundTrips) {
+    uint32_t badDecode = 0;
+    uint32_t badTrip = 0;
+    forRaw([&](int32_t raw) {
+        // Keep the round trip inside int32
+        if (raw > INT32_MAX / 8 || raw < INT32_MIN / 8) return;
+        int32_t scaled = Codec::decode(raw);
+        if (scaled != refDivRound((int64_t)raw * refPow10(Codec::decimals), (int64_t)1 << fracBits)) badDecode++;
+        if (roundTrips && Codec::encode(scaled) != raw) badTrip++;
+    });
+    TEST_ASSERT_EQUAL_UINT32(0, badDecode);
+    TEST_ASSERT_EQUAL_UINT32(0, badTrip);
+}
+
+static void test_open_inverter_codecs() {
+    checkFixedPoint<OpenInverterCodec>(5, true);
+    checkFixedPoint<OpenInverterRawCodec>(5, false);
+    checkFixedPoint<OpenInverterDeciCodec>(5, false);
+
+    TEST_ASSERT_EQUAL_INT32(100, OpenInverterCodec::decode(32));        // 1.00
+    TEST_ASSERT_EQUAL_INT32(-3, OpenInverterCodec::decode(-1));         // -0.03125 -> -0.03
+    TEST_ASSERT_EQUAL_INT32(32, OpenInverterRawCodec::encode(1));
+    TEST_ASSERT_EQUAL_INT32(125, OpenInverterDeciCodec::decode(400));   // 12.5 kW
+}
+
+// Coarser scaled steps: encode() then decode() gives the scaled value back
+template <typename Codec>
+static void checkDecimalScale(int64_t divisor) {
+    uint32_t badDecode = 0;
+    uint32_t badTrip = 0;
+    forRaw([&](int32_t raw) {
+        if (Codec::decode(raw) != refDivRound((int64_t)raw * refPow10(Codec::decimals), divisor)) badDecode++;
+        int32_t scaled = raw / (int32_t)divisor;
+        if (Codec::decode(Codec::encode(scaled)) != scaled) badTrip++;
+    });
+    TEST_ASSERT_EQUAL_UINT32(0, badDecode);
+    TEST_ASSERT_EQUAL_UINT32(0, badTrip);
+}
+
+static void test_decimal_scale_codecs() {
+    checkDecimalScale<MilliCodec>(1000);
+    checkDecimalScale<WattToKwCodec>(1000);
+    checkDecimalScale<DeciCodec>(10);
+    checkDecimalScale<AsToAhCodec>(3600);
+
+    TEST_ASSERT_EQUAL_INT32(18, WattToKwCodec::decode(1753));
+    TEST_ASSERT_EQUAL_INT32(-18, WattToKwCodec::decode(-1753));
+    TEST_ASSERT_EQUAL_INT32(0, WattToKwCodec::decode(49));
+}
+
+static void test_gain_offset_codec() {
+    typedef GainOffset<5, 4, -40, 1> Sensor;   // value = raw * 1.25 - 40, 0.1 resolution
+    uint32_t bad = 0;
+    for (int32_t raw = -WINDOW; raw <= WINDOW; raw++) {
+        int64_t expected = refDivRound((int64_t)raw * 5 * 10, 4) - 400;
+        if (Sensor::decode(raw) != expected) bad++;
+        if (Sensor::encode(Sensor::decode(raw)) != raw) bad++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, bad);
+}
+
+// formatScaled() against printf of the integer and fraction parts
+static void test_format_matches_printf() {
+    for (uint8_t decimals = 0; decimals <= 4; decimals++) {
+        int64_t pow = refPow10(decimals);
+        uint32_t bad = 0;
+        forRaw([&](int32_t scaled) {
+            char expected[32];
+            char actual[32];
+            int64_t magnitude = scaled < 0 ? -(int64_t)scaled : scaled;
+            if (decimals == 0) {
+                snprintf(expected, sizeof(expected), "%s%lld", scaled < 0 ? "-" : "",
+                         (long long)magnitude);
+            } else {
+                snprintf(expected, sizeof(expected), "%s%lld.%0*lld", scaled < 0 ? "-" : "",
+                         (long long)(magnitude / pow), (int)decimals, (long long)(magnitude % pow));
+            }
+            size_t length = formatScaled(actual, sizeof(actual), scaled, decimals);
+            if (strcmp(expected, actual) != 0 || length != strlen(expected)) bad++;
+        });
+        TEST_ASSERT_EQUAL_UINT32(0, bad);
+    }
+
+    char text[8];
+    TEST_ASSERT_EQUAL_UINT32(6, formatScaled(text, sizeof(text), -5, 1, "kW"));
+    TEST_ASSERT_EQUAL_STRING("-0.5kW", text);
+    TEST_ASSERT_EQUAL_UINT32(7, formatScaled(text, sizeof(text), 1234567, 2, "kW"));
+    TEST_ASSERT_EQUAL_STRING("12345.6", text);   // Truncated, still terminated
+    TEST_ASSERT_EQUAL_UINT32(0, formatScaled(text, 0, 1, 0));
+}
+
+// parseScaled() reads back everything formatScaled() writes
+static void test_parse_round_trip() {
+    for (uint8_t decimals = 0; decimals <= 4; decimals++) {
+        uint32_t bad = 0;
+        forRaw([&](int32_t scaled) {
+            if (scaled == INT32_MIN) return;    // Magnitude is limited to INT32_MAX
+            char text[32];
+            formatScaled(text, sizeof(text), scaled, decimals);
+            int32_t parsed;
+            if (!parseScaled(text, decimals, parsed) || parsed != scaled) bad++;
+        });
+        TEST_ASSERT_EQUAL_UINT32(0, bad);
+    }
+}
+
+static void test_parse_rounding_and_rejects() {
+    int32_t value;
+
+    TEST_ASSERT_TRUE(parseScaled("1.25", 1, value));
+    TEST_ASSERT_EQUAL_INT32(13, value);
+    TEST_ASSERT_TRUE(parseScaled("-1.25", 1, value));
+    TEST_ASSERT_EQUAL_INT32(-13, value);
+    TEST_ASSERT_TRUE(parseScaled("1.249999", 1, value));
+    TEST_ASSERT_EQUAL_INT32(12, value);
+    TEST_ASSERT_TRUE(parseScaled("+7", 2, value));
+    TEST_ASSERT_EQUAL_INT32(700, value);
+    TEST_ASSERT_TRUE(parseScaled(".5", 1, value));
+    TEST_ASSERT_EQUAL_INT32(5, value);
+    TEST_ASSERT_TRUE(parseScaled("3.", 0, value));
+    TEST_ASSERT_EQUAL_INT32(3, value);
+
+    // Range is checked after rounding, not just before
+    TEST_ASSERT_TRUE(parseScaled("2147483647.4", 0, value));
+    TEST_ASSERT_EQUAL_INT32(INT32_MAX, value);
+    TEST_ASSERT_FALSE(parseScaled("2147483647.5", 0, value));
+    TEST_ASSERT_FALSE(parseScaled("-2147483647.5", 0, value));
+    TEST_ASSERT_FALSE(parseScaled("214748364.75", 1, value));
+    TEST_ASSERT_FALSE(parseScaled("2147483648", 0, value));
+    TEST_ASSERT_FALSE(parseScaled("21474836.48", 2, value));
+
+    const char* rejects[] = { "", "-", "+", ".", "1.2.3", "abc", "1e3", " 1", "1 ", "--1", "0x10" };
+    for (size_t i = 0; i < sizeof(rejects) / sizeof(rejects[0]); i++) {
+        TEST_ASSERT_FALSE_MESSAGE(parseScaled(rejects[i], 2, value), rejects[i]);
+    }
+    TEST_ASSERT_FALSE(parseScaled(nullptr, 2, value));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_div_round);
+    RUN_TEST(test_open_inverter_codecs);
+    RUN_TEST(test_decimal_scale_codecs);
+    RUN_TEST(test_gain_offset_codec);
+    RUN_TEST(test_format_matches_printf);
+    RUN_TEST(test_parse_round_trip);
+    RUN_TEST(test_parse_rounding_and_rejects);
+    return UNITY_END();
+}
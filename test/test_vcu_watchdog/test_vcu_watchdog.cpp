@@ -0,0 +1,154 @@
+// VCU heartbeat watchdog in simulated time: 0x500 every 100 ms, the CAN task
+// every 2 ms at a random phase, esp_timer callbacks dispatched 20-120 us
+// after they fall due. Measures how late the one-shot timer detects a
+// dropout next to what a 2 ms polled millis() check would have seen, and
+// checks the arm/re-arm hysteresis.
+
+#include <unity.h>
+#include <stdio.h>
+#include "Immobilizer.h"
+#include "../../src/Immobilizer.cpp"
+
+#define STEP_US         50
+#define FRAME_US        100000
+#define CAN_TASK_US     2000
+#define TRIALS          50
+
+// Link seams: no bus, no RFID reader, no scheduler in this suite
+bool CANDataManager::addFrameListener(uint32_t id, uint32_t mask, FrameHandler handler, void* context) { return false; }
+bool CANDataManager::sendMessage(uint32_t id, uint8_t* data, uint8_t length) { return false; }
+int8_t Scheduler::addJob(const char* name, JobFn fn, void* context, uint32_t periodMs, uint8_t priority, int32_t firstMs) { return -1; }
+WS1850S::WS1850S() : address(0), irqPin(-1), version(0), irqSemaphore(nullptr), irqUs(0) {}
+
+static uint32_t rng = 1;
+static uint32_t nextRandom() {
+    rng = rng * 1103515245u + 12345u;
+    return (rng >> 16) & 0x7FFF;
+}
+
+// One Immobilizer on the simulated bus. Frames are sent while sending() says
+// so; the caller decides when the rider unlocks.
+struct Sim {
+    Immobilizer immo;
+    esp_timer* timer;
+    int64_t now;
+    int64_t start;
+    uint32_t phase;
+    int64_t fireAt;
+    int64_t lastFrame;
+    int64_t pollDetect;
+
+    Sim() : timer(nullptr), now(0), start(0), phase(0), fireAt(0), lastFrame(0), pollDetect(0) {
+        now = nativeTimeUs() < 0 ? 0 : nativeTimeUs();
+        nativeSetTimeUs(now);
+        immo.init(nullptr);
+        timer = nativeTimers().back();
+    }
+
+    // Runs until now + durationUs; frames go out while now < framesUntil
+    void run(int64_t durationUs, int64_t framesUntil) {
+        start = now;
+        int64_t end = now + durationUs;
+        for (; now < end; now += STEP_US) {
+            nativeSetTimeUs(now);
+            if (now < framesUntil && (now - start) % FRAME_US == 0) {
+                immo.processCANMessage(VCU_HEARTBEAT_ID, nullptr, 8);
+                lastFrame = now;
+            }
+            if ((now + phase) % CAN_TASK_US == 0) {
+                immo.update();
+                // What a polled millis() check in update() would have seen
+                if (!pollDetect && now >= framesUntil && now - lastFrame >= (int64_t)VCU_TIMEOUT_MS * 1000) {
+                    pollDetect = now;
+                }
+            }
+            if (timer->active && !fireAt && now >= timer->dueUs) {
+                fireAt = now + 20 + (nextRandom() % 3) * 50;
+            }
+            if (fireAt && now >= fireAt) {
+                fireAt = 0;
+                if (timer->active) nativeFireTimer(timer);
+            }
+        }
+    }
+
+    VcuWatchdogStatus status() {
+        VcuWatchdogStatus out;
+        immo.getVcuStatus(out);
+        return out;
+    }
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_dropout_latency() {
+    uint64_t sumTimer = 0, maxTimer = 0, sumPoll = 0, maxPoll = 0;
+    for (int trial = 0; trial < TRIALS; trial++) {
+        Sim sim;
+        sim.phase = (nextRandom() % 40) * STEP_US;
+        int64_t base = sim.now;
+        sim.run(1500000, base + 2000000);
+        sim.immo.unlock();
+        sim.run(7500000, base + 2000000 + (nextRandom() % 100) * 1000);
+
+        VcuWatchdogStatus v = sim.status();
+        TEST_ASSERT_FALSE_MESSAGE(sim.immo.isUnlocked(), "dropout did not lock");
+        TEST_ASSERT_EQUAL_UINT32(1, v.autoLocks);
+        TEST_ASSERT_TRUE(sim.pollDetect > 0);
+
+        uint64_t pollLatency = sim.pollDetect - (sim.lastFrame + (int64_t)VCU_TIMEOUT_MS * 1000);
+        sumTimer += v.lastLatencyUs;
+        sumPoll += pollLatency;
+        if (v.lastLatencyUs > maxTimer) maxTimer = v.lastLatencyUs;
+        if (pollLatency > maxPoll) maxPoll = pollLatency;
+    }
+    printf("watchdog latency avg %llu us max %llu us | 2 ms poll avg %llu us max %llu us\n",
+           (unsigned long long)(sumTimer / TRIALS), (unsigned long long)maxTimer,
+           (unsigned long long)(sumPoll / TRIALS), (unsigned long long)maxPoll);
+
+    // Bounded by the dispatch delay plus one step, not by the CAN task period
+    TEST_ASSERT_TRUE(maxTimer <= 120 + STEP_US);
+    TEST_ASSERT_TRUE(sumTimer < sumPoll);
+}
+
+void test_few_frames_never_arm() {
+    Sim sim;
+    sim.immo.unlock();
+    sim.run(7000000, sim.now + (VCU_ONLINE_FRAMES / 2) * FRAME_US);
+
+    VcuWatchdogStatus v = sim.status();
+    TEST_ASSERT_TRUE(sim.immo.isUnlocked());
+    TEST_ASSERT_EQUAL_UINT32(1, v.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(0, v.autoLocks);
+}
+
+void test_flapping_vcu_needs_rearm() {
+    Sim sim;
+    sim.immo.unlock();
+    sim.run(7000000, sim.now + 2000000);
+    TEST_ASSERT_FALSE(sim.immo.isUnlocked());
+    TEST_ASSERT_EQUAL_UINT32(1, sim.status().autoLocks);
+
+    // Back for a few seconds only: enough frames, but not VCU_REARM_MS
+    sim.immo.unlock();
+    sim.run(8000000, sim.now + 3000000);
+    TEST_ASSERT_TRUE(sim.immo.isUnlocked());
+    TEST_ASSERT_EQUAL_UINT32(2, sim.status().timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.status().autoLocks);
+
+    // Steady for longer than VCU_REARM_MS: armed again
+    sim.run((int64_t)VCU_REARM_MS * 1000 + 8000000, sim.now + (int64_t)VCU_REARM_MS * 1000 + 2000000);
+    VcuWatchdogStatus v = sim.status();
+    TEST_ASSERT_FALSE(sim.immo.isUnlocked());
+    TEST_ASSERT_EQUAL_UINT32(3, v.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(2, v.autoLocks);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_dropout_latency);
+    RUN_TEST(test_few_frames_never_arm);
+    RUN_TEST(test_flapping_vcu_needs_rearm);
+    return UNITY_END();
+}